@@ -20,9 +20,12 @@
  *
  */
 
+#include "common/atomic.h"
 #include "common/debug.h"
 #include "common/file.h"
+#include "common/jobsystem.h"
 #include "common/mutex.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/queue.h"
 #include "common/util.h"
@@ -466,6 +469,238 @@ AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp
 	return new LimitingAudioStream(parentStream, length, disposeAfterUse);
 }
 
+/**
+ * Implementation of PrefetchingAudioStream and SeekablePrefetchingAudioStream.
+ *
+ * A job writes to a ring buffer, which the reader empties. At most one job
+ * is queued or running at a time. The parent stream is only ever accessed
+ * with _parentMutex held.
+ */
+template<class Interface>
+class PrefetchingAudioStreamImpl : public Interface {
+public:
+	PrefetchingAudioStreamImpl(AudioStream *parentStream, uint msecs, DisposeAfterUse::Flag disposeAfterUse, Common::JobSystem *jobSystem);
+	~PrefetchingAudioStreamImpl();
+
+	int readBuffer(int16 *buffer, const int numSamples);
+	bool endOfData() const;
+	bool endOfStream() const;
+	bool isStereo() const { return _stereo; }
+	int getRate() const { return _rate; }
+
+	uint getBufferSize() const { return _size; }
+	uint getBufferedSamples() const { return Common::atomicLoad(&_writePos) - Common::atomicLoad(&_readPos); }
+	uint getUnderruns() const { return Common::atomicLoad(&_underruns); }
+
+protected:
+	/** Discard the data decoded ahead. Must be called with _parentMutex held. */
+	void flushBuffer() { Common::atomicStore(&_readPos, Common::atomicLoad(&_writePos)); }
+	void scheduleFill();
+
+	mutable Common::Mutex _parentMutex;
+
+private:
+	enum {
+		kMinBufferFrames = 4096
+	};
+
+	static void fillJobProc(void *param);
+	void fillBuffer();
+	int readFromBuffer(int16 *buffer, int numSamples);
+
+	Common::DisposablePtr<AudioStream> _parent;
+	const bool _stereo;
+	const int _rate;
+
+	int16 *_buffer;
+	uint _size;		///< size of the buffer in samples, a power of two
+	uint _chunk;	///< number of samples decoded in one go
+	volatile uint32 _readPos;
+	volatile uint32 _writePos;
+	volatile uint32 _underruns;
+
+	/** The job system decoding ahead, or nullptr if the parent is read directly */
+	Common::JobSystem *_jobSystem;
+	Common::JobSystem::JobGroup _fillJob;
+	volatile int32 _fillPending;
+	volatile int32 _quit;
+};
+
+template<class Interface>
+PrefetchingAudioStreamImpl<Interface>::PrefetchingAudioStreamImpl(AudioStream *parentStream, uint msecs, DisposeAfterUse::Flag disposeAfterUse, Common::JobSystem *jobSystem)
+	: _parentMutex(), _parent(parentStream, disposeAfterUse), _stereo(parentStream->isStereo()), _rate(parentStream->getRate()),
+	  _buffer(0), _size(0), _chunk(0), _readPos(0), _writePos(0), _underruns(0),
+	  _jobSystem(jobSystem), _fillPending(0), _quit(0) {
+
+	if (!_jobSystem)
+		_jobSystem = &g_system->getJobSystem();
+	if (!_jobSystem->getThreadCount()) {
+		// The jobs would run on the reading thread
+		_jobSystem = nullptr;
+		return;
+	}
+
+	const uint samples = MAX<uint>(_rate * msecs / 1000, kMinBufferFrames) * (_stereo ? 2 : 1);
+	_size = 1;
+	while (_size < samples)
+		_size <<= 1;
+	// Small chunks keep the time a reader may wait for the lock short
+	_chunk = _size / 16;
+	_buffer = new int16[_size];
+
+	scheduleFill();
+}
+
+template<class Interface>
+PrefetchingAudioStreamImpl<Interface>::~PrefetchingAudioStreamImpl() {
+	if (_jobSystem) {
+		Common::atomicStore(&_quit, 1);
+		_jobSystem->wait(_fillJob);
+	}
+
+	delete[] _buffer;
+}
+
+template<class Interface>
+void PrefetchingAudioStreamImpl<Interface>::fillJobProc(void *param) {
+	PrefetchingAudioStreamImpl *stream = (PrefetchingAudioStreamImpl *)param;
+
+	stream->fillBuffer();
+	// Whatever the reader consumed meanwhile is refilled by the next job,
+	// scheduled by its next read
+	Common::atomicStore(&stream->_fillPending, 0);
+}
+
+template<class Interface>
+void PrefetchingAudioStreamImpl<Interface>::scheduleFill() {
+	if (!_jobSystem)
+		return;
+
+	// Only start a job once there is room for a whole chunk
+	if (_size - getBufferedSamples() < _chunk)
+		return;
+
+	if (Common::atomicCompareAndSwap(&_fillPending, 0, 1))
+		_jobSystem->submit(_fillJob, fillJobProc, this);
+}
+
+template<class Interface>
+void PrefetchingAudioStreamImpl<Interface>::fillBuffer() {
+	while (!Common::atomicLoad(&_quit)) {
+		// Take the lock for one chunk at a time, so that a reader which ran
+		// out of data only waits for the chunk being decoded
+		Common::StackLock lock(_parentMutex);
+
+		const uint32 writePos = _writePos;
+		const uint space = _size - (writePos - Common::atomicLoad(&_readPos));
+		if (space < _chunk || _parent->endOfData())
+			break;
+
+		const uint start = writePos & (_size - 1);
+		const int len = MIN<uint>(_chunk, _size - start);
+		const int samples = _parent->readBuffer(_buffer + start, len);
+		if (samples > 0)
+			Common::atomicStore(&_writePos, writePos + samples);
+		if (samples < len)
+			break;
+	}
+}
+
+template<class Interface>
+int PrefetchingAudioStreamImpl<Interface>::readFromBuffer(int16 *buffer, int numSamples) {
+	const uint32 readPos = Common::atomicLoad(&_readPos);
+	const uint samples = MIN<uint>(numSamples, Common::atomicLoad(&_writePos) - readPos);
+	const uint start = readPos & (_size - 1);
+	const uint first = MIN<uint>(samples, _size - start);
+
+	memcpy(buffer, _buffer + start, first * sizeof(int16));
+	memcpy(buffer + first, _buffer, (samples - first) * sizeof(int16));
+
+	// A seek on another thread may have flushed the buffer meanwhile, which
+	// moves _readPos past the samples copied, and lets the job overwrite
+	// them. They are dropped then, so no data from before the seek is played.
+	if (!Common::atomicCompareAndSwap(&_readPos, readPos, readPos + samples))
+		return 0;
+	return samples;
+}
+
+template<class Interface>
+int PrefetchingAudioStreamImpl<Interface>::readBuffer(int16 *buffer, const int numSamples) {
+	if (!_jobSystem) {
+		Common::StackLock lock(_parentMutex);
+		return _parent->readBuffer(buffer, numSamples);
+	}
+
+	int samples = readFromBuffer(buffer, numSamples);
+	if (samples < numSamples) {
+		// The job did not keep up. Whatever it decoded until we got the
+		// lock has to be used up first, then we read the parent stream
+		// ourselves.
+		Common::StackLock lock(_parentMutex);
+		samples += readFromBuffer(buffer + samples, numSamples - samples);
+
+		if (samples < numSamples && !_parent->endOfData()) {
+			Common::atomicAdd(&_underruns, 1);
+
+			const int read = _parent->readBuffer(buffer + samples, numSamples - samples);
+			if (read > 0)
+				samples += read;
+		}
+	}
+
+	scheduleFill();
+	return samples;
+}
+
+template<class Interface>
+bool PrefetchingAudioStreamImpl<Interface>::endOfData() const {
+	if (getBufferedSamples())
+		return false;
+
+	Common::StackLock lock(_parentMutex);
+	return !getBufferedSamples() && _parent->endOfData();
+}
+
+template<class Interface>
+bool PrefetchingAudioStreamImpl<Interface>::endOfStream() const {
+	if (getBufferedSamples())
+		return false;
+
+	Common::StackLock lock(_parentMutex);
+	return !getBufferedSamples() && _parent->endOfStream();
+}
+
+class SeekablePrefetchingAudioStreamImpl : public PrefetchingAudioStreamImpl<SeekablePrefetchingAudioStream> {
+public:
+	SeekablePrefetchingAudioStreamImpl(SeekableAudioStream *parentStream, uint msecs, DisposeAfterUse::Flag disposeAfterUse, Common::JobSystem *jobSystem)
+		: PrefetchingAudioStreamImpl<SeekablePrefetchingAudioStream>(parentStream, msecs, disposeAfterUse, jobSystem), _seekableParent(parentStream) {}
+
+	bool seek(const Timestamp &where) {
+		bool result;
+		{
+			Common::StackLock lock(_parentMutex);
+			result = _seekableParent->seek(where);
+			flushBuffer();
+		}
+
+		scheduleFill();
+		return result;
+	}
+
+	Timestamp getLength() const { return _seekableParent->getLength(); }
+
+private:
+	SeekableAudioStream *_seekableParent;
+};
+
+PrefetchingAudioStream *makePrefetchingAudioStream(AudioStream *parentStream, uint msecs, DisposeAfterUse::Flag disposeAfterUse, Common::JobSystem *jobSystem) {
+	return new PrefetchingAudioStreamImpl<PrefetchingAudioStream>(parentStream, msecs, disposeAfterUse, jobSystem);
+}
+
+SeekablePrefetchingAudioStream *makePrefetchingAudioStream(SeekableAudioStream *parentStream, uint msecs, DisposeAfterUse::Flag disposeAfterUse, Common::JobSystem *jobSystem) {
+	return new SeekablePrefetchingAudioStreamImpl(parentStream, msecs, disposeAfterUse, jobSystem);
+}
+
 /**
  * An AudioStream that plays nothing and immediately returns that
  * the endOfStream() has been reached
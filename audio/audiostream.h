@@ -31,6 +31,7 @@
 #include "audio/timestamp.h"
 
 namespace Common {
+class JobSystem;
 class SeekableReadStream;
 }
 
@@ -371,6 +372,68 @@ Timestamp convertTimeToStreamPos(const Timestamp &where, int rate, bool isStereo
  */
 AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp &length, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
 
+/**
+ * An AudioStream wrapper which decodes its parent stream ahead of time on
+ * the worker threads of a Common::JobSystem, so that slow disk access or
+ * expensive frames of e.g. an MP3, Ogg Vorbis or FLAC stream do not delay
+ * the mixer.
+ *
+ * When the job system has no worker threads, or the decoding falls behind,
+ * the parent stream is read directly, so the output is always the same as
+ * the one of the parent stream.
+ */
+class PrefetchingAudioStream : public virtual AudioStream {
+public:
+	/**
+	 * Return the size of the read-ahead buffer in samples, or 0 if the
+	 * parent stream is read directly.
+	 */
+	virtual uint getBufferSize() const = 0;
+
+	/**
+	 * Return the number of samples currently decoded ahead.
+	 */
+	virtual uint getBufferedSamples() const = 0;
+
+	/**
+	 * Return how often the read-ahead buffer ran empty while the parent
+	 * stream still had data, i.e. how often the parent had to be read
+	 * directly.
+	 */
+	virtual uint getUnderruns() const = 0;
+};
+
+/**
+ * A PrefetchingAudioStream for a seekable parent stream. Seeking discards
+ * the data decoded ahead, so it can be used with makeLoopingAudioStream().
+ * seek() may be called on another thread than the reading one; a read
+ * running at the same time then returns no data from before the seek.
+ */
+class SeekablePrefetchingAudioStream : public PrefetchingAudioStream, public SeekableAudioStream {
+};
+
+/**
+ * Factory function for a PrefetchingAudioStream.
+ *
+ * @param parentStream    The stream to decode ahead
+ * @param msecs           How much audio to decode ahead, in milliseconds
+ * @param disposeAfterUse Whether the parent stream object should be destroyed on destruction of the returned stream
+ * @param jobSystem       The job system to decode ahead on, the shared one of OSystem if nullptr.
+ *                        Without worker threads, the parent stream is read directly.
+ */
+PrefetchingAudioStream *makePrefetchingAudioStream(AudioStream *parentStream, uint msecs = 500, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES, Common::JobSystem *jobSystem = nullptr);
+
+/**
+ * Factory function for a SeekablePrefetchingAudioStream.
+ *
+ * @param parentStream    The stream to decode ahead
+ * @param msecs           How much audio to decode ahead, in milliseconds
+ * @param disposeAfterUse Whether the parent stream object should be destroyed on destruction of the returned stream
+ * @param jobSystem       The job system to decode ahead on, the shared one of OSystem if nullptr.
+ *                        Without worker threads, the parent stream is read directly.
+ */
+SeekablePrefetchingAudioStream *makePrefetchingAudioStream(SeekableAudioStream *parentStream, uint msecs = 500, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES, Common::JobSystem *jobSystem = nullptr);
+
 /**
  * An AudioStream designed to work in terms of packets.
  *
@@ -306,7 +306,13 @@ EmulatedOPL::EmulatedOPL() :
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
-	_handle(new Audio::SoundHandle()) {
+	_handle(new Audio::SoundHandle()),
+	_queuedWrites(0),
+	_appliedWrites(0),
+	_batching(false),
+	_batchBuffer(0),
+	_batchPos(0),
+	_renderedPos(0) {
 }
 
 EmulatedOPL::~EmulatedOPL() {
@@ -319,17 +325,112 @@ EmulatedOPL::~EmulatedOPL() {
 	delete _handle;
 }
 
+void EmulatedOPL::reset() {
+	Common::StackLock lock(_queueMutex);
+	if (_batching)
+		queueWrite(QueuedWrite::kReset, 0, 0);
+	else
+		resetChip();
+}
+
+void EmulatedOPL::write(int a, int v) {
+	Common::StackLock lock(_queueMutex);
+	if (_batching)
+		queueWrite(QueuedWrite::kWritePort, a, v);
+	else
+		writePort(a, v);
+}
+
+byte EmulatedOPL::read(int a) {
+	// Status reads depend on the state of the chip at the current
+	// position, so everything up to it has to be generated first.
+	Common::StackLock lock(_queueMutex);
+	if (_batching)
+		flushWrites(_batchPos);
+
+	return readPort(a);
+}
+
+void EmulatedOPL::writeReg(int r, int v) {
+	Common::StackLock lock(_queueMutex);
+	if (_batching)
+		queueWrite(QueuedWrite::kWriteRegister, r, v);
+	else
+		writeRegister(r, v);
+}
+
+void EmulatedOPL::queueWrite(QueuedWrite::Type type, int a, int v) {
+	if (_queuedWrites == _writeQueue.size())
+		_writeQueue.resize(_queuedWrites ? _queuedWrites * 2 : 64);
+
+	QueuedWrite &write = _writeQueue[_queuedWrites++];
+	write.type = type;
+	write.pos = _batchPos;
+	write.a = a;
+	write.v = v;
+}
+
+void EmulatedOPL::flushWrites(int pos) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+
+	while (_renderedPos < pos || (_appliedWrites < _queuedWrites && _writeQueue[_appliedWrites].pos <= pos)) {
+		// Generate everything up to the next write, or up to pos
+		int end = pos;
+		if (_appliedWrites < _queuedWrites && _writeQueue[_appliedWrites].pos < end)
+			end = _writeQueue[_appliedWrites].pos;
+
+		if (end > _renderedPos) {
+			generateSamples(_batchBuffer + _renderedPos * stereoFactor, (end - _renderedPos) * stereoFactor);
+			_renderedPos = end;
+		}
+
+		// Apply all writes made at that position
+		while (_appliedWrites < _queuedWrites && _writeQueue[_appliedWrites].pos == _renderedPos) {
+			const QueuedWrite &write = _writeQueue[_appliedWrites++];
+			switch (write.type) {
+			case QueuedWrite::kReset:
+				resetChip();
+				break;
+			case QueuedWrite::kWritePort:
+				writePort(write.a, write.v);
+				break;
+			case QueuedWrite::kWriteRegister:
+				writeRegister(write.a, write.v);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
 int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 	const int stereoFactor = isStereo() ? 2 : 1;
-	int len = numSamples / stereoFactor;
+	const int len = numSamples / stereoFactor;
 	int step;
 
+	{
+		Common::StackLock lock(_queueMutex);
+		_batchBuffer = buffer;
+		_batchPos = 0;
+		_renderedPos = 0;
+		_batching = true;
+	}
+
+	// First run all timer callbacks up to the end of the buffer, queuing
+	// their writes. The position of every callback is the same as when the
+	// samples in front of it would have been generated right before it.
+	// The lock is not held while calling them, since they usually take the
+	// locks of the engine, which may access the chip at the same time.
 	do {
-		step = len;
+		step = len - _batchPos;
 		if (step > (_nextTick >> FIXP_SHIFT))
 			step = (_nextTick >> FIXP_SHIFT);
 
-		generateSamples(buffer, step * stereoFactor);
+		{
+			Common::StackLock lock(_queueMutex);
+			_batchPos += step;
+		}
 
 		_nextTick -= step << FIXP_SHIFT;
 		if (!(_nextTick >> FIXP_SHIFT)) {
@@ -338,10 +439,17 @@ int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 
 			_nextTick += _samplesPerTick;
 		}
+	} while (_batchPos < len);
+
+	Common::StackLock lock(_queueMutex);
+	_batching = false;
+
+	// Now generate the samples, stopping only at the queued writes
+	flushWrites(len);
 
-		buffer += step * stereoFactor;
-		len -= step;
-	} while (len);
+	_queuedWrites = 0;
+	_appliedWrites = 0;
+	_batchBuffer = 0;
 
 	return numSamples;
 }
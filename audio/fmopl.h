@@ -25,7 +25,9 @@
 
 #include "audio/audiostream.h"
 
+#include "common/array.h"
 #include "common/func.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/scummsys.h"
 
@@ -236,6 +238,13 @@ private:
  *
  * This will send callbacks based on the number of samples
  * decoded in readBuffer().
+ *
+ * All timer callbacks falling into one readBuffer() call are run before any
+ * samples are generated. The register writes they make are queued together
+ * with their sample position, and the emulator is then run over the whole
+ * buffer, stopping only where a queued write has to be applied. The output
+ * is the same as when generating samples tick by tick, but the emulator is
+ * called once per block of writes instead of once per timer tick.
  */
 class EmulatedOPL : public OPL, protected Audio::AudioStream {
 public:
@@ -243,6 +252,10 @@ public:
 	virtual ~EmulatedOPL();
 
 	// OPL API
+	void reset();
+	void write(int a, int v);
+	byte read(int a);
+	void writeReg(int r, int v);
 	void setCallbackFrequency(int timerFrequency);
 
 	// AudioStream API
@@ -255,6 +268,27 @@ protected:
 	void startCallbacks(int timerFrequency);
 	void stopCallbacks();
 
+	/**
+	 * Reset the emulated chip. Called by reset() once all samples up to
+	 * the point of the reset have been generated.
+	 */
+	virtual void resetChip() = 0;
+
+	/**
+	 * Write a value to an I/O port of the emulated chip, see write().
+	 */
+	virtual void writePort(int a, int v) = 0;
+
+	/**
+	 * Read a value from an I/O port of the emulated chip, see read().
+	 */
+	virtual byte readPort(int a) = 0;
+
+	/**
+	 * Write a value to a register of the emulated chip, see writeReg().
+	 */
+	virtual void writeRegister(int r, int v) = 0;
+
 	/**
 	 * Read up to 'length' samples.
 	 *
@@ -278,6 +312,46 @@ private:
 	int _samplesPerTick;
 
 	Audio::SoundHandle *_handle;
+
+	/**
+	 * A chip access made by a timer callback during readBuffer(), applied
+	 * once all samples before its position have been generated.
+	 */
+	struct QueuedWrite {
+		enum Type {
+			kReset,
+			kWritePort,
+			kWriteRegister
+		};
+
+		Type type;
+		int pos;
+		int a;
+		int v;
+	};
+
+	/**
+	 * Generate samples up to the frame 'pos' of the current buffer,
+	 * applying all queued writes in front of it.
+	 */
+	void flushWrites(int pos);
+
+	void queueWrite(QueuedWrite::Type type, int a, int v);
+
+	/**
+	 * Guards the queue and the batch state, as the engine may access the
+	 * chip from its own thread while readBuffer() runs. Writes made then are
+	 * queued as well. The lock is never held while calling the callback.
+	 */
+	Common::Mutex _queueMutex;
+	Common::Array<QueuedWrite> _writeQueue;
+	uint _queuedWrites;
+	uint _appliedWrites;
+
+	bool _batching;
+	int16 *_batchBuffer;
+	int _batchPos;
+	int _renderedPos;
 };
 
 } // End of namespace OPL
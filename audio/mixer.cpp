@@ -22,10 +22,12 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
 #include "audio/mixer_intern.h"
+#include "audio/mixkernels.h"
 #include "audio/rate.h"
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
@@ -40,10 +42,13 @@ namespace Audio {
 
 /**
  * Channel used by the default Mixer implementation.
+ *
+ * Once handed to the audio thread, a channel is only ever accessed by
+ * whoever holds the slot mutex of its channel.
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, ResamplerType resampler);
 	~Channel();
 
 	/**
@@ -58,29 +63,38 @@ public:
 	int mix(int16 *data, uint len);
 
 	/**
-	 * Queries whether the channel is still playing or not.
+	 * Renders the channel's samples at full volume, for mixing them later
+	 * via mixRendered(). This does not advance the playback position.
+	 *
+	 * @param data buffer where to render the data, must be cleared
+	 * @param len  number of sample pairs to render
+	 * @return number of sample pairs rendered
 	 */
-	bool isFinished() const { return _stream->endOfStream(); }
+	int render(int16 *data, uint len);
 
 	/**
-	 * Queries whether the channel is a permanent channel.
-	 * A permanent channel is not affected by a Mixer::stopAll
-	 * call.
+	 * Mixes samples produced by render() into the given buffer, applying
+	 * the current channel volume, and accounts for them as played.
+	 *
+	 * @param data     buffer where to mix the data
+	 * @param rendered samples produced by render()
+	 * @param len      number of sample pairs to mix
 	 */
-	bool isPermanent() const { return _permanent; }
+	void mixRendered(int16 *data, const int16 *rendered, uint len);
 
 	/**
-	 * Returns the id of the channel.
+	 * Queries whether the channel is still playing or not.
 	 */
-	int getId() const { return _id; }
+	bool isFinished() const { return _stream->endOfStream(); }
 
 	/**
 	 * Pauses or unpaused the channel in a recursive fashion.
 	 *
 	 * @param paused true, when the channel should be paused.
 	 *               false when it should be unpaused.
+	 * @param timestamp time of the request, as returned by OSystem::getMillis
 	 */
-	void pause(bool paused);
+	void pause(bool paused, uint32 timestamp);
 
 	/**
 	 * Queries whether the channel is currently paused.
@@ -88,48 +102,19 @@ public:
 	bool isPaused() const { return (_pauseLevel != 0); }
 
 	/**
-	 * Sets the channel's own volume.
-	 *
-	 * @param volume new volume
-	 */
-	void setVolume(const byte volume);
-
-	/**
-	 * Gets the channel's own volume.
-	 *
-	 * @return volume
+	 * Sets the effective left and right channel volumes, which already
+	 * include balance and sound type volume.
 	 */
-	byte getVolume();
+	void setOutputVolume(int volL, int volR) { _volL = volL; _volR = volR; }
 
 	/**
-	 * Sets the channel's balance setting.
-	 *
-	 * @param balance new balance
+	 * Queries the bookkeeping needed to compute how long the channel has
+	 * been playing.
 	 */
-	void setBalance(const int8 balance);
-
-	/**
-	 * Gets the channel's balance setting.
-	 *
-	 * @return balance
-	 */
-	int8 getBalance();
-
-	/**
-	 * Notifies the channel that the global sound type
-	 * volume settings changed.
-	 */
-	void notifyGlobalVolChange() { updateChannelVolumes(); }
-
-	/**
-	 * Queries how long the channel has been playing.
-	 */
-	Timestamp getElapsedTime();
-
-	/**
-	 * Queries the channel's sound type.
-	 */
-	Mixer::SoundType getType() const { return _type; }
+	uint32 getSamplesConsumed() const { return _samplesConsumed; }
+	uint32 getMixerTimeStamp() const { return _mixerTimeStamp; }
+	uint32 getPauseStartTime() const { return _pauseStartTime; }
+	uint32 getPauseTime() const { return _pauseTime; }
 
 	/**
 	 * Sets the channel's sound handle.
@@ -144,20 +129,12 @@ public:
 	SoundHandle getHandle() const { return _handle; }
 
 private:
-	const Mixer::SoundType _type;
 	SoundHandle _handle;
-	bool _permanent;
 	int _pauseLevel;
-	int _id;
+	bool _swapVolumes;
 
-	byte _volume;
-	int8 _balance;
-
-	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
 
-	Mixer *_mixer;
-
 	uint32 _samplesConsumed;
 	uint32 _samplesDecoded;
 	uint32 _mixerTimeStamp;
@@ -173,17 +150,48 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _queueMutex(), _renderMutex(), _sampleRate(sampleRate), _resampler(kResamplerLinear), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _queueHead(0), _queueTail(0), _overflowPending(0), _jobSystem(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		_slotHandle[i] = kInvalidHandle;
 		_channels[i] = 0;
+		_finishedHandle[i] = kInvalidHandle;
+		_renderBlocks[i].mixer = this;
+		_renderBlocks[i].slot = i;
+	}
+
+	// playStream may be called from timer threads, so the config is read
+	// once here
+	if (ConfMan.get("resampler") == "sinc") {
+		_resampler = kResamplerSinc;
+		initSincFilterBanks();
+	}
+
+	if (ConfMan.hasKey("mixer_render_ahead") && ConfMan.getBool("mixer_render_ahead")) {
+		_jobSystem = &g_system->getJobSystem();
+		if (!_jobSystem->getThreadCount()) {
+			// Rendering ahead on the audio thread itself gains nothing
+			_jobSystem = 0;
+		}
+	}
 }
 
 MixerImpl::~MixerImpl() {
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	if (_jobSystem)
+		_jobSystem->wait(_renderJobs);
+
+	// Take ownership of channels which were never picked up by the audio thread
+	processCommands();
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		delete _channels[i];
+		delete[] _renderBlocks[i].data;
+	}
+
+	freeSincFilterBanks();
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -194,10 +202,240 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+bool MixerImpl::isSlotActive(int slot) const {
+	const uint32 handle = Common::atomicLoad(&_slotHandle[slot]);
+	return handle != kInvalidHandle && Common::atomicLoad(&_finishedHandle[slot]) != handle;
+}
+
+bool MixerImpl::isHandleActive(uint32 handle) const {
+	if (handle == kInvalidHandle)
+		return false;
+
+	const int index = handle % NUM_CHANNELS;
+	return Common::atomicLoad(&_slotHandle[index]) == handle && Common::atomicLoad(&_finishedHandle[index]) != handle;
+}
+
+void MixerImpl::computeChannelVolumes(const ChannelInfo &info, int &volL, int &volR) const {
+	// From the channel balance/volume and the global volume, we compute
+	// the effective volume for the left and right channel. Note the
+	// slightly odd divisor: the 255 reflects the fact that the maximal
+	// value for volume is 255, while the 127 is there because the
+	// balance value ranges from -127 to 127.  The mixer (music/sound)
+	// volume is in the range 0 - kMaxMixerVolume.
+	// Hence, the vol_l/vol_r values will be in that range, too
+
+	if (!_soundTypeSettings[info.type].mute) {
+		int vol = _soundTypeSettings[info.type].volume * info.volume;
+
+		if (info.balance == 0) {
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = vol / Mixer::kMaxChannelVolume;
+		} else if (info.balance < 0) {
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = ((127 + info.balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+		} else {
+			volL = ((127 - info.balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volR = vol / Mixer::kMaxChannelVolume;
+		}
+	} else {
+		volL = volR = 0;
+	}
+}
+
+void MixerImpl::pushCommand(const Command &cmd) {
+	// Called with _queueMutex held, which makes us the only producer.
+	const uint32 tail = _queueTail;
+	if (Common::atomicLoad(&_overflowPending) || tail - Common::atomicLoad(&_queueHead) >= COMMAND_QUEUE_SIZE) {
+		// The audio thread is not keeping up (or not running at all). We
+		// must not wait for it here, so the command is set aside, and
+		// applied by whichever comes first: the audio thread, or the caller
+		// through applyOverflow() once it released _queueMutex.
+		_overflow.push_back(cmd);
+		Common::atomicStore(&_overflowPending, 1);
+		return;
+	}
+
+	_queue[tail % COMMAND_QUEUE_SIZE] = cmd;
+	Common::atomicStore(&_queueTail, tail + 1);
+}
+
+void MixerImpl::queueStop(int slot) {
+	Command cmd;
+	cmd.type = kCommandStop;
+	cmd.slot = slot;
+	cmd.handle = _slotHandle[slot];
+
+	// Revoke the slot first: the audio thread skips channels whose
+	// handle no longer matches, even before it picks up the command.
+	Common::atomicStore(&_slotHandle[slot], kInvalidHandle);
+	pushCommand(cmd);
+}
+
+void MixerImpl::queuePause(int slot, bool paused) {
+	Command cmd;
+	cmd.type = kCommandPause;
+	cmd.slot = slot;
+	cmd.handle = _slotHandle[slot];
+	cmd.paused = paused;
+	cmd.timestamp = g_system->getMillis(true);
+	pushCommand(cmd);
+}
+
+void MixerImpl::queueVolumeUpdate(int slot) {
+	Command cmd;
+	cmd.type = kCommandVolume;
+	cmd.slot = slot;
+	cmd.handle = _slotHandle[slot];
+	computeChannelVolumes(_channelInfo[slot], cmd.volL, cmd.volR);
+	pushCommand(cmd);
+}
+
+void MixerImpl::applyOverflow() {
+	// Called without _queueMutex held: it must not be held while waiting
+	// for _renderMutex, since the audio thread may call back into the mixer
+	// from within a stream.
+	if (!Common::atomicLoad(&_overflowPending))
+		return;
+
+	Common::StackLock lock(_renderMutex);
+	processCommands();
+}
+
+void MixerImpl::waitForRender(uint32 slots) {
+	// Callers may free the data of a stopped stream as soon as we return.
+	// Stopped slots are already revoked, so once the audio thread or a
+	// render job is done with the channel, it will not touch the stream
+	// again.
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (slots & (1 << i))
+			Common::StackLock lock(_slotMutex[i]);
+	}
+}
+
+void MixerImpl::processCommands() {
+	// Called with _renderMutex held (or from the destructor).
+	uint32 tail = Common::atomicLoad(&_queueTail);
+	Common::Array<Command> overflow;
+	if (Common::atomicLoad(&_overflowPending)) {
+		// The queue does not move while commands overflow, so everything in
+		// it up to the tail comes before them. Only copy them here: a
+		// command may wait for a render job, which may be waiting for
+		// _queueMutex in turn.
+		Common::StackLock lock(_queueMutex);
+		tail = _queueTail;
+		overflow = _overflow;
+		_overflow.clear();
+		Common::atomicStore(&_overflowPending, 0);
+	}
+
+	uint32 head = _queueHead;
+	while (head != tail) {
+		applyCommand(_queue[head % COMMAND_QUEUE_SIZE]);
+		++head;
+		Common::atomicStore(&_queueHead, head);
+	}
+
+	for (uint i = 0; i < overflow.size(); ++i)
+		applyCommand(overflow[i]);
+}
+
+void MixerImpl::applyCommand(const Command &cmd) {
+	Common::StackLock lock(_slotMutex[cmd.slot]);
+	Channel *chan = _channels[cmd.slot];
+
+	if (cmd.type == kCommandPlay) {
+		delete chan;
+		_channels[cmd.slot] = cmd.channel;
+		resetRenderBlock(cmd.slot);
+		publishSnapshot(cmd.slot, cmd.channel);
+	} else if (chan && chan->getHandle()._val == cmd.handle) {
+		switch (cmd.type) {
+		case kCommandStop:
+			delete chan;
+			_channels[cmd.slot] = 0;
+			resetRenderBlock(cmd.slot);
+			break;
+		case kCommandPause:
+			chan->pause(cmd.paused, cmd.timestamp);
+			publishSnapshot(cmd.slot, chan);
+			break;
+		case kCommandVolume:
+			chan->setOutputVolume(cmd.volL, cmd.volR);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void MixerImpl::publishSnapshot(int slot, const Channel *chan) {
+	ChannelSnapshot &snap = _snapshots[slot];
+
+	// An odd sequence number marks an update in progress
+	Common::atomicAdd(&snap.sequence, 1);
+	snap.handle = chan->getHandle()._val;
+	snap.samplesConsumed = chan->getSamplesConsumed();
+	snap.mixerTimeStamp = chan->getMixerTimeStamp();
+	snap.pauseStartTime = chan->getPauseStartTime();
+	snap.pauseTime = chan->getPauseTime();
+	snap.paused = chan->isPaused();
+	Common::atomicAdd(&snap.sequence, 1);
+}
+
+void MixerImpl::renderJobProc(void *param) {
+	RenderBlock &block = *(RenderBlock *)param;
+	MixerImpl &mixer = *block.mixer;
+
+	// The audio thread may have taken care of the block already, in which
+	// case there is nothing left to do
+	if (Common::atomicLoad(&block.state) != kRenderQueued)
+		return;
+
+	Common::StackLock lock(mixer._slotMutex[block.slot]);
+	if (block.state == kRenderQueued)
+		mixer.renderBlock(block.slot);
+}
+
+void MixerImpl::resetRenderBlock(int slot) {
+	// Called with the slot mutex held
+	RenderBlock &block = _renderBlocks[slot];
+	Common::atomicStore(&block.state, kRenderIdle);
+	block.frames = block.pos = 0;
+}
+
+void MixerImpl::queueRenderBlock(int slot, uint len) {
+	// Called from the audio thread with the slot mutex held
+	RenderBlock &block = _renderBlocks[slot];
+
+	if (block.capacity < len) {
+		delete[] block.data;
+		block.data = new int16[2 * len];
+		block.capacity = len;
+	}
+
+	block.size = len;
+	block.frames = block.pos = 0;
+	Common::atomicStore(&block.state, kRenderQueued);
+	_jobSystem->submit(_renderJobs, renderJobProc, &block);
+}
+
+void MixerImpl::renderBlock(int slot) {
+	// Called with the slot mutex held
+	RenderBlock &block = _renderBlocks[slot];
+	Channel *chan = _channels[slot];
+
+	block.frames = block.pos = 0;
+	if (chan && Common::atomicLoad(&_slotHandle[slot]) == chan->getHandle()._val) {
+		memset(block.data, 0, 2 * block.size * sizeof(int16));
+		block.frames = chan->render(block.data, block.size);
+	}
+	Common::atomicStore(&block.state, kRenderIdle);
+}
+
+void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan, const ChannelInfo &info) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
+		if (!isSlotActive(i)) {
 			index = i;
 			break;
 		}
@@ -208,13 +446,26 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	_handleSeed++;
+
+	_channelInfo[index] = info;
 
+	int volL, volR;
+	computeChannelVolumes(info, volL, volR);
+	chan->setOutputVolume(volL, volR);
 	chan->setHandle(chanHandle);
-	_handleSeed++;
+
+	Command cmd;
+	cmd.type = kCommandPlay;
+	cmd.slot = index;
+	cmd.handle = chanHandle._val;
+	cmd.channel = chan;
+
+	Common::atomicStore(&_slotHandle[index], chanHandle._val);
+	pushCommand(cmd);
+
 	if (handle)
 		*handle = chanHandle;
 }
@@ -227,48 +478,54 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_queueMutex);
 
-	if (stream == 0) {
-		warning("stream is 0");
-		return;
-	}
+		if (stream == 0) {
+			warning("stream is 0");
+			return;
+		}
 
 
-	assert(_mixerReady);
-
-	// Prevent duplicate sounds
-	if (id != -1) {
-		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
-				// Delete the stream if were asked to auto-dispose it.
-				// Note: This could cause trouble if the client code does not
-				// yet expect the stream to be gone. The primary example to
-				// keep in mind here is QueuingAudioStream.
-				// Thus, as a quick rule of thumb, you should never, ever,
-				// try to play QueuingAudioStreams with a sound id.
-				if (autofreeStream == DisposeAfterUse::YES)
-					delete stream;
-				return;
-			}
-	}
+		assert(_mixerReady);
+
+		// Prevent duplicate sounds
+		if (id != -1) {
+			for (int i = 0; i != NUM_CHANNELS; i++)
+				if (isSlotActive(i) && _channelInfo[i].id == id) {
+					// Delete the stream if were asked to auto-dispose it.
+					// Note: This could cause trouble if the client code does not
+					// yet expect the stream to be gone. The primary example to
+					// keep in mind here is QueuingAudioStream.
+					// Thus, as a quick rule of thumb, you should never, ever,
+					// try to play QueuingAudioStreams with a sound id.
+					if (autofreeStream == DisposeAfterUse::YES)
+						delete stream;
+					return;
+				}
+		}
 
 #ifdef AUDIO_REVERSE_STEREO
-	reverseStereo = !reverseStereo;
+		reverseStereo = !reverseStereo;
 #endif
 
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
-	chan->setVolume(volume);
-	chan->setBalance(balance);
-	insertChannel(handle, chan);
+		// Create the channel
+		ChannelInfo info;
+		info.id = id;
+		info.type = type;
+		info.permanent = permanent;
+		info.volume = volume;
+		info.balance = balance;
+
+		Channel *chan = new Channel(this, stream, autofreeStream, reverseStereo, _resampler);
+		insertChannel(handle, chan, info);
+	}
+	applyOverflow();
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
-
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -280,64 +537,120 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
-	// mix all channels
+	// pick up the requests made since the last callback
+	{
+		Common::StackLock lock(_renderMutex);
+		processCommands();
+	}
+
+	// mix all channels. Each slot is locked separately, so that engine
+	// threads stopping a sound wait for at most that one channel instead
+	// of the whole mix.
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		Common::StackLock lock(_slotMutex[i]);
+
+		Channel *chan = _channels[i];
+		if (!chan)
+			continue;
+
+		const uint32 chanHandle = chan->getHandle()._val;
+		if (Common::atomicLoad(&_slotHandle[i]) != chanHandle) {
+			// Stopped by the engine; the queued stop command disposes of it
+			continue;
+		}
+
+		// The render job did not get to this channel in time
+		RenderBlock &block = _renderBlocks[i];
+		if (block.state == kRenderQueued)
+			renderBlock(i);
+
+		if (block.pos == block.frames && chan->isFinished()) {
+			delete chan;
+			_channels[i] = 0;
+			Common::atomicStore(&_finishedHandle[i], chanHandle);
+		} else if (!chan->isPaused()) {
+			// Use up what was rendered ahead of time, then render the
+			// remainder (or everything, without rendering ahead) directly.
+			tmp = MIN<uint>(len, block.frames - block.pos);
+			if (tmp > 0) {
+				chan->mixRendered(buf, block.data + 2 * block.pos, tmp);
+				block.pos += tmp;
 			}
+			if ((uint)tmp < len)
+				tmp += chan->mix(buf + 2 * tmp, len - tmp);
+			publishSnapshot(i, chan);
+
+			if (tmp > res)
+				res = tmp;
+
+			// Let a job prepare the next callback
+			if (_jobSystem && block.pos == block.frames)
+				queueRenderBlock(i, len);
 		}
+	}
 
 	return res;
 }
 
 void MixerImpl::stopAll() {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
+	uint32 stopped = 0;
+	{
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (isSlotActive(i) && !_channelInfo[i].permanent) {
+				queueStop(i);
+				stopped |= 1 << i;
+			}
 		}
 	}
+	applyOverflow();
+	waitForRender(stopped);
 }
 
 void MixerImpl::stopID(int id) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
+	uint32 stopped = 0;
+	{
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (isSlotActive(i) && _channelInfo[i].id == id) {
+				queueStop(i);
+				stopped |= 1 << i;
+			}
 		}
 	}
+	applyOverflow();
+	waitForRender(stopped);
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock lock(_queueMutex);
+
+		// Simply ignore stop requests for handles of sounds that already terminated
+		if (!isHandleActive(handle._val))
+			return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+		queueStop(index);
+	}
+	applyOverflow();
+	waitForRender(1 << index);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
+	{
+		Common::StackLock lock(_queueMutex);
+		_soundTypeSettings[type].mute = mute;
+
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (isSlotActive(i) && _channelInfo[i].type == type)
+				queueVolumeUpdate(i);
+		}
 	}
+	applyOverflow();
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -346,39 +659,49 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+		if (!isHandleActive(handle._val))
+			return;
 
-	_channels[index]->setVolume(volume);
+		const int index = handle._val % NUM_CHANNELS;
+		_channelInfo[index].volume = volume;
+		queueVolumeUpdate(index);
+	}
+	applyOverflow();
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_queueMutex);
+
+	if (!isHandleActive(handle._val))
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _channelInfo[handle._val % NUM_CHANNELS].volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+		if (!isHandleActive(handle._val))
+			return;
 
-	_channels[index]->setBalance(balance);
+		const int index = handle._val % NUM_CHANNELS;
+		_channelInfo[index].balance = balance;
+		queueVolumeUpdate(index);
+	}
+	applyOverflow();
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_queueMutex);
+
+	if (!isHandleActive(handle._val))
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _channelInfo[handle._val % NUM_CHANNELS].balance;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -386,81 +709,118 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Audio::Timestamp ts(0, _sampleRate);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return Timestamp(0, _sampleRate);
+	if (!isHandleActive(handle._val))
+		return ts;
+
+	// Take a consistent copy of the snapshot published by the audio thread
+	const ChannelSnapshot &snap = _snapshots[handle._val % NUM_CHANNELS];
+	ChannelSnapshot copy;
+	uint32 sequence;
+	do {
+		sequence = Common::atomicLoad(&snap.sequence);
+		copy.handle = snap.handle;
+		copy.samplesConsumed = snap.samplesConsumed;
+		copy.mixerTimeStamp = snap.mixerTimeStamp;
+		copy.pauseStartTime = snap.pauseStartTime;
+		copy.pauseTime = snap.pauseTime;
+		copy.paused = snap.paused;
+	} while ((sequence & 1) || Common::atomicLoad(&snap.sequence) != sequence);
+
+	// The audio thread has not picked up the sound yet
+	if (copy.handle != handle._val || copy.mixerTimeStamp == 0)
+		return ts;
 
-	return _channels[index]->getElapsedTime();
+	uint32 delta = 0;
+	if (copy.paused)
+		delta = copy.pauseStartTime - copy.mixerTimeStamp;
+	else
+		delta = g_system->getMillis(true) - copy.mixerTimeStamp - copy.pauseTime;
+
+	// Convert the number of samples into a time duration.
+
+	ts = ts.addFrames(copy.samplesConsumed);
+	ts = ts.addMsecs(delta);
+
+	// In theory it would seem like a good idea to limit the approximation
+	// so that it never exceeds the theoretical upper bound set by
+	// the number of decoded samples. Meanwhile, back in the real world,
+	// doing so makes the Broken Sword cutscenes noticeably jerkier. I guess
+	// the mixer isn't invoked at the regular intervals that I first imagined.
+
+	return ts;
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
+	{
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (isSlotActive(i))
+				queuePause(i, paused);
 		}
 	}
+	applyOverflow();
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
-			return;
+	{
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (isSlotActive(i) && _channelInfo[i].id == id) {
+				queuePause(i, paused);
+				break;
+			}
 		}
 	}
+	applyOverflow();
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_queueMutex);
 
-	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+		// Simply ignore (un)pause requests for sounds that already terminated
+		if (!isHandleActive(handle._val))
+			return;
 
-	_channels[index]->pause(paused);
+		queuePause(handle._val % NUM_CHANNELS, paused);
+	}
+	applyOverflow();
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (isSlotActive(i) && _channelInfo[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	Common::StackLock lock(_queueMutex);
+	if (isHandleActive(handle._val))
+		return _channelInfo[handle._val % NUM_CHANNELS].id;
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return isHandleActive(handle._val);
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (isSlotActive(i) && _channelInfo[i].type == type)
 			return true;
 	return false;
 }
@@ -474,13 +834,16 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
-	_soundTypeSettings[type].volume = volume;
+	{
+		Common::StackLock lock(_queueMutex);
+		_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (isSlotActive(i) && _channelInfo[i].type == type)
+				queueVolumeUpdate(i);
+		}
 	}
+	applyOverflow();
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -494,114 +857,38 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark --- Channel implementations ---
 #pragma mark -
 
-Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
-    : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
-      _stream(stream, autofreeStream) {
+Channel::Channel(Mixer *mixer, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, ResamplerType resampler)
+    : _pauseLevel(0), _swapVolumes(reverseStereo && stream->isStereo()), _volL(0), _volR(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+      _pauseStartTime(0), _pauseTime(0), _converter(0), _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, resampler);
 }
 
 Channel::~Channel() {
 	delete _converter;
 }
 
-void Channel::setVolume(const byte volume) {
-	_volume = volume;
-	updateChannelVolumes();
-}
-
-byte Channel::getVolume() {
-	return _volume;
-}
-
-void Channel::setBalance(const int8 balance) {
-	_balance = balance;
-	updateChannelVolumes();
-}
-
-int8 Channel::getBalance() {
-	return _balance;
-}
-
-void Channel::updateChannelVolumes() {
-	// From the channel balance/volume and the global volume, we compute
-	// the effective volume for the left and right channel. Note the
-	// slightly odd divisor: the 255 reflects the fact that the maximal
-	// value for _volume is 255, while the 127 is there because the
-	// balance value ranges from -127 to 127.  The mixer (music/sound)
-	// volume is in the range 0 - kMaxMixerVolume.
-	// Hence, the vol_l/vol_r values will be in that range, too
-
-	if (!_mixer->isSoundTypeMuted(_type)) {
-		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
-
-		if (_balance == 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = vol / Mixer::kMaxChannelVolume;
-		} else if (_balance < 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-		} else {
-			_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-			_volR = vol / Mixer::kMaxChannelVolume;
-		}
-	} else {
-		_volL = _volR = 0;
-	}
-}
-
-void Channel::pause(bool paused) {
+void Channel::pause(bool paused, uint32 timestamp) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
 	if (paused) {
 		_pauseLevel++;
 
 		if (_pauseLevel == 1)
-			_pauseStartTime = g_system->getMillis(true);
+			_pauseStartTime = timestamp;
 	} else if (_pauseLevel > 0) {
 		_pauseLevel--;
 
 		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
+			_pauseTime = (timestamp - _pauseStartTime);
 			_pauseStartTime = 0;
 		}
 	}
 }
 
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
-	uint32 delta = 0;
-
-	Audio::Timestamp ts(0, rate);
-
-	if (_mixerTimeStamp == 0)
-		return ts;
-
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
-
-	// Convert the number of samples into a time duration.
-
-	ts = ts.addFrames(_samplesConsumed);
-	ts = ts.addMsecs(delta);
-
-	// In theory it would seem like a good idea to limit the approximation
-	// so that it never exceeds the theoretical upper bound set by
-	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
-	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
-	// isn't invoked at the regular intervals that I first imagined.
-
-	return ts;
-}
-
 int Channel::mix(int16 *data, uint len) {
 	assert(_stream);
 
@@ -620,4 +907,29 @@ int Channel::mix(int16 *data, uint len) {
 	return res;
 }
 
+int Channel::render(int16 *data, uint len) {
+	assert(_stream);
+
+	if (_stream->endOfData())
+		return 0;
+
+	assert(_converter);
+	return _converter->flow(*_stream, data, len, Mixer::kMaxMixerVolume, Mixer::kMaxMixerVolume);
+}
+
+void Channel::mixRendered(int16 *data, const int16 *rendered, uint len) {
+	// The converter already stored the samples in output order, so the
+	// volumes of reversed stereo channels have to be swapped as well.
+	const MixKernel &kernel = getDefaultMixKernel();
+	if (_swapVolumes)
+		kernel.mixStereo(data, rendered, len, _volR, _volL);
+	else
+		kernel.mixStereo(data, rendered, len, _volL, _volR);
+
+	_samplesConsumed = _samplesDecoded;
+	_mixerTimeStamp = g_system->getMillis(true);
+	_pauseTime = 0;
+	_samplesDecoded += len;
+}
+
 } // End of namespace Audio
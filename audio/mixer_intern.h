@@ -24,8 +24,13 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/jobsystem.h"
 #include "common/mutex.h"
+#include "common/system.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -51,12 +56,104 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
-	Common::Mutex _mutex;
+	static const uint32 kInvalidHandle = 0xFFFFFFFF;
+
+	/**
+	 * Channel state changes requested by the engine side. These are queued
+	 * and applied by the audio thread at the start of the next callback, so
+	 * that the engine never has to wait for a whole mix to finish.
+	 */
+	enum CommandType {
+		kCommandPlay,
+		kCommandStop,
+		kCommandPause,
+		kCommandVolume
+	};
+
+	struct Command {
+		Command() : type(kCommandStop), slot(0), handle(kInvalidHandle), channel(0), paused(false), timestamp(0), volL(0), volR(0) {}
+
+		CommandType type;
+		int slot;
+		uint32 handle;
+
+		Channel *channel;	///< kCommandPlay: the channel to insert
+		bool paused;		///< kCommandPause: new pause state
+		uint32 timestamp;	///< kCommandPause: time of the request
+		int volL, volR;		///< kCommandVolume: effective channel volumes
+	};
+
+	/**
+	 * Engine side view of a channel slot. Only accessed with _queueMutex
+	 * held; the audio thread never touches it.
+	 */
+	struct ChannelInfo {
+		ChannelInfo() : id(-1), type(kPlainSoundType), permanent(false), volume(kMaxChannelVolume), balance(0) {}
+
+		int id;
+		SoundType type;
+		bool permanent;
+		byte volume;
+		int8 balance;
+	};
+
+	/**
+	 * Playback position of a channel, published by the audio thread after
+	 * each mix. Readers use the sequence counter to detect torn reads.
+	 */
+	struct ChannelSnapshot {
+		ChannelSnapshot() : sequence(0), handle(kInvalidHandle), samplesConsumed(0), mixerTimeStamp(0),
+			pauseStartTime(0), pauseTime(0), paused(false) {}
+
+		volatile uint32 sequence;
+		uint32 handle;
+		uint32 samplesConsumed;
+		uint32 mixerTimeStamp;
+		uint32 pauseStartTime;
+		uint32 pauseTime;
+		bool paused;
+	};
+
+	enum RenderState {
+		kRenderIdle,
+		kRenderQueued
+	};
+
+	/**
+	 * Output of a channel rendered at full volume ahead of time by a job,
+	 * so that the audio callback only has to apply the volume and sum it
+	 * up. Protected by the slot mutex of the channel.
+	 */
+	struct RenderBlock {
+		RenderBlock() : mixer(0), slot(0), state(kRenderIdle), data(0), capacity(0), size(0), frames(0), pos(0) {}
+
+		MixerImpl *mixer;
+		int slot;
+		volatile int32 state;
+		int16 *data;
+		uint capacity;	///< allocated size of data, in sample pairs
+		uint size;		///< number of sample pairs to render
+		uint frames;	///< number of sample pairs rendered
+		uint pos;		///< number of sample pairs already mixed
+	};
+
+	/** Serializes all engine side (producer) operations. */
+	Common::Mutex _queueMutex;
+	/** Held by whoever applies the queued commands. */
+	Common::Mutex _renderMutex;
+	/**
+	 * Held while a channel is rendered, mixed or changed by a command.
+	 * Must be acquired after _renderMutex when both are needed.
+	 */
+	Common::Mutex _slotMutex[NUM_CHANNELS];
 
 	const uint _sampleRate;
+	/** Resampler of new channels, from the "resampler" config key. */
+	ResamplerType _resampler;
 	bool _mixerReady;
 	uint32 _handleSeed;
 
@@ -68,8 +165,34 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	// Engine side state
+	ChannelInfo _channelInfo[NUM_CHANNELS];
+	/** Handle of the sound occupying each slot, as seen by the engine (kInvalidHandle if none). */
+	volatile uint32 _slotHandle[NUM_CHANNELS];
+
+	// Command queue: _queueTail is only advanced by the engine side,
+	// _queueHead only by whoever holds _renderMutex.
+	Command _queue[COMMAND_QUEUE_SIZE];
+	volatile uint32 _queueHead;
+	volatile uint32 _queueTail;
+	/**
+	 * Commands which did not fit into the queue, guarded by _queueMutex.
+	 * While there are any, all new commands go here, so they stay in order.
+	 */
+	Common::Array<Command> _overflow;
+	volatile int32 _overflowPending;
+
+	// Audio thread state
 	Channel *_channels[NUM_CHANNELS];
+	/** Handle of the last sound in each slot which ran out of data. */
+	volatile uint32 _finishedHandle[NUM_CHANNELS];
+	ChannelSnapshot _snapshots[NUM_CHANNELS];
 
+	// Rendering ahead of time, on the job system if it has worker threads
+	RenderBlock _renderBlocks[NUM_CHANNELS];
+	Common::JobSystem *_jobSystem;
+	Common::JobSystem::JobGroup _renderJobs;
 
 public:
 
@@ -119,7 +242,28 @@ public:
 	virtual uint getOutputRate() const;
 
 protected:
-	void insertChannel(SoundHandle *handle, Channel *chan);
+	void insertChannel(SoundHandle *handle, Channel *chan, const ChannelInfo &info);
+
+private:
+	bool isSlotActive(int slot) const;
+	bool isHandleActive(uint32 handle) const;
+	void computeChannelVolumes(const ChannelInfo &info, int &volL, int &volR) const;
+
+	void pushCommand(const Command &cmd);
+	void queueStop(int slot);
+	void queuePause(int slot, bool paused);
+	void queueVolumeUpdate(int slot);
+	void applyOverflow();
+	void waitForRender(uint32 slots);
+
+	void processCommands();
+	void applyCommand(const Command &cmd);
+	void publishSnapshot(int slot, const Channel *chan);
+
+	static void renderJobProc(void *param);
+	void resetRenderBlock(int slot);
+	void queueRenderBlock(int slot, uint len);
+	void renderBlock(int slot);
 
 public:
 	/**
@@ -0,0 +1,344 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/mixkernels.h"
+#include "audio/mixer.h"
+#include "common/cpudetect.h"
+
+#if defined(SCUMMVM_AVX2)
+#include <immintrin.h>
+#elif defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Audio {
+
+// The SIMD kernels divide by Mixer::kMaxMixerVolume with a shift. Like the
+// scalar code, they round towards zero, which matters for negative samples.
+enum {
+	kVolumeShift = 8,
+	kVolumeRoundBias = (1 << kVolumeShift) - 1
+};
+
+#pragma mark -
+#pragma mark --- Scalar ---
+#pragma mark -
+
+static void mixStereoScalar(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	for (; frames > 0; --frames) {
+		clampedAdd(obuf[0], (ibuf[0] * (int)volL) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (ibuf[1] * (int)volR) / Audio::Mixer::kMaxMixerVolume);
+		ibuf += 2;
+		obuf += 2;
+	}
+}
+
+static void mixMonoScalar(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	for (; frames > 0; --frames) {
+		clampedAdd(obuf[0], (*ibuf * (int)volL) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (*ibuf * (int)volR) / Audio::Mixer::kMaxMixerVolume);
+		ibuf++;
+		obuf += 2;
+	}
+}
+
+static int32 firScalar(const int16 *coeffs, const st_sample_t *samples, uint taps) {
+	int32 sum = 0;
+	for (uint i = 0; i < taps; ++i)
+		sum += coeffs[i] * samples[i];
+	return sum;
+}
+
+static const MixKernel mixKernelScalar = { "scalar", mixStereoScalar, mixMonoScalar, firScalar };
+
+// The unsigned output format is not supported by the SIMD kernels.
+#ifndef OUTPUT_UNSIGNED_AUDIO
+
+#ifdef SCUMMVM_SSE2
+
+#pragma mark -
+#pragma mark --- SSE2 ---
+#pragma mark -
+
+/** Multiplies 8 samples by the volumes in vol and divides by kMaxMixerVolume. */
+static inline __m128i scaleSSE2(__m128i samples, __m128i vol) {
+	const __m128i bias = _mm_set1_epi32(kVolumeRoundBias);
+	const __m128i lo = _mm_mullo_epi16(samples, vol);
+	const __m128i hi = _mm_mulhi_epi16(samples, vol);
+
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), kVolumeShift);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), kVolumeShift);
+
+	// The results always fit, so the saturation never kicks in here
+	return _mm_packs_epi32(p0, p1);
+}
+
+static void mixStereoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = _mm_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL);
+
+	for (; frames >= 4; frames -= 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+		const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, scaleSSE2(in, vol)));
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	mixStereoScalar(obuf, ibuf, frames, volL, volR);
+}
+
+static void mixMonoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = _mm_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL);
+
+	for (; frames >= 8; frames -= 8) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+		const __m128i out0 = _mm_loadu_si128((const __m128i *)obuf);
+		const __m128i out1 = _mm_loadu_si128((const __m128i *)(obuf + 8));
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out0, scaleSSE2(_mm_unpacklo_epi16(in, in), vol)));
+		_mm_storeu_si128((__m128i *)(obuf + 8), _mm_adds_epi16(out1, scaleSSE2(_mm_unpackhi_epi16(in, in), vol)));
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	mixMonoScalar(obuf, ibuf, frames, volL, volR);
+}
+
+static int32 firSSE2(const int16 *coeffs, const st_sample_t *samples, uint taps) {
+	__m128i sum = _mm_setzero_si128();
+	for (uint i = 0; i < taps; i += 8) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)(coeffs + i));
+		const __m128i s = _mm_loadu_si128((const __m128i *)(samples + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(c, s));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+static const MixKernel mixKernelSSE2 = { "sse2", mixStereoSSE2, mixMonoSSE2, firSSE2 };
+
+#endif // SCUMMVM_SSE2
+
+#ifdef SCUMMVM_AVX2
+
+#pragma mark -
+#pragma mark --- AVX2 ---
+#pragma mark -
+
+// Unpacking and packing both work per 128 bit lane, so the sample order
+// is preserved without any extra permutes.
+SCUMMVM_TARGET_AVX2
+static inline __m256i scaleAVX2(__m256i samples, __m256i vol) {
+	const __m256i bias = _mm256_set1_epi32(kVolumeRoundBias);
+	const __m256i lo = _mm256_mullo_epi16(samples, vol);
+	const __m256i hi = _mm256_mulhi_epi16(samples, vol);
+
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), bias)), kVolumeShift);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), bias)), kVolumeShift);
+
+	return _mm256_packs_epi32(p0, p1);
+}
+
+SCUMMVM_TARGET_AVX2
+static void mixStereoAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	const __m256i vol = _mm256_set1_epi32((int32)((uint32)volL | ((uint32)volR << 16)));
+
+	for (; frames >= 8; frames -= 8) {
+		const __m256i in = _mm256_loadu_si256((const __m256i *)ibuf);
+		const __m256i out = _mm256_loadu_si256((const __m256i *)obuf);
+		_mm256_storeu_si256((__m256i *)obuf, _mm256_adds_epi16(out, scaleAVX2(in, vol)));
+		ibuf += 16;
+		obuf += 16;
+	}
+
+	mixStereoSSE2(obuf, ibuf, frames, volL, volR);
+}
+
+SCUMMVM_TARGET_AVX2
+static void mixMonoAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	const __m256i vol = _mm256_set1_epi32((int32)((uint32)volL | ((uint32)volR << 16)));
+
+	for (; frames >= 16; frames -= 16) {
+		// Reorder the 64 bit quarters, so that unpacking the lanes yields
+		// frames 0-7 and 8-15 in order.
+		const __m256i in = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i *)ibuf), 0xD8);
+		const __m256i out0 = _mm256_loadu_si256((const __m256i *)obuf);
+		const __m256i out1 = _mm256_loadu_si256((const __m256i *)(obuf + 16));
+		_mm256_storeu_si256((__m256i *)obuf, _mm256_adds_epi16(out0, scaleAVX2(_mm256_unpacklo_epi16(in, in), vol)));
+		_mm256_storeu_si256((__m256i *)(obuf + 16), _mm256_adds_epi16(out1, scaleAVX2(_mm256_unpackhi_epi16(in, in), vol)));
+		ibuf += 16;
+		obuf += 32;
+	}
+
+	mixMonoSSE2(obuf, ibuf, frames, volL, volR);
+}
+
+SCUMMVM_TARGET_AVX2
+static int32 firAVX2(const int16 *coeffs, const st_sample_t *samples, uint taps) {
+	__m256i sum = _mm256_setzero_si256();
+	uint i = 0;
+	for (; i + 16 <= taps; i += 16) {
+		const __m256i c = _mm256_loadu_si256((const __m256i *)(coeffs + i));
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(samples + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(c, s));
+	}
+
+	__m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	if (i < taps) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)(coeffs + i));
+		const __m128i s = _mm_loadu_si128((const __m128i *)(samples + i));
+		sum128 = _mm_add_epi32(sum128, _mm_madd_epi16(c, s));
+	}
+
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum128);
+}
+
+static const MixKernel mixKernelAVX2 = { "avx2", mixStereoAVX2, mixMonoAVX2, firAVX2 };
+
+#endif // SCUMMVM_AVX2
+
+#ifdef SCUMMVM_NEON
+
+#pragma mark -
+#pragma mark --- NEON ---
+#pragma mark -
+
+static inline int32x4_t divideNEON(int32x4_t p) {
+	const int32x4_t bias = vdupq_n_s32(kVolumeRoundBias);
+	return vshrq_n_s32(vaddq_s32(p, vandq_s32(vshrq_n_s32(p, 31), bias)), kVolumeShift);
+}
+
+static inline int16x8_t scaleNEON(int16x8_t samples, int16x4_t vol) {
+	const int32x4_t p0 = divideNEON(vmull_s16(vget_low_s16(samples), vol));
+	const int32x4_t p1 = divideNEON(vmull_s16(vget_high_s16(samples), vol));
+	return vcombine_s16(vmovn_s32(p0), vmovn_s32(p1));
+}
+
+static void mixStereoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	const int16 volArray[4] = { (int16)volL, (int16)volR, (int16)volL, (int16)volR };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	for (; frames >= 4; frames -= 4) {
+		const int16x8_t in = vld1q_s16(ibuf);
+		const int16x8_t out = vld1q_s16(obuf);
+		vst1q_s16(obuf, vqaddq_s16(out, scaleNEON(in, vol)));
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	mixStereoScalar(obuf, ibuf, frames, volL, volR);
+}
+
+static void mixMonoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	const int16 volArray[4] = { (int16)volL, (int16)volR, (int16)volL, (int16)volR };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	for (; frames >= 8; frames -= 8) {
+		const int16x8_t in = vld1q_s16(ibuf);
+		const int16x8x2_t dup = vzipq_s16(in, in);
+		const int16x8_t out0 = vld1q_s16(obuf);
+		const int16x8_t out1 = vld1q_s16(obuf + 8);
+		vst1q_s16(obuf, vqaddq_s16(out0, scaleNEON(dup.val[0], vol)));
+		vst1q_s16(obuf + 8, vqaddq_s16(out1, scaleNEON(dup.val[1], vol)));
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	mixMonoScalar(obuf, ibuf, frames, volL, volR);
+}
+
+static int32 firNEON(const int16 *coeffs, const st_sample_t *samples, uint taps) {
+	int32x4_t sum = vdupq_n_s32(0);
+	for (uint i = 0; i < taps; i += 8) {
+		const int16x8_t c = vld1q_s16(coeffs + i);
+		const int16x8_t s = vld1q_s16(samples + i);
+		sum = vmlal_s16(sum, vget_low_s16(c), vget_low_s16(s));
+		sum = vmlal_s16(sum, vget_high_s16(c), vget_high_s16(s));
+	}
+
+	const int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(half, half), 0);
+}
+
+static const MixKernel mixKernelNEON = { "neon", mixStereoNEON, mixMonoNEON, firNEON };
+
+#endif // SCUMMVM_NEON
+
+#endif // !OUTPUT_UNSIGNED_AUDIO
+
+#pragma mark -
+
+const MixKernel *getMixKernel(MixKernelType type) {
+	switch (type) {
+	case kMixKernelScalar:
+		return &mixKernelScalar;
+
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_SSE2
+	case kMixKernelSSE2:
+		return Common::hasCPUFeature(Common::kCPUFeatureSSE2) ? &mixKernelSSE2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_AVX2
+	case kMixKernelAVX2:
+		return Common::hasCPUFeature(Common::kCPUFeatureAVX2) ? &mixKernelAVX2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_NEON
+	case kMixKernelNEON:
+		return Common::hasCPUFeature(Common::kCPUFeatureNEON) ? &mixKernelNEON : nullptr;
+#endif
+#endif
+
+	default:
+		return nullptr;
+	}
+}
+
+const MixKernel &getDefaultMixKernel() {
+	static const MixKernel *defaultKernel = nullptr;
+
+	if (!defaultKernel) {
+		const MixKernel *kernel = &mixKernelScalar;
+		for (int i = kMixKernelScalar + 1; i < kMixKernelCount; ++i) {
+			const MixKernel *candidate = getMixKernel((MixKernelType)i);
+			if (candidate)
+				kernel = candidate;
+		}
+		defaultKernel = kernel;
+	}
+
+	return *defaultKernel;
+}
+
+} // End of namespace Audio
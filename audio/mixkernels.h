@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_MIXKERNELS_H
+#define AUDIO_MIXKERNELS_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Adds a block of interleaved stereo samples to the output buffer, scaling
+ * the left and right channel by volL resp. volR (in the range 0 to
+ * Mixer::kMaxMixerVolume) and clamping the result to the sample range.
+ *
+ * @param obuf   output buffer, interleaved stereo
+ * @param ibuf   input buffer, interleaved stereo
+ * @param frames number of sample pairs to mix
+ */
+typedef void (*MixStereoProc)(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR);
+
+/**
+ * Same as MixStereoProc, but for mono input which is mixed into both
+ * output channels.
+ */
+typedef void (*MixMonoProc)(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t volL, st_volume_t volR);
+
+/**
+ * Computes the dot product of a FIR filter with a block of samples, as used
+ * by the polyphase resampler. The coefficients must be small enough (e.g.
+ * Q14) that the result fits into 32 bits.
+ *
+ * @param coeffs  filter coefficients
+ * @param samples input samples
+ * @param taps    number of taps, a multiple of 8
+ */
+typedef int32 (*FIRProc)(const int16 *coeffs, const st_sample_t *samples, uint taps);
+
+/**
+ * A set of mixing routines for one instruction set. All kernels produce
+ * exactly the same output as the scalar one.
+ */
+struct MixKernel {
+	const char *name;
+	MixStereoProc mixStereo;
+	MixMonoProc mixMono;
+	FIRProc fir;
+};
+
+enum MixKernelType {
+	kMixKernelScalar = 0,
+	kMixKernelSSE2,
+	kMixKernelAVX2,
+	kMixKernelNEON,
+
+	kMixKernelCount
+};
+
+/**
+ * Returns the kernel of the given type, or nullptr if it is not available
+ * in this build or not supported by the host CPU.
+ */
+const MixKernel *getMixKernel(MixKernelType type);
+
+/**
+ * Returns the fastest kernel available on the host.
+ */
+const MixKernel &getDefaultMixKernel();
+
+} // End of namespace Audio
+
+#endif
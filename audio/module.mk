@@ -13,6 +13,7 @@ MODULE_OBJS := \
 	miles_adlib.o \
 	miles_mt32.o \
 	mixer.o \
+	mixkernels.o \
 	mpu401.o \
 	musicplugin.o \
 	null.o \
@@ -31,7 +31,12 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "audio/mixkernels.h"
+#include "common/algorithm.h"
+#include "common/atomic.h"
 #include "common/frac.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -57,6 +62,74 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * Base class for the rate converters. The converted samples are collected in
+ * an intermediate buffer, which is then mixed into the output buffer with
+ * the fastest mixing kernel available on the host.
+ */
+template<bool stereo, bool reverseStereo>
+class MixingRateConverter : public RateConverter {
+protected:
+	const MixKernel &_kernel;
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	MixingRateConverter() : _kernel(getDefaultMixKernel()) {}
+
+	/**
+	 * Converts up to 'frames' sample pairs into outBuf.
+	 * @return number of frames converted, less than requested at the end of the input
+	 */
+	virtual st_size_t convert(AudioStream &input, st_size_t frames) { return 0; }
+
+	/** Appends a frame to the intermediate buffer, in output channel order. */
+	static inline void storeFrame(st_sample_t *&ptr, st_sample_t out0, st_sample_t out1) {
+		if (stereo) {
+			ptr[0] = reverseStereo ? out1 : out0;
+			ptr[1] = reverseStereo ? out0 : out1;
+			ptr += 2;
+		} else {
+			*ptr++ = out0;
+		}
+	}
+
+	/** Mixes frames stored in output channel order into obuf. */
+	void mixFrames(st_sample_t *obuf, const st_sample_t *buf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+		if (!stereo)
+			_kernel.mixMono(obuf, buf, frames, vol_l, vol_r);
+		else if (reverseStereo)
+			_kernel.mixStereo(obuf, buf, frames, vol_r, vol_l);
+		else
+			_kernel.mixStereo(obuf, buf, frames, vol_l, vol_r);
+	}
+
+public:
+	/*
+	 * Processed signed long samples from ibuf to obuf.
+	 * Return number of sample pairs processed.
+	 */
+	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		const st_size_t maxFrames = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+		st_size_t done = 0;
+
+		while (done < osamp) {
+			const st_size_t frames = MIN<st_size_t>(osamp - done, maxFrames);
+			const st_size_t converted = convert(input, frames);
+
+			mixFrames(obuf + done * 2, outBuf, converted, vol_l, vol_r);
+			done += converted;
+
+			if (converted < frames)
+				break;
+		}
+
+		return done;
+	}
+
+	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -64,7 +137,7 @@ enum {
  * Limited to sampling frequency <= 65535 Hz.
  */
 template<bool stereo, bool reverseStereo>
-class SimpleRateConverter : public RateConverter {
+class SimpleRateConverter : public MixingRateConverter<stereo, reverseStereo> {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
@@ -77,12 +150,10 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	st_size_t convert(AudioStream &input, st_size_t frames);
+
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
-	}
 };
 
 
@@ -108,17 +179,14 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
 }
 
 /*
- * Processed signed long samples from ibuf to obuf.
- * Return number of sample pairs processed.
+ * Convert samples from the input stream into the intermediate buffer.
+ * Return number of sample pairs converted.
  */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
+st_size_t SimpleRateConverter<stereo, reverseStereo>::convert(AudioStream &input, st_size_t frames) {
+	st_sample_t *outPtr = this->outBuf;
 
-	ostart = obuf;
-	oend = obuf + osamp * 2;
-
-	while (obuf < oend) {
+	for (st_size_t done = 0; done < frames; ++done) {
 
 		// read enough input samples so that opos >= 0
 		do {
@@ -127,7 +195,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
 				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+					return done;
 			}
 			inLen -= (stereo ? 2 : 1);
 			opos--;
@@ -143,15 +211,9 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		// Increment output position
 		opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-		obuf += 2;
+		this->storeFrame(outPtr, out0, out1);
 	}
-	return (obuf - ostart) / 2;
+	return frames;
 }
 
 /**
@@ -166,7 +228,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  */
 
 template<bool stereo, bool reverseStereo>
-class LinearRateConverter : public RateConverter {
+class LinearRateConverter : public MixingRateConverter<stereo, reverseStereo> {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
@@ -183,12 +245,10 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	st_size_t convert(AudioStream &input, st_size_t frames);
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
-	}
 };
 
 
@@ -217,17 +277,15 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
 }
 
 /*
- * Processed signed long samples from ibuf to obuf.
- * Return number of sample pairs processed.
+ * Convert samples from the input stream into the intermediate buffer.
+ * Return number of sample pairs converted.
  */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
-
-	ostart = obuf;
-	oend = obuf + osamp * 2;
+st_size_t LinearRateConverter<stereo, reverseStereo>::convert(AudioStream &input, st_size_t frames) {
+	st_sample_t *outPtr = this->outBuf;
+	st_size_t done = 0;
 
-	while (obuf < oend) {
+	while (done < frames) {
 
 		// read enough input samples so that opos < 0
 		while ((frac_t)FRAC_ONE_LOW <= opos) {
@@ -236,7 +294,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
 				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+					return done;
 			}
 			inLen -= (stereo ? 2 : 1);
 			ilast0 = icur0;
@@ -250,7 +308,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 
 		// Loop as long as the outpos trails behind, and as long as there is
 		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
+		while (opos < (frac_t)FRAC_ONE_LOW && done < frames) {
 			// interpolate
 			st_sample_t out0, out1;
 			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
@@ -258,19 +316,343 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
 						  out0);
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
+			this->storeFrame(outPtr, out0, out1);
+			++done;
 
 			// Increment output position
 			opos += opos_inc;
 		}
 	}
-	return (obuf - ostart) / 2;
+	return done;
+}
+
+
+#pragma mark -
+
+
+/**
+ * Coefficients of a windowed sinc lowpass filter, split into phases for a
+ * polyphase implementation. Banks only depend on the ratio between input
+ * and output rate, and are shared by all converters using that ratio.
+ */
+struct SincFilterBank {
+	/** Conversion ratio: 'interpolation' output frames for every 'decimation' input frames. */
+	uint32 interpolation, decimation;
+	/** Number of taps of each phase, a multiple of 8. */
+	uint taps;
+	/** Number of phases; less than 'interpolation' for complicated ratios. */
+	uint phases;
+	/**
+	 * taps * (phases + 1) coefficients in Q14 format. The extra phase lies
+	 * one input sample after the first one, for rounding to the nearest
+	 * phase when there are less phases than 'interpolation'.
+	 */
+	int16 *coeffs;
+
+	SincFilterBank *next;
+};
+
+enum {
+	/** Filter length when upsampling. Downsampling needs proportionally longer filters. */
+	SINC_BASE_TAPS = 32,
+	SINC_MAX_TAPS = 128,
+	/**
+	 * Maximum number of phases, which covers the common ratios like 11025
+	 * or 22050 to 48000 Hz exactly. Other ratios use the nearest phase.
+	 */
+	SINC_MAX_PHASES = 1024,
+	SINC_COEFF_BITS = 14
+};
+
+/**
+ * Zeroth order modified Bessel function of the first kind, used by the
+ * Kaiser window.
+ */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+static void computeSincFilterBank(SincFilterBank &bank) {
+	// Keep the passband slightly below the Nyquist frequency of the lower
+	// of the two rates, so that the transition band does not alias.
+	const double rolloff = 0.94;
+	const double beta = 8.0;
+	const double cutoff = rolloff * MIN<double>(1.0, (double)bank.interpolation / bank.decimation);
+	const double halfLength = bank.taps / 2;
+	const double windowNorm = besselI0(beta);
+
+	double *h = new double[bank.taps];
+
+	for (uint phase = 0; phase <= bank.phases; ++phase) {
+		// Tap (taps / 2 - 1) is the input sample at or right before the
+		// output position, which lies 'phase / phases' samples after it.
+		const double offset = (double)phase / bank.phases;
+		double sum = 0.0;
+
+		for (uint tap = 0; tap < bank.taps; ++tap) {
+			const double x = (double)tap - (bank.taps / 2 - 1) - offset;
+			const double t = x / halfLength;
+			double value = 0.0;
+
+			if (t > -1.0 && t < 1.0) {
+				const double sinc = (x == 0.0) ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+				value = cutoff * sinc * besselI0(beta * sqrt(1.0 - t * t)) / windowNorm;
+			}
+
+			h[tap] = value;
+			sum += value;
+		}
+
+		// Normalize to unity gain, and give the rounding error to the
+		// largest coefficient so that DC passes unchanged.
+		int16 *coeffs = bank.coeffs + phase * bank.taps;
+		int total = 0;
+		uint largest = 0;
+		for (uint tap = 0; tap < bank.taps; ++tap) {
+			coeffs[tap] = (int16)floor(h[tap] / sum * (1 << SINC_COEFF_BITS) + 0.5);
+			total += coeffs[tap];
+			if (ABS(coeffs[tap]) > ABS(coeffs[largest]))
+				largest = tap;
+		}
+		coeffs[largest] += (1 << SINC_COEFF_BITS) - total;
+	}
+
+	delete[] h;
+}
+
+/**
+ * Filter banks for all conversion ratios used so far. Computing a bank takes
+ * a while, so they are kept until freeSincFilterBanks() is called instead of
+ * being recomputed for every sound.
+ */
+class SincFilterBankCache : public Common::Singleton<SincFilterBankCache> {
+public:
+	~SincFilterBankCache();
+
+	/**
+	 * Returns the filter bank for the given rates, computing it if it does
+	 * not exist yet.
+	 */
+	const SincFilterBank *get(st_rate_t inrate, st_rate_t outrate);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	SincFilterBankCache() : _banks(nullptr) {}
+
+	SincFilterBank *find(uint32 interpolation, uint32 decimation) const;
+
+	Common::Mutex _mutex;
+	SincFilterBank *_banks;
+};
+
+SincFilterBankCache::~SincFilterBankCache() {
+	while (_banks) {
+		SincFilterBank *bank = _banks;
+		_banks = bank->next;
+		delete[] bank->coeffs;
+		delete bank;
+	}
+}
+
+SincFilterBank *SincFilterBankCache::find(uint32 interpolation, uint32 decimation) const {
+	for (SincFilterBank *bank = _banks; bank; bank = bank->next) {
+		if (bank->interpolation == interpolation && bank->decimation == decimation)
+			return bank;
+	}
+	return nullptr;
+}
+
+const SincFilterBank *SincFilterBankCache::get(st_rate_t inrate, st_rate_t outrate) {
+	const st_rate_t divisor = Common::gcd(inrate, outrate);
+	const uint32 interpolation = outrate / divisor;
+	const uint32 decimation = inrate / divisor;
+
+	{
+		Common::StackLock lock(_mutex);
+		const SincFilterBank *bank = find(interpolation, decimation);
+		if (bank)
+			return bank;
+	}
+
+	// Compute the bank without holding the lock, so that the audio thread
+	// never waits for it
+	SincFilterBank *bank = new SincFilterBank();
+	bank->interpolation = interpolation;
+	bank->decimation = decimation;
+
+	uint taps = SINC_BASE_TAPS;
+	if (decimation > interpolation)
+		taps = MIN<uint>((SINC_BASE_TAPS * decimation / interpolation + 7) & ~7, SINC_MAX_TAPS);
+	bank->taps = taps;
+	bank->phases = MIN<uint32>(interpolation, SINC_MAX_PHASES);
+	bank->coeffs = new int16[bank->taps * (bank->phases + 1)];
+	computeSincFilterBank(*bank);
+
+	Common::StackLock lock(_mutex);
+
+	// Another thread may have computed the same bank in the meantime
+	SincFilterBank *existing = find(interpolation, decimation);
+	if (existing) {
+		delete[] bank->coeffs;
+		delete bank;
+		return existing;
+	}
+
+	bank->next = _banks;
+	_banks = bank;
+	return bank;
+}
+
+/**
+ * Audio rate converter based on a windowed sinc interpolation filter,
+ * implemented as a polyphase FIR filter with precomputed coefficients.
+ *
+ * Unlike the other converters, this one properly band-limits the signal,
+ * which avoids the aliasing audible when upsampling low rate sounds.
+ *
+ * Limited to sampling frequency < 131072 Hz.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public MixingRateConverter<stereo, reverseStereo> {
+protected:
+	enum {
+		HISTORY_SIZE = SINC_MAX_TAPS + INTERMEDIATE_BUFFER_SIZE
+	};
+
+	const SincFilterBank *_bank;
+
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** Input samples for each channel, the filter for the next output frame starts at histPos. */
+	st_sample_t hist[stereo ? 2 : 1][HISTORY_SIZE];
+	uint histPos;
+	uint histLen;
+	/** Number of input frames to drop before appending to the history. */
+	uint histSkip;
+
+	/** Fractional part of the output position, in 1/interpolation input samples. */
+	uint32 phase;
+	/** Output position increment, split into integer and fractional part. */
+	uint32 stepInt, stepFrac;
+
+	bool refill(AudioStream &input);
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate);
+
+	st_size_t convert(AudioStream &input, st_size_t frames);
+};
+
+/*
+ * Prepare processing.
+ */
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	if (inrate >= 131072 || outrate >= 131072) {
+		error("rate effect can only handle rates < 131072");
+	}
+
+	_bank = SincFilterBankCache::instance().get(inrate, outrate);
+
+	stepInt = _bank->decimation / _bank->interpolation;
+	stepFrac = _bank->decimation % _bank->interpolation;
+	phase = 0;
+
+	// Start with silence before the first input sample, so that the first
+	// output frame is centered on it.
+	histPos = 0;
+	histLen = _bank->taps / 2 - 1;
+	histSkip = 0;
+	memset(hist, 0, sizeof(hist));
+}
+
+/*
+ * Append the next block of input samples to the history.
+ * Return false at the end of the input.
+ */
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	// Drop the samples which are no longer needed. When downsampling, the
+	// output position may even have moved past the end of the history.
+	if (histPos >= histLen) {
+		histSkip += histPos - histLen;
+		histPos = histLen = 0;
+	} else if (histLen + INTERMEDIATE_BUFFER_SIZE / (stereo ? 2 : 1) > HISTORY_SIZE) {
+		for (int ch = 0; ch < (stereo ? 2 : 1); ++ch)
+			memmove(hist[ch], hist[ch] + histPos, (histLen - histPos) * sizeof(st_sample_t));
+		histLen -= histPos;
+		histPos = 0;
+	}
+
+	const int len = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+	if (len <= 0)
+		return false;
+
+	const st_sample_t *inPtr = inBuf;
+	for (int i = 0; i < len; i += (stereo ? 2 : 1)) {
+		if (histSkip) {
+			histSkip--;
+			inPtr += (stereo ? 2 : 1);
+			continue;
+		}
+
+		hist[0][histLen] = *inPtr++;
+		if (stereo)
+			hist[stereo ? 1 : 0][histLen] = *inPtr++;
+		histLen++;
+	}
+
+	return true;
+}
+
+/*
+ * Convert samples from the input stream into the intermediate buffer.
+ * Return number of sample pairs converted.
+ */
+template<bool stereo, bool reverseStereo>
+st_size_t SincRateConverter<stereo, reverseStereo>::convert(AudioStream &input, st_size_t frames) {
+	const FIRProc fir = this->_kernel.fir;
+	const uint taps = _bank->taps;
+	const bool exactPhases = (_bank->phases == _bank->interpolation);
+	st_sample_t *outPtr = this->outBuf;
+
+	for (st_size_t done = 0; done < frames; ++done) {
+		// Make sure all input samples covered by the filter are available
+		while (histPos + taps > histLen) {
+			if (!refill(input))
+				return done;
+		}
+
+		// Round to the nearest phase, which may be the extra one at the end
+		const uint32 phaseIndex = exactPhases ? phase : (phase * _bank->phases + _bank->interpolation / 2) / _bank->interpolation;
+		const int16 *coeffs = _bank->coeffs + phaseIndex * taps;
+
+		const int32 acc0 = fir(coeffs, hist[0] + histPos, taps);
+		const st_sample_t out0 = (st_sample_t)CLIP<int32>((acc0 + (1 << (SINC_COEFF_BITS - 1))) >> SINC_COEFF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		st_sample_t out1 = out0;
+		if (stereo) {
+			const int32 acc1 = fir(coeffs, hist[stereo ? 1 : 0] + histPos, taps);
+			out1 = (st_sample_t)CLIP<int32>((acc1 + (1 << (SINC_COEFF_BITS - 1))) >> SINC_COEFF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		}
+
+		this->storeFrame(outPtr, out0, out1);
+
+		// Increment output position
+		histPos += stepInt;
+		phase += stepFrac;
+		if (phase >= _bank->interpolation) {
+			phase -= _bank->interpolation;
+			histPos++;
+		}
+	}
+	return frames;
 }
 
 
@@ -281,7 +663,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  * Simple audio rate converter for the case that the inrate equals the outrate.
  */
 template<bool stereo, bool reverseStereo>
-class CopyRateConverter : public RateConverter {
+class CopyRateConverter : public MixingRateConverter<stereo, reverseStereo> {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
 public:
@@ -293,11 +675,6 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
-		st_size_t len;
-
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -312,28 +689,20 @@ public:
 			error("[CopyRateConverter::flow] Cannot allocate memory for temp buffer");
 
 		// Read up to 'osamp' samples into our temporary buffer
-		len = input.readBuffer(_buffer, osamp);
-
-		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
+		const int len = input.readBuffer(_buffer, osamp);
+		if (len <= 0)
+			return 0;
+		const st_size_t frames = (stereo ? len / 2 : len);
+
+		// Bring the channels into output order
+		if (reverseStereo) {
+			for (st_size_t i = 0; i < frames; ++i)
+				SWAP(_buffer[2 * i], _buffer[2 * i + 1]);
 		}
-		return (obuf - ostart) / 2;
-	}
 
-	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
+		// Mix the data into the output buffer
+		this->mixFrames(obuf, _buffer, frames, vol_l, vol_r);
+		return frames;
 	}
 };
 
@@ -341,9 +710,11 @@ public:
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, ResamplerType resampler) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (resampler == kResamplerSinc) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -356,14 +727,26 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, ResamplerType resampler) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, resampler);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, resampler);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, resampler);
+}
+
+void initSincFilterBanks() {
+	SincFilterBankCache::instance();
+}
+
+void freeSincFilterBanks() {
+	SincFilterBankCache::destroy();
 }
 
 } // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::SincFilterBankCache);
+}
@@ -78,7 +78,32 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+/**
+ * Available interpolation methods for rate conversion.
+ */
+enum ResamplerType {
+	/** Nearest neighbour for integer ratio downsampling, linear interpolation otherwise */
+	kResamplerLinear,
+	/** Band-limited polyphase FIR filter, higher quality at a higher CPU cost */
+	kResamplerSinc
+};
+
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, ResamplerType resampler = kResamplerLinear);
+
+/**
+ * Sets up the cache of the filter banks used by the sinc resampler. This is
+ * done on the first use as well, but has to happen on the main thread if
+ * rate converters may be created on other threads. The mixer takes care of
+ * this.
+ */
+void initSincFilterBanks();
+
+/**
+ * Frees the filter banks used by the sinc resampler, which are otherwise
+ * kept for all conversion ratios used so far. No sinc rate converter may be
+ * left when calling this.
+ */
+void freeSincFilterBanks();
 
 } // End of namespace Audio
 
@@ -447,7 +447,8 @@ public:
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, ResamplerType resampler) {
+	// The ARM converters only interpolate linearly
 	if (inrate != outrate) {
 		if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			if (stereo) {
@@ -477,4 +478,10 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stere
 	}
 }
 
+void initSincFilterBanks() {
+}
+
+void freeSincFilterBanks() {
+}
+
 } // End of namespace Audio
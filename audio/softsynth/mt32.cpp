@@ -102,7 +102,31 @@ class MidiChannel_MT32 : public MidiChannel_MPU401 {
 	void chorusLevel(byte value) { }
 };
 
+class MidiDriver_MT32;
+
+/**
+ * Renders the MT-32 emulation without running any of the timer callbacks.
+ * This is what the render-ahead thread reads from, so that only the synth
+ * itself, and no engine code, runs off the mixer thread.
+ */
+class MT32RenderStream : public Audio::AudioStream {
+public:
+	MT32RenderStream(MidiDriver_MT32 *driver) : _renderedSamples(0), _renderMillis(0), _driver(driver) {}
+
+	int readBuffer(int16 *data, const int numSamples) override;
+	bool isStereo() const override { return true; }
+	int getRate() const override;
+	bool endOfData() const override { return false; }
+
+	uint32 _renderedSamples;
+	uint32 _renderMillis;
+
+private:
+	MidiDriver_MT32 *_driver;
+};
+
 class MidiDriver_MT32 : public MidiDriver_Emulated {
+	friend class MT32RenderStream;
 private:
 	MidiChannel_MT32 _midiChannels[16];
 	uint16 _channelMask;
@@ -113,6 +137,15 @@ private:
 
 	int _outputRate;
 
+	/**
+	 * Renders the synth ahead of time on a separate thread, if enabled
+	 * through the mt32_render_ahead setting.
+	 */
+	MT32RenderStream *_renderStream;
+	Audio::PrefetchingAudioStream *_renderAhead;
+
+	void renderSamples(int16 *buf, int len);
+
 protected:
 	void generateSamples(int16 *buf, int len);
 
@@ -150,6 +183,8 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_outputRate = 0;
 	_controlData = nullptr;
 	_pcmData = nullptr;
+	_renderStream = nullptr;
+	_renderAhead = nullptr;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -221,6 +256,18 @@ int MidiDriver_MT32::open() {
 
 	MidiDriver_Emulated::open();
 
+	// Rendering ahead of time keeps the expensive LA32 and reverb emulation
+	// out of the mixer callback. Only the synth runs on the worker threads:
+	// the driver itself is still played by the mixer, so the timer callbacks
+	// (i.e. the engine music code) keep running on the mixer thread. The
+	// messages they send take effect at the render position, i.e. they are
+	// delayed by up to the buffer length.
+	const int renderAhead = ConfMan.getInt("mt32_render_ahead");
+	if (renderAhead > 0) {
+		_renderStream = new MT32RenderStream(this);
+		_renderAhead = Audio::makePrefetchingAudioStream(_renderStream, CLIP(renderAhead, 20, 1000), DisposeAfterUse::NO);
+	}
+
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
 	return 0;
@@ -274,6 +321,19 @@ void MidiDriver_MT32::close() {
 	// Detach the mixer callback handler
 	_mixer->stopHandle(_mixerSoundHandle);
 
+	if (_renderAhead) {
+		debug(1, "MT-32 render-ahead: %u ms latency, rendered %u ms in %u ms, %u underruns",
+		      _renderAhead->getBufferSize() / 2 * 1000 / _outputRate,
+		      (uint32)((uint64)_renderStream->_renderedSamples / 2 * 1000 / _outputRate), _renderStream->_renderMillis,
+		      _renderAhead->getUnderruns());
+
+		// This waits for the job rendering ahead
+		delete _renderAhead;
+		_renderAhead = nullptr;
+		delete _renderStream;
+		_renderStream = nullptr;
+	}
+
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
 	_service.freeContext();
@@ -283,11 +343,31 @@ void MidiDriver_MT32::close() {
 	_pcmData = nullptr;
 }
 
-void MidiDriver_MT32::generateSamples(int16 *data, int len) {
+int MT32RenderStream::readBuffer(int16 *data, const int numSamples) {
+	const uint32 start = g_system->getMillis();
+	_driver->renderSamples(data, numSamples / 2);
+
+	_renderMillis += g_system->getMillis() - start;
+	_renderedSamples += numSamples;
+	return numSamples;
+}
+
+int MT32RenderStream::getRate() const {
+	return _driver->getRate();
+}
+
+void MidiDriver_MT32::renderSamples(int16 *data, int len) {
 	Common::StackLock lock(_mutex);
 	_service.renderBit16s(data, len);
 }
 
+void MidiDriver_MT32::generateSamples(int16 *data, int len) {
+	if (_renderAhead)
+		_renderAhead->readBuffer(data, len * 2);
+	else
+		renderSamples(data, len);
+}
+
 uint32 MidiDriver_MT32::property(int prop, uint32 param) {
 	switch (prop) {
 	case PROP_CHANNEL_MASK:
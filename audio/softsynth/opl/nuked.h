@@ -167,16 +167,17 @@ public:
 	~OPL();
 
 	bool init();
-	void reset();
-
-	void write(int a, int v);
-	byte read(int a);
-
-	void writeReg(int r, int v);
 
 	bool isStereo() const { return true; }
 
 protected:
+	void resetChip();
+
+	void writePort(int a, int v);
+	byte readPort(int a);
+
+	void writeRegister(int r, int v);
+
 	void generateSamples(int16 *buffer, int length);
 };
 
@@ -173,6 +173,15 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns the time the object referred by this path was last modified,
+	 * in seconds. Only differences between two values are meaningful.
+	 *
+	 * @param size	if not null and the modification time is available, set
+	 *              to the lower 32 bits of the size of the file
+	 * @return the modification time, or 0 if it is not available.
+	 */
+	virtual uint32 getModificationTime(uint32 *size) const { return 0; }
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -183,6 +192,16 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream on a memory mapping of the file referred
+	 * by this node. Its readStream() and createView() share the mapping
+	 * instead of copying data out of it.
+	 *
+	 * @return pointer to the stream object, 0 if the file can not be mapped
+	 *         or the backend does not support memory mapping
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return nullptr; }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
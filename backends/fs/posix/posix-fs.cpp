@@ -35,6 +35,7 @@
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
 #include "common/algorithm.h"
+#include "common/memstream.h"
 
 #include <sys/param.h>
 #include <sys/stat.h>
@@ -52,6 +53,12 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+// Console ports build this file without a usable mmap()
+#if defined(POSIX) && !defined(PSP2) && !defined(PLAYSTATION3) && !defined(NINTENDO_SWITCH) && !defined(__OS2__)
+#define POSIX_FS_USE_MMAP
+#include <sys/mman.h>
+#endif
+
 #ifdef __OS2__
 #define INCL_DOS
 #include <os2.h>
@@ -73,6 +80,16 @@ bool POSIXFilesystemNode::isWritable() const {
 	return access(_path.c_str(), W_OK) == 0;
 }
 
+uint32 POSIXFilesystemNode::getModificationTime(uint32 *size) const {
+	struct stat st;
+
+	if (stat(_path.c_str(), &st) != 0)
+		return 0;
+	if (size)
+		*size = (uint32)st.st_size;
+	return (uint32)st.st_mtime;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
@@ -315,6 +332,49 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
+#ifdef POSIX_FS_USE_MMAP
+namespace {
+
+struct MappingDeleter {
+	size_t _size;
+
+	MappingDeleter(size_t size) : _size(size) {}
+
+	void operator()(const byte *memory) {
+		munmap(const_cast<byte *>(memory), _size);
+	}
+};
+
+} // End of anonymous namespace
+#endif
+
+Common::SeekableReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#ifdef POSIX_FS_USE_MMAP
+	const int fd = open(_path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	// Streams are limited to 2 GB, and empty files can not be mapped
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || st.st_size > 0x7FFFFFFF) {
+		close(fd);
+		return nullptr;
+	}
+
+	const size_t size = st.st_size;
+	void *memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps the file alive on its own
+	close(fd);
+	if (memory == MAP_FAILED)
+		return nullptr;
+
+	Common::SharedPtr<const byte> mapping((const byte *)memory, MappingDeleter(size));
+	return new Common::SharedMemoryReadStream(mapping, (const byte *)memory, size);
+#else
+	return nullptr;
+#endif
+}
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return PosixIoStream::makeFromPath(getPath(), true);
 }
@@ -28,6 +28,9 @@
 #include "backends/fs/windows/windows-fs.h"
 #include "backends/fs/stdiostream.h"
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 // F_OK, R_OK and W_OK are not defined under MSVC, so we define them here
 // For more information on the modes used by MSVC, check:
 // http://msdn2.microsoft.com/en-us/library/1w06ktdy(VS.80).aspx
@@ -55,6 +58,16 @@ bool WindowsFilesystemNode::isWritable() const {
 	return _access(_path.c_str(), W_OK) == 0;
 }
 
+uint32 WindowsFilesystemNode::getModificationTime(uint32 *size) const {
+	struct _stat st;
+
+	if (_stat(_path.c_str(), &st) != 0)
+		return 0;
+	if (size)
+		*size = (uint32)st.st_size;
+	return (uint32)st.st_mtime;
+}
+
 void WindowsFilesystemNode::addFile(AbstractFSList &list, ListMode mode, const char *base, bool hidden, WIN32_FIND_DATA* find_data) {
 	WindowsFilesystemNode entry;
 	char *asciiName = toAscii(find_data->cFileName);
@@ -24,6 +24,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/mutex/mutex.h"
+#include "backends/thread/thread.h"
 #include "gui/EventRecorder.h"
 
 #include "audio/mixer.h"
@@ -32,6 +33,7 @@
 ModularBackend::ModularBackend()
 	:
 	_mutexManager(0),
+	_threadManager(0),
 	_graphicsManager(0),
 	_mixer(0) {
 
@@ -42,6 +44,9 @@ ModularBackend::~ModularBackend() {
 	_graphicsManager = 0;
 	delete _mixer;
 	_mixer = 0;
+	destroyJobSystem();
+	delete _threadManager;
+	_threadManager = 0;
 	delete _mutexManager;
 	_mutexManager = 0;
 }
@@ -263,6 +268,44 @@ void ModularBackend::deleteMutex(MutexRef mutex) {
 	_mutexManager->deleteMutex(mutex);
 }
 
+OSystem::ThreadRef ModularBackend::createThread(ThreadProc proc, void *param, const char *name) {
+	if (!_threadManager)
+		return 0;
+	return _threadManager->createThread(proc, param, name);
+}
+
+void ModularBackend::joinThread(ThreadRef thread) {
+	assert(_threadManager);
+	_threadManager->joinThread(thread);
+}
+
+OSystem::SemaphoreRef ModularBackend::createSemaphore(uint value) {
+	if (!_threadManager)
+		return 0;
+	return _threadManager->createSemaphore(value);
+}
+
+void ModularBackend::waitSemaphore(SemaphoreRef sem) {
+	assert(_threadManager);
+	_threadManager->waitSemaphore(sem);
+}
+
+void ModularBackend::postSemaphore(SemaphoreRef sem) {
+	assert(_threadManager);
+	_threadManager->postSemaphore(sem);
+}
+
+void ModularBackend::deleteSemaphore(SemaphoreRef sem) {
+	assert(_threadManager);
+	_threadManager->deleteSemaphore(sem);
+}
+
+uint ModularBackend::getCPUCount() {
+	if (!_threadManager)
+		return 1;
+	return _threadManager->getCPUCount();
+}
+
 Audio::Mixer *ModularBackend::getMixer() {
 	assert(_mixer);
 	return (Audio::Mixer *)_mixer;
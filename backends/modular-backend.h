@@ -27,6 +27,7 @@
 
 class GraphicsManager;
 class MutexManager;
+class ThreadManager;
 
 /**
  * Base class for modular backends.
@@ -124,6 +125,19 @@ public:
 
 	//@}
 
+	/** @name Worker threads */
+	//@{
+
+	virtual ThreadRef createThread(ThreadProc proc, void *param, const char *name) override;
+	virtual void joinThread(ThreadRef thread) override;
+	virtual SemaphoreRef createSemaphore(uint value) override;
+	virtual void waitSemaphore(SemaphoreRef sem) override;
+	virtual void postSemaphore(SemaphoreRef sem) override;
+	virtual void deleteSemaphore(SemaphoreRef sem) override;
+	virtual uint getCPUCount() override;
+
+	//@}
+
 	/** @name Sound */
 	//@{
 
@@ -144,6 +158,7 @@ protected:
 	//@{
 
 	MutexManager *_mutexManager;
+	ThreadManager *_threadManager;
 	GraphicsManager *_graphicsManager;
 	Audio::Mixer *_mixer;
 
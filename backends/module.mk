@@ -143,6 +143,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mutex/sdl/sdl-mutex.o \
 	plugins/sdl/sdl-provider.o \
+	thread/sdl/sdl-thread.o \
 	timer/sdl/sdl-timer.o
 
 # SDL 2 removed audio CD support
@@ -166,9 +167,11 @@ MODULE_OBJS += \
 	fs/posix-drives/posix-drives-fs-factory.o \
 	fs/chroot/chroot-fs-factory.o \
 	fs/chroot/chroot-fs.o \
+	mutex/pthread/pthread-mutex.o \
 	plugins/posix/posix-provider.o \
 	saves/posix/posix-saves.o \
-	taskbar/unity/unity-taskbar.o
+	taskbar/unity/unity-taskbar.o \
+	thread/pthread/pthread-thread.o
 
 ifdef USE_SPEECH_DISPATCHER
 ifdef USE_TTS
@@ -214,11 +217,6 @@ endif
 
 endif
 
-ifeq ($(BACKEND),android)
-MODULE_OBJS += \
-	mutex/pthread/pthread-mutex.o
-endif
-
 ifeq ($(BACKEND),androidsdl)
 MODULE_OBJS += \
 	events/androidsdl/androidsdl-events.o
@@ -57,6 +57,7 @@
 
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/thread/pthread/pthread-thread.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 
@@ -345,6 +346,7 @@ void OSystem_Android::initBackend() {
 	LOGD("Setting DefaultSaveFileManager path to: %s", ConfMan.get("savepath").c_str());
 
 	_mutexManager = new PthreadMutexManager();
+	_threadManager = new PthreadThreadManager();
 	_timerManager = new DefaultTimerManager();
 
 	_event_queue_lock = createMutex();
@@ -131,6 +131,7 @@ OSystem_iOS7::~OSystem_iOS7() {
 	AudioQueueDispose(s_AudioQueue.queue, true);
 
 	delete _mixer;
+	destroyJobSystem();
 	// Prevent accidental freeing of the screen texture here. This needs to be
 	// checked since we might use the screen texture as framebuffer in the case
 	// of hi-color games for example. Otherwise this can lead to a double free.
@@ -285,6 +286,34 @@ void OSystem_iOS7::deleteMutex(MutexRef mutex) {
 	}
 }
 
+OSystem::ThreadRef OSystem_iOS7::createThread(ThreadProc proc, void *param, const char *name) {
+	return _threadManager.createThread(proc, param, name);
+}
+
+void OSystem_iOS7::joinThread(ThreadRef thread) {
+	_threadManager.joinThread(thread);
+}
+
+OSystem::SemaphoreRef OSystem_iOS7::createSemaphore(uint value) {
+	return _threadManager.createSemaphore(value);
+}
+
+void OSystem_iOS7::waitSemaphore(SemaphoreRef sem) {
+	_threadManager.waitSemaphore(sem);
+}
+
+void OSystem_iOS7::postSemaphore(SemaphoreRef sem) {
+	_threadManager.postSemaphore(sem);
+}
+
+void OSystem_iOS7::deleteSemaphore(SemaphoreRef sem) {
+	_threadManager.deleteSemaphore(sem);
+}
+
+uint OSystem_iOS7::getCPUCount() {
+	return _threadManager.getCPUCount();
+}
+
 
 void OSystem_iOS7::setTimerCallback(TimerProc callback, int interval) {
 	//printf("setTimerCallback()\n");
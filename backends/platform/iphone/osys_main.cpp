@@ -75,6 +75,7 @@ OSystem_IPHONE::~OSystem_IPHONE() {
 	AudioQueueDispose(s_AudioQueue.queue, true);
 
 	delete _mixer;
+	destroyJobSystem();
 	// Prevent accidental freeing of the screen texture here. This needs to be
 	// checked since we might use the screen texture as framebuffer in the case
 	// of hi-color games for example. Otherwise this can lead to a double free.
@@ -215,6 +216,34 @@ void OSystem_IPHONE::deleteMutex(MutexRef mutex) {
 	}
 }
 
+OSystem::ThreadRef OSystem_IPHONE::createThread(ThreadProc proc, void *param, const char *name) {
+	return _threadManager.createThread(proc, param, name);
+}
+
+void OSystem_IPHONE::joinThread(ThreadRef thread) {
+	_threadManager.joinThread(thread);
+}
+
+OSystem::SemaphoreRef OSystem_IPHONE::createSemaphore(uint value) {
+	return _threadManager.createSemaphore(value);
+}
+
+void OSystem_IPHONE::waitSemaphore(SemaphoreRef sem) {
+	_threadManager.waitSemaphore(sem);
+}
+
+void OSystem_IPHONE::postSemaphore(SemaphoreRef sem) {
+	_threadManager.postSemaphore(sem);
+}
+
+void OSystem_IPHONE::deleteSemaphore(SemaphoreRef sem) {
+	_threadManager.deleteSemaphore(sem);
+}
+
+uint OSystem_IPHONE::getCPUCount() {
+	return _threadManager.getCPUCount();
+}
+
 
 void OSystem_IPHONE::setTimerCallback(TimerProc callback, int interval) {
 	//printf("setTimerCallback()\n");
@@ -29,6 +29,7 @@
 #include "common/events.h"
 #include "audio/mixer_intern.h"
 #include "backends/fs/posix/posix-fs-factory.h"
+#include "backends/thread/pthread/pthread-thread.h"
 #include "graphics/colormasks.h"
 #include "graphics/palette.h"
 
@@ -101,6 +102,7 @@ protected:
 	int _timerCallbackNext;
 	int _timerCallbackTimer;
 	TimerProc _timerCallback;
+	PthreadThreadManager _threadManager;
 
 	Common::Array<Common::Rect> _dirtyRects;
 	Common::Array<Common::Rect> _dirtyOverlayRects;
@@ -176,6 +178,14 @@ public:
 	virtual void unlockMutex(MutexRef mutex);
 	virtual void deleteMutex(MutexRef mutex);
 
+	virtual ThreadRef createThread(ThreadProc proc, void *param, const char *name);
+	virtual void joinThread(ThreadRef thread);
+	virtual SemaphoreRef createSemaphore(uint value);
+	virtual void waitSemaphore(SemaphoreRef sem);
+	virtual void postSemaphore(SemaphoreRef sem);
+	virtual void deleteSemaphore(SemaphoreRef sem);
+	virtual uint getCPUCount();
+
 	static void mixCallback(void *sys, byte *samples, int len);
 	virtual void setupMixer(void);
 	virtual void setTimerCallback(TimerProc callback, int interval);
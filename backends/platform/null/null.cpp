@@ -37,6 +37,8 @@
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mutex/null/null-mutex.h"
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/thread/pthread/pthread-thread.h"
 #include "backends/graphics/null/null-graphics.h"
 #include "audio/mixer_intern.h"
 #include "common/scummsys.h"
@@ -74,6 +76,16 @@ public:
 };
 
 OSystem_NULL::OSystem_NULL() {
+	// Mutexes are used by the command line commands, which run before
+	// initBackend().
+#if defined(POSIX)
+	// Worker threads need real mutexes
+	_mutexManager = new PthreadMutexManager();
+	_threadManager = new PthreadThreadManager();
+#else
+	_mutexManager = new NullMutexManager();
+#endif
+
 	#if defined(__amigaos4__)
 		_fsFactory = new AmigaOSFilesystemFactory();
 	#elif defined(POSIX)
@@ -91,7 +103,6 @@ OSystem_NULL::~OSystem_NULL() {
 }
 
 void OSystem_NULL::initBackend() {
-	_mutexManager = new NullMutexManager();
 	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
@@ -37,6 +37,7 @@
 #include "backends/saves/posix/posix-saves.h"
 #include "backends/fs/posix/posix-fs-factory.h"
 #include "backends/fs/posix/posix-fs.h"
+#include "backends/thread/pthread/pthread-thread.h"
 #include "backends/taskbar/unity/unity-taskbar.h"
 
 #ifdef USE_LINUXCD
@@ -64,6 +65,9 @@ void OSystem_POSIX::init() {
 	// Initialze File System Factory
 	_fsFactory = new POSIXFilesystemFactory();
 
+	// Use the native threads instead of the SDL ones
+	_threadManager = new PthreadThreadManager();
+
 #if defined(USE_TASKBAR) && defined(USE_UNITY)
 	// Initialize taskbar manager
 	_taskbarManager = new UnityTaskbarManager();
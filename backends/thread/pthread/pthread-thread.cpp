@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(POSIX) || defined(__ANDROID__) || defined(IPHONE)
+
+#include "backends/thread/pthread/pthread-thread.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace {
+
+struct PthreadStart {
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+void *pthreadEntry(void *data) {
+	PthreadStart *start = (PthreadStart *)data;
+	OSystem::ThreadProc proc = start->proc;
+	void *param = start->param;
+	delete start;
+
+	proc(param);
+	return NULL;
+}
+
+/*
+ * Unnamed POSIX semaphores are not available everywhere (most notably on
+ * Mac OS X), so build them from a mutex and a condition variable.
+ */
+struct PthreadSemaphore {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	uint value;
+};
+
+} // End of anonymous namespace
+
+OSystem::ThreadRef PthreadThreadManager::createThread(OSystem::ThreadProc proc, void *param, const char *name) {
+	PthreadStart *start = new PthreadStart;
+	start->proc = proc;
+	start->param = param;
+
+	pthread_t *thread = new pthread_t;
+	if (pthread_create(thread, NULL, pthreadEntry, start) != 0) {
+		warning("pthread_create() failed");
+		delete thread;
+		delete start;
+		return NULL;
+	}
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void PthreadThreadManager::joinThread(OSystem::ThreadRef thread) {
+	pthread_t *t = (pthread_t *)thread;
+
+	if (pthread_join(*t, NULL) != 0)
+		warning("pthread_join() failed");
+	delete t;
+}
+
+OSystem::SemaphoreRef PthreadThreadManager::createSemaphore(uint value) {
+	PthreadSemaphore *sem = new PthreadSemaphore;
+
+	if (pthread_mutex_init(&sem->mutex, NULL) != 0) {
+		warning("pthread_mutex_init() failed");
+		delete sem;
+		return NULL;
+	}
+	if (pthread_cond_init(&sem->cond, NULL) != 0) {
+		warning("pthread_cond_init() failed");
+		pthread_mutex_destroy(&sem->mutex);
+		delete sem;
+		return NULL;
+	}
+	sem->value = value;
+
+	return (OSystem::SemaphoreRef)sem;
+}
+
+void PthreadThreadManager::waitSemaphore(OSystem::SemaphoreRef sem) {
+	PthreadSemaphore *s = (PthreadSemaphore *)sem;
+
+	pthread_mutex_lock(&s->mutex);
+	while (s->value == 0)
+		pthread_cond_wait(&s->cond, &s->mutex);
+	s->value--;
+	pthread_mutex_unlock(&s->mutex);
+}
+
+void PthreadThreadManager::postSemaphore(OSystem::SemaphoreRef sem) {
+	PthreadSemaphore *s = (PthreadSemaphore *)sem;
+
+	pthread_mutex_lock(&s->mutex);
+	s->value++;
+	pthread_cond_signal(&s->cond);
+	pthread_mutex_unlock(&s->mutex);
+}
+
+void PthreadThreadManager::deleteSemaphore(OSystem::SemaphoreRef sem) {
+	PthreadSemaphore *s = (PthreadSemaphore *)sem;
+
+	pthread_cond_destroy(&s->cond);
+	pthread_mutex_destroy(&s->mutex);
+	delete s;
+}
+
+uint PthreadThreadManager::getCPUCount() {
+#if defined(_SC_NPROCESSORS_ONLN)
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > 0)
+		return count;
+#endif
+	return 1;
+}
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "common/scummsys.h"
 #include "backends/timer/default/default-timer.h"
+#include "common/debug.h"
 #include "common/util.h"
 #include "common/system.h"
 
@@ -31,87 +32,210 @@ struct TimerSlot {
 	Common::String id;
 	uint32 interval;	// in microseconds
 
-	uint32 nextFireTime;	// in milliseconds
-	uint32 nextFireTimeMicro;	// microseconds part of nextFire
+	uint64 nextFire;	// in microseconds, on the clock of the timer manager
+
+	DefaultTimerManager::TimerStats stats;
+	bool running;	// the callback is being invoked
+	bool removed;	// removed while running, to be deleted afterwards
 
 	TimerSlot *next;
+	TimerSlot **pprev;	// the pointer pointing at this slot, for unlinking
 
-	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0), next(nullptr) {}
+	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFire(0), running(false), removed(false), next(nullptr), pprev(nullptr) {
+		stats.calls = 0;
+		stats.overruns = 0;
+		stats.maxLateness = 0;
+		stats.totalLateness = 0;
+	}
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = 0;
-
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == 0 || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
+static void linkSlot(TimerSlot *&list, TimerSlot *slot) {
+	slot->next = list;
+	if (list)
+		list->pprev = &slot->next;
+	slot->pprev = &list;
+	list = slot;
+}
+
+static void unlinkSlot(TimerSlot *slot) {
+	if (!slot->pprev)
+		return;
+
+	*slot->pprev = slot->next;
+	if (slot->next)
+		slot->next->pprev = slot->pprev;
+	slot->next = nullptr;
+	slot->pprev = nullptr;
 }
 
 
 DefaultTimerManager::DefaultTimerManager() :
-	_head(0) {
+	_overflow(nullptr), _due(nullptr), _currentTick(0), _millis(0), _lastMillis(0), _started(false), _dispatching(false) {
 
-	_head = new TimerSlot();
+	for (int i = 0; i < kNearSize; ++i)
+		_near[i] = nullptr;
+	for (int i = 0; i < kFarSize; ++i)
+		_far[i] = nullptr;
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
+	for (uint i = 0; i < _timers.size(); ++i)
+		delete _timers[i];
+	_timers.clear();
+}
+
+void DefaultTimerManager::updateTime(uint32 millis) {
+	// The clock is extended to 64 bits, so it does not wrap after 49 days.
+	// The timestamps of the event recorder may lag behind the real time a
+	// little, so the clock is never moved backwards.
+	if (!_started) {
+		_millis = millis;
+		_currentTick = millis;
+		_started = true;
+	} else if ((int32)(millis - _lastMillis) > 0) {
+		_millis += millis - _lastMillis;
+	} else {
+		return;
+	}
+
+	_lastMillis = millis;
+}
+
+void DefaultTimerManager::schedule(TimerSlot *slot) {
+	const uint64 tick = slot->nextFire / 1000;
+
+	if (tick < _currentTick)
+		linkSlot(_due, slot);
+	else if ((tick >> kNearBits) == (_currentTick >> kNearBits))
+		linkSlot(_near[tick & (kNearSize - 1)], slot);
+	else if ((tick >> (kNearBits + kFarBits)) == (_currentTick >> (kNearBits + kFarBits)))
+		linkSlot(_far[(tick >> kNearBits) & (kFarSize - 1)], slot);
+	else
+		linkSlot(_overflow, slot);
+}
+
+void DefaultTimerManager::reschedule(TimerSlot *&list) {
+	TimerSlot *slot = list;
+	list = nullptr;
+
 	while (slot) {
 		TimerSlot *next = slot->next;
-		delete slot;
+		slot->next = nullptr;
+		slot->pprev = nullptr;
+		schedule(slot);
 		slot = next;
 	}
-	_head = 0;
+}
+
+void DefaultTimerManager::advance() {
+	// After a long pause, like with a suspended process, it is cheaper to
+	// sort all timers again than to step through the wheels
+	if (_millis - _currentTick > kWheelSpan) {
+		for (uint i = 0; i < _timers.size(); ++i)
+			unlinkSlot(_timers[i]);
+
+		_currentTick = _millis;
+		for (uint i = 0; i < _timers.size(); ++i) {
+			if (!_timers[i]->running)
+				schedule(_timers[i]);
+		}
+		return;
+	}
+
+	// Move the timers of every millisecond passed to the due list
+	while (_currentTick < _millis) {
+		TimerSlot *&bucket = _near[_currentTick & (kNearSize - 1)];
+		while (bucket) {
+			TimerSlot *slot = bucket;
+			unlinkSlot(slot);
+			linkSlot(_due, slot);
+		}
+
+		++_currentTick;
+		if (_currentTick & (kNearSize - 1))
+			continue;
+
+		// A new revolution of a wheel starts, so the timers of the next
+		// larger one are distributed over the smaller one
+		if (!(_currentTick & (kWheelSpan - 1)))
+			reschedule(_overflow);
+		reschedule(_far[(_currentTick >> kNearBits) & (kFarSize - 1)]);
+	}
+}
+
+TimerSlot *DefaultTimerManager::popDue() {
+	// Timers which fell behind may be due several times, so the earliest
+	// one is invoked first, as the order of the due list is arbitrary
+	TimerSlot *first = _due;
+	for (TimerSlot *slot = _due; slot; slot = slot->next) {
+		if (slot->nextFire < first->nextFire)
+			first = slot;
+	}
+
+	if (first)
+		unlinkSlot(first);
+	return first;
 }
 
 void DefaultTimerManager::handler() {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_mutex);
+
+		// Another thread or a callback is already invoking the timers
+		if (_dispatching)
+			return;
+		_dispatching = true;
+
+		updateTime(g_system->getMillis(true));
+		advance();
+	}
+
+	for (;;) {
+		// Held while the callback runs, but not the lock of the timer lists
+		Common::StackLock dispatchLock(_dispatchMutex);
+
+		TimerSlot *slot;
+		{
+			Common::StackLock lock(_mutex);
+
+			slot = popDue();
+			if (!slot) {
+				_dispatching = false;
+				return;
+			}
 
-	uint32 curTime = g_system->getMillis(true);
-
-	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
-
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
-		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
+			const uint32 lateness = MIN<uint64>(_millis * 1000 - slot->nextFire, 0xFFFFFFFF);
+			slot->stats.calls++;
+			slot->stats.maxLateness = MAX(slot->stats.maxLateness, lateness);
+			slot->stats.totalLateness += lateness;
+
+			// Advancing by the exact interval keeps the timer from drifting
+			assert(slot->interval > 0);
+			slot->nextFire += slot->interval;
+			if (slot->nextFire / 1000 < _currentTick)
+				slot->stats.overruns++;
+
+			slot->running = true;
 		}
-		insertPrioQueue(_head, slot);
 
 		// Invoke the timer callback
 		assert(slot->callback);
 		slot->callback(slot->refCon);
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+		Common::StackLock lock(_mutex);
+		slot->running = false;
+		if (slot->removed)
+			delete slot;
+		else
+			schedule(slot);
 	}
 }
 
 bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, void *refCon, const Common::String &id) {
 	assert(interval > 0);
+	const uint32 curTime = g_system->getMillis();
 	Common::StackLock lock(_mutex);
 
 	if (_callbacks.contains(id)) {
@@ -128,49 +252,78 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	}
 	_callbacks[id] = callback;
 
+	updateTime(curTime);
+
 	TimerSlot *slot = new TimerSlot;
 	slot->callback = callback;
 	slot->refCon = refCon;
 	slot->id = id;
 	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
-	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = 0;
+	slot->nextFire = _millis * 1000 + interval;
 
-	insertPrioQueue(_head, slot);
+	_timers.push_back(slot);
+	schedule(slot);
 
 	return true;
 }
 
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
+		for (uint i = 0; i < _timers.size(); ++i) {
+			TimerSlot *slot = _timers[i];
+			if (slot->callback != callback)
+				continue;
+
+			const TimerStats &stats = slot->stats;
+			debug(2, "Timer '%s': %u calls, %u overruns, lateness %u us on average, %u us at most",
+			      slot->id.c_str(), stats.calls, stats.overruns,
+			      stats.calls ? (uint32)(stats.totalLateness / stats.calls) : 0, stats.maxLateness);
+
+			_timers.remove_at(i--);
+			if (slot->running) {
+				// Deleted by handler() once the callback returns
+				slot->removed = true;
+			} else {
+				unlinkSlot(slot);
+				delete slot;
+			}
+		}
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
-		} else {
-			slot = slot->next;
+		// We need to remove all names referencing the timer proc here.
+		//
+		// Else we run into troubles, when the client code removes and readds timer
+		// callbacks.
+		//
+		// Another issues occurs when one plays a game with ALSA as music driver,
+		// does RTL and starts a different engine game with ALSA as music driver.
+		// In this case the MPU401 code will add different timer procs with the
+		// same name, resulting in two different callbacks added with the same
+		// name and causing installTimerProc to error out.
+		// A good test case is running a SCUMM with ALSA output and then a KYRA
+		// game for example.
+		for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
+			if (i->_value == callback)
+				_callbacks.erase(i);
 		}
 	}
 
-	// We need to remove all names referencing the timer proc here.
-	//
-	// Else we run into troubles, when the client code removes and readds timer
-	// callbacks.
-	//
-	// Another issues occurs when one plays a game with ALSA as music driver,
-	// does RTL and starts a different engine game with ALSA as music driver.
-	// In this case the MPU401 code will add different timer procs with the
-	// same name, resulting in two different callbacks added with the same
-	// name and causing installTimerProc to error out.
-	// A good test case is running a SCUMM with ALSA output and then a KYRA
-	// game for example.
-	for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
-		if (i->_value == callback)
-			_callbacks.erase(i);
+	// Wait for a callback invoked on another thread to return, as its data
+	// may be destroyed right after this. The mutex is recursive, so this
+	// does not block when a callback removes itself.
+	Common::StackLock dispatchLock(_dispatchMutex);
+}
+
+bool DefaultTimerManager::getTimerStats(TimerProc callback, TimerStats &stats) {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _timers.size(); ++i) {
+		if (_timers[i]->callback == callback) {
+			stats = _timers[i]->stats;
+			return true;
+		}
 	}
+
+	return false;
 }
@@ -23,6 +23,7 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -30,20 +31,78 @@
 
 struct TimerSlot;
 
+/**
+ * Timer manager driven by periodic calls to handler().
+ *
+ * The timers are kept in a hierarchical timing wheel with a resolution of
+ * one millisecond, so installing, removing and firing a timer takes
+ * constant time. Due times advance by the exact interval in microseconds,
+ * so timers do not drift; a timer which fell behind fires repeatedly to
+ * catch up.
+ *
+ * The callbacks are invoked without holding the lock of the timer list, so
+ * timers can be installed while a slow callback runs. Once
+ * removeTimerProc() returns, the removed callback is not running anymore
+ * and will not be invoked again, unless it was called by that very callback.
+ */
 class DefaultTimerManager : public Common::TimerManager {
+public:
+	/** Statistics on the invocations of a timer callback. */
+	struct TimerStats {
+		uint32 calls;         ///< Number of invocations
+		uint32 overruns;      ///< Invocations after which the timer was still due
+		uint32 maxLateness;   ///< Largest delay of an invocation, in microseconds
+		uint64 totalLateness; ///< Sum of the delays, in microseconds
+	};
+
 private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
+	enum {
+		kNearBits = 8,                 ///< The near wheel has one slot per millisecond
+		kFarBits = 6,                  ///< The far wheel has one slot per revolution of the near wheel
+		kNearSize = 1 << kNearBits,
+		kFarSize = 1 << kFarBits,
+		kWheelSpan = kNearSize * kFarSize
+	};
+
+	/** Guards the timer lists and the members below */
 	Common::Mutex _mutex;
-	TimerSlot *_head;
+	/** Held while invoking a callback, so removeTimerProc() can wait for it */
+	Common::Mutex _dispatchMutex;
+
+	Common::Array<TimerSlot *> _timers;
 	TimerSlotMap _callbacks;
 
+	TimerSlot *_near[kNearSize]; ///< Timers due within the current revolution of the near wheel
+	TimerSlot *_far[kFarSize];   ///< Timers due in one of the next revolutions
+	TimerSlot *_overflow;        ///< Timers due beyond the far wheel
+	TimerSlot *_due;             ///< Timers to invoke in this call to handler()
+
+	uint64 _currentTick; ///< The last millisecond processed by the wheels
+	uint64 _millis;      ///< The current time, extended to 64 bits
+	uint32 _lastMillis;
+	bool _started;
+	bool _dispatching;
+
+	void updateTime(uint32 millis);
+	void schedule(TimerSlot *slot);
+	void reschedule(TimerSlot *&list);
+	void advance();
+	TimerSlot *popDue();
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
 	virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
 	virtual void removeTimerProc(TimerProc proc);
 
+	/**
+	 * Get the statistics of an installed timer.
+	 * @return false if the callback is not installed
+	 */
+	bool getTimerStats(TimerProc proc, TimerStats &stats);
+
 	/**
 	 * Timer callback, to be invoked at regular time intervals by the backend.
 	 */
@@ -27,6 +27,8 @@
 
 #include <limits.h>
 
+#include "engines/detectioncache.h"
+#include "engines/detectionscanner.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
@@ -238,6 +240,9 @@ void registerDefaults() {
 	ConfMan.registerDefault("dump_midi", false);
 	ConfMan.registerDefault("enable_gs", false);
 	ConfMan.registerDefault("midi_gain", 100);
+	ConfMan.registerDefault("resampler", "linear");
+	ConfMan.registerDefault("mixer_render_ahead", false);
+	ConfMan.registerDefault("mt32_render_ahead", 0);
 
 	ConfMan.registerDefault("music_driver", "auto");
 	ConfMan.registerDefault("mt32_device", "null");
@@ -283,6 +288,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("joystick_num", -1);
 	ConfMan.registerDefault("confirm_exit", false);
 	ConfMan.registerDefault("disable_sdl_parachute", false);
+	ConfMan.registerDefault("detection_cache", true);
 
 	ConfMan.registerDefault("disable_display", false);
 	ConfMan.registerDefault("record_mode", "none");
@@ -953,16 +959,8 @@ static void listAudioDevices() {
 	}
 }
 
-/** Display all games in the given directory, or current directory if empty */
-static DetectedGames getGameList(const Common::FSNode &dir) {
-	Common::FSList files;
-
-	// Collect all files from directory
-	if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-		printf("Path %s does not exist or is not a directory.\n", dir.getPath().c_str());
-		return DetectedGames();
-	}
-
+/** Detect the games in a directory, given its contents */
+static DetectedGames getGameList(const Common::FSList &files) {
 	// detect Games
 	DetectionResults detectionResults = EngineMan.detectGames(files);
 
@@ -975,18 +973,24 @@ static DetectedGames getGameList(const Common::FSNode &dir) {
 }
 
 static DetectedGames recListGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
-	DetectedGames list = getGameList(dir);
+	DetectedGames list;
 
-	if (recursive) {
-		Common::FSList files;
-		dir.getChildren(files, Common::FSNode::kListDirectoriesOnly);
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			DetectedGames rec = recListGames(*file, engineId, gameId, recursive);
-			for (DetectedGames::const_iterator game = rec.begin(); game != rec.end(); ++game) {
-				if ((game->engineId == engineId && game->gameId == gameId)
-				    || gameId.empty())
-					list.push_back(*game);
-			}
+	DetectionScanner scanner(dir, recursive);
+	Common::FSNode subdir;
+	Common::FSList files;
+	DetectionScanner::Result result;
+	for (bool top = true; (result = scanner.next(subdir, files)) != DetectionScanner::kFinished; top = false) {
+		if (result == DetectionScanner::kUnreadable) {
+			printf("Path %s does not exist or is not a directory.\n", subdir.getPath().c_str());
+			continue;
+		}
+
+		// Only the games found in subdirectories are filtered
+		DetectedGames games = getGameList(files);
+		for (DetectedGames::const_iterator game = games.begin(); game != games.end(); ++game) {
+			if (top || (game->engineId == engineId && game->gameId == gameId)
+			    || gameId.empty())
+				list.push_back(*game);
 		}
 	}
 
@@ -998,7 +1002,13 @@ static Common::String detectGames(const Common::String &path, const Common::Stri
 	bool noPath = path.empty();
 	//Current directory
 	Common::FSNode dir(path);
+	const uint32 start = g_system->getMillis();
 	DetectedGames candidates = recListGames(dir, engineId, gameId, recursive);
+	const uint32 elapsed = g_system->getMillis() - start;
+
+	DetCache.flush();
+	printf("Detection took %u ms, %u files checksummed, %u files from the detection cache\n",
+	       elapsed, DetCache.getMisses(), DetCache.getHits());
 
 	if (candidates.empty()) {
 		printf("WARNING: ScummVM could not find any game in %s\n", dir.getPath().c_str());
@@ -1025,37 +1035,40 @@ static Common::String detectGames(const Common::String &path, const Common::Stri
 
 static int recAddGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	int count = 0;
-	DetectedGames list = getGameList(dir);
-	for (DetectedGames::const_iterator v = list.begin(); v != list.end(); ++v) {
-		if ((v->engineId != engineId || v->gameId != gameId)
-		    && !gameId.empty()) {
-			printf("Found %s, only adding %s per --game option, ignoring...\n",
-			       buildQualifiedGameName(v->engineId, v->gameId).c_str(),
-			       buildQualifiedGameName(engineId, gameId).c_str());
-		} else if (ConfMan.hasGameDomain(v->preferredTarget)) {
-			// TODO Better check for game already added?
-			printf("Found %s, but has already been added, skipping\n",
-			       buildQualifiedGameName(v->engineId, v->gameId).c_str());
-		} else {
-			Common::String target = EngineMan.createTargetForGame(*v);
-			count++;
-
-			// Display added game info
-			printf("Game Added: \n  Target:   %s\n  GameID:   %s\n  Name:     %s\n  Language: %s\n  Platform: %s\n",
-			       target.c_str(),
-			       buildQualifiedGameName(v->engineId, v->gameId).c_str(),
-			       v->description.c_str(),
-			       Common::getLanguageDescription(v->language),
-			       Common::getPlatformDescription(v->platform)
-			);
+
+	DetectionScanner scanner(dir, recursive);
+	Common::FSNode subdir;
+	Common::FSList files;
+	DetectionScanner::Result result;
+	while ((result = scanner.next(subdir, files)) != DetectionScanner::kFinished) {
+		if (result == DetectionScanner::kUnreadable) {
+			printf("Path %s does not exist or is not a directory.\n", subdir.getPath().c_str());
+			continue;
 		}
-	}
 
-	if (recursive) {
-		Common::FSList files;
-		if (dir.getChildren(files, Common::FSNode::kListDirectoriesOnly)) {
-			for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-				count += recAddGames(*file, engineId, gameId, recursive);
+		DetectedGames list = getGameList(files);
+		for (DetectedGames::const_iterator v = list.begin(); v != list.end(); ++v) {
+			if ((v->engineId != engineId || v->gameId != gameId)
+			    && !gameId.empty()) {
+				printf("Found %s, only adding %s per --game option, ignoring...\n",
+				       buildQualifiedGameName(v->engineId, v->gameId).c_str(),
+				       buildQualifiedGameName(engineId, gameId).c_str());
+			} else if (ConfMan.hasGameDomain(v->preferredTarget)) {
+				// TODO Better check for game already added?
+				printf("Found %s, but has already been added, skipping\n",
+				       buildQualifiedGameName(v->engineId, v->gameId).c_str());
+			} else {
+				Common::String target = EngineMan.createTargetForGame(*v);
+				count++;
+
+				// Display added game info
+				printf("Game Added: \n  Target:   %s\n  GameID:   %s\n  Name:     %s\n  Language: %s\n  Platform: %s\n",
+				       target.c_str(),
+				       buildQualifiedGameName(v->engineId, v->gameId).c_str(),
+				       v->description.c_str(),
+				       Common::getLanguageDescription(v->language),
+				       Common::getPlatformDescription(v->platform)
+				);
 			}
 		}
 	}
@@ -1067,6 +1080,7 @@ static bool addGames(const Common::String &path, const Common::String &engineId,
 	//Current directory
 	Common::FSNode dir(path);
 	int added = recAddGames(dir, engineId, gameId, recursive);
+	DetCache.flush();
 	printf("Added %d games\n", added);
 	if (added == 0 && !recursive) {
 		printf("Consider using --recursive to search inside subdirectories\n");
@@ -472,6 +472,7 @@ void PluginManager::addToPluginsInMemList(Plugin *plugin) {
 
 // Engine plugins
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 
 namespace Common {
@@ -554,6 +555,8 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist) const
 		}
 	} while (PluginMan.loadNextPlugin());
 
+	DetCache.flush(false);
+
 	return DetectionResults(candidates);
 }
 
@@ -60,6 +60,10 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern)
 	return matches;
 }
 
+SeekableReadStream *Archive::createMappedReadStreamForMember(const String &name) const {
+	return createReadStreamForMember(name);
+}
+
 
 
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
@@ -265,6 +269,20 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	return nullptr;
 }
 
+SeekableReadStream *SearchSet::createMappedReadStreamForMember(const String &name) const {
+	if (name.empty())
+		return nullptr;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		SeekableReadStream *stream = it->_arc->createMappedReadStreamForMember(name);
+		if (stream)
+			return stream;
+	}
+
+	return nullptr;
+}
+
 
 SearchManager::SearchManager() {
 	clear(); // Force a reset
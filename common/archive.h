@@ -123,6 +123,14 @@ public:
 	 * @return the newly created input stream
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const = 0;
+
+	/**
+	 * Same as createReadStreamForMember, but archives which can hand out
+	 * members on memory mappings, like FSDirectory, do so. The readStream()
+	 * and createView() of such streams share the mapping instead of copying.
+	 * By default this is just createReadStreamForMember.
+	 */
+	virtual SeekableReadStream *createMappedReadStreamForMember(const String &name) const;
 };
 
 
@@ -251,6 +259,12 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 
+	/**
+	 * Implements createMappedReadStreamForMember from Archive base class,
+	 * with the same policy as createReadStreamForMember.
+	 */
+	virtual SeekableReadStream *createMappedReadStreamForMember(const String &name) const;
+
 	/**
 	 * Ignore clashes when adding directories. For more details see the corresponding parameter
 	 * in FSDirectory documentation
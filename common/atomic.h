@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER)
+extern "C" long __cdecl _InterlockedExchangeAdd(long volatile *addend, long value);
+extern "C" long __cdecl _InterlockedCompareExchange(long volatile *dest, long exchange, long comparand);
+extern "C" long __cdecl _InterlockedExchange(long volatile *target, long value);
+#pragma intrinsic(_InterlockedExchangeAdd, _InterlockedCompareExchange, _InterlockedExchange)
+#endif
+
+namespace Common {
+
+/*
+ * Minimal set of sequentially consistent operations on 32-bit integers,
+ * used to exchange data between threads without taking a mutex.
+ *
+ * On compilers without support for atomic builtins, these degrade to plain
+ * volatile accesses, which is only correct on single core targets where
+ * audio/timer callbacks interrupt the main thread.
+ */
+
+/** Full memory barrier. */
+inline void atomicBarrier() {
+#if defined(__GNUC__)
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	long dummy = 0;
+	_InterlockedExchange(&dummy, 0);
+#endif
+}
+
+/** Read *ptr, ordering the read after all preceding memory accesses. */
+inline int32 atomicLoad(const volatile int32 *ptr) {
+	atomicBarrier();
+	int32 value = *ptr;
+	atomicBarrier();
+	return value;
+}
+
+/** Write value to *ptr, ordering the write after all preceding memory accesses. */
+inline void atomicStore(volatile int32 *ptr, int32 value) {
+#if defined(__GNUC__)
+	__sync_synchronize();
+	*ptr = value;
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	_InterlockedExchange((volatile long *)ptr, value);
+#else
+	*ptr = value;
+#endif
+}
+
+/** Add value to *ptr and return the new value. */
+inline int32 atomicAdd(volatile int32 *ptr, int32 value) {
+#if defined(__GNUC__)
+	return __sync_add_and_fetch(ptr, value);
+#elif defined(_MSC_VER)
+	return _InterlockedExchangeAdd((volatile long *)ptr, value) + value;
+#else
+	return *ptr += value;
+#endif
+}
+
+/**
+ * Replace *ptr by desired if it currently equals expected.
+ *
+ * @return true if the exchange took place
+ */
+inline bool atomicCompareAndSwap(volatile int32 *ptr, int32 expected, int32 desired) {
+#if defined(__GNUC__)
+	return __sync_bool_compare_and_swap(ptr, expected, desired);
+#elif defined(_MSC_VER)
+	return _InterlockedCompareExchange((volatile long *)ptr, desired, expected) == expected;
+#else
+	if (*ptr != expected)
+		return false;
+	*ptr = desired;
+	return true;
+#endif
+}
+
+inline uint32 atomicLoad(const volatile uint32 *ptr) {
+	return (uint32)atomicLoad((const volatile int32 *)ptr);
+}
+
+inline void atomicStore(volatile uint32 *ptr, uint32 value) {
+	atomicStore((volatile int32 *)ptr, (int32)value);
+}
+
+inline uint32 atomicAdd(volatile uint32 *ptr, uint32 value) {
+	return (uint32)atomicAdd((volatile int32 *)ptr, (int32)value);
+}
+
+inline bool atomicCompareAndSwap(volatile uint32 *ptr, uint32 expected, uint32 desired) {
+	return atomicCompareAndSwap((volatile int32 *)ptr, (int32)expected, (int32)desired);
+}
+
+} // End of namespace Common
+
+#endif
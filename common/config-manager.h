@@ -100,6 +100,12 @@ public:
 	void				loadDefaultConfigFile();
 	void				loadConfigFile(const String &filename);
 
+	/**
+	 * Retrieve the name of the config file passed to loadConfigFile().
+	 * @return the file name, or an empty string if the default config file is used.
+	 */
+	const String &		getCustomConfigFileName() const { return _filename; }
+
 	/**
 	 * Retrieve the config domain with the given name.
 	 * @param domName	the name of the domain to retrieve
@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/cpudetect.h"
+
+#if defined(SCUMMVM_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+#if defined(SCUMMVM_AVX2) && defined(_MSC_VER)
+static bool detectAVX2() {
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	// The OS must save the AVX registers on context switches
+	__cpuid(info, 1);
+	if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+}
+#endif
+
+bool hasCPUFeature(CPUFeature feature) {
+	switch (feature) {
+	case kCPUFeatureSSE2:
+#ifdef SCUMMVM_SSE2
+		return true;
+#else
+		return false;
+#endif
+
+	case kCPUFeatureAVX2:
+#if defined(SCUMMVM_AVX2) && defined(__GNUC__)
+		return __builtin_cpu_supports("avx2");
+#elif defined(SCUMMVM_AVX2) && defined(_MSC_VER)
+		{
+			static const bool hasAVX2 = detectAVX2();
+			return hasAVX2;
+		}
+#else
+		return false;
+#endif
+
+	case kCPUFeatureNEON:
+#ifdef SCUMMVM_NEON
+		return true;
+#else
+		return false;
+#endif
+
+	default:
+		return false;
+	}
+}
+
+} // End of namespace Common
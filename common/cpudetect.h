@@ -0,0 +1,72 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_CPUDETECT_H
+#define COMMON_CPUDETECT_H
+
+#include "common/scummsys.h"
+
+/*
+ * Instruction set extensions for which this build can compile optimized
+ * code paths. Code using them must still check hasCPUFeature() at runtime,
+ * except for SSE2 and NEON, which are only enabled when the compiler
+ * already targets them.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCUMMVM_SSE2
+#endif
+
+#if defined(SCUMMVM_SSE2) && ((defined(__GNUC__) && (GCC_ATLEAST(4, 9) || defined(__clang__))) || (defined(_MSC_VER) && _MSC_VER >= 1700))
+#define SCUMMVM_AVX2
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SCUMMVM_NEON
+#endif
+
+/**
+ * Marks a function as being compiled for AVX2, independently of the flags
+ * used for the rest of the file.
+ */
+#if defined(SCUMMVM_AVX2) && defined(__GNUC__)
+#define SCUMMVM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SCUMMVM_TARGET_AVX2
+#endif
+
+namespace Common {
+
+enum CPUFeature {
+	kCPUFeatureSSE2,
+	kCPUFeatureAVX2,
+	kCPUFeatureNEON
+};
+
+/**
+ * Checks whether the host CPU supports the given instruction set extension
+ * and whether this build contains code for it.
+ */
+bool hasCPUFeature(CPUFeature feature);
+
+} // End of namespace Common
+
+#endif
@@ -41,9 +41,10 @@ class SeekableReadStream;
 
 /**
  * Try to decompress a PKWARE DCL (PKWARE data compression library) compressed stream. Returns true if
- * successful.
+ * successful. If quiet is set, failures are only reported through the return value, and nothing is
+ * logged, so the function may be used off the main thread.
  */
-bool decompressDCL(ReadStream *sourceStream, byte *dest, uint32 packedSize, uint32 unpackedSize);
+bool decompressDCL(ReadStream *sourceStream, byte *dest, uint32 packedSize, uint32 unpackedSize, bool quiet = false);
 
 /**
  * Try to decompress a PKWARE DCL (PKWARE data compression library) compressed stream. Returns a valid pointer
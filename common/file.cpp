@@ -74,6 +74,42 @@ bool File::open(const FSNode &node) {
 	return open(stream, node.getPath());
 }
 
+bool File::openMapped(const String &filename) {
+	return openMapped(filename, SearchMan);
+}
+
+bool File::openMapped(const String &filename, Archive &archive) {
+	assert(!filename.empty());
+	assert(!_handle);
+
+	SeekableReadStream *stream = nullptr;
+
+	if ((stream = archive.createMappedReadStreamForMember(filename))) {
+		debug(8, "Opening mapped: %s", filename.c_str());
+	} else if ((stream = archive.createMappedReadStreamForMember(filename + "."))) {
+		// WORKAROUND: Bug #1458388: "SIMON1: Game Detection fails"
+		// sometimes instead of "GAMEPC" we get "GAMEPC." (note trailing dot)
+		debug(8, "Opening mapped: %s.", filename.c_str());
+	}
+
+	return open(stream, filename);
+}
+
+bool File::openMapped(const FSNode &node) {
+	assert(!_handle);
+
+	if (!node.exists()) {
+		warning("File::openMapped: '%s' does not exist", node.getPath().c_str());
+		return false;
+	} else if (node.isDirectory()) {
+		warning("File::openMapped: '%s' is a directory", node.getPath().c_str());
+		return false;
+	}
+
+	SeekableReadStream *stream = node.createMappedReadStream();
+	return open(stream, node.getPath());
+}
+
 bool File::open(SeekableReadStream *stream, const String &name) {
 	assert(!_handle);
 
@@ -143,6 +179,16 @@ uint32 File::read(void *ptr, uint32 len) {
 	return _handle->read(ptr, len);
 }
 
+SeekableReadStream *File::readStream(uint32 dataSize) {
+	assert(_handle);
+	return _handle->readStream(dataSize);
+}
+
+SeekableReadStream *File::createView(uint32 begin, uint32 size) const {
+	assert(_handle);
+	return _handle->createView(begin, size);
+}
+
 
 DumpFile::DumpFile() : _handle(nullptr) {
 }
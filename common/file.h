@@ -98,6 +98,29 @@ public:
 	 */
 	virtual bool open(SeekableReadStream *stream, const String &name);
 
+	/**
+	 * Same as open(), but opens the file on a memory mapping if the backend
+	 * supports this. readStream() and createView() then share the mapping
+	 * instead of copying data out of the file, which is useful for large
+	 * files read in many parts, like archives.
+	 * @note Must not be called if this file already is open (i.e. if isOpen returns true).
+	 *
+	 * @param	filename	the name of the file to open
+	 * @return	true if file was opened successfully, false otherwise
+	 */
+	bool openMapped(const String &filename);
+
+	/**
+	 * Same as openMapped(const String &), but searches the given archive.
+	 */
+	bool openMapped(const String &filename, Archive &archive);
+
+	/**
+	 * Same as openMapped(const String &), but opens the file corresponding
+	 * to the given node.
+	 */
+	bool openMapped(const FSNode &node);
+
 	/**
 	 * Close the file, if open.
 	 */
@@ -125,6 +148,9 @@ public:
 	int32 size() const override;	// implement abstract SeekableReadStream method
 	bool seek(int32 offs, int whence = SEEK_SET) override;	// implement abstract SeekableReadStream method
 	uint32 read(void *dataPtr, uint32 dataSize) override;	// implement abstract SeekableReadStream method
+
+	SeekableReadStream *readStream(uint32 dataSize) override;
+	SeekableReadStream *createView(uint32 begin, uint32 size) const override;
 };
 
 
@@ -125,6 +125,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+uint32 FSNode::getModificationTime(uint32 *size) const {
+	return _realNode ? _realNode->getModificationTime(size) : 0;
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -140,6 +144,16 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createMappedReadStream() const {
+	if (_realNode == nullptr || !_realNode->exists() || _realNode->isDirectory())
+		return createReadStream();
+
+	SeekableReadStream *stream = _realNode->createMappedReadStream();
+	if (!stream)
+		stream = _realNode->createReadStream();
+	return stream;
+}
+
 WriteStream *FSNode::createWriteStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -255,6 +269,20 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const String &name) c
 	return stream;
 }
 
+SeekableReadStream *FSDirectory::createMappedReadStreamForMember(const String &name) const {
+	if (name.empty() || !_node.isDirectory())
+		return nullptr;
+
+	FSNode *node = lookupCache(_fileCache, name);
+	if (!node)
+		return nullptr;
+	SeekableReadStream *stream = node->createMappedReadStream();
+	if (!stream)
+		warning("FSDirectory::createMappedReadStreamForMember: Can't create stream for file '%s'", name.c_str());
+
+	return stream;
+}
+
 FSDirectory *FSDirectory::getSubDirectory(const String &name, int depth, bool flat, bool ignoreClashes) {
 	return getSubDirectory(String(), name, depth, flat, ignoreClashes);
 }
@@ -213,6 +213,17 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Returns the time the object referred by this node was last modified,
+	 * in seconds. Only differences between two values are meaningful, and
+	 * not all backends provide this information.
+	 *
+	 * @param size	if not null, set to the lower 32 bits of the size of the
+	 *              file, which backends get along with the modification time
+	 * @return the modification time, or 0 if it is not available.
+	 */
+	uint32 getModificationTime(uint32 *size = nullptr) const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -222,6 +233,16 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Creates a SeekableReadStream on a memory mapping of the file referred
+	 * by this node, if the backend supports this. Its readStream() and
+	 * createView() then share the mapping instead of copying data out of it.
+	 * Otherwise this falls back to createReadStream().
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -369,6 +390,11 @@ public:
 	 * for success.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+
+	/**
+	 * Open the specified file on a memory mapping, if the backend supports this.
+	 */
+	virtual SeekableReadStream *createMappedReadStreamForMember(const String &name) const;
 };
 
 
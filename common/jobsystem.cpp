@@ -0,0 +1,273 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/jobsystem.h"
+#include "common/util.h"
+
+namespace Common {
+
+// The queues are bounded multi-producer, multi-consumer ring buffers. Every
+// slot carries a sequence number: a slot at position pos of the ring may be
+// filled once its sequence is pos, and its job taken once it is pos + 1.
+// Pushing and taking claim a position with a compare-and-swap, and hand the
+// slot over by advancing its sequence afterwards, so neither ever blocks.
+//
+// The owner of a queue is not special, as threads running jobs can not tell
+// which worker they are: OSystem has no thread-local storage.
+
+JobSystem::JobSystem(uint numThreads) : _work(0), _nextWorker(0), _quit(0) {
+	numThreads = MIN<uint>(numThreads, kMaxThreads);
+	if (numThreads)
+		_work = g_system->createSemaphore(0);
+	if (!_work)
+		return;
+
+	for (uint i = 0; i < numThreads; ++i) {
+		Worker *worker = new Worker;
+		worker->owner = this;
+		worker->index = i;
+		worker->slots = new Slot[kQueueSize];
+		for (uint j = 0; j < kQueueSize; ++j)
+			worker->slots[j].sequence = j;
+		worker->pushPos = worker->takePos = 0;
+
+		worker->thread = g_system->createThread(workerProc, worker, "JobWorker");
+		if (!worker->thread) {
+			delete[] worker->slots;
+			delete worker;
+			break;
+		}
+
+		// The workers only look at the queues once jobs are submitted, which
+		// happens after the constructor
+		_workers.push_back(worker);
+	}
+}
+
+JobSystem::~JobSystem() {
+	atomicStore(&_quit, 1);
+
+	for (uint i = 0; i < _workers.size(); ++i)
+		g_system->postSemaphore(_work);
+	for (uint i = 0; i < _workers.size(); ++i) {
+		g_system->joinThread(_workers[i]->thread);
+		assert(_workers[i]->pushPos == _workers[i]->takePos);
+		delete[] _workers[i]->slots;
+		delete _workers[i];
+	}
+
+	for (uint i = 0; i < _freeSemaphores.size(); ++i)
+		g_system->deleteSemaphore(_freeSemaphores[i]);
+	if (_work)
+		g_system->deleteSemaphore(_work);
+}
+
+void JobSystem::submit(JobGroup &group, JobProc proc, void *param) {
+	if (_workers.empty()) {
+		proc(param);
+		return;
+	}
+
+	Job job;
+	job.proc = proc;
+	job.rangeProc = nullptr;
+	job.param = param;
+	job.begin = job.end = 0;
+	job.group = &group;
+	push(job);
+}
+
+void JobSystem::parallelFor(uint begin, uint end, uint grainSize, RangeProc proc, void *param) {
+	if (begin >= end)
+		return;
+
+	// A few chunks per thread even out jobs taking different amounts of time
+	const uint count = end - begin;
+	const uint numChunks = (_workers.size() + 1) * 4;
+	const uint chunkSize = MAX<uint>(MAX<uint>(grainSize, 1), (count + numChunks - 1) / numChunks);
+	if (_workers.empty() || chunkSize >= count) {
+		proc(param, begin, end);
+		return;
+	}
+
+	JobGroup group;
+	for (uint offset = chunkSize; offset < count; offset += chunkSize) {
+		Job job;
+		job.proc = nullptr;
+		job.rangeProc = proc;
+		job.param = param;
+		job.begin = begin + offset;
+		job.end = begin + MIN<uint>(count, offset + chunkSize);
+		job.group = &group;
+		push(job);
+	}
+
+	proc(param, begin, begin + chunkSize);
+	wait(group);
+}
+
+void JobSystem::wait(JobGroup &group) {
+	while (atomicLoad(&group._state)) {
+		Job job;
+		if (!take(nullptr, job))
+			break;
+		run(job);
+	}
+
+	if (!atomicLoad(&group._state))
+		return;
+
+	// The remaining jobs of the group are running on other threads. The last
+	// one to finish posts the semaphore once kWaiting is set.
+	OSystem::SemaphoreRef waiter = 0;
+	{
+		Common::StackLock lock(_mutex);
+		if (!_freeSemaphores.empty()) {
+			waiter = _freeSemaphores.back();
+			_freeSemaphores.pop_back();
+		}
+	}
+
+	if (!waiter)
+		waiter = g_system->createSemaphore(0);
+	group._waiter = waiter;
+
+	for (;;) {
+		const int32 state = atomicLoad(&group._state);
+		if (!state)
+			break;
+
+		if (atomicCompareAndSwap(&group._state, state, state | JobGroup::kWaiting)) {
+			g_system->waitSemaphore(waiter);
+			atomicStore(&group._state, 0);
+			break;
+		}
+	}
+
+	group._waiter = 0;
+
+	Common::StackLock lock(_mutex);
+	_freeSemaphores.push_back(waiter);
+}
+
+void JobSystem::push(const Job &job) {
+	atomicAdd(&job.group->_state, 1);
+
+	const uint first = atomicAdd(&_nextWorker, 1);
+	for (uint i = 0; i < _workers.size(); ++i) {
+		if (pushJob(*_workers[(first + i) % _workers.size()], job)) {
+			g_system->postSemaphore(_work);
+			return;
+		}
+	}
+
+	// The workers have plenty to do already
+	run(job);
+}
+
+bool JobSystem::take(Worker *own, Job &job) {
+	const uint first = own ? own->index : 0;
+	for (uint i = 0; i < _workers.size(); ++i) {
+		if (takeJob(*_workers[(first + i) % _workers.size()], job))
+			return true;
+	}
+
+	return false;
+}
+
+bool JobSystem::pushJob(Worker &worker, const Job &job) {
+	uint32 pos = atomicLoad(&worker.pushPos);
+	for (;;) {
+		Slot &slot = worker.slots[pos & (kQueueSize - 1)];
+		const int32 diff = (int32)(atomicLoad(&slot.sequence) - pos);
+		if (diff < 0) {
+			// The slot still holds the job from one round before, so the
+			// queue is full
+			return false;
+		}
+
+		if (diff == 0 && atomicCompareAndSwap(&worker.pushPos, pos, pos + 1)) {
+			slot.job = job;
+			atomicStore(&slot.sequence, pos + 1);
+			return true;
+		}
+
+		// Another thread pushed in the meantime
+		pos = atomicLoad(&worker.pushPos);
+	}
+}
+
+bool JobSystem::takeJob(Worker &worker, Job &job) {
+	uint32 pos = atomicLoad(&worker.takePos);
+	for (;;) {
+		Slot &slot = worker.slots[pos & (kQueueSize - 1)];
+		const int32 diff = (int32)(atomicLoad(&slot.sequence) - (pos + 1));
+		if (diff < 0) {
+			// The slot was not filled yet, so the queue is empty
+			return false;
+		}
+
+		if (diff == 0 && atomicCompareAndSwap(&worker.takePos, pos, pos + 1)) {
+			job = slot.job;
+			atomicStore(&slot.sequence, pos + kQueueSize);
+			return true;
+		}
+
+		// Another thread took a job in the meantime
+		pos = atomicLoad(&worker.takePos);
+	}
+}
+
+void JobSystem::run(const Job &job) {
+	if (job.rangeProc)
+		job.rangeProc(job.param, job.begin, job.end);
+	else
+		job.proc(job.param);
+
+	// A waiting thread may return and destroy the group once the count
+	// drops to zero, so it must not be touched after the decrement, except
+	// for waking up that thread
+	JobGroup *group = job.group;
+	if (atomicAdd(&group->_state, -1) == JobGroup::kWaiting)
+		g_system->postSemaphore(group->_waiter);
+}
+
+void JobSystem::workerProc(void *param) {
+	Worker *worker = (Worker *)param;
+	worker->owner->runWorker(*worker);
+}
+
+void JobSystem::runWorker(Worker &worker) {
+	for (;;) {
+		g_system->waitSemaphore(_work);
+		if (atomicLoad(&_quit))
+			return;
+
+		// Jobs taken by other workers or waiting threads leave extra posts
+		// behind, which merely wake up a worker with nothing to do
+		Job job;
+		while (take(&worker, job))
+			run(job);
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,165 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_JOBSYSTEM_H
+#define COMMON_JOBSYSTEM_H
+
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+#include "common/system.h"
+
+namespace Common {
+
+/**
+ * Runs short, independent jobs on a pool of worker threads.
+ *
+ * Every worker has its own lock-free queue. Jobs are spread over the queues
+ * when they are submitted, and a worker whose queue is empty steals jobs from
+ * the others. If all queues are full, the submitting thread runs the job
+ * itself. Threads waiting for a group of jobs help running them, so jobs may
+ * submit and wait for other jobs themselves.
+ *
+ * Without worker threads, which is the case on backends not supporting them,
+ * jobs run synchronously when they are submitted. Jobs must therefore never
+ * wait for anything but other jobs.
+ *
+ * Like all worker threads, jobs may only use the mutex, semaphore and
+ * getMillis() methods of OSystem.
+ */
+class JobSystem : NonCopyable {
+public:
+	typedef void (*JobProc)(void *param);
+
+	/** A job handling the elements from begin up to (excluding) end. */
+	typedef void (*RangeProc)(void *param, uint begin, uint end);
+
+	enum {
+		kMaxThreads = 16, ///< Maximum number of worker threads
+		kQueueSize = 256  ///< Number of jobs queued per worker, a power of two
+	};
+
+	/**
+	 * Counts the unfinished jobs submitted with it, so they can be waited
+	 * for. A group may be reused once wait() returned.
+	 */
+	class JobGroup : NonCopyable {
+	public:
+		JobGroup() : _state(0), _waiter(0) {}
+
+	private:
+		friend class JobSystem;
+
+		enum {
+			kWaiting = 0x40000000 ///< Added to _state while a thread waits for the group
+		};
+
+		/** The number of unfinished jobs, plus kWaiting */
+		volatile int32 _state;
+		OSystem::SemaphoreRef _waiter;
+	};
+
+	/**
+	 * @param numThreads	number of worker threads to start, which may be
+	 *						fewer if the backend can not create them.
+	 */
+	explicit JobSystem(uint numThreads);
+
+	/** All groups must have been waited for. */
+	~JobSystem();
+
+	/** Return the number of worker threads, not counting waiting threads. */
+	uint getThreadCount() const { return _workers.size(); }
+
+	/** Run proc(param) on one of the worker threads. */
+	void submit(JobGroup &group, JobProc proc, void *param);
+
+	/** Wait until all jobs of the group have finished, helping with them. */
+	void wait(JobGroup &group);
+
+	/**
+	 * Split the range from begin to end into chunks, and process them in
+	 * parallel. Returns once all of them are done.
+	 *
+	 * @param grainSize	minimum number of elements per chunk, below which
+	 *					splitting up the work does not pay off.
+	 */
+	void parallelFor(uint begin, uint end, uint grainSize, RangeProc proc, void *param);
+
+private:
+	struct Job {
+		JobProc proc;
+		RangeProc rangeProc;
+		void *param;
+		uint begin, end;
+		JobGroup *group;
+	};
+
+	/**
+	 * An entry of a queue. Its sequence number tells whether the job may be
+	 * taken, or the slot may be filled, at the current position of the queue.
+	 */
+	struct Slot {
+		volatile uint32 sequence;
+		Job job;
+	};
+
+	/** A worker thread and its queue of jobs. */
+	struct Worker {
+		JobSystem *owner;
+		OSystem::ThreadRef thread;
+		uint index;
+
+		/** Ring buffer of kQueueSize jobs, filled at pushPos and emptied at takePos */
+		Slot *slots;
+		volatile uint32 pushPos;
+		volatile uint32 takePos;
+	};
+
+	Array<Worker *> _workers;
+
+	/** Signalled once per queued job */
+	OSystem::SemaphoreRef _work;
+
+	volatile uint32 _nextWorker;
+	volatile int32 _quit;
+
+	/** Guards the semaphores below, which are handed to waiting threads */
+	Mutex _mutex;
+	Array<OSystem::SemaphoreRef> _freeSemaphores;
+
+	/** Queue the job, or run it right away if all queues are full. */
+	void push(const Job &job);
+	/** Take a job of the given worker, or else one of any other. */
+	bool take(Worker *own, Job &job);
+	static bool pushJob(Worker &worker, const Job &job);
+	static bool takeJob(Worker &worker, Job &job);
+	void run(const Job &job);
+
+	static void workerProc(void *param);
+	void runWorker(Worker &worker);
+};
+
+} // End of namespace Common
+
+#endif
@@ -23,6 +23,7 @@
 #ifndef COMMON_MEMSTREAM_H
 #define COMMON_MEMSTREAM_H
 
+#include "common/ptr.h"
 #include "common/stream.h"
 #include "common/types.h"
 #include "common/util.h"
@@ -34,7 +35,7 @@ namespace Common {
  * a plain memory block.
  */
 class MemoryReadStream : public SeekableReadStream {
-private:
+protected:
 	const byte * const _ptrOrig;
 	const byte *_ptr;
 	const uint32 _size;
@@ -74,6 +75,28 @@ public:
 };
 
 
+/**
+ * A MemoryReadStream on memory which is shared with other streams, like a
+ * memory mapped file. The memory is released through the SharedPtr once the
+ * last stream on it is gone, so readStream() and createView() can return
+ * streams on the same memory instead of copies.
+ */
+class SharedMemoryReadStream : public MemoryReadStream {
+private:
+	SharedPtr<const byte> _memory;
+
+public:
+	/**
+	 * Wraps dataSize bytes from dataPtr on, which have to lie within the
+	 * memory held by memory.
+	 */
+	SharedMemoryReadStream(const SharedPtr<const byte> &memory, const byte *dataPtr, uint32 dataSize) :
+		MemoryReadStream(dataPtr, dataSize), _memory(memory) {}
+
+	SeekableReadStream *readStream(uint32 dataSize) override;
+	SeekableReadStream *createView(uint32 begin, uint32 size) const override;
+};
+
 /**
  * This is a MemoryReadStream subclass which adds non-endian
  * read methods whose endianness is set on the stream creation.
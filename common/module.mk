@@ -4,6 +4,7 @@ MODULE_OBJS := \
 	archive.o \
 	config-manager.o \
 	coroutines.o \
+	cpudetect.o \
 	dcl.o \
 	debug.o \
 	error.o \
@@ -13,6 +14,7 @@ MODULE_OBJS := \
 	gui_options.o \
 	hashmap.o \
 	iff_container.o \
+	jobsystem.o \
 	ini-file.o \
 	installshield_cab.o \
 	json.o \
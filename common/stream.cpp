@@ -117,6 +117,26 @@ bool MemoryReadStream::seek(int32 offs, int whence) {
 	return true; // FIXME: STREAM REWRITE
 }
 
+SeekableReadStream *SharedMemoryReadStream::readStream(uint32 dataSize) {
+	// Read at most as many bytes as are still available...
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+	SeekableReadStream *view = new SharedMemoryReadStream(_memory, _ptr, dataSize);
+
+	_ptr += dataSize;
+	_pos += dataSize;
+
+	return view;
+}
+
+SeekableReadStream *SharedMemoryReadStream::createView(uint32 begin, uint32 size) const {
+	if (begin > _size || size > _size - begin)
+		return nullptr;
+	return new SharedMemoryReadStream(_memory, _ptrOrig + begin, size);
+}
+
 #pragma mark -
 
 enum {
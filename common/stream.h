@@ -547,8 +547,11 @@ public:
 	 * if reading more failed, because of an I/O error or because
 	 * the end of the stream was reached. Which can be determined by
 	 * calling err() and eos().
+	 *
+	 * Streams on memory which is shared with other streams, like memory
+	 * mapped files, return a stream on the same memory instead of a copy.
 	 */
-	SeekableReadStream *readStream(uint32 dataSize);
+	virtual SeekableReadStream *readStream(uint32 dataSize);
 
 	/**
 	 * Read stream in Pascal format, that is, one byte is
@@ -608,6 +611,19 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Creates a stream on the given part of this stream, which reads from
+	 * the same memory instead of a copy of it. The new stream stays valid
+	 * after this stream is deleted. Only streams on shared memory, like
+	 * memory mapped files, support this.
+	 *
+	 * @param begin	start of the part, independent of the current position
+	 * @param size	size of the part in bytes
+	 * @return the new stream, or nullptr if this stream does not support views
+	 *         or the part does not lie within the stream
+	 */
+	virtual SeekableReadStream *createView(uint32 begin, uint32 size) const { return nullptr; }
+
 	/**
 	 * Reads at most one less than the number of characters specified
 	 * by bufSize from the and stores them in the string buf. Reading
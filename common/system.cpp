@@ -25,6 +25,7 @@
 #include "common/system.h"
 #include "common/events.h"
 #include "common/fs.h"
+#include "common/jobsystem.h"
 #include "common/savefile.h"
 #include "common/str.h"
 #include "common/taskbar.h"
@@ -58,6 +59,7 @@ OSystem::OSystem() {
 #endif
 	_fsFactory = nullptr;
 	_backendInitialized = false;
+	_jobSystem = nullptr;
 }
 
 OSystem::~OSystem() {
@@ -122,11 +124,27 @@ void OSystem::initBackend() {
 }
 
 void OSystem::destroy() {
+	// Without worker threads, nothing is left running on the job system
+	if (_jobSystem && !_jobSystem->getThreadCount())
+		destroyJobSystem();
+
 	_backendInitialized = false;
 	Common::String::releaseMemoryPoolMutex();
 	delete this;
 }
 
+Common::JobSystem &OSystem::getJobSystem() {
+	// The thread waiting for jobs runs them as well, so it counts as a core
+	if (!_jobSystem)
+		_jobSystem = new Common::JobSystem(CLIP<uint>(getCPUCount(), 1, Common::JobSystem::kMaxThreads + 1) - 1);
+	return *_jobSystem;
+}
+
+void OSystem::destroyJobSystem() {
+	delete _jobSystem;
+	_jobSystem = nullptr;
+}
+
 bool OSystem::setGraphicsMode(const char *name) {
 	if (!name)
 		return false;
@@ -63,6 +63,7 @@ class HardwareInputSet;
 class Keymap;
 class KeymapperDefaultBindings;
 class Encoding;
+class JobSystem;
 
 typedef Array<Keymap *> KeymapArray;
 }
@@ -233,6 +234,21 @@ private:
 	 */
 	bool _backendInitialized;
 
+	/**
+	 * The job system, created on demand. See destroyJobSystem().
+	 */
+	Common::JobSystem *_jobSystem;
+
+protected:
+	/**
+	 * Delete the job system. The mixer and audio streams keep submitting
+	 * jobs until they are deleted, so backends supporting threads have to
+	 * call this from their destructor, after deleting the mixer and before
+	 * tearing down their thread support. Otherwise, destroy() takes care of
+	 * it.
+	 */
+	void destroyJobSystem();
+
 	//@}
 
 public:
@@ -1227,6 +1243,83 @@ public:
 
 
 
+	/**
+	 * @name Worker threads
+	 * Backends may optionally allow creating worker threads, which are used
+	 * to spread CPU heavy work (e.g. audio rendering) over several cores.
+	 * Code using them must always provide a synchronous fallback, since
+	 * backends without thread support keep the default implementations,
+	 * which refuse to create threads and semaphores.
+	 *
+	 * Worker threads must not call any OSystem method except the mutex,
+	 * semaphore and getMillis() ones.
+	 */
+	//@{
+
+	typedef struct OpaqueThread *ThreadRef;
+	typedef struct OpaqueSemaphore *SemaphoreRef;
+	typedef void (*ThreadProc)(void *param);
+
+	/**
+	 * Create a new thread running proc(param).
+	 * @param proc	the function to run in the new thread.
+	 * @param param	user data passed to proc.
+	 * @param name	name of the thread, used for debugging purposes.
+	 * @return the newly created thread, or 0 if threads are not supported
+	 *         or an error occurred.
+	 */
+	virtual ThreadRef createThread(ThreadProc proc, void *param, const char *name) { return 0; }
+
+	/**
+	 * Wait until the given thread has finished and free its resources.
+	 * @param thread	the thread to wait for.
+	 */
+	virtual void joinThread(ThreadRef thread) {}
+
+	/**
+	 * Create a new counting semaphore.
+	 * @param value	the initial value of the semaphore.
+	 * @return the newly created semaphore, or 0 if not supported.
+	 */
+	virtual SemaphoreRef createSemaphore(uint value) { return 0; }
+
+	/**
+	 * Wait until the value of the semaphore is positive, then decrement it.
+	 * @param sem	the semaphore to wait on.
+	 */
+	virtual void waitSemaphore(SemaphoreRef sem) {}
+
+	/**
+	 * Increment the value of the semaphore, waking up a waiting thread.
+	 * @param sem	the semaphore to post.
+	 */
+	virtual void postSemaphore(SemaphoreRef sem) {}
+
+	/**
+	 * Delete the given semaphore. No thread may be waiting on it.
+	 * @param sem	the semaphore to delete.
+	 */
+	virtual void deleteSemaphore(SemaphoreRef sem) {}
+
+	/**
+	 * Return the number of CPU cores available to the process, which is
+	 * a hint for the number of worker threads worth creating.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
+	/**
+	 * Return the shared job system, which spreads short jobs over one
+	 * worker thread per additional CPU core. On backends without thread
+	 * support, it runs the jobs synchronously. The job system is created
+	 * on the first call, which must happen on the main thread, and
+	 * destroyed when the backend shuts down.
+	 */
+	Common::JobSystem &getJobSystem();
+
+	//@}
+
+
+
 	/** @name Sound */
 	//@{
 
@@ -109,6 +109,10 @@ typedef struct {
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/mutex.h"
+#include "common/textconsole.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
@@ -1419,9 +1423,344 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+/**
+ * The stream of a ZIP file, shared by the archive and the streams of its
+ * open members. Every read seeks first, so members can be read
+ * independently of each other, even from several threads, and the stream
+ * is only deleted together with its last user.
+ */
+class ZipSource {
+public:
+	ZipSource(SeekableReadStream *stream) : _stream(stream), _refCount(1) {}
+
+	void incRef() {
+		atomicAdd(&_refCount, 1);
+	}
+
+	void decRef() {
+		if (atomicAdd(&_refCount, -1) == 0)
+			delete this;
+	}
+
+	/** Guards the stream, also for the unz functions of the archive */
+	Mutex &getMutex() { return _mutex; }
+
+	/**
+	 * Read data from the given position of the ZIP file.
+	 *
+	 * @return the number of bytes read
+	 */
+	uint32 readAt(uint32 offset, void *dataPtr, uint32 dataSize) {
+		StackLock lock(_mutex);
+		_stream->clearErr();
+		if (!_stream->seek(offset, SEEK_SET))
+			return 0;
+		return _stream->read(dataPtr, dataSize);
+	}
+
+	/**
+	 * Create a stream on the given part of the ZIP file which shares its
+	 * memory, if the ZIP file is memory mapped.
+	 *
+	 * @return the new stream, or nullptr if the ZIP file does not support views
+	 */
+	SeekableReadStream *createView(uint32 offset, uint32 dataSize) {
+		StackLock lock(_mutex);
+		return _stream->createView(offset, dataSize);
+	}
+
+private:
+	~ZipSource() {
+		delete _stream;
+	}
+
+	SeekableReadStream *_stream;
+	Mutex _mutex;
+	volatile int32 _refCount;
+};
+
+/**
+ * A stored member, read straight from the ZIP file into the buffers of the
+ * caller. The CRC is checked once the member was read up to its end.
+ */
+class ZipStoredReadStream : public SeekableReadStream {
+public:
+	ZipStoredReadStream(ZipSource *source, uint32 begin, uint32 size, uint32 crc)
+		: _source(source), _begin(begin), _size(size), _expectedCrc(crc), _pos(0), _crc(0), _crcPos(0), _eos(false), _err(false) {
+		_source->incRef();
+	}
+
+	~ZipStoredReadStream() {
+		_source->decRef();
+	}
+
+	virtual bool err() const { return _err; }
+	virtual void clearErr() { _eos = false; _err = false; }
+	virtual bool eos() const { return _eos; }
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize) {
+		if (dataSize > _size - _pos) {
+			dataSize = _size - _pos;
+			_eos = true;
+		}
+
+		const uint32 start = _pos;
+		const uint32 read = _source->readAt(_begin + _pos, dataPtr, dataSize);
+		if (read != dataSize)
+			_err = true;
+		_pos += read;
+
+#ifdef USE_ZLIB
+		// The CRC covers the data read without gaps from the start on
+		if (start <= _crcPos && _pos > _crcPos) {
+			_crc = crc32(_crc, (const byte *)dataPtr + (_crcPos - start), _pos - _crcPos);
+			_crcPos = _pos;
+			if (_crcPos == _size && _crc != _expectedCrc) {
+				warning("ZipStoredReadStream: CRC mismatch");
+				_err = true;
+			}
+		}
+#endif
+
+		return read;
+	}
+
+	virtual int32 pos() const { return _pos; }
+	virtual int32 size() const { return _size; }
+
+	virtual bool seek(int32 offset, int whence = SEEK_SET) {
+		if (whence == SEEK_CUR)
+			offset += _pos;
+		else if (whence == SEEK_END)
+			offset += _size;
+
+		if (offset < 0 || (uint32)offset > _size)
+			return false;
+
+		_pos = offset;
+		_eos = false;
+		return true;
+	}
+
+private:
+	ZipSource *_source;
+	const uint32 _begin;
+	const uint32 _size;
+	const uint32 _expectedCrc;
+	uint32 _pos;
+	uint32 _crc;
+	uint32 _crcPos;
+	bool _eos;
+	bool _err;
+};
+
+#ifdef USE_ZLIB
+
+/**
+ * Check the CRC of a whole stream, and rewind it.
+ */
+static bool checkCrc(SeekableReadStream *stream, uint32 expectedCrc) {
+	byte buffer[4096];
+	uint32 crc = 0;
+	uint32 read;
+	while ((read = stream->read(buffer, sizeof(buffer))) != 0)
+		crc = crc32(crc, buffer, read);
+
+	return !stream->err() && stream->seek(0) && crc == expectedCrc;
+}
+
+/**
+ * A deflated member, inflated as it is read. To seek backwards, inflation
+ * restarts from the nearest of the checkpoints taken while passing through
+ * the member for the first time.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+public:
+	ZipInflateReadStream(ZipSource *source, uint32 begin, uint32 compressedSize, uint32 size, uint32 crc)
+		: _source(source), _begin(begin), _compressedSize(compressedSize), _size(size), _expectedCrc(crc),
+		  _compressedPos(0), _pos(0), _crc(0), _eos(false), _err(false) {
+		_source->incRef();
+
+		_checkpointInterval = MAX<uint32>(kMinCheckpointInterval, _size / kMaxCheckpoints + 1);
+
+		memset(&_stream, 0, sizeof(_stream));
+		_initialized = (inflateInit2(&_stream, -MAX_WBITS) == Z_OK);
+		if (!_initialized)
+			_err = true;
+	}
+
+	~ZipInflateReadStream() {
+		for (uint i = 0; i < _checkpoints.size(); ++i) {
+			inflateEnd(&_checkpoints[i]->stream);
+			delete _checkpoints[i];
+		}
+		if (_initialized)
+			inflateEnd(&_stream);
+		_source->decRef();
+	}
+
+	virtual bool err() const { return _err; }
+	virtual void clearErr() { _eos = false; }
+	virtual bool eos() const { return _eos; }
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize) {
+		if (dataSize > _size - _pos) {
+			dataSize = _size - _pos;
+			_eos = true;
+		}
+
+		return inflateTo((byte *)dataPtr, dataSize);
+	}
+
+	virtual int32 pos() const { return _pos; }
+	virtual int32 size() const { return _size; }
+
+	virtual bool seek(int32 offset, int whence = SEEK_SET) {
+		if (whence == SEEK_CUR)
+			offset += _pos;
+		else if (whence == SEEK_END)
+			offset += _size;
+
+		if (offset < 0 || (uint32)offset > _size || _err)
+			return false;
+
+		if ((uint32)offset < _pos && !restart(offset))
+			return false;
+
+		byte skipBuffer[1024];
+		while (!_err && _pos < (uint32)offset)
+			inflateTo(skipBuffer, MIN<uint32>(sizeof(skipBuffer), offset - _pos));
+
+		_eos = false;
+		return !_err;
+	}
+
+private:
+	enum {
+		kInputBufferSize = 16384,
+		/** Minimum distance between checkpoints, each one takes ~40 KB */
+		kMinCheckpointInterval = 256 * 1024,
+		kMaxCheckpoints = 32
+	};
+
+	struct Checkpoint {
+		z_stream stream;
+		uint32 compressedPos;
+		uint32 pos;
+		uint32 crc;
+	};
+
+	uint32 inflateTo(byte *dst, uint32 dataSize) {
+		_stream.next_out = dst;
+		_stream.avail_out = dataSize;
+
+		while (_stream.avail_out && !_err) {
+			if (!_stream.avail_in && _compressedPos < _compressedSize) {
+				const uint32 toRead = MIN<uint32>(kInputBufferSize, _compressedSize - _compressedPos);
+				if (_source->readAt(_begin + _compressedPos, _inputBuffer, toRead) != toRead) {
+					_err = true;
+					break;
+				}
+				_compressedPos += toRead;
+				_stream.next_in = _inputBuffer;
+				_stream.avail_in = toRead;
+			}
+
+			byte *const out = _stream.next_out;
+			const int result = inflate(&_stream, Z_SYNC_FLUSH);
+			const uint32 produced = _stream.next_out - out;
+			_crc = crc32(_crc, out, produced);
+			_pos += produced;
+
+			if ((result != Z_OK && result != Z_STREAM_END) || (!produced && !_stream.avail_in && _compressedPos == _compressedSize)) {
+				// Corrupt or truncated data
+				_err = true;
+				break;
+			}
+
+			if (_pos >= (_checkpoints.size() + 1) * _checkpointInterval && _pos < _size)
+				addCheckpoint();
+		}
+
+		if (_pos == _size && _crc != _expectedCrc && !_err) {
+			warning("ZipInflateReadStream: CRC mismatch");
+			_err = true;
+		}
+
+		return dataSize - _stream.avail_out;
+	}
+
+	void addCheckpoint() {
+		// The inflate state refers back to its z_stream, which must not move
+		Checkpoint *checkpoint = new Checkpoint;
+		if (inflateCopy(&checkpoint->stream, &_stream) != Z_OK) {
+			delete checkpoint;
+			return;
+		}
+
+		// Compressed data already in the input buffer is read again
+		checkpoint->compressedPos = _compressedPos - _stream.avail_in;
+		checkpoint->pos = _pos;
+		checkpoint->crc = _crc;
+		_checkpoints.push_back(checkpoint);
+	}
+
+	bool restart(uint32 offset) {
+		int checkpoint = _checkpoints.size() - 1;
+		while (checkpoint >= 0 && _checkpoints[checkpoint]->pos > offset)
+			--checkpoint;
+
+		inflateEnd(&_stream);
+		if (checkpoint >= 0) {
+			Checkpoint &start = *_checkpoints[checkpoint];
+			_initialized = (inflateCopy(&_stream, &start.stream) == Z_OK);
+			_compressedPos = start.compressedPos;
+			_pos = start.pos;
+			_crc = start.crc;
+		} else {
+			memset(&_stream, 0, sizeof(_stream));
+			_initialized = (inflateInit2(&_stream, -MAX_WBITS) == Z_OK);
+			_compressedPos = 0;
+			_pos = 0;
+			_crc = 0;
+		}
+
+		_stream.next_in = _inputBuffer;
+		_stream.avail_in = 0;
+		if (!_initialized)
+			_err = true;
+		return _initialized;
+	}
+
+	ZipSource *_source;
+	const uint32 _begin;
+	const uint32 _compressedSize;
+	const uint32 _size;
+	const uint32 _expectedCrc;
+
+	z_stream _stream;
+	bool _initialized;
+	byte _inputBuffer[kInputBufferSize];
+	uint32 _compressedPos;
+	uint32 _pos;
+	uint32 _crc;
+	bool _eos;
+	bool _err;
+
+	uint32 _checkpointInterval;
+	Array<Checkpoint *> _checkpoints;
+};
+
+#endif
 
 class ZipArchive : public Archive {
+	enum {
+		/** Deflated members up to this size are inflated when opened */
+		kMaxInflatedMemberSize = 64 * 1024
+	};
+
 	unzFile _zipFile;
+	ZipSource *_source;
 
 public:
 	ZipArchive(unzFile zipFile);
@@ -1455,13 +1794,19 @@ public:
 
 ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
 	assert(_zipFile);
+	_source = new ZipSource(((unz_s *)_zipFile)->_stream);
 }
 
 ZipArchive::~ZipArchive() {
+	// The stream of the ZIP file stays alive as long as members are open
+	((unz_s *)_zipFile)->_stream = nullptr;
 	unzClose(_zipFile);
+	_source->decRef();
 }
 
 bool ZipArchive::hasFile(const String &name) const {
+	// Locating a file changes the current file of _zipFile
+	StackLock lock(_source->getMutex());
 	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
 }
 
@@ -1479,6 +1824,7 @@ int ZipArchive::listMembers(ArchiveMemberList &list) const {
 }
 
 const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
+	// Goes through hasFile(), which takes the lock of the ZIP file
 	if (!hasFile(name))
 		return ArchiveMemberPtr();
 
@@ -1486,20 +1832,54 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 }
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	// Open members read from the stream of the ZIP file as well
+	StackLock lock(_source->getMutex());
+
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return nullptr;
 
-	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
+	unz_s *s = (unz_s *)_zipFile;
+	const unz_file_info &fileInfo = s->cur_file_info;
+
+	uInt localHeaderSize;
+	uLong extraFieldOffset;
+	uInt extraFieldSize;
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &localHeaderSize, &extraFieldOffset, &extraFieldSize) != UNZ_OK)
 		return nullptr;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+	const uint32 begin = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + localHeaderSize + s->byte_before_the_zipfile;
+
+	if (fileInfo.compression_method == 0) {
+		// Stored members of mapped ZIP files are read straight from the
+		// mapping, so their CRC is checked up front
+		SeekableReadStream *view = _source->createView(begin, fileInfo.uncompressed_size);
+#ifdef USE_ZLIB
+		if (view && !checkCrc(view, fileInfo.crc)) {
+			warning("ZipArchive: CRC mismatch in '%s'", name.c_str());
+			delete view;
+			return nullptr;
+		}
+#endif
+		if (view)
+			return view;
+		return new ZipStoredReadStream(_source, begin, fileInfo.uncompressed_size, fileInfo.crc);
+	}
+
+#ifdef USE_ZLIB
+	// Small members are inflated right away, which takes less memory than
+	// keeping the inflate state around
+	if (fileInfo.compression_method == Z_DEFLATED && fileInfo.uncompressed_size > kMaxInflatedMemberSize)
+		return new ZipInflateReadStream(_source, begin, fileInfo.compressed_size, fileInfo.uncompressed_size, fileInfo.crc);
+#endif
+
+	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return nullptr;
 
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
 	assert(buffer);
 
 	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
+		unzCloseCurrentFile(_zipFile);
 		free(buffer);
 		return nullptr;
 	}
@@ -1510,18 +1890,17 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	}
 
 	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
-
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
 }
 
-Archive *makeZipArchive(const String &name) {
+Archive *makeZipArchive(const String &name, bool mapped) {
+	if (mapped)
+		return makeZipArchive(SearchMan.createMappedReadStreamForMember(name));
 	return makeZipArchive(SearchMan.createReadStreamForMember(name));
 }
 
-Archive *makeZipArchive(const FSNode &node) {
+Archive *makeZipArchive(const FSNode &node, bool mapped) {
+	if (mapped)
+		return makeZipArchive(node.createMappedReadStream());
 	return makeZipArchive(node.createReadStream());
 }
 
@@ -35,17 +35,27 @@ class SeekableReadStream;
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * If mapped is true, the file is memory-mapped and stored members are handed
+ * out as views into the mapping instead of being copied. Only use this for
+ * files which are not modified while the archive is open: a file truncated
+ * behind a mapping faults on access instead of failing with a stream error.
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const String &name);
+Archive *makeZipArchive(const String &name, bool mapped = false);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * If mapped is true, the file is memory-mapped and stored members are handed
+ * out as views into the mapping instead of being copied. Only use this for
+ * files which are not modified while the archive is open: a file truncated
+ * behind a mapping faults on access instead of failing with a stream error.
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const FSNode &node);
+Archive *makeZipArchive(const FSNode &node, bool mapped = false);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
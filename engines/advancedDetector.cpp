@@ -33,6 +33,7 @@
 #include "gui/gui-manager.h"
 #include "gui/message.h"
 #include "engines/advancedDetector.h"
+#include "engines/detectioncache.h"
 #include "engines/obsolete.h"
 
 static Common::String sanitizeName(const char *name) {
@@ -193,6 +194,33 @@ DetectedGames AdvancedMetaEngine::detectGames(const Common::FSList &fslist) cons
 	return detectedGames;
 }
 
+void AdvancedMetaEngine::prepareDetection(const Common::FSList &fslist) const {
+	FileMap allFiles;
+
+	if (fslist.empty())
+		return;
+
+	composeFileHashMap(allFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
+
+	// Compute the properties of the same files detectGame() looks at, which
+	// puts them into the DetectionCache.
+	const Common::FSNode parent = fslist.begin()->getParent();
+	FilePropertiesMap filesProps;
+
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			Common::String fname = fileDesc->fileName;
+
+			if (filesProps.contains(fname))
+				continue;
+
+			getFileProperties(parent, allFiles, *g, fname, filesProps[fname]);
+		}
+	}
+}
+
 const ExtraGuiOptions AdvancedMetaEngine::getExtraGuiOptions(const Common::String &target) const {
 	if (!_extraGuiOptions)
 		return ExtraGuiOptions();
@@ -364,6 +392,12 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	// file and as one with resource fork.
 
 	if (game.flags & ADGF_MACRESFORK) {
+		// The resource fork may live in a separate file. The cache entry is
+		// tied to the data fork, so it is only used when that one exists.
+		const Common::FSNode node = parent.getChild(fname);
+		if (node.exists() && DetCache.lookup(node, _md5Bytes, true, fileProps))
+			return true;
+
 		Common::MacResManager macResMan;
 
 		if (!macResMan.open(parent, fname))
@@ -372,13 +406,18 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 		fileProps.md5 = macResMan.computeResForkMD5AsString(_md5Bytes);
 		fileProps.size = macResMan.getResForkDataSize();
 
-		if (fileProps.size != 0)
+		if (fileProps.size != 0) {
+			DetCache.store(node, _md5Bytes, true, fileProps);
 			return true;
+		}
 	}
 
 	if (!allFiles.contains(fname))
 		return false;
 
+	if (DetCache.lookup(allFiles[fname], _md5Bytes, false, fileProps))
+		return true;
+
 	Common::File testFile;
 
 	if (!testFile.open(allFiles[fname]))
@@ -386,6 +425,7 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 
 	fileProps.size = (int32)testFile.size();
 	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
+	DetCache.store(allFiles[fname], _md5Bytes, false, fileProps);
 	return true;
 }
 
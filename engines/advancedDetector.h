@@ -258,6 +258,8 @@ public:
 
 	DetectedGames detectGames(const Common::FSList &fslist) const override;
 
+	void prepareDetection(const Common::FSList &fslist) const override;
+
 	virtual Common::Error createInstance(OSystem *syst, Engine **engine) const override;
 
 	virtual const ExtraGuiOptions getExtraGuiOptions(const Common::String &target) const override;
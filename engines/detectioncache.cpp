@@ -0,0 +1,252 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/detectioncache.h"
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/fs.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+namespace Common {
+DECLARE_SINGLETON(DetectionCache);
+}
+
+static const char *const kCacheFileName = "scummvm-detection.cache";
+static const char *const kCacheHeader = "ScummVM detection cache 2";
+
+DetectionCache::DetectionCache() : _loaded(false), _enabled(false), _dirty(false), _lastFlush(0), _hits(0), _misses(0) {
+}
+
+DetectionCache::~DetectionCache() {
+	flush();
+}
+
+bool DetectionCache::isEnabled() {
+	Common::StackLock lock(_mutex);
+	load();
+	return _enabled;
+}
+
+Common::FSNode DetectionCache::getCacheFile() {
+	// The detection code runs for command line commands before the backend
+	// (and so the savefile manager) is set up, so the cache lives next to
+	// the config file instead.
+	Common::String path = ConfMan.getCustomConfigFileName();
+	if (path.empty())
+		path = g_system->getDefaultConfigFileName();
+
+	const char *end = path.c_str() + path.size();
+	while (end != path.c_str() && end[-1] != '/' && end[-1] != '\\')
+		--end;
+
+	return Common::FSNode(Common::String(path.c_str(), end) + kCacheFileName);
+}
+
+Common::String DetectionCache::makeKey(const Common::String &path, uint md5Bytes, bool resFork) {
+	// The path goes last, so it may contain any character but a newline
+	return Common::String::format("%u\t%d\t%s", md5Bytes, resFork ? 1 : 0, path.c_str());
+}
+
+const char *DetectionCache::getKeyPath(const Common::String &key) {
+	const char *path = strchr(key.c_str(), '\t');
+	path = path ? strchr(path + 1, '\t') : nullptr;
+	return path ? path + 1 : key.c_str() + key.size();
+}
+
+Common::String DetectionCache::getDirectory(const char *path, const char *end) {
+	// Strip the trailing separators of a directory path, then the last
+	// component of a file path
+	while (end != path && (end[-1] == '/' || end[-1] == '\\'))
+		--end;
+	return Common::String(path, end);
+}
+
+Common::String DetectionCache::getParentDirectory(const char *path) {
+	const char *end = path + strlen(path);
+	while (end != path && end[-1] != '/' && end[-1] != '\\')
+		--end;
+	return getDirectory(path, end);
+}
+
+bool DetectionCache::lookup(const Common::FSNode &node, uint md5Bytes, bool resFork, FileProperties &fileProps) {
+	Common::StackLock lock(_mutex);
+	load();
+	if (!_enabled)
+		return false;
+
+	uint32 fileSize = 0;
+	const uint32 mtime = node.getModificationTime(&fileSize);
+	if (mtime) {
+		EntryMap::const_iterator entry = _entries.find(makeKey(node.getPath(), md5Bytes, resFork));
+		if (entry != _entries.end() && entry->_value.mtime == mtime && entry->_value.fileSize == fileSize) {
+			// Copy the checksum, so no String data is shared between threads
+			fileProps.size = entry->_value.props.size;
+			fileProps.md5 = Common::String(entry->_value.props.md5.c_str());
+			_hits++;
+			return true;
+		}
+	}
+
+	_misses++;
+	return false;
+}
+
+void DetectionCache::store(const Common::FSNode &node, uint md5Bytes, bool resFork, const FileProperties &fileProps) {
+	Common::StackLock lock(_mutex);
+	load();
+	if (!_enabled)
+		return;
+
+	uint32 fileSize = 0;
+	const uint32 mtime = node.getModificationTime(&fileSize);
+	if (!mtime)
+		return;
+
+	const Common::String path = node.getPath();
+	if (path.contains('\n'))
+		return;
+
+	_directories[getParentDirectory(path.c_str())] = true;
+
+	Entry &entry = _entries[makeKey(path, md5Bytes, resFork)];
+	entry.mtime = mtime;
+	entry.fileSize = fileSize;
+	entry.props.size = fileProps.size;
+	entry.props.md5 = Common::String(fileProps.md5.c_str());
+	_dirty = true;
+}
+
+void DetectionCache::prune(const Common::FSNode &dir, const Common::FSList &files) {
+	Common::StackLock lock(_mutex);
+	if (!_loaded || !_enabled)
+		return;
+
+	const Common::String dirPath = dir.getPath();
+	const Common::String dirName = getDirectory(dirPath.c_str(), dirPath.c_str() + dirPath.size());
+	if (!_directories.contains(dirName))
+		return;
+
+	Common::HashMap<Common::String, bool> present;
+	for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file)
+		present[file->getPath()] = true;
+
+	Common::Array<Common::String> stale;
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		const char *path = getKeyPath(i->_key);
+		if (present.contains(path))
+			continue;
+
+		if (getParentDirectory(path) == dirName)
+			stale.push_back(i->_key);
+	}
+
+	for (uint i = 0; i < stale.size(); ++i)
+		_entries.erase(stale[i]);
+
+	if (!stale.empty()) {
+		debug(2, "DetectionCache: Dropped %d entries of '%s'", stale.size(), dirPath.c_str());
+		_dirty = true;
+	}
+}
+
+void DetectionCache::load() {
+	if (_loaded)
+		return;
+	_loaded = true;
+
+	_enabled = ConfMan.getBool("detection_cache");
+	if (!_enabled)
+		return;
+
+	const Common::FSNode node = getCacheFile();
+	if (!node.exists())
+		return;
+
+	Common::SeekableReadStream *file = node.createReadStream();
+	if (!file)
+		return;
+
+	if (file->readLine() != kCacheHeader) {
+		debug(2, "DetectionCache: Ignoring '%s' with an unknown format", kCacheFileName);
+		delete file;
+		return;
+	}
+
+	// Every line holds the modification time and size of a file, the size
+	// and MD5 computed by the detector, and the key, separated by tabs.
+	while (!file->eos() && !file->err()) {
+		const Common::String line = file->readLine();
+		const char *mtime = line.c_str();
+		const char *fileSize = strchr(mtime, '\t');
+		const char *size = fileSize ? strchr(fileSize + 1, '\t') : nullptr;
+		const char *md5 = size ? strchr(size + 1, '\t') : nullptr;
+		const char *key = md5 ? strchr(md5 + 1, '\t') : nullptr;
+		if (!key)
+			continue;
+
+		const Common::String keyString(key + 1);
+		_directories[getParentDirectory(getKeyPath(keyString))] = true;
+
+		Entry &entry = _entries[keyString];
+		entry.mtime = strtoul(mtime, nullptr, 10);
+		entry.fileSize = strtoul(fileSize + 1, nullptr, 10);
+		entry.props.size = strtol(size + 1, nullptr, 10);
+		entry.props.md5 = Common::String(md5 + 1, key);
+	}
+
+	debug(2, "DetectionCache: Loaded %d entries", _entries.size());
+	delete file;
+}
+
+void DetectionCache::flush(bool force) {
+	Common::StackLock lock(_mutex);
+	if (!_dirty)
+		return;
+
+	const uint32 now = g_system->getMillis();
+	if (!force && now - _lastFlush < kFlushInterval)
+		return;
+
+	Common::WriteStream *file = getCacheFile().createWriteStream();
+	if (!file) {
+		warning("DetectionCache: Could not write '%s'", kCacheFileName);
+		return;
+	}
+
+	file->writeString(kCacheHeader);
+	file->writeByte('\n');
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		file->writeString(Common::String::format("%u\t%u\t%d\t%s\t", i->_value.mtime, i->_value.fileSize, i->_value.props.size, i->_value.props.md5.c_str()));
+		file->writeString(i->_key);
+		file->writeByte('\n');
+	}
+
+	file->finalize();
+	if (file->err())
+		warning("DetectionCache: Could not write '%s'", kCacheFileName);
+	delete file;
+
+	_dirty = false;
+	_lastFlush = now;
+}
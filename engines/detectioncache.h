@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_DETECTIONCACHE_H
+#define ENGINES_DETECTIONCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+#include "engines/game.h"
+
+namespace Common {
+class FSNode;
+class FSList;
+}
+
+/**
+ * Persistent cache of the file properties computed during game detection.
+ *
+ * Computing the MD5 checksums of the candidate files of every engine is
+ * the slowest part of detecting games, especially on network shares. This
+ * cache keeps the results across runs, in a file next to the config file.
+ * Entries are keyed by the path of the file, the number of checksummed
+ * bytes and whether the resource fork was checksummed. They are discarded
+ * as soon as the modification time or the size of the file changes, and
+ * entries of files which disappeared are dropped when their directory is
+ * scanned again.
+ *
+ * Files on backends which do not report modification times are never
+ * cached. The cache can be turned off with the detection_cache setting.
+ *
+ * lookup() and store() may be called from several threads at once, see
+ * MetaEngine::prepareDetection().
+ */
+class DetectionCache : public Common::Singleton<DetectionCache> {
+public:
+	DetectionCache();
+	~DetectionCache();
+
+	/**
+	 * Check whether the cache is in use. The first call reads the setting
+	 * and the cache file, so it has to happen on the main thread.
+	 */
+	bool isEnabled();
+
+	/**
+	 * Look up the properties of a file.
+	 *
+	 * @return true if fileProps was filled from the cache, false if the
+	 *         properties have to be computed
+	 */
+	bool lookup(const Common::FSNode &node, uint md5Bytes, bool resFork, FileProperties &fileProps);
+
+	/** Remember the properties computed for a file. */
+	void store(const Common::FSNode &node, uint md5Bytes, bool resFork, const FileProperties &fileProps);
+
+	/**
+	 * Drop the entries of the files which are no longer in a directory.
+	 * Does nothing until the cache was loaded by isEnabled() or lookup().
+	 *
+	 * @param dir	the directory
+	 * @param files	the current contents of the directory
+	 */
+	void prune(const Common::FSNode &dir, const Common::FSList &files);
+
+	/**
+	 * Write the cache to disk, if it changed.
+	 *
+	 * @param force	if false, the cache is only written if the last write was
+	 *              a while ago, so scanning many directories does not rewrite
+	 *              it for each of them
+	 */
+	void flush(bool force = true);
+
+	/** Number of lookups answered from the cache since startup. */
+	uint getHits() const { return _hits; }
+
+	/** Number of lookups which required computing the properties since startup. */
+	uint getMisses() const { return _misses; }
+
+private:
+	struct Entry {
+		uint32 mtime;
+		uint32 fileSize;	///< lower 32 bits of the size of the file on disk
+		FileProperties props;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+	typedef Common::HashMap<Common::String, bool> DirectoryMap;
+
+	enum {
+		kFlushInterval = 10000
+	};
+
+	static Common::FSNode getCacheFile();
+	void load();
+	static Common::String makeKey(const Common::String &path, uint md5Bytes, bool resFork);
+	static const char *getKeyPath(const Common::String &key);
+	static Common::String getDirectory(const char *path, const char *end);
+	static Common::String getParentDirectory(const char *path);
+
+	Common::Mutex _mutex;
+	EntryMap _entries;
+	/** The directories which hold files with entries, so prune() can skip the others quickly */
+	DirectoryMap _directories;
+	bool _loaded;
+	bool _enabled;
+	bool _dirty;
+	uint32 _lastFlush;
+	uint _hits;
+	uint _misses;
+};
+
+/** Shortcut for accessing the detection cache. */
+#define DetCache DetectionCache::instance()
+
+#endif
@@ -0,0 +1,219 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/detectionscanner.h"
+#include "engines/detectioncache.h"
+#include "engines/metaengine.h"
+
+#include "base/plugins.h"
+
+#include "common/util.h"
+
+// The reference counts of FSNode and String are not thread-safe. All nodes
+// are therefore created by the thread which lists them, and a listing is
+// only touched by one thread at a time: the lister, then a job, then the
+// caller of next(). Directories to descend into are recreated with
+// getChild() instead of being copied from the listing.
+
+DetectionScanner::DetectionScanner(const Common::FSNode &root, bool recursive)
+	: _recursive(recursive), _lister(0), _jobSystem(nullptr), _space(0), _ready(0),
+	  _listingDone(false), _quit(false) {
+
+	// A node which does not share any data with the one of the caller
+	_root = Common::FSNode(Common::String(root.getPath().c_str()));
+
+	_space = g_system->createSemaphore(kMaxListingsAhead);
+	_ready = g_system->createSemaphore(0);
+
+	// Load the cache here, as the listings prune it from the lister thread
+	DetCache.isEnabled();
+
+	// Preparing the detection only pays off when the results are cached.
+	// Plugins which are loaded one at a time can not be used from several
+	// threads either. Without worker threads, the jobs run on the lister,
+	// which still overlaps them with the detection.
+#if !(defined(UNCACHED_PLUGINS) && defined(DYNAMIC_MODULES))
+	if (_space && _ready && DetCache.isEnabled()) {
+		const PluginList &plugins = EngineMan.getPlugins();
+		for (PluginList::const_iterator i = plugins.begin(); i != plugins.end(); ++i)
+			_metaEngines.push_back(&(*i)->get<MetaEngine>());
+		_jobSystem = &g_system->getJobSystem();
+	}
+#endif
+
+	if (_space && _ready)
+		_lister = g_system->createThread(listerProc, this, "DetectionLister");
+
+	if (!_lister) {
+		_jobSystem = nullptr;
+		_stack.push(_root);
+		_root = Common::FSNode();
+	}
+}
+
+DetectionScanner::~DetectionScanner() {
+	if (_lister) {
+		{
+			Common::StackLock lock(_mutex);
+			_quit = true;
+		}
+		g_system->postSemaphore(_space);
+		g_system->joinThread(_lister);
+	}
+
+	if (_jobSystem)
+		_jobSystem->wait(_prepareJobs);
+
+	for (uint i = 0; i < _listings.size(); ++i)
+		delete _listings[i];
+
+	if (_space)
+		g_system->deleteSemaphore(_space);
+	if (_ready)
+		g_system->deleteSemaphore(_ready);
+}
+
+DetectionScanner::Listing *DetectionScanner::listDirectory(NodeStack &stack) {
+	Listing *listing = new Listing;
+	listing->scanner = this;
+	listing->dir = stack.pop();
+	listing->readable = listing->dir.getChildren(listing->files, Common::FSNode::kListAll);
+	listing->prepared = false;
+
+	if (listing->readable)
+		DetCache.prune(listing->dir, listing->files);
+
+	// Push the subdirectories backwards, so they are listed in order
+	if (_recursive && listing->readable) {
+		for (uint i = listing->files.size(); i-- > 0; ) {
+			if (listing->files[i].isDirectory())
+				stack.push(listing->dir.getChild(listing->files[i].getName()));
+		}
+	}
+
+	return listing;
+}
+
+DetectionScanner::Result DetectionScanner::next(Common::FSNode &dir, Common::FSList &files, bool wait) {
+	if (!_lister) {
+		if (_stack.empty())
+			return kFinished;
+
+		Listing *listing = listDirectory(_stack);
+		dir = listing->dir;
+		files = listing->files;
+		const bool readable = listing->readable;
+		delete listing;
+		return readable ? kDirectory : kUnreadable;
+	}
+
+	for (;;) {
+		{
+			Common::StackLock lock(_mutex);
+			if (!_listings.empty() && _listings.front()->prepared) {
+				Listing *listing = _listings.front();
+				_listings.remove_at(0);
+
+				dir = listing->dir;
+				files = listing->files;
+				const bool readable = listing->readable;
+				delete listing;
+
+				g_system->postSemaphore(_space);
+				return readable ? kDirectory : kUnreadable;
+			}
+
+			if (_listings.empty() && _listingDone)
+				return kFinished;
+		}
+
+		if (!wait)
+			return kPending;
+
+		g_system->waitSemaphore(_ready);
+	}
+}
+
+void DetectionScanner::listerProc(void *param) {
+	((DetectionScanner *)param)->runLister();
+}
+
+void DetectionScanner::prepareJobProc(void *param) {
+	Listing *listing = (Listing *)param;
+	DetectionScanner *scanner = listing->scanner;
+
+	bool quit;
+	{
+		Common::StackLock lock(scanner->_mutex);
+		quit = scanner->_quit;
+	}
+
+	if (!quit) {
+		for (uint i = 0; i < scanner->_metaEngines.size(); ++i)
+			scanner->_metaEngines[i]->prepareDetection(listing->files);
+	}
+
+	{
+		Common::StackLock lock(scanner->_mutex);
+		listing->prepared = true;
+	}
+
+	g_system->postSemaphore(scanner->_ready);
+}
+
+void DetectionScanner::runLister() {
+	NodeStack stack;
+	stack.push(_root);
+	_root = Common::FSNode();
+
+	while (!stack.empty()) {
+		g_system->waitSemaphore(_space);
+
+		{
+			Common::StackLock lock(_mutex);
+			if (_quit)
+				break;
+		}
+
+		Listing *listing = listDirectory(stack);
+		// Listings of unreadable directories need no preparation
+		const bool prepare = listing->readable && _jobSystem;
+
+		{
+			Common::StackLock lock(_mutex);
+			listing->prepared = !prepare;
+			_listings.push_back(listing);
+		}
+
+		if (prepare)
+			_jobSystem->submit(_prepareJobs, prepareJobProc, listing);
+		else
+			g_system->postSemaphore(_ready);
+	}
+
+	{
+		Common::StackLock lock(_mutex);
+		_listingDone = true;
+	}
+
+	g_system->postSemaphore(_ready);
+}
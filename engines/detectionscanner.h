@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_DETECTIONSCANNER_H
+#define ENGINES_DETECTIONSCANNER_H
+
+#include "common/array.h"
+#include "common/fs.h"
+#include "common/jobsystem.h"
+#include "common/mutex.h"
+#include "common/stack.h"
+#include "common/system.h"
+
+class MetaEngine;
+
+/**
+ * Walks a directory tree for game detection.
+ *
+ * The directories are returned in pre-order, each together with its
+ * contents, ready to be passed to EngineManager::detectGames(). If the
+ * backend supports threads, the tree is listed on a separate thread, and the
+ * files the detectors are going to checksum are hashed into the
+ * DetectionCache by jobs (see MetaEngine::prepareDetection()), while the
+ * caller runs the detectors on the directories returned earlier.
+ *
+ * The detectors themselves always run on the thread calling next(), as
+ * they are free to use the config manager and other global state.
+ */
+class DetectionScanner {
+public:
+	enum Result {
+		kDirectory,		///< dir and files hold the next directory
+		kUnreadable,	///< dir holds the next directory, which could not be listed
+		kPending,		///< the next directory is not ready yet
+		kFinished		///< all directories have been returned
+	};
+
+	/**
+	 * @param root		the directory to start at
+	 * @param recursive	whether to descend into subdirectories
+	 */
+	DetectionScanner(const Common::FSNode &root, bool recursive);
+	~DetectionScanner();
+
+	/**
+	 * Get the next directory of the tree.
+	 *
+	 * @param dir	set to the directory
+	 * @param files	set to the contents of the directory
+	 * @param wait	whether to wait for the next directory, or return
+	 *              kPending if it is still being listed or prepared
+	 */
+	Result next(Common::FSNode &dir, Common::FSList &files, bool wait = true);
+
+private:
+	struct Listing {
+		DetectionScanner *scanner;
+		Common::FSNode dir;
+		Common::FSList files;
+		bool readable;
+		bool prepared;
+	};
+
+	typedef Common::Stack<Common::FSNode> NodeStack;
+
+	enum {
+		/** Maximum number of directories listed ahead of the caller */
+		kMaxListingsAhead = 64
+	};
+
+	Listing *listDirectory(NodeStack &stack);
+
+	static void listerProc(void *param);
+	static void prepareJobProc(void *param);
+	void runLister();
+
+	const bool _recursive;
+
+	/** Directories still to be listed, when listing on the caller's thread */
+	NodeStack _stack;
+
+	/** The root directory, handed over to the lister thread */
+	Common::FSNode _root;
+
+	Common::Array<const MetaEngine *> _metaEngines;
+
+	OSystem::ThreadRef _lister;
+
+	/** The job system preparing the detection, or nullptr if it is not prepared */
+	Common::JobSystem *_jobSystem;
+	Common::JobSystem::JobGroup _prepareJobs;
+
+	/** Signalled when a listing may be added */
+	OSystem::SemaphoreRef _space;
+	/** Signalled when a listing became ready */
+	OSystem::SemaphoreRef _ready;
+
+	/** Guards the members below */
+	Common::Mutex _mutex;
+	Common::Array<Listing *> _listings;
+	bool _listingDone;
+	bool _quit;
+};
+
+#endif
@@ -121,6 +121,19 @@ public:
 	 */
 	virtual DetectedGames detectGames(const Common::FSList &fslist) const = 0;
 
+	/**
+	 * Does the expensive part of detectGames() for the given list of files
+	 * ahead of time, so a later detectGames() call on them is fast. Used by
+	 * DetectionScanner to prepare the detection of several directories in
+	 * parallel.
+	 *
+	 * This is called on worker threads, concurrently for different
+	 * directories. Implementations may only access their own constant data
+	 * and thread-safe facilities like the DetectionCache, and must not keep
+	 * references to the nodes in fslist.
+	 */
+	virtual void prepareDetection(const Common::FSList &fslist) const {}
+
 	/**
 	 * Tries to instantiate an engine instance based on the settings of
 	 * the currently active ConfMan target. That is, the MetaEngine should
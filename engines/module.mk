@@ -2,6 +2,8 @@ MODULE := engines
 
 MODULE_OBJS := \
 	advancedDetector.o \
+	detectioncache.o \
+	detectionscanner.o \
 	dialogs.o \
 	engine.o \
 	game.o \
@@ -117,6 +117,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
+	registerCmd("resource_stats",		WRAP_METHOD(Console, cmdResourceStats));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
@@ -150,6 +151,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("parallel_rendering", WRAP_METHOD(Console, cmdParallelRendering));
+	registerCmd("frame_times",        WRAP_METHOD(Console, cmdFrameTimes));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -163,6 +166,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -347,6 +351,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_types - Shows the valid resource types\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
+	debugPrintf(" resource_stats - Shows the resource memory usage and cache statistics\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
@@ -376,6 +381,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" parallel_rendering - Enables/disables drawing frames on several threads (SCI2+)\n");
+	debugPrintf(" frame_times - Shows a histogram of the frame drawing times (SCI2+)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -388,6 +395,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows the pause times of the garbage collector\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -1037,6 +1045,22 @@ bool Console::cmdAllocList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceStats(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	debugPrintf("Memory: %d bytes locked, %d of %d bytes under LRU control\n",
+	            resMan->getMemoryLocked(), resMan->getMemoryLRU(), resMan->getMaxMemoryLRU());
+	debugPrintf("%-12s %8s %8s %9s\n", "Type", "Hits", "Misses", "Evictions");
+
+	for (int i = 0; i < kResourceTypeInvalid; ++i) {
+		const ResourceManager::ResourceTypeStats &stats = resMan->getResourceTypeStats((ResourceType)i);
+		if (stats.hits || stats.misses)
+			debugPrintf("%-12s %8u %8u %9u\n", getResourceTypeName((ResourceType)i), stats.hits, stats.misses, stats.evictions);
+	}
+
+	return true;
+}
+
 bool Console::cmdDissectScript(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Examines a script\n");
@@ -2072,6 +2096,53 @@ bool Console::cmdPlaneList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdParallelRendering(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!_engine->_gfxFrameout) {
+		debugPrintf("This SCI version does not draw planes\n");
+		return true;
+	}
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "on")) {
+		_engine->_gfxFrameout->setParallelRendering(true);
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "off")) {
+		_engine->_gfxFrameout->setParallelRendering(false);
+	} else if (argc != 1) {
+		debugPrintf("Enables or disables drawing frames on several threads\n");
+		debugPrintf("Usage: %s [on|off]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Parallel rendering is %s\n", _engine->_gfxFrameout->getParallelRendering() ? "on" : "off");
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
+bool Console::cmdFrameTimes(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!_engine->_gfxFrameout) {
+		debugPrintf("This SCI version does not draw planes\n");
+		return true;
+	}
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		_engine->_gfxFrameout->resetFrameTimes();
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows a histogram of the time taken to draw frames\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	_engine->_gfxFrameout->printFrameTimes(this);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 bool Console::cmdVisiblePlaneList(int argc, const char **argv) {
 #ifdef ENABLE_SCI32
 	if (_engine->_gfxFrameout) {
@@ -2838,6 +2909,20 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	const GarbageCollector *gc = _engine->_gamestate->_gc;
+	const GCStatistics &stats = gc->getStatistics();
+
+	debugPrintf("Full collections: %u, last one took %u ms\n", stats.fullCollections, stats.lastFullPause);
+	debugPrintf("Incremental collections: %u completed, %u dropped, %s\n", stats.cycles, stats.abortedCycles,
+		gc->isCollecting() ? "one in progress" : "none in progress");
+	debugPrintf("Slices: %u\n", stats.slices);
+	debugPrintf("Pauses: last %u ms, longest %u ms, total %u ms\n", stats.lastPause, stats.maxPause, stats.totalPause);
+	debugPrintf("Objects freed: %u\n", stats.freed);
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -25,6 +25,7 @@
 #include "common/dcl.h"
 #include "common/util.h"
 #include "common/endian.h"
+#include "common/str.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 
@@ -44,6 +45,19 @@ int Decompressor::unpack(Common::ReadStream *src, byte *dest, uint32 nPacked, ui
 	return (src->eos() || src->err()) ? 1 : 0;
 }
 
+void Decompressor::reportProblem(const char *s, ...) {
+	_problem = true;
+	if (_quiet)
+		return;
+
+	va_list va;
+	va_start(va, s);
+	const Common::String message = Common::String::vformat(s, va);
+	va_end(va);
+
+	warning("%s", message.c_str());
+}
+
 void Decompressor::init(Common::ReadStream *src, byte *dest, uint32 nPacked,
                         uint32 nUnpacked) {
 	_src = src;
@@ -191,6 +205,10 @@ int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPack
 		free(tokenlist);
 		free(tokenlengthlist);
 
+		if (_quiet) {
+			_problem = true;
+			return SCI_ERROR_DECOMPRESSION_ERROR;
+		}
 		error("[DecompressorLZW::unpackLZW] Cannot allocate token memory buffers");
 	}
 
@@ -211,7 +229,7 @@ int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPack
 		} else {
 			if (token > 0xff) {
 				if (token >= _curtoken) {
-					warning("unpackLZW: Bad token %x", token);
+					reportProblem("unpackLZW: Bad token %x", token);
 
 					free(tokenlist);
 					free(tokenlengthlist);
@@ -221,7 +239,7 @@ int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPack
 				tokenlastlength = tokenlengthlist[token] + 1;
 				if (_dwWrote + tokenlastlength > _szUnpacked) {
 					// For me this seems a normal situation, It's necessary to handle it
-					warning("unpackLZW: Trying to write beyond the end of array(len=%d, destctr=%d, tok_len=%d)",
+					reportProblem("unpackLZW: Trying to write beyond the end of array(len=%d, destctr=%d, tok_len=%d)",
 					        _szUnpacked, _dwWrote, tokenlastlength);
 					for (int i = 0; _dwWrote < _szUnpacked; i++)
 						putByte(dest[tokenlist[token] + i]);
@@ -231,7 +249,7 @@ int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPack
 			} else {
 				tokenlastlength = 1;
 				if (_dwWrote >= _szUnpacked)
-					warning("unpackLZW: Try to write single byte beyond end of array");
+					reportProblem("unpackLZW: Try to write single byte beyond end of array");
 				else
 					putByte(token);
 			}
@@ -265,6 +283,10 @@ int DecompressorLZW::unpackLZW1(Common::ReadStream *src, byte *dest, uint32 nPac
 		free(stak);
 		free(tokens);
 
+		if (_quiet) {
+			_problem = true;
+			return SCI_ERROR_DECOMPRESSION_ERROR;
+		}
 		error("[DecompressorLZW::unpackLZW1] Cannot allocate decompression buffers");
 	}
 
@@ -562,7 +584,7 @@ void DecompressorLZW::reorderView(byte *src, byte *dest) {
 	for (l = 0; l < loopheaders; l++) {
 		if (lh_mask & lb) { /* The loop is _not_ present */
 			if (lh_last == -1) {
-				warning("Error: While reordering view: Loop not present, but can't re-use last loop");
+				reportProblem("Error: While reordering view: Loop not present, but can't re-use last loop");
 				lh_last = 0;
 			}
 			WRITE_LE_UINT16(lh_ptr, lh_last);
@@ -596,7 +618,7 @@ void DecompressorLZW::reorderView(byte *src, byte *dest) {
 	}
 
 	if (celindex < cel_total) {
-		warning("View decompression generated too few (%d / %d) headers", celindex, cel_total);
+		reportProblem("View decompression generated too few (%d / %d) headers", celindex, cel_total);
 		free(cc_pos);
 		free(cc_lengths);
 		return;
@@ -632,7 +654,10 @@ void DecompressorLZW::reorderView(byte *src, byte *dest) {
 
 int DecompressorDCL::unpack(Common::ReadStream *src, byte *dest, uint32 nPacked,
                             uint32 nUnpacked) {
-	return Common::decompressDCL(src, dest, nPacked, nUnpacked) ? 0 : SCI_ERROR_DECOMPRESSION_ERROR;
+	if (Common::decompressDCL(src, dest, nPacked, nUnpacked, _quiet))
+		return 0;
+	_problem = true;
+	return SCI_ERROR_DECOMPRESSION_ERROR;
 }
 
 #ifdef ENABLE_SCI32
@@ -657,14 +682,14 @@ int DecompressorLZS::unpackLZS() {
 				if (!offs) // This is the end marker - a 7 bit offset of zero
 					break;
 				if (!(clen = getCompLen())) {
-					warning("lzsDecomp: length mismatch");
+					reportProblem("lzsDecomp: length mismatch");
 					return SCI_ERROR_DECOMPRESSION_ERROR;
 				}
 				copyComp(offs, clen);
 			} else { // Eleven bit offset follows
 				offs = getBitsMSB(11);
 				if (!(clen = getCompLen())) {
-					warning("lzsDecomp: length mismatch");
+					reportProblem("lzsDecomp: length mismatch");
 					return SCI_ERROR_DECOMPRESSION_ERROR;
 				}
 				copyComp(offs, clen);
@@ -715,4 +740,26 @@ void DecompressorLZS::copyComp(int offs, uint32 clen) {
 
 #endif	// #ifdef ENABLE_SCI32
 
+Decompressor *createDecompressor(ResourceCompression compression) {
+	switch (compression) {
+	case kCompNone:
+		return new Decompressor;
+	case kCompHuffman:
+		return new DecompressorHuffman;
+	case kCompLZW:
+	case kCompLZW1:
+	case kCompLZW1View:
+	case kCompLZW1Pic:
+		return new DecompressorLZW(compression);
+	case kCompDCL:
+		return new DecompressorDCL;
+#ifdef ENABLE_SCI32
+	case kCompSTACpack:
+		return new DecompressorLZS;
+#endif
+	default:
+		return NULL;
+	}
+}
+
 } // End of namespace Sci
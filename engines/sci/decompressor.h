@@ -51,13 +51,29 @@ enum ResourceCompression {
  */
 class Decompressor {
 public:
-	Decompressor() {}
+	Decompressor() : _quiet(false), _problem(false) {}
 	virtual ~Decompressor() {}
 
 
 	virtual int unpack(Common::ReadStream *src, byte *dest, uint32 nPacked, uint32 nUnpacked);
 
+	/**
+	 * Do not print warnings or call error() on damaged data, but only
+	 * remember that there was a problem, see hadProblem(). Quiet
+	 * decompressors may be used off the main thread.
+	 */
+	void setQuiet(bool quiet) { _quiet = quiet; }
+
+	/** Returns true if a quiet decompressor ran into damaged data. */
+	bool hadProblem() const { return _problem; }
+
 protected:
+	/**
+	 * Report damaged data: prints a warning, or only remembers the problem
+	 * if the decompressor is quiet.
+	 */
+	void reportProblem(const char *s, ...) GCC_PRINTF(2, 3);
+
 	/**
 	 * Initialize decompressor.
 	 * @param src		source stream to read from
@@ -117,6 +133,8 @@ protected:
 	uint32 _dwWrote;	///< number of bytes written to _dest
 	Common::ReadStream *_src;
 	byte *_dest;
+	bool _quiet;		///< see setQuiet()
+	bool _problem;		///< damaged data was found while quiet
 };
 
 /**
@@ -194,6 +212,14 @@ protected:
 };
 #endif
 
+/**
+ * Creates a decompressor for the given compression method.
+ * Decompressors do not share any state, so quiet ones may be used on any
+ * thread, see Decompressor::setQuiet().
+ * @return the decompressor, or NULL if the method is not supported
+ */
+Decompressor *createDecompressor(ResourceCompression compression);
+
 } // End of namespace Sci
 
 #endif // SCI_SCICORE_DECOMPRESSOR_H
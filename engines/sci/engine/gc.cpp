@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -99,11 +100,9 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void pushRoots(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -170,7 +169,14 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushRoots(s, wm);
 
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
 	processWorkList(s->_segMan, wm, heap);
 
 	if (g_sci->_gfxPorts)
@@ -179,60 +185,299 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
-	SegManager *segMan = s->_segMan;
+static uint freeUnreachable(SegManager *segMan, SegmentId seg, const AddrSet &activeRefs, const AddrSet *keep) {
+	SegmentObj *mobj = segMan->getSegments()[seg];
+	uint freed = 0;
+#ifdef GC_DEBUG_CODE
+	const SegmentType type = mobj->getType();
+#endif
+
+	// Get a list of all deallocatable objects in this segment,
+	// then free any which are not referenced from somewhere.
+	const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
+	for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
+		const reg_t addr = *it;
+		if (!activeRefs.contains(addr) && !(keep && keep->contains(addr))) {
+			// Not found -> we can free it
+			mobj->freeAtAddress(segMan, addr);
+			debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+			freed++;
+		}
+	}
 
-	// Some debug stuff
-	debugC(kDebugLevelGC, "[GC] Running...");
 #ifdef GC_DEBUG_CODE
-	const char *segnames[SEG_TYPE_MAX + 1];
-	int segcount[SEG_TYPE_MAX + 1];
-	memset(segnames, 0, sizeof(segnames));
-	memset(segcount, 0, sizeof(segcount));
+	if (freed)
+		debugC(kDebugLevelGC, "\t%d\t* %s", freed, segmentTypeNames[type]);
 #endif
 
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	return freed;
+}
+
+GarbageCollector::GarbageCollector() : _phase(kPhaseIdle), _activeRefs(nullptr), _sweepSegment(0), _sweepIndex(0) {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+GarbageCollector::~GarbageCollector() {
+	delete _activeRefs;
+}
+
+bool GarbageCollector::checkState(SegManager *segMan) {
+	if (_phase == kPhaseIdle)
+		return true;
+
+	// Restarting or restoring the game resets the barriers, which
+	// invalidates everything found so far
+	if (segMan->getGCAllocatedObjects() != &_allocatedObjects) {
+		debugC(kDebugLevelGC, "[GC] Dropping the collection in progress");
+		abortCycle(segMan);
+		_stats.abortedCycles++;
+		return false;
+	}
+
+	return true;
+}
+
+void GarbageCollector::runSlice(EngineState *s) {
+	checkState(s->_segMan);
+
+	const uint32 startTime = g_system->getMillis();
+	const uint32 endTime = startTime + kSliceMillis;
+
+	switch (_phase) {
+	case kPhaseIdle:
+		startCycle(s);
+		// fall through
+	case kPhaseMark:
+		if (mark(s, endTime))
+			break;
+		remark(s);
+		break;
+	case kPhaseSweep:
+		if (sweep(s->_segMan, endTime))
+			finishCycle(s->_segMan);
+		break;
+	default:
+		break;
+	}
+
+	_stats.slices++;
+	recordPause(startTime);
+}
+
+void GarbageCollector::collect(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	const uint32 startTime = g_system->getMillis();
+
+	checkState(segMan);
+
+	if (_phase == kPhaseMark)
+		remark(s);
+
+	if (_phase == kPhaseSweep) {
+		sweep(segMan, 0xFFFFFFFF);
+		finishCycle(segMan);
+	} else {
+		debugC(kDebugLevelGC, "[GC] Running...");
+
+		// Compute the set of all segments references currently in use.
+		AddrSet *activeRefs = findAllActiveReferences(s);
+
+		// Iterate over all segments, and check for each whether it
+		// contains stuff that can be collected.
+		const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+		for (uint seg = 1; seg < heap.size(); seg++) {
+			if (heap[seg])
+				_stats.freed += freeUnreachable(segMan, seg, *activeRefs, nullptr);
+		}
+
+		delete activeRefs;
+	}
+
+	_stats.fullCollections++;
+	recordPause(startTime);
+	_stats.lastFullPause = _stats.lastPause;
+}
+
+void GarbageCollector::startCycle(EngineState *s) {
+	debugC(kDebugLevelGC, "[GC] Starting an incremental collection");
+
+	_phase = kPhaseMark;
+	_wm._worklist.clear();
+	_wm._map.clear();
+	_writtenObjects.clear();
+	_allocatedObjects.clear();
+	s->_segMan->setGCBarriers(&_writtenObjects, &_allocatedObjects);
+
+	pushRoots(s, _wm);
+}
+
+bool GarbageCollector::mark(EngineState *s, uint32 endTime) {
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
+	const SegmentId stackSegment = s->_segMan->findSegmentByType(SEG_TYPE_STACK);
+	uint count = 0;
+
+	while (!_wm._worklist.empty()) {
+		if (++count % kSliceCheckInterval == 0 && g_system->getMillis() >= endTime)
+			return true;
 
-	// Iterate over all segments, and check for each whether it
-	// contains stuff that can be collected.
+		const reg_t reg = _wm._worklist.back();
+		_wm._worklist.pop_back();
+
+		// Unlike during a full collection, the addresses found earlier may
+		// have been freed explicitly in the meantime
+		if (reg.getSegment() != stackSegment && reg.getSegment() < heap.size() && heap[reg.getSegment()] &&
+			heap[reg.getSegment()]->isValidOffset(reg.getOffset())) {
+			_wm.pushArray(heap[reg.getSegment()]->listAllOutgoingReferences(reg));
+		}
+	}
+
+	return false;
+}
+
+void GarbageCollector::remark(EngineState *s) {
+	SegManager *segMan = s->_segMan;
 	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	const SegmentId stackSegment = segMan->findSegmentByType(SEG_TYPE_STACK);
+
+	debugC(kDebugLevelGC, "[GC] Remarking %d written and %d allocated objects",
+		_writtenObjects.size(), _allocatedObjects.size());
+
+	segMan->setGCBarriers(nullptr, &_allocatedObjects);
+
+	// Everything that may have changed since it was traced is traced again:
+	// the roots, the globals, which are also written to directly by the
+	// engine, and the objects recorded by the barriers.
+	Common::Array<reg_t> retrace;
+	for (Common::List<ExecStack>::const_iterator iter = s->_executionStack.begin(); iter != s->_executionStack.end(); ++iter) {
+		if (iter->type != EXEC_STACK_TYPE_KERNEL) {
+			retrace.push_back(iter->objp);
+			retrace.push_back(iter->sendp);
+		}
+	}
+	if (s->variablesSegment[VAR_GLOBAL])
+		retrace.push_back(make_reg(s->variablesSegment[VAR_GLOBAL], 0));
+	for (AddrSet::const_iterator i = _writtenObjects.begin(); i != _writtenObjects.end(); ++i)
+		retrace.push_back(i->_key);
+	for (AddrSet::const_iterator i = _allocatedObjects.begin(); i != _allocatedObjects.end(); ++i)
+		retrace.push_back(i->_key);
+	_writtenObjects.clear();
+
+	pushRoots(s, _wm);
+	for (uint i = 0; i < retrace.size(); ++i) {
+		const reg_t reg = retrace[i];
+		if (reg.getSegment() && reg.getSegment() != stackSegment && reg.getSegment() < heap.size() &&
+			heap[reg.getSegment()] && heap[reg.getSegment()]->isValidOffset(reg.getOffset())) {
+			_wm.push(reg);
+			_wm.pushArray(heap[reg.getSegment()]->listAllOutgoingReferences(reg));
+		}
+	}
+
+	mark(s, 0xFFFFFFFF);
+
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(_wm);
+	mark(s, 0xFFFFFFFF);
+
+	_activeRefs = normalizeAddresses(segMan, _wm._map);
+	_wm._map.clear();
+
+	// Scripts are freed right away, as they can be reloaded at any time
 	for (uint seg = 1; seg < heap.size(); seg++) {
-		SegmentObj *mobj = heap[seg];
+		if (heap[seg] && heap[seg]->getType() == SEG_TYPE_SCRIPT)
+			_stats.freed += freeUnreachable(segMan, seg, *_activeRefs, &_allocatedObjects);
+	}
 
-		if (mobj != NULL) {
-#ifdef GC_DEBUG_CODE
-			const SegmentType type = mobj->getType();
-			segnames[type] = segmentTypeNames[type];
-#endif
+	_phase = kPhaseSweep;
+	_sweepSegment = 1;
+	_sweepList.clear();
+	_sweepIndex = 0;
+}
 
-			// Get a list of all deallocatable objects in this segment,
-			// then free any which are not referenced from somewhere.
-			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
-			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
-				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
-					// Not found -> we can free it
-					mobj->freeAtAddress(segMan, addr);
-					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
-#ifdef GC_DEBUG_CODE
-					segcount[type]++;
-#endif
-				}
-			}
+bool GarbageCollector::sweep(SegManager *segMan, uint32 endTime) {
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	uint count = 0;
+
+	// Objects allocated since marking started are never freed, as the
+	// allocation barrier stays active. Everything else unmarked is garbage,
+	// which can not become reachable again.
+	for (;;) {
+		if (_sweepIndex == _sweepList.size()) {
+			if (_sweepSegment == heap.size())
+				return true;
+
+			const SegmentId seg = _sweepSegment++;
+			_sweepList.clear();
+			_sweepIndex = 0;
+			if (heap[seg] && heap[seg]->getType() != SEG_TYPE_SCRIPT)
+				_sweepList = heap[seg]->listAllDeallocatable(seg);
+			continue;
+		}
+
+		if (++count % kSliceCheckInterval == 0 && g_system->getMillis() >= endTime)
+			return false;
 
+		const reg_t addr = _sweepList[_sweepIndex++];
+		SegmentObj *mobj = heap[addr.getSegment()];
+
+		// Skip objects which were freed explicitly after the list was made
+		if (!mobj || !mobj->isValidOffset(addr.getOffset()))
+			continue;
+
+		if (!_activeRefs->contains(addr) && !_allocatedObjects.contains(addr)) {
+			mobj->freeAtAddress(segMan, addr);
+			debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+			_stats.freed++;
 		}
 	}
+}
 
-	delete activeRefs;
+void GarbageCollector::finishCycle(SegManager *segMan) {
+	debugC(kDebugLevelGC, "[GC] Finished an incremental collection");
+	_stats.cycles++;
+	abortCycle(segMan);
+}
 
-#ifdef GC_DEBUG_CODE
-	// Output debug summary of garbage collection
-	debugC(kDebugLevelGC, "[GC] Summary:");
-	for (int i = 0; i <= SEG_TYPE_MAX; i++)
-		if (segcount[i])
-			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
-#endif
+void GarbageCollector::abortCycle(SegManager *segMan) {
+	if (segMan->getGCAllocatedObjects() == &_allocatedObjects)
+		segMan->setGCBarriers(nullptr, nullptr);
+
+	_phase = kPhaseIdle;
+	_wm._worklist.clear();
+	_wm._map.clear();
+	_writtenObjects.clear();
+	_allocatedObjects.clear();
+	_sweepList.clear();
+	_sweepIndex = 0;
+	delete _activeRefs;
+	_activeRefs = nullptr;
+}
+
+void GarbageCollector::recordPause(uint32 startTime) {
+	_stats.lastPause = g_system->getMillis() - startTime;
+	_stats.maxPause = MAX(_stats.maxPause, _stats.lastPause);
+	_stats.totalPause += _stats.lastPause;
+}
+
+void run_gc(EngineState *s) {
+	s->_gc->collect(s);
+}
+
+void run_gc_slice(EngineState *s) {
+	// Objects a kernel function is working on while it invokes scripts may
+	// have been looked up before the collection started, so that they were
+	// not seen by the barriers. Collect in one go in that case, as always.
+	if (s->executionStackBase) {
+		if (s->_gc->isCollecting()) {
+			s->gcCountDown = GC_SLICE_INTERVAL;
+		} else {
+			s->gcCountDown = s->scriptGCInterval;
+			s->_gc->collect(s);
+		}
+		return;
+	}
+
+	s->_gc->runSlice(s);
+	s->gcCountDown = s->_gc->isCollecting() ? GC_SLICE_INTERVAL : s->scriptGCInterval;
 }
 
 } // End of namespace Sci
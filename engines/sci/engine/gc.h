@@ -30,18 +30,6 @@
 
 namespace Sci {
 
-struct reg_t_Hash {
-	uint operator()(const reg_t& x) const {
-		return (x.getSegment() << 3) ^ x.getOffset() ^ (x.getOffset() << 16);
-	}
-};
-
-/*
- * The AddrSet is a "set" of reg_t values.
- * We don't have a HashSet type, so we abuse a HashMap for this.
- */
-typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
-
 /**
  * Finds all used references and normalises them to their memory addresses
  * @param s The state to gather all information from
@@ -50,11 +38,21 @@ typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
 AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
- * Runs garbage collection on the current system state
+ * Runs garbage collection on the current system state. An incremental
+ * collection in progress is completed first.
  * @param s The state in which we should gc
  */
 void run_gc(EngineState *s);
 
+/**
+ * Runs the garbage collector from the script loop, once the kernel call
+ * countdown of the state expired. Outside of nested script invocations,
+ * this starts or continues an incremental collection instead of stopping
+ * the game for a full one, and resets the countdown accordingly.
+ * @param s The state in which we should gc
+ */
+void run_gc_slice(EngineState *s);
+
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
 	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
@@ -63,6 +61,84 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+/**
+ * Timing of the collections, as shown by the gc_stats console command.
+ * All times are in milliseconds.
+ */
+struct GCStatistics {
+	uint32 fullCollections;		///< Number of collections done in one go
+	uint32 cycles;				///< Number of incremental collections completed
+	uint32 abortedCycles;		///< Incremental collections dropped by restarts and restores
+	uint32 slices;				///< Number of slices of incremental collections
+	uint32 lastPause;			///< Duration of the last slice or full collection
+	uint32 maxPause;			///< Longest slice or full collection
+	uint32 totalPause;			///< Total time spent collecting
+	uint32 lastFullPause;		///< Duration of the last full collection
+	uint32 freed;				///< Number of objects freed
+};
+
+/**
+ * Incremental mark and sweep garbage collector.
+ *
+ * A collection is split into slices of bounded duration, which run between
+ * kernel calls. First the objects reachable from the root set are marked,
+ * a part of the heap per slice. Meanwhile, the segment manager remembers
+ * every object which references may have been stored into (see
+ * SegManager::gcRecordWrite()) and every object allocated. Once marking
+ * runs out of work, the roots and the remembered objects are traced again
+ * in one go, which finds everything that got reachable while marking.
+ * Finally, the unmarked objects are freed, a few segments per slice.
+ */
+class GarbageCollector {
+public:
+	GarbageCollector();
+	~GarbageCollector();
+
+	/** Runs a slice of the current collection, starting a new one if none is in progress. */
+	void runSlice(EngineState *s);
+
+	/** Completes the current collection, or runs a full one if none is in progress. */
+	void collect(EngineState *s);
+
+	/** Whether an incremental collection is in progress. */
+	bool isCollecting() const { return _phase != kPhaseIdle; }
+
+	const GCStatistics &getStatistics() const { return _stats; }
+
+private:
+	enum Phase {
+		kPhaseIdle,
+		kPhaseMark,
+		kPhaseSweep
+	};
+
+	enum {
+		/** Maximum duration of a slice */
+		kSliceMillis = 2,
+		/** Number of objects traced or swept in between checks of the slice duration */
+		kSliceCheckInterval = 256
+	};
+
+	bool checkState(SegManager *segMan);
+	void startCycle(EngineState *s);
+	bool mark(EngineState *s, uint32 endTime);
+	void remark(EngineState *s);
+	bool sweep(SegManager *segMan, uint32 endTime);
+	void finishCycle(SegManager *segMan);
+	void abortCycle(SegManager *segMan);
+	void recordPause(uint32 startTime);
+
+	Phase _phase;
+	WorklistManager _wm;
+	AddrSet _writtenObjects;
+	AddrSet _allocatedObjects;
+	AddrSet *_activeRefs;
+	uint _sweepSegment;
+	Common::Array<reg_t> _sweepList;
+	uint _sweepIndex;
+	GCStatistics _stats;
+};
+
 
 } // End of namespace Sci
 
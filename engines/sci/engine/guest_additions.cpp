@@ -188,6 +188,10 @@ void GuestAdditions::writeVarHook(const int type, const int index, const reg_t v
 		}
 #endif
 		syncMessageTypeToScummVM(index, value);
+
+		if (index == kGlobalVarNewRoomNo && value.isNumber()) {
+			g_sci->getResMan()->prefetchRoom(value.toUint16());
+		}
 	}
 }
 
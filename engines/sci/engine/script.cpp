@@ -73,6 +73,10 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_instructionIndex.clear();
+	_instructions.clear();
+	_instructionEpoch = 1;
 }
 
 enum {
@@ -946,9 +950,44 @@ SegmentRef Script::dereference(reg_t pointer) {
 	ret.isRaw = true;
 	ret.maxSize = _buf->size() - pointer.getOffset();
 	ret.raw = _buf->getUnsafeDataAt(pointer.getOffset(), ret.maxSize);
+
+	// Raw references are writable. Scripts only write to their data, but
+	// anything pointing at decoded code might modify it.
+	if (pointer.getOffset() < _instructionIndex.size() && _instructionIndex[pointer.getOffset()])
+		invalidateInstructions();
+
 	return ret;
 }
 
+const PMachineInstruction &Script::getInstruction(uint32 offset) {
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_buf->size());
+
+	PMachineInstruction *instruction;
+	uint16 &index = _instructionIndex[offset];
+	if (index) {
+		instruction = &_instructions[index - 1];
+		if (instruction->epoch == _instructionEpoch)
+			return *instruction;
+	} else if (_instructions.size() < 0xFFFF) {
+		_instructions.push_back(PMachineInstruction());
+		index = _instructions.size();
+		instruction = &_instructions.back();
+	} else {
+		// Too many instructions to index, decode the rest every time
+		instruction = &_uncachedInstruction;
+	}
+
+	instruction->size = readPMachineInstruction(getBuf(offset), instruction->extOpcode, instruction->opparams);
+	instruction->epoch = _instructionEpoch;
+	return *instruction;
+}
+
+void Script::invalidateInstructions() {
+	// Outdated instructions are decoded again when they are executed next
+	++_instructionEpoch;
+}
+
 LocalVariables *Script::allocLocalsSegment(SegManager *segMan) {
 	if (!getLocalsCount()) { // No locals
 		return NULL;
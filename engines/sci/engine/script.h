@@ -69,6 +69,14 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/** A PMachine instruction, as decoded by readPMachineInstruction() */
+struct PMachineInstruction {
+	int16 opparams[4];
+	uint16 size;    // length of the instruction in bytes
+	byte extOpcode; // "extended" opcode, see readPMachineInstruction()
+	uint32 epoch;   // see Script::invalidateInstructions()
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -102,6 +110,16 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	/**
+	 * Instructions decoded by getInstruction(). _instructionIndex maps every
+	 * offset in the buffer to the 1-based index of the instruction decoded
+	 * at it, or to 0.
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions;
+	PMachineInstruction _uncachedInstruction;
+	uint32 _instructionEpoch;
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -266,6 +284,20 @@ public:
 	 */
 	void syncStringHeap(Common::Serializer &ser);
 
+	/**
+	 * Decodes the instruction at the given offset, like
+	 * readPMachineInstruction(). The result is cached, so the VM decodes
+	 * every instruction of a script only once. The returned reference is
+	 * only valid until the next call.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset);
+
+	/**
+	 * Discards all decoded instructions. Has to be called whenever the
+	 * code of the script is modified.
+	 */
+	void invalidateInstructions();
+
 #ifdef ENABLE_SCI32
 	/**
 	 * Resolve a relocation in an SCI3 script
@@ -48,6 +48,9 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	_bitmapSegId = 0;
 #endif
 
+	_gcWrittenObjects = nullptr;
+	_gcAllocatedObjects = nullptr;
+
 	createClassTable();
 }
 
@@ -56,6 +59,10 @@ SegManager::~SegManager() {
 }
 
 void SegManager::resetSegMan() {
+	// Drop any garbage collection in progress
+	_gcWrittenObjects = nullptr;
+	_gcAllocatedObjects = nullptr;
+
 	// Free memory
 	for (uint i = 0; i < _heap.size(); i++) {
 		if (_heap[i])
@@ -405,6 +412,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	offset = table->allocEntry();
 
 	reg_t addr = make_reg(_hunksSegId, offset);
+	gcRecordAllocation(addr);
 	Hunk *h = &table->at(offset);
 
 	if (!h)
@@ -440,6 +448,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	gcRecordAllocation(*addr);
 	return &table->at(offset);
 }
 
@@ -454,6 +463,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	gcRecordAllocation(*addr);
 	return &table->at(offset);
 }
 
@@ -468,6 +478,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	gcRecordAllocation(*addr);
 	return &table->at(offset);
 }
 
@@ -494,6 +505,7 @@ List *SegManager::lookupList(reg_t addr) {
 		return NULL;
 	}
 
+	gcRecordWrite(addr);
 	return &(lt[addr.getOffset()]);
 }
 
@@ -518,6 +530,7 @@ Node *SegManager::lookupNode(reg_t addr, bool stopOnDiscarded) {
 		return NULL;
 	}
 
+	gcRecordWrite(addr);
 	return &(nt[addr.getOffset()]);
 }
 
@@ -531,6 +544,7 @@ SegmentRef SegManager::dereference(reg_t pointer) {
 	}
 
 	SegmentObj *mobj = _heap[pointer.getSegment()];
+	gcRecordWrite(pointer);
 	return mobj->dereference(pointer);
 }
 
@@ -851,6 +865,7 @@ byte *SegManager::allocDynmem(int size, const char *descr, reg_t *addr) {
 	SegmentId seg;
 	SegmentObj *mobj = allocSegment(new DynMem(), &seg);
 	*addr = make_reg(seg, 0);
+	gcRecordAllocation(*addr);
 
 	DynMem &d = *(DynMem *)mobj;
 
@@ -895,6 +910,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	gcRecordAllocation(*addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -911,6 +927,7 @@ SciArray *SegManager::lookupArray(reg_t addr) {
 	if (!arrayTable.isValidEntry(addr.getOffset()))
 		error("Attempt to use non-array %04x:%04x as array", PRINT_REG(addr));
 
+	gcRecordWrite(addr);
 	return &(arrayTable[addr.getOffset()]);
 }
 
@@ -951,6 +968,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 	offset = table->allocEntry();
 
 	*addr = make_reg(_bitmapSegId, offset);
+	gcRecordAllocation(*addr);
 	SciBitmap &bitmap = table->at(offset);
 
 	bitmap.create(width, height, skipColor, originX, originY, xResolution, yResolution, paletteSize, remap, gc);
@@ -24,6 +24,7 @@
 #define SCI_ENGINE_SEGMAN_H
 
 #include "common/scummsys.h"
+#include "common/hashmap.h"
 #include "common/serializer.h"
 #include "sci/engine/script.h"
 #include "sci/engine/vm.h"
@@ -44,6 +45,18 @@ enum ScriptLoadType {
 	SCRIPT_GET_LOCK = 3 /**< Load, if neccessary, and lock */
 };
 
+struct reg_t_Hash {
+	uint operator()(const reg_t& x) const {
+		return (x.getSegment() << 3) ^ x.getOffset() ^ (x.getOffset() << 16);
+	}
+};
+
+/*
+ * The AddrSet is a "set" of reg_t values.
+ * We don't have a HashSet type, so we abuse a HashMap for this.
+ */
+typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
+
 class Script;
 
 class SegManager : public Common::Serializable {
@@ -458,7 +471,40 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	// Garbage Collection Barriers
+
+	/**
+	 * Sets where the barriers of the incremental garbage collector record
+	 * the objects it has to look at again. Passing NULL disables a barrier.
+	 * Resetting the segment manager disables both.
+	 * @param writtenObjects	set receiving the objects references may have been stored into
+	 * @param allocatedObjects	set receiving the newly allocated objects
+	 */
+	void setGCBarriers(AddrSet *writtenObjects, AddrSet *allocatedObjects) {
+		_gcWrittenObjects = writtenObjects;
+		_gcAllocatedObjects = allocatedObjects;
+	}
+
+	AddrSet *getGCWrittenObjects() const { return _gcWrittenObjects; }
+	AddrSet *getGCAllocatedObjects() const { return _gcAllocatedObjects; }
+
+	/**
+	 * Write barrier: must be called when a reference may be stored into the
+	 * object at addr, unless the object is on the stack or was looked up
+	 * with lookupList(), lookupNode(), lookupArray() or dereference(),
+	 * which call it themselves.
+	 */
+	void gcRecordWrite(reg_t addr) {
+		if (_gcWrittenObjects)
+			_gcWrittenObjects->setVal(addr, true);
+	}
+
 private:
+	void gcRecordAllocation(reg_t addr) {
+		if (_gcAllocatedObjects)
+			_gcAllocatedObjects->setVal(addr, true);
+	}
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
@@ -481,6 +527,9 @@ private:
 	SegmentId _bitmapSegId;
 #endif
 
+	AddrSet *_gcWrittenObjects; ///< See setGCBarriers()
+	AddrSet *_gcAllocatedObjects; ///< See setGCBarriers()
+
 public:
 	SegmentObj *allocSegment(SegmentObj *mem, SegmentId *segid);
 
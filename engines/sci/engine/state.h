@@ -45,6 +45,7 @@ namespace Sci {
 
 class FileHandle;
 class DirSeeker;
+class GarbageCollector;
 class EventManager;
 class MessageState;
 class SoundCommandParser;
@@ -190,6 +191,7 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GarbageCollector *_gc;
 
 	MessageState *_msgState;
 
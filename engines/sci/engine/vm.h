@@ -185,7 +185,8 @@ enum GlobalVar {
 
 /** Number of kernel calls in between gcs; should be < 50000 */
 enum {
-	GC_INTERVAL = 0x8000
+	GC_INTERVAL = 0x8000,
+	GC_SLICE_INTERVAL = 0x40 ///< Number of kernel calls in between slices of an incremental gc
 };
 
 enum SciOpcodes {
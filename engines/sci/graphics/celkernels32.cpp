@@ -0,0 +1,224 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "sci/graphics/celkernels32.h"
+#include "common/cpudetect.h"
+
+#ifdef SCUMMVM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Sci {
+
+#pragma mark -
+#pragma mark --- Scalar ---
+#pragma mark -
+
+static void drawSkipScalar(byte *target, const byte *source, uint width, uint8 skipColor) {
+	for (uint i = 0; i < width; ++i) {
+		if (source[i] != skipColor)
+			target[i] = source[i];
+	}
+}
+
+static bool drawBelowScalar(byte *target, const byte *source, uint width, uint8 skipColor, uint8 limit) {
+	bool needsRemap = false;
+	for (uint i = 0; i < width; ++i) {
+		const byte pixel = source[i];
+		if (pixel == skipColor)
+			continue;
+		if (pixel < limit)
+			target[i] = pixel;
+		else
+			needsRemap = true;
+	}
+	return needsRemap;
+}
+
+static void reverseScalar(byte *target, const byte *source, uint width) {
+	source += width;
+	for (uint i = 0; i < width; ++i)
+		target[i] = *--source;
+}
+
+static const CelRowKernel celRowKernelScalar = { "scalar", drawSkipScalar, drawBelowScalar, reverseScalar };
+
+#ifdef SCUMMVM_SSE2
+
+#pragma mark -
+#pragma mark --- SSE2 ---
+#pragma mark -
+
+static inline __m128i blendSSE2(__m128i keep, __m128i source, __m128i target) {
+	return _mm_or_si128(_mm_and_si128(keep, target), _mm_andnot_si128(keep, source));
+}
+
+static void drawSkipSSE2(byte *target, const byte *source, uint width, uint8 skipColor) {
+	const __m128i skip = _mm_set1_epi8((char)skipColor);
+
+	uint i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(source + i));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(target + i));
+		_mm_storeu_si128((__m128i *)(target + i), blendSSE2(_mm_cmpeq_epi8(src, skip), src, dst));
+	}
+
+	drawSkipScalar(target + i, source + i, width - i, skipColor);
+}
+
+static bool drawBelowSSE2(byte *target, const byte *source, uint width, uint8 skipColor, uint8 limit) {
+	const __m128i skip = _mm_set1_epi8((char)skipColor);
+	const __m128i lim = _mm_set1_epi8((char)limit);
+	int remapMask = 0;
+
+	uint i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(source + i));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(target + i));
+		const __m128i isSkip = _mm_cmpeq_epi8(src, skip);
+		// There is no unsigned byte comparison, but src >= limit exactly
+		// when max(src, limit) == src
+		const __m128i isHigh = _mm_cmpeq_epi8(_mm_max_epu8(src, lim), src);
+		remapMask |= _mm_movemask_epi8(_mm_andnot_si128(isSkip, isHigh));
+		_mm_storeu_si128((__m128i *)(target + i), blendSSE2(_mm_or_si128(isSkip, isHigh), src, dst));
+	}
+
+	const bool tailNeedsRemap = drawBelowScalar(target + i, source + i, width - i, skipColor, limit);
+	return remapMask != 0 || tailNeedsRemap;
+}
+
+static void reverseSSE2(byte *target, const byte *source, uint width) {
+	uint i = 0;
+	for (; i + 16 <= width; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(source + width - i - 16));
+		// Reverse the dwords, then the words in each dword, then the bytes
+		// in each word
+		v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+		v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128((__m128i *)(target + i), v);
+	}
+
+	reverseScalar(target + i, source, width - i);
+}
+
+static const CelRowKernel celRowKernelSSE2 = { "sse2", drawSkipSSE2, drawBelowSSE2, reverseSSE2 };
+
+#endif // SCUMMVM_SSE2
+
+#ifdef SCUMMVM_NEON
+
+#pragma mark -
+#pragma mark --- NEON ---
+#pragma mark -
+
+static void drawSkipNEON(byte *target, const byte *source, uint width, uint8 skipColor) {
+	const uint8x16_t skip = vdupq_n_u8(skipColor);
+
+	uint i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const uint8x16_t src = vld1q_u8(source + i);
+		const uint8x16_t dst = vld1q_u8(target + i);
+		vst1q_u8(target + i, vbslq_u8(vceqq_u8(src, skip), dst, src));
+	}
+
+	drawSkipScalar(target + i, source + i, width - i, skipColor);
+}
+
+static bool drawBelowNEON(byte *target, const byte *source, uint width, uint8 skipColor, uint8 limit) {
+	const uint8x16_t skip = vdupq_n_u8(skipColor);
+	const uint8x16_t lim = vdupq_n_u8(limit);
+	uint8x16_t remap = vdupq_n_u8(0);
+
+	uint i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const uint8x16_t src = vld1q_u8(source + i);
+		const uint8x16_t dst = vld1q_u8(target + i);
+		const uint8x16_t isSkip = vceqq_u8(src, skip);
+		const uint8x16_t isHigh = vcgeq_u8(src, lim);
+		remap = vorrq_u8(remap, vbicq_u8(isHigh, isSkip));
+		vst1q_u8(target + i, vbslq_u8(vorrq_u8(isSkip, isHigh), dst, src));
+	}
+
+	const uint64x2_t remap64 = vreinterpretq_u64_u8(remap);
+	const bool tailNeedsRemap = drawBelowScalar(target + i, source + i, width - i, skipColor, limit);
+	return (vgetq_lane_u64(remap64, 0) | vgetq_lane_u64(remap64, 1)) != 0 || tailNeedsRemap;
+}
+
+static void reverseNEON(byte *target, const byte *source, uint width) {
+	uint i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const uint8x16_t v = vrev64q_u8(vld1q_u8(source + width - i - 16));
+		vst1q_u8(target + i, vcombine_u8(vget_high_u8(v), vget_low_u8(v)));
+	}
+
+	reverseScalar(target + i, source, width - i);
+}
+
+static const CelRowKernel celRowKernelNEON = { "neon", drawSkipNEON, drawBelowNEON, reverseNEON };
+
+#endif // SCUMMVM_NEON
+
+#pragma mark -
+
+const CelRowKernel *getCelRowKernel(CelRowKernelType type) {
+	switch (type) {
+	case kCelRowKernelScalar:
+		return &celRowKernelScalar;
+
+#ifdef SCUMMVM_SSE2
+	case kCelRowKernelSSE2:
+		return Common::hasCPUFeature(Common::kCPUFeatureSSE2) ? &celRowKernelSSE2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_NEON
+	case kCelRowKernelNEON:
+		return Common::hasCPUFeature(Common::kCPUFeatureNEON) ? &celRowKernelNEON : nullptr;
+#endif
+
+	default:
+		return nullptr;
+	}
+}
+
+const CelRowKernel &getDefaultCelRowKernel() {
+	static const CelRowKernel *defaultKernel = nullptr;
+
+	if (!defaultKernel) {
+		const CelRowKernel *kernel = &celRowKernelScalar;
+		for (int i = kCelRowKernelScalar + 1; i < kCelRowKernelCount; ++i) {
+			const CelRowKernel *candidate = getCelRowKernel((CelRowKernelType)i);
+			if (candidate)
+				kernel = candidate;
+		}
+		defaultKernel = kernel;
+	}
+
+	return *defaultKernel;
+}
+
+} // End of namespace Sci
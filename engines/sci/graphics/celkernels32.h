@@ -0,0 +1,89 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_GRAPHICS_CELKERNELS32_H
+#define SCI_GRAPHICS_CELKERNELS32_H
+
+#include "common/scummsys.h"
+
+namespace Sci {
+
+/**
+ * Draws a row of cel pixels, leaving the target pixels under pixels of the
+ * skip color untouched.
+ *
+ * @param target	row of the target buffer
+ * @param source	row of cel pixels, already flipped and scaled
+ * @param width		number of pixels
+ * @param skipColor	transparent color of the cel
+ */
+typedef void (*CelDrawSkipProc)(byte *target, const byte *source, uint width, uint8 skipColor);
+
+/**
+ * Same as CelDrawSkipProc, but only draws the pixels below the given color,
+ * as done for cels with remapping data. The pixels from limit up are the
+ * remap colors, which the caller has to handle itself.
+ *
+ * @return true if the row contains any pixel from limit up which is not of
+ *         the skip color
+ */
+typedef bool (*CelDrawBelowProc)(byte *target, const byte *source, uint width, uint8 skipColor, uint8 limit);
+
+/**
+ * Copies a row of pixels in reverse order, for horizontally flipped cels:
+ * target[i] = source[width - 1 - i].
+ */
+typedef void (*CelReverseProc)(byte *target, const byte *source, uint width);
+
+/**
+ * A set of cel row drawing routines for one instruction set. All kernels
+ * produce exactly the same output as the scalar one.
+ */
+struct CelRowKernel {
+	const char *name;
+	CelDrawSkipProc drawSkip;
+	CelDrawBelowProc drawBelow;
+	CelReverseProc reverse;
+};
+
+enum CelRowKernelType {
+	kCelRowKernelScalar = 0,
+	kCelRowKernelSSE2,
+	kCelRowKernelNEON,
+
+	kCelRowKernelCount
+};
+
+/**
+ * Returns the kernel of the given type, or nullptr if it is not available
+ * in this build or not supported by the host CPU.
+ */
+const CelRowKernel *getCelRowKernel(CelRowKernelType type);
+
+/**
+ * Returns the fastest kernel available on the host.
+ */
+const CelRowKernel &getDefaultCelRowKernel();
+
+} // End of namespace Sci
+
+#endif
@@ -24,6 +24,7 @@
 #include "sci/engine/features.h"
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
+#include "sci/graphics/celkernels32.h"
 #include "sci/graphics/celobj32.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/palette32.h"
@@ -85,10 +86,14 @@ const CelScalerTable &CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
+bool CelObj::_larryScaleEnabled = false;
 
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
+	updateLarryScaleEnabled();
+	// Pick the row kernel before any worker thread asks for it
+	getDefaultCelRowKernel();
 	_nextCacheId = 1;
 	_scaler.reset(new CelScaler());
 	_cache.reset(new CelCache(100));
@@ -112,13 +117,18 @@ struct SCALER_NoScale {
 	const int16 _lastIndex;
 	const int16 _sourceX;
 	const int16 _sourceY;
+	const CelRowKernel &_kernel;
+	// Flipped rows are reversed into here, so they can be drawn with the
+	// same row kernels as unflipped ones
+	byte _buffer[FLIP ? kCelScalerTableSize : 1];
 
 	SCALER_NoScale(const CelObj &celObj, const int16 maxWidth, const Common::Point &scaledPosition) :
 	_row(nullptr),
 	_reader(celObj, FLIP ? celObj._width : maxWidth),
 	_lastIndex(celObj._width - 1),
 	_sourceX(scaledPosition.x),
-	_sourceY(scaledPosition.y) {}
+	_sourceY(scaledPosition.y),
+	_kernel(getDefaultCelRowKernel()) {}
 
 	inline void setTarget(const int16 x, const int16 y) {
 		_row = _reader.getRow(y - _sourceY);
@@ -138,13 +148,15 @@ struct SCALER_NoScale {
 		}
 	}
 
-	inline byte read() {
-		assert(_row != _rowEdge);
-
+	inline const byte *readRow(const int16 width) {
 		if (FLIP) {
-			return *_row--;
+			assert(_row - width >= _rowEdge);
+			assert(width <= (int16)sizeof(_buffer));
+			_kernel.reverse(_buffer, _row - width + 1, width);
+			return _buffer;
 		} else {
-			return *_row++;
+			assert(_row + width <= _rowEdge);
+			return _row;
 		}
 	}
 };
@@ -161,8 +173,14 @@ struct SCALER_Scale {
 	// image and takes precedence over _reader.
 	Common::SharedPtr<Buffer> _sourceBuffer;
 	int16 _x;
-	static int16 _valuesX[kCelScalerTableSize];
-	static int16 _valuesY[kCelScalerTableSize];
+	// The source pixels of a row are gathered into here before drawing
+	byte *_buffer;
+	// The lookup tables belong to the scaler rather than being static like
+	// in SSCI, so that cels can be drawn from several threads. Like the row
+	// buffer, they are indexed by target coordinates and live on the heap,
+	// as worker threads may have small stacks.
+	int16 *_valuesX;
+	int16 *_valuesY;
 
 	SCALER_Scale(const CelObj &celObj, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio scaleX, const Ratio scaleY) :
 	_row(nullptr),
@@ -174,7 +192,10 @@ struct SCALER_Scale {
 	// data it requires if downscaling, so just always make the reader
 	// decompress an entire line of source data when scaling
 	_reader(celObj, celObj._width),
-	_sourceBuffer() {
+	_sourceBuffer(),
+	_buffer(new byte[targetRect.width()]),
+	_valuesX(new int16[targetRect.right]),
+	_valuesY(new int16[targetRect.bottom]) {
 #ifndef NDEBUG
 		assert(_minX <= _maxX);
 #endif
@@ -201,10 +222,10 @@ struct SCALER_Scale {
 		// games which use global scaling are the ones that use low-resolution
 		// script coordinates too.
 
+		Common::StackLock lock(CelObj::_scaler->getMutex());
 		const CelScalerTable &table = CelObj::_scaler->getScalerTable(scaleX, scaleY);
 
-		const bool useLarryScale = Common::checkGameGUIOption(GAMEOPTION_LARRYSCALE, ConfMan.get("guioptions")) && ConfMan.getBool("enable_larryscale");
-		if (useLarryScale) {
+		if (CelObj::isLarryScaleEnabled()) {
 			// LarryScale is an alternative, high-quality cel scaler implemented
 			// for ScummVM. Due to the nature of smooth upscaling, it does *not*
 			// respect the global scaling pattern. Instead, it simply scales the
@@ -291,6 +312,12 @@ struct SCALER_Scale {
 		}
 	}
 
+	~SCALER_Scale() {
+		delete[] _buffer;
+		delete[] _valuesX;
+		delete[] _valuesY;
+	}
+
 	inline void setTarget(const int16 x, const int16 y) {
 		_row = _sourceBuffer
 			? static_cast<const byte *>( _sourceBuffer->getBasePtr(0, _valuesY[y]))
@@ -299,17 +326,16 @@ struct SCALER_Scale {
 		assert(_x >= _minX && _x <= _maxX);
 	}
 
-	inline byte read() {
-		assert(_x >= _minX && _x <= _maxX);
-		return _row[_valuesX[_x++]];
+	inline const byte *readRow(const int16 width) {
+		assert(_x >= _minX && _x + width - 1 <= _maxX);
+		const int16 *valuesX = _valuesX + _x;
+		for (int16 i = 0; i < width; ++i) {
+			_buffer[i] = _row[valuesX[i]];
+		}
+		return _buffer;
 	}
 };
 
-template<bool FLIP, typename READER>
-int16 SCALER_Scale<FLIP, READER>::_valuesX[kCelScalerTableSize];
-template<bool FLIP, typename READER>
-int16 SCALER_Scale<FLIP, READER>::_valuesY[kCelScalerTableSize];
-
 #pragma mark -
 #pragma mark CelObj - Resource readers
 
@@ -327,7 +353,7 @@ public:
 	_sourceHeight(celObj._height),
 #endif
 	_sourceWidth(celObj._width) {
-		const SciSpan<const byte> resource = celObj.getResPointer();
+		const SciSpan<const byte> resource = celObj.getDrawResPointer();
 		const uint32 pixelsOffset = resource.getUint32SEAt(celObj._celHeaderOffset + 24);
 		const int32 numPixels = MIN<int32>(resource.size() - pixelsOffset, celObj._width * celObj._height);
 
@@ -361,7 +387,7 @@ private:
 
 public:
 	READER_Compressed(const CelObj &celObj, const int16 maxWidth) :
-	_resource(celObj.getResPointer()),
+	_resource(celObj.getDrawResPointer()),
 	_y(-1),
 	_sourceHeight(celObj._height),
 	_skipColor(celObj._skipColor),
@@ -436,15 +462,20 @@ public:
 #pragma mark -
 #pragma mark CelObj - Remappers
 
+// The mappers draw a whole row of source pixels at once, using the row
+// kernels of celkernels32.h.
+
 /**
  * Pixel mapper for a CelObj with transparent pixels and no
  * remapping data.
  */
 struct MAPPER_NoMD {
-	inline void draw(byte *target, const byte pixel, const uint8 skipColor) const {
-		if (pixel != skipColor) {
-			*target = pixel;
-		}
+	const CelRowKernel &_kernel;
+
+	MAPPER_NoMD() : _kernel(getDefaultCelRowKernel()) {}
+
+	inline void draw(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
+		_kernel.drawSkip(target, source, width, skipColor);
 	}
 };
 
@@ -453,8 +484,8 @@ struct MAPPER_NoMD {
  * no remapping data.
  */
 struct MAPPER_NoMDNoSkip {
-	inline void draw(byte *target, const byte pixel, const uint8) const {
-		*target = pixel;
+	inline void draw(byte *target, const byte *source, const int16 width, const uint8) const {
+		memcpy(target, source, width);
 	}
 };
 
@@ -463,14 +494,24 @@ struct MAPPER_NoMDNoSkip {
  * remapping data, and remapping enabled.
  */
 struct MAPPER_Map {
-	inline void draw(byte *target, const byte pixel, const uint8 skipColor) const {
-		if (pixel != skipColor) {
-			// For some reason, SSCI never checks if the source pixel is *above*
-			// the range of remaps, so we do not either.
-			if (pixel < g_sci->_gfxRemap32->getStartColor()) {
-				*target = pixel;
-			} else if (g_sci->_gfxRemap32->remapEnabled(pixel)) {
-				*target = g_sci->_gfxRemap32->remapColor(pixel, *target);
+	const CelRowKernel &_kernel;
+
+	MAPPER_Map() : _kernel(getDefaultCelRowKernel()) {}
+
+	inline void draw(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
+		// For some reason, SSCI never checks if the source pixel is *above*
+		// the range of remaps, so we do not either.
+		const uint8 startColor = g_sci->_gfxRemap32->getStartColor();
+		if (!_kernel.drawBelow(target, source, width, skipColor, startColor)) {
+			return;
+		}
+
+		// Remapped pixels depend on the target, so they are blended one by
+		// one, in the rows which contain any
+		for (int16 x = 0; x < width; ++x) {
+			const byte pixel = source[x];
+			if (pixel != skipColor && pixel >= startColor && g_sci->_gfxRemap32->remapEnabled(pixel)) {
+				target[x] = g_sci->_gfxRemap32->remapColor(pixel, target[x]);
 			}
 		}
 	}
@@ -481,20 +522,27 @@ struct MAPPER_Map {
  * remapping data, and remapping disabled.
  */
 struct MAPPER_NoMap {
-	inline void draw(byte *target, const byte pixel, const uint8 skipColor) const {
+	const CelRowKernel &_kernel;
+
+	MAPPER_NoMap() : _kernel(getDefaultCelRowKernel()) {}
+
+	inline void draw(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
 		// For some reason, SSCI never checks if the source pixel is *above* the
 		// range of remaps, so we do not either.
-		if (pixel != skipColor && pixel < g_sci->_gfxRemap32->getStartColor()) {
-			*target = pixel;
-		}
+		_kernel.drawBelow(target, source, width, skipColor, g_sci->_gfxRemap32->getStartColor());
 	}
 };
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
+	_drawBlackLines = screenItem._drawBlackLines;
+	drawCel(target, screenItem, targetRect);
+	_drawBlackLines = false;
+}
+
+void CelObj::drawCel(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
 	const Common::Point &scaledPosition = screenItem._scaledPosition;
 	const Ratio &scaleX = screenItem._ratioX;
 	const Ratio &scaleY = screenItem._ratioY;
-	_drawBlackLines = screenItem._drawBlackLines;
 
 	if (_remap) {
 		// In SSCI, this check was `g_Remap_numActiveRemaps && _remap`, but
@@ -576,8 +624,6 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 			}
 		}
 	}
-
-	_drawBlackLines = false;
 }
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect, bool mirrorX) {
@@ -591,6 +637,36 @@ void CelObj::draw(Buffer &target, const Common::Rect &targetRect, const Common::
 	drawTo(target, targetRect, scaledPosition, square, square);
 }
 
+void CelObj::beginSharedDraw(const bool mirrorX) {
+	_drawMirrored = mirrorX;
+	const SciSpan<const byte> data = getResPointer();
+	_sharedData = data.getUnsafeDataAt(0, data.size());
+	_sharedSize = data.size();
+}
+
+void CelObj::drawShared(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
+	assert(_sharedData && !screenItem._drawBlackLines);
+	drawCel(target, screenItem, targetRect);
+}
+
+void CelObj::endSharedDraw() {
+	_sharedData = nullptr;
+	_sharedSize = 0;
+}
+
+const SciSpan<const byte> CelObj::getDrawResPointer() const {
+	// The span is not named after the resource like the one returned by
+	// getResPointer, as copying a shared name is not thread-safe
+	if (_sharedData) {
+		return SciSpan<const byte>(_sharedData, _sharedSize);
+	}
+	return getResPointer();
+}
+
+void CelObj::updateLarryScaleEnabled() {
+	_larryScaleEnabled = Common::checkGameGUIOption(GAMEOPTION_LARRYSCALE, ConfMan.get("guioptions")) && ConfMan.getBool("enable_larryscale");
+}
+
 void CelObj::drawTo(Buffer &target, Common::Rect const &targetRect, Common::Point const &scaledPosition, Ratio const &scaleX, Ratio const &scaleY) const {
 	if (_remap) {
 		if (scaleX.isOne() && scaleY.isOne()) {
@@ -733,12 +809,9 @@ struct RENDERER {
 			}
 
 			_scaler.setTarget(targetRect.left, targetRect.top + y);
+			_mapper.draw(targetPixel, _scaler.readRow(targetWidth), targetWidth, _skipColor);
 
-			for (int16 x = 0; x < targetWidth; ++x) {
-				_mapper.draw(targetPixel++, _scaler.read(), _skipColor);
-			}
-
-			targetPixel += skipStride;
+			targetPixel += targetWidth + skipStride;
 		}
 	}
 };
@@ -1108,6 +1181,18 @@ const SciSpan<const byte> CelObjView::getResPointer() const {
 	return *resource;
 }
 
+void CelObjView::beginSharedDraw(const bool mirrorX) {
+	// Keep the view in memory while other threads draw from it
+	g_sci->getResMan()->findResource(ResourceId(kResourceTypeView, _info.resourceId), true);
+	CelObj::beginSharedDraw(mirrorX);
+}
+
+void CelObjView::endSharedDraw() {
+	CelObj::endSharedDraw();
+	ResourceManager *resMan = g_sci->getResMan();
+	resMan->unlockResource(resMan->testResource(ResourceId(kResourceTypeView, _info.resourceId)));
+}
+
 Common::Point CelObjView::getLinkPosition(const int16 linkId) const {
 	const SciSpan<const byte> resource = getResPointer();
 
@@ -1267,6 +1352,17 @@ const SciSpan<const byte> CelObjPic::getResPointer() const {
 	return *resource;
 }
 
+void CelObjPic::beginSharedDraw(const bool mirrorX) {
+	g_sci->getResMan()->findResource(ResourceId(kResourceTypePic, _info.resourceId), true);
+	CelObj::beginSharedDraw(mirrorX);
+}
+
+void CelObjPic::endSharedDraw() {
+	CelObj::endSharedDraw();
+	ResourceManager *resMan = g_sci->getResMan();
+	resMan->unlockResource(resMan->testResource(ResourceId(kResourceTypePic, _info.resourceId)));
+}
+
 #pragma mark -
 #pragma mark CelObjMem
 
@@ -1334,6 +1430,13 @@ void CelObjColor::draw(Buffer &target, const Common::Rect &targetRect, const Com
 void CelObjColor::draw(Buffer &target, const Common::Rect &targetRect) const {
 	target.fillRect(targetRect, _info.color);
 }
+void CelObjColor::beginSharedDraw(const bool mirrorX) {
+	_drawMirrored = mirrorX;
+}
+void CelObjColor::drawShared(Buffer &target, const ScreenItem &, const Common::Rect &targetRect) const {
+	draw(target, targetRect);
+}
+void CelObjColor::endSharedDraw() {}
 
 CelObjColor *CelObjColor::duplicate() const {
 	return new CelObjColor(*this);
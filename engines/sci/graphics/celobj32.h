@@ -23,6 +23,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/mutex.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource.h"
@@ -212,6 +213,11 @@ class CelScaler {
 	 */
 	void buildLookupTable(int *table, const Ratio &ratio, const int size);
 
+	/**
+	 * Guards the scale tables, which are shared by all threads drawing cels.
+	 */
+	Common::Mutex _mutex;
+
 public:
 	CelScaler() :
 		_scaleTables(),
@@ -232,6 +238,12 @@ public:
 	 * Retrieves scaler tables for the given X and Y ratios.
 	 */
 	const CelScalerTable &getScalerTable(const Ratio &scaleX, const Ratio &scaleY);
+
+	/**
+	 * Returns the mutex which must be held while retrieving and reading scaler
+	 * tables.
+	 */
+	Common::Mutex &getMutex() { return _mutex; }
 };
 
 #pragma mark -
@@ -254,6 +266,11 @@ protected:
 	 */
 	static bool _drawBlackLines;
 
+	/**
+	 * The LarryScale setting, see isLarryScaleEnabled().
+	 */
+	static bool _larryScaleEnabled;
+
 	/**
 	 * When true, this cel will be horizontally mirrored when it is drawn. This
 	 * is an internal flag that is set by draw methods based on the combination
@@ -262,6 +279,15 @@ protected:
 	 */
 	bool _drawMirrored;
 
+	/**
+	 * The raw resource data of the cel while it is prepared for shared
+	 * drawing, or null.
+	 *
+	 * @see beginSharedDraw
+	 */
+	const byte *_sharedData;
+	uint32 _sharedSize;
+
 public:
 	static Common::ScopedPtr<CelScaler> _scaler;
 
@@ -345,8 +371,21 @@ public:
 	 */
 	static void deinit();
 
+	CelObj() : _drawMirrored(false), _sharedData(nullptr), _sharedSize(0) {}
 	virtual ~CelObj() {};
 
+	/**
+	 * Whether cels are scaled with LarryScale, as of the last call to
+	 * updateLarryScaleEnabled(). Safe to call from the worker threads.
+	 */
+	static bool isLarryScaleEnabled() { return _larryScaleEnabled; }
+
+	/**
+	 * Reads the LarryScale setting. Called on the main thread before drawing
+	 * a frame, as the configuration must not be read by the worker threads.
+	 */
+	static void updateLarryScaleEnabled();
+
 	/**
 	 * Draws the cel to the target buffer using the priority and positioning
 	 * information from the given screen item. The mirroring of the cel will be
@@ -383,6 +422,32 @@ public:
 	 */
 	void drawTo(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const;
 
+	/**
+	 * Prepares the cel for drawing with `drawShared`. This sets the mirroring
+	 * like `draw` does and keeps the resource data of the cel in memory until
+	 * `endSharedDraw` is called. Must be called from the main thread.
+	 */
+	virtual void beginSharedDraw(const bool mirrorX);
+
+	/**
+	 * Draws the cel to the target buffer like `draw` does, but without
+	 * changing any state, so that several threads can draw disjoint parts of
+	 * the target at the same time. Screen items which draw black lines are not
+	 * supported.
+	 */
+	virtual void drawShared(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const;
+
+	/**
+	 * Releases the resource data kept by `beginSharedDraw`.
+	 */
+	virtual void endSharedDraw();
+
+	/**
+	 * Retrieves the raw resource data to draw from, which is the data kept by
+	 * `beginSharedDraw` during shared drawing.
+	 */
+	const SciSpan<const byte> getDrawResPointer() const;
+
 	/**
 	 * Creates a copy of this cel on the free store and returns a pointer to the
 	 * new object. The new cel will point to a shared copy of bitmap/resource
@@ -411,6 +476,8 @@ public:
 #pragma mark -
 #pragma mark CelObj - Drawing
 private:
+	void drawCel(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const;
+
 	template<typename MAPPER, typename SCALER>
 	void render(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const;
 
@@ -509,6 +576,9 @@ public:
 	 */
 	void draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, bool mirrorX, const Ratio &scaleX, const Ratio &scaleY);
 
+	void beginSharedDraw(const bool mirrorX) override;
+	void endSharedDraw() override;
+
 	CelObjView *duplicate() const override;
 	const SciSpan<const byte> getResPointer() const override;
 
@@ -553,6 +623,9 @@ public:
 	using CelObj::draw;
 	void draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const bool mirrorX) override;
 
+	void beginSharedDraw(const bool mirrorX) override;
+	void endSharedDraw() override;
+
 	CelObjPic *duplicate() const override;
 	const SciSpan<const byte> getResPointer() const override;
 };
@@ -594,6 +667,10 @@ public:
 	void draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect, const bool mirrorX) override;
 	void draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const bool mirrorX) override;
 
+	void beginSharedDraw(const bool mirrorX) override;
+	void drawShared(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const override;
+	void endSharedDraw() override;
+
 	CelObjColor *duplicate() const override;
 	const SciSpan<const byte> getResPointer() const override;
 };
@@ -23,6 +23,7 @@
 #include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/events.h"
+#include "common/jobsystem.h"
 #include "common/keyboard.h"
 #include "common/list.h"
 #include "common/str.h"
@@ -71,7 +72,13 @@ GfxFrameout::GfxFrameout(SegManager *segMan, GfxPalette32 *palette, GfxTransitio
 	_overdrawThreshold(0),
 	_throttleKernelFrameOut(true),
 	_palMorphIsOn(false),
-	_lastScreenUpdateTick(0) {
+	_lastScreenUpdateTick(0),
+	_parallelRendering(ConfMan.hasKey("parallel_rendering") ? ConfMan.getBool("parallel_rendering") : false),
+	_numBands(0),
+	_renderScreenItemLists(nullptr),
+	_renderEraseLists(nullptr) {
+
+	resetFrameTimes();
 
 	if (g_sci->getGameId() == GID_PHANTASMAGORIA) {
 		_currentBuffer.create(630, 450, Graphics::PixelFormat::createFormatCLUT8());
@@ -459,6 +466,8 @@ void GfxFrameout::kernelAddPicAt(const reg_t planeObject, const GuiResourceId pi
 #pragma mark Rendering
 
 void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseRect) {
+	const uint32 startTime = g_system->getMillis();
+
 	updateMousePositionForRendering();
 
 	RobotDecoder &robotPlayer = g_sci->_video32->getRobotPlayer();
@@ -494,10 +503,7 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 
 	_remapOccurred = _palette->updateForFrame();
 
-	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
-		drawEraseList(eraseLists[i], *_planes[i]);
-		drawScreenItemList(screenItemLists[i]);
-	}
+	const bool parallel = drawLists(screenItemLists, eraseLists);
 
 	if (robotIsActive) {
 		robotPlayer.frameAlmostVisible();
@@ -512,6 +518,8 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 	if (robotIsActive) {
 		robotPlayer.frameNowVisible();
 	}
+
+	recordFrameTime(g_system->getMillis() - startTime, parallel);
 }
 
 void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *showStyle) {
@@ -551,10 +559,7 @@ void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *show
 
 	_remapOccurred = _palette->updateForFrame();
 
-	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
-		drawEraseList(eraseLists[i], *_planes[i]);
-		drawScreenItemList(screenItemLists[i]);
-	}
+	drawLists(screenItemLists, eraseLists);
 
 	Palette nextPalette(_palette->getNextPalette());
 
@@ -606,10 +611,7 @@ void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *show
 
 	_remapOccurred = _palette->updateForFrame();
 
-	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
-		drawEraseList(eraseLists[i], *_planes[i]);
-		drawScreenItemList(screenItemLists[i]);
-	}
+	drawLists(screenItemLists, eraseLists);
 
 	_palette->submit(nextPalette);
 	_palette->updateFFrame();
@@ -998,6 +1000,22 @@ void GfxFrameout::drawScreenItemList(const DrawList &screenItemList) {
 	}
 }
 
+bool GfxFrameout::drawLists(const ScreenItemListList &screenItemLists, const EraseListList &eraseLists) {
+	// The worker threads must not read the configuration
+	CelObj::updateLarryScaleEnabled();
+
+	if (shouldDrawInParallel(screenItemLists, eraseLists)) {
+		drawListsInParallel(screenItemLists, eraseLists);
+		return true;
+	}
+
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		drawEraseList(eraseLists[i], *_planes[i]);
+		drawScreenItemList(screenItemLists[i]);
+	}
+	return false;
+}
+
 void GfxFrameout::mergeToShowList(const Common::Rect &drawRect, RectList &showList, const int overdrawThreshold) {
 	RectList mergeList;
 	Common::Rect merged;
@@ -1260,6 +1278,145 @@ void GfxFrameout::shakeScreen(int16 numShakes, const ShakeDirection direction) {
 	}
 }
 
+#pragma mark -
+#pragma mark Parallel rendering
+
+bool GfxFrameout::shouldDrawInParallel(const ScreenItemListList &screenItemLists, const EraseListList &eraseLists) const {
+	if (!_parallelRendering || !g_system->getJobSystem().getThreadCount() || CelObj::isLarryScaleEnabled()) {
+		return false;
+	}
+
+	int area = 0;
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		const DrawList &drawList = screenItemLists[i];
+		for (DrawList::size_type j = 0; j < drawList.size(); ++j) {
+			// The black lines alternate relative to the top of the drawn
+			// rectangle, which differs between bands
+			if (drawList[j]->screenItem->_drawBlackLines) {
+				return false;
+			}
+			area += drawList[j]->rect.width() * drawList[j]->rect.height();
+		}
+
+		if (_planes[i]->_type == kPlaneTypeColored) {
+			const RectList &eraseList = eraseLists[i];
+			for (RectList::size_type j = 0; j < eraseList.size(); ++j) {
+				area += eraseList[j]->width() * eraseList[j]->height();
+			}
+		}
+	}
+
+	return area >= kMinParallelArea;
+}
+
+void GfxFrameout::drawListsInParallel(const ScreenItemListList &screenItemLists, const EraseListList &eraseLists) {
+	// Everything touching shared state happens up front on this thread: the
+	// show list is built in the same order as when drawing serially, and the
+	// cels keep their resources in memory until all bands are drawn
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		if (_planes[i]->_type == kPlaneTypeColored) {
+			const RectList &eraseList = eraseLists[i];
+			for (RectList::size_type j = 0; j < eraseList.size(); ++j) {
+				mergeToShowList(*eraseList[j], _showList, _overdrawThreshold);
+			}
+		}
+
+		const DrawList &drawList = screenItemLists[i];
+		for (DrawList::size_type j = 0; j < drawList.size(); ++j) {
+			mergeToShowList(drawList[j]->rect, _showList, _overdrawThreshold);
+			const ScreenItem &screenItem = *drawList[j]->screenItem;
+			CelObj &celObj = *screenItem._celObj;
+			celObj.beginSharedDraw(screenItem._mirrorX ^ celObj._mirrorX);
+		}
+	}
+
+	Common::JobSystem &jobSystem = g_system->getJobSystem();
+	const int numThreads = jobSystem.getThreadCount() + 1;
+	_renderScreenItemLists = &screenItemLists;
+	_renderEraseLists = &eraseLists;
+	_numBands = MIN<int>(numThreads * kBandsPerThread, _currentBuffer.h / kMinBandHeight);
+
+	jobSystem.parallelFor(0, _numBands, 1, drawBands, this);
+
+	_renderScreenItemLists = nullptr;
+	_renderEraseLists = nullptr;
+
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		const DrawList &drawList = screenItemLists[i];
+		for (DrawList::size_type j = 0; j < drawList.size(); ++j) {
+			drawList[j]->screenItem->_celObj->endSharedDraw();
+		}
+	}
+}
+
+void GfxFrameout::drawBands(void *param, uint begin, uint end) {
+	GfxFrameout &frameout = *(GfxFrameout *)param;
+	const Graphics::Surface &buffer = frameout._currentBuffer;
+
+	for (uint band = begin; band < end; ++band) {
+		const int16 top = buffer.h * band / frameout._numBands;
+		const int16 bottom = buffer.h * (band + 1) / frameout._numBands;
+		frameout.drawBand(Common::Rect(0, top, buffer.w, bottom));
+	}
+}
+
+void GfxFrameout::drawBand(const Common::Rect &band) {
+	const ScreenItemListList &screenItemLists = *_renderScreenItemLists;
+	const EraseListList &eraseLists = *_renderEraseLists;
+
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		const Plane &plane = *_planes[i];
+		if (plane._type == kPlaneTypeColored) {
+			const RectList &eraseList = eraseLists[i];
+			for (RectList::size_type j = 0; j < eraseList.size(); ++j) {
+				const Common::Rect rect = eraseList[j]->findIntersectingRect(band);
+				if (!rect.isEmpty()) {
+					_currentBuffer.fillRect(rect, plane._back);
+				}
+			}
+		}
+
+		const DrawList &drawList = screenItemLists[i];
+		for (DrawList::size_type j = 0; j < drawList.size(); ++j) {
+			const Common::Rect rect = drawList[j]->rect.findIntersectingRect(band);
+			if (!rect.isEmpty()) {
+				const ScreenItem &screenItem = *drawList[j]->screenItem;
+				screenItem._celObj->drawShared(_currentBuffer, screenItem, rect);
+			}
+		}
+	}
+}
+
+void GfxFrameout::recordFrameTime(const uint32 time, const bool parallel) {
+	int bucket = 0;
+	for (uint32 t = time; t && bucket < kFrameTimeBuckets - 1; t >>= 1) {
+		++bucket;
+	}
+	++_frameTimes[parallel][bucket];
+}
+
+void GfxFrameout::resetFrameTimes() {
+	memset(_frameTimes, 0, sizeof(_frameTimes));
+}
+
+void GfxFrameout::printFrameTimes(Console *con) const {
+	con->debugPrintf("Parallel rendering: %s, %u worker threads\n", _parallelRendering ? "on" : "off", g_system->getJobSystem().getThreadCount());
+	con->debugPrintf("Frame time      serial  parallel\n");
+	for (int i = 0; i < kFrameTimeBuckets; ++i) {
+		Common::String range;
+		if (i == 0) {
+			range = "< 1 ms";
+		} else if (i == 1) {
+			range = "1 ms";
+		} else if (i == kFrameTimeBuckets - 1) {
+			range = Common::String::format(">= %d ms", 1 << (i - 1));
+		} else {
+			range = Common::String::format("%d-%d ms", 1 << (i - 1), (1 << i) - 1);
+		}
+		con->debugPrintf("%-12s %9u %9u\n", range.c_str(), _frameTimes[0][i], _frameTimes[1][i]);
+	}
+}
+
 #pragma mark -
 #pragma mark Mouse cursor
 
@@ -369,6 +369,14 @@ private:
 	 */
 	void drawScreenItemList(const DrawList &screenItemList);
 
+	/**
+	 * Draws the erase and draw lists of all planes to the visible screen
+	 * buffer, using the worker threads when possible.
+	 *
+	 * @returns true if the lists were drawn in parallel
+	 */
+	bool drawLists(const ScreenItemListList &screenItemLists, const EraseListList &eraseLists);
+
 	/**
 	 * Adds a new rectangle to the list of regions to write out to the hardware.
 	 * The provided rect may be merged into an existing rectangle to reduce the
@@ -405,6 +413,82 @@ private:
 		}
 	}
 
+#pragma mark -
+#pragma mark Parallel rendering
+public:
+	/**
+	 * Enables or disables drawing frames on several threads.
+	 */
+	void setParallelRendering(const bool enable) { _parallelRendering = enable; }
+	bool getParallelRendering() const { return _parallelRendering; }
+
+	/**
+	 * Prints the histogram of the times taken by `frameOut`.
+	 */
+	void printFrameTimes(Console *con) const;
+	void resetFrameTimes();
+
+private:
+	enum {
+		/** The number of bands each thread draws on average */
+		kBandsPerThread = 4,
+		/** The minimum height of a band */
+		kMinBandHeight = 8,
+		/** The minimum number of pixels drawn by a frame to draw it in parallel */
+		kMinParallelArea = 16000,
+		/** The number of buckets of the frame time histogram */
+		kFrameTimeBuckets = 8
+	};
+
+	/**
+	 * When true, frames are split into horizontal bands, which are drawn by
+	 * the worker threads of the job system. Every band is drawn like the whole
+	 * frame would be, so the result is exactly the same as when drawing
+	 * serially. Off unless enabled with the parallel_rendering setting or the
+	 * console.
+	 */
+	bool _parallelRendering;
+
+	/** The number of bands of the frame being drawn */
+	int _numBands;
+
+	/**
+	 * The lists of the frame being drawn. They are only read while the bands
+	 * are drawn.
+	 */
+	const ScreenItemListList *_renderScreenItemLists;
+	const EraseListList *_renderEraseLists;
+
+	/**
+	 * Frame time histograms for serial and parallel drawing. Bucket 0 counts
+	 * frames taking less than 1ms, bucket n > 0 frames taking 2^(n-1) to
+	 * 2^n - 1 ms, and the last bucket all slower frames.
+	 */
+	uint32 _frameTimes[2][kFrameTimeBuckets];
+
+	/**
+	 * Whether the given frame can be drawn in parallel, and is large enough
+	 * for it to pay off.
+	 */
+	bool shouldDrawInParallel(const ScreenItemListList &screenItemLists, const EraseListList &eraseLists) const;
+
+	/**
+	 * Draws the given frame on the worker threads and the calling thread.
+	 */
+	void drawListsInParallel(const ScreenItemListList &screenItemLists, const EraseListList &eraseLists);
+
+	/**
+	 * Draws the bands from begin up to (excluding) end of the current frame.
+	 */
+	static void drawBands(void *param, uint begin, uint end);
+
+	/**
+	 * Draws the part of the current frame inside the given band.
+	 */
+	void drawBand(const Common::Rect &band);
+
+	void recordFrameTime(const uint32 time, const bool parallel);
+
 #pragma mark -
 #pragma mark Mouse cursor
 public:
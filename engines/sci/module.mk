@@ -8,6 +8,7 @@ MODULE_OBJS := \
 	resource.o \
 	resource_audio.o \
 	resource_patcher.o \
+	resource_prefetch.o \
 	sci.o \
 	util.o \
 	engine/features.o \
@@ -86,6 +87,7 @@ ifdef ENABLE_SCI32
 MODULE_OBJS += \
 	engine/hoyle5poker.o \
 	engine/kgraphics32.o \
+	graphics/celkernels32.o \
 	graphics/celobj32.o \
 	graphics/controls32.o \
 	graphics/frameout.o \
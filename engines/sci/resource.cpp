@@ -207,6 +207,8 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_fileOffset = 0;
 	_status = kResStatusNoMalloc;
 	_lockers = 0;
+	_lruPrev = nullptr;
+	_lruNext = nullptr;
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
@@ -970,13 +972,19 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager(const bool detectionMode) :
-	_detectionMode(detectionMode) {}
+	_detectionMode(detectionMode), _recordingAccesses(!detectionMode), _accessLogChanged(false),
+	_prefetchRoomNumber(0), _prefetching(false), _prefetchDone(0),
+	_prefetchQuit(false) {}
 
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
-	_LRU.clear();
+	for (int i = 0; i < kLRUClassCount; ++i) {
+		_LRU[i].head = _LRU[i].tail = nullptr;
+		_LRU[i].memory = 0;
+	}
+	memset(_typeStats, 0, sizeof(_typeStats));
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1069,6 +1077,8 @@ void ResourceManager::init() {
 }
 
 ResourceManager::~ResourceManager() {
+	stopPrefetching();
+
 	// freeing resources
 	ResourceMap::iterator itr = _resMap.begin();
 	while (itr != _resMap.end()) {
@@ -1084,12 +1094,43 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+ResourceManager::LRUClass ResourceManager::getLRUClass(ResourceType type) {
+	switch (type) {
+	case kResourceTypeScript:
+	case kResourceTypeHeap:
+	case kResourceTypeText:
+	case kResourceTypeVocab:
+	case kResourceTypeMessage:
+	case kResourceTypeFont:
+	case kResourceTypeCursor:
+	case kResourceTypePalette:
+	case kResourceTypeClut:
+	case kResourceTypePatch:
+	case kResourceTypeMap:
+		return kLRUCode;
+	default:
+		return kLRUMedia;
+	}
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+
+	LRUList &list = _LRU[getLRUClass(res->getType())];
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		list.head = res->_lruNext;
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		list.tail = res->_lruPrev;
+	res->_lruPrev = res->_lruNext = nullptr;
+
+	list.memory -= res->size();
 	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
@@ -1099,7 +1140,17 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
+
+	LRUList &list = _LRU[getLRUClass(res->getType())];
+	res->_lruPrev = nullptr;
+	res->_lruNext = list.head;
+	if (list.head)
+		list.head->_lruPrev = res;
+	else
+		list.tail = res;
+	list.head = res;
+
+	list.memory += res->size();
 	_memoryLRU += res->size();
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
@@ -1112,15 +1163,13 @@ void ResourceManager::addToLRU(Resource *res) {
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
-
-	while (it != _LRU.end()) {
-		res = *it;
-		debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
-		mem += res->size();
-		++entries;
-		++it;
+
+	for (int i = 0; i < kLRUClassCount; ++i) {
+		for (Resource *res = _LRU[i].head; res; res = res->_lruNext) {
+			debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
+			mem += res->size();
+			++entries;
+		}
 	}
 
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
@@ -1128,10 +1177,18 @@ void ResourceManager::printLRU() {
 
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+		// Free the least recently used resource of the lowest class, so
+		// large media resources go before the scripts
+		LRUList *list = _LRU;
+		while (!list->tail) {
+			++list;
+			assert(list != _LRU + kLRUClassCount);
+		}
+
+		Resource *goner = list->tail;
 		removeFromLRU(goner);
 		goner->unalloc();
+		_typeStats[goner->getType()].evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
@@ -1174,15 +1231,23 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (!_prefetchJobs.empty())
+		adoptPrefetches(retval);
+
+	if (retval->_status == kResStatusNoMalloc) {
+		_typeStats[id.getType()].misses++;
+		recordAccess(id);
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		// The resource is removed from its current position
-		// in the LRU list because it has been requested
-		// again. Below, it will either be locked, or it
-		// will be added back to the LRU list at the 'most
-		// recent' position.
-		removeFromLRU(retval);
+	} else {
+		_typeStats[id.getType()].hits++;
+		if (retval->_status == kResStatusEnqueued)
+			// The resource is removed from its current position
+			// in the LRU list because it has been requested
+			// again. Below, it will either be locked, or it
+			// will be added back to the LRU list at the 'most
+			// recent' position.
+			removeFromLRU(retval);
+	}
 
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
@@ -2280,29 +2345,8 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 		return errorNum;
 
 	// getting a decompressor
-	Decompressor *dec = NULL;
-	switch (compression) {
-	case kCompNone:
-		dec = new Decompressor;
-		break;
-	case kCompHuffman:
-		dec = new DecompressorHuffman;
-		break;
-	case kCompLZW:
-	case kCompLZW1:
-	case kCompLZW1View:
-	case kCompLZW1Pic:
-		dec = new DecompressorLZW(compression);
-		break;
-	case kCompDCL:
-		dec = new DecompressorDCL;
-		break;
-#ifdef ENABLE_SCI32
-	case kCompSTACpack:
-		dec = new DecompressorLZS;
-		break;
-#endif
-	default:
+	Decompressor *dec = createDecompressor(compression);
+	if (!dec) {
 		error("Resource %s: Compression method %d not supported", _id.toString().c_str(), compression);
 		return SCI_ERROR_UNKNOWN_COMPRESSION;
 	}
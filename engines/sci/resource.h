@@ -26,6 +26,9 @@
 #include "common/str.h"
 #include "common/list.h"
 #include "common/hashmap.h"
+#include "common/jobsystem.h"
+#include "common/mutex.h"
+#include "common/system.h"
 
 #include "sci/graphics/helpers.h"		// for ViewType
 #include "sci/decompressor.h"
@@ -298,6 +301,8 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	Resource *_lruPrev; /**< More recently used resource in the LRU list */
+	Resource *_lruNext; /**< Less recently used resource in the LRU list */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -396,6 +401,43 @@ public:
 	 */
 	bool hasResourceType(ResourceType type);
 
+	/** Usage statistics of the resources of one type */
+	struct ResourceTypeStats {
+		uint hits;      ///< Requests for resources which were in memory
+		uint misses;    ///< Requests which had to load the resource
+		uint evictions; ///< Resources freed by the LRU
+	};
+
+	const ResourceTypeStats &getResourceTypeStats(ResourceType type) const { return _typeStats[type]; }
+	int getMemoryLocked() const { return _memoryLocked; }
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+
+	/**
+	 * Tells the resource manager that the game is switching to another room.
+	 * The views, pics, palettes and sounds which were loaded in that room
+	 * before, in this or in earlier sessions according to the access log,
+	 * are decompressed on the worker threads and put into the LRU, so the
+	 * room does not have to wait for them.
+	 * The resources loaded from now on are recorded for this room.
+	 */
+	void prefetchRoom(uint16 roomNumber);
+
+	/**
+	 * Reads the access log written by saveAccessLog() in an earlier session.
+	 * Must be called from the main thread.
+	 */
+	void loadAccessLog(const Common::String &fileName);
+
+	/**
+	 * Writes the access log to a save file, if it changed. Must be called
+	 * from the main thread.
+	 */
+	void saveAccessLog(const Common::String &fileName);
+
+	/** Prints the resources recorded per room to the Prefetch debug channel. */
+	void dumpAccessLog() const;
+
 	void setAudioLanguage(int language);
 	int getAudioLanguage() const;
 	void changeAudioDirectory(Common::String path);
@@ -487,7 +529,44 @@ protected:
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+
+	/**
+	 * Resources under LRU control are kept in one of these classes. When
+	 * memory runs out, all resources of a lower class are freed before any
+	 * of a higher class.
+	 */
+	enum LRUClass {
+		kLRUMedia = 0,	///< Large resources, e.g. views, pics, audio
+		kLRUCode,		///< Small resources needed all the time, e.g. scripts, heaps
+		kLRUClassCount
+	};
+
+	/** An intrusive list of resources, most recently used first */
+	struct LRUList {
+		Resource *head;
+		Resource *tail;
+		int memory;	///< Amount of resource bytes in the list
+	};
+
+	LRUList _LRU[kLRUClassCount]; ///< Last Resource Used lists
+	ResourceTypeStats _typeStats[kResourceTypeInvalid];
+
+	/** A resource being decompressed by a job */
+	struct PrefetchJob;
+	typedef Common::HashMap<ResourceId, PrefetchJob *, ResourceIdHash> PrefetchJobMap;
+	typedef Common::HashMap<uint16, Common::Array<ResourceId> > RoomResourceMap;
+
+	RoomResourceMap _roomResources; ///< Resources loaded per room, see prefetchRoom()
+	bool _recordingAccesses;
+	bool _accessLogChanged;
+	uint16 _prefetchRoomNumber;
+
+	bool _prefetching; ///< Set once the jobs can be submitted
+	Common::JobSystem::JobGroup _prefetchGroup;
+	OSystem::SemaphoreRef _prefetchDone; ///< Signalled whenever a job is done
+	PrefetchJobMap _prefetchJobs; ///< Jobs not adopted yet, only touched by the main thread
+	Common::Mutex _prefetchMutex; ///< Guards the state of the jobs, and the member below
+	bool _prefetchQuit;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -622,6 +701,14 @@ protected:
 	void printLRU();
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
+	static LRUClass getLRUClass(ResourceType type);
+
+	void recordAccess(ResourceId id);
+	bool startPrefetching();
+	void stopPrefetching();
+	bool queuePrefetch(Resource *res);
+	void adoptPrefetches(Resource *wanted);
+	static void prefetchJobProc(void *param);
 
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
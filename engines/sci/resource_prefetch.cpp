@@ -0,0 +1,398 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Prefetching of room resources
+
+#include "common/debug-channels.h"
+#include "common/memstream.h"
+#include "common/savefile.h"
+#include "common/textconsole.h"
+#include "sci/resource.h"
+#include "sci/resource_intern.h"
+#include "sci/resource_patcher.h"
+#include "sci/sci.h"
+
+namespace Sci {
+
+// The prefetch jobs only decompress. Reading the compressed data and
+// everything touching a Resource happens on the main thread, as neither
+// the volume files nor the resource map are thread-safe. The decompressors
+// run quietly in the jobs, so damaged data does not end up in warning()
+// or error() there: the job fails instead, and the main thread loads the
+// resource again the regular way, which reports the problem.
+struct ResourceManager::PrefetchJob {
+	ResourceManager *resMan;
+	ResourceId id;
+	ResourceCompression compression;
+	byte *packed;
+	uint32 packedSize;
+	byte *data;
+	uint32 size;
+	int error;
+	bool started;
+	bool cancelled; ///< Set when the main thread forgot about the job, which then deletes itself
+	bool done;
+};
+
+enum {
+	/** Maximum number of resources recorded per room */
+	kMaxRoomResources = 64
+};
+
+static const char *const kAccessLogHeader = "ScummVM SCI resource log 1";
+
+static bool isPrefetchableType(ResourceType type) {
+	switch (type) {
+	case kResourceTypeView:
+	case kResourceTypePic:
+	case kResourceTypePalette:
+	case kResourceTypeSound:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void ResourceManager::recordAccess(ResourceId id) {
+	if (!_recordingAccesses || !isPrefetchableType(id.getType()))
+		return;
+
+	Common::Array<ResourceId> &resources = _roomResources[_prefetchRoomNumber];
+	if (resources.size() >= kMaxRoomResources)
+		return;
+
+	for (uint i = 0; i < resources.size(); ++i) {
+		if (resources[i] == id)
+			return;
+	}
+
+	resources.push_back(id);
+	_accessLogChanged = true;
+}
+
+void ResourceManager::loadAccessLog(const Common::String &fileName) {
+	Common::InSaveFile *file = g_system->getSavefileManager()->openForLoading(fileName);
+	if (!file)
+		return;
+
+	if (file->readLine() != kAccessLogHeader) {
+		warning("Ignoring resource log '%s' with an unknown format", fileName.c_str());
+		delete file;
+		return;
+	}
+
+	// Every line holds a room number followed by the type and number of
+	// each resource loaded in the room
+	while (!file->eos() && !file->err()) {
+		const Common::String line = file->readLine();
+		const char *pos = line.c_str();
+		char *end;
+
+		const uint16 room = strtoul(pos, &end, 10);
+		if (end == pos)
+			continue;
+
+		Common::Array<ResourceId> &resources = _roomResources[room];
+		for (;;) {
+			pos = end;
+			const int type = strtol(pos, &end, 10);
+			if (end == pos)
+				break;
+			pos = end;
+			const uint16 number = strtoul(pos, &end, 10);
+			if (end == pos)
+				break;
+
+			const ResourceId id((ResourceType)type, number);
+			if (isPrefetchableType(id.getType()) && resources.size() < kMaxRoomResources)
+				resources.push_back(id);
+		}
+	}
+
+	debugC(kDebugLevelPrefetch, "Loaded the resource log of %d rooms", _roomResources.size());
+	delete file;
+}
+
+void ResourceManager::saveAccessLog(const Common::String &fileName) {
+	if (!_accessLogChanged)
+		return;
+
+	Common::OutSaveFile *file = g_system->getSavefileManager()->openForSaving(fileName, false);
+	if (!file) {
+		warning("Could not write resource log '%s'", fileName.c_str());
+		return;
+	}
+
+	file->writeString(kAccessLogHeader);
+	file->writeByte('\n');
+	for (RoomResourceMap::const_iterator room = _roomResources.begin(); room != _roomResources.end(); ++room) {
+		file->writeString(Common::String::format("%u", room->_key));
+		for (uint i = 0; i < room->_value.size(); ++i)
+			file->writeString(Common::String::format(" %d %u", room->_value[i].getType(), room->_value[i].getNumber()));
+		file->writeByte('\n');
+	}
+
+	file->finalize();
+	delete file;
+
+	_accessLogChanged = false;
+}
+
+void ResourceManager::dumpAccessLog() const {
+	if (!DebugMan.isDebugChannelEnabled(kDebugLevelPrefetch))
+		return;
+
+	for (RoomResourceMap::const_iterator room = _roomResources.begin(); room != _roomResources.end(); ++room) {
+		Common::String line = Common::String::format("Room %u:", room->_key);
+		for (uint i = 0; i < room->_value.size(); ++i)
+			line += " " + room->_value[i].toString();
+		debugC(kDebugLevelPrefetch, "%s", line.c_str());
+	}
+}
+
+void ResourceManager::prefetchRoom(uint16 roomNumber) {
+	_prefetchRoomNumber = roomNumber;
+
+	RoomResourceMap::const_iterator room = _roomResources.find(roomNumber);
+	if (room == _roomResources.end() || !startPrefetching())
+		return;
+
+	// Leave room in the LRU for the resources the room loads in addition
+	int budget = _maxMemoryLRU / 2;
+	int queued = 0;
+	for (uint i = 0; i < room->_value.size() && budget > 0; ++i) {
+		Resource *res = testResource(room->_value[i]);
+		if (res && queuePrefetch(res)) {
+			budget -= _prefetchJobs[res->_id]->size;
+			++queued;
+		}
+	}
+
+	debugC(kDebugLevelPrefetch, "Prefetching %d resources for room %d", queued, roomNumber);
+}
+
+bool ResourceManager::startPrefetching() {
+	if (_prefetching)
+		return true;
+	if (_prefetchQuit)
+		return false;
+
+	// Decompressing on the main thread would only delay the room change
+	if (g_system->getJobSystem().getThreadCount())
+		_prefetchDone = g_system->createSemaphore(0);
+
+	if (!_prefetchDone) {
+		// No worker threads, don't try again
+		stopPrefetching();
+		return false;
+	}
+
+	_prefetching = true;
+	return true;
+}
+
+void ResourceManager::stopPrefetching() {
+	{
+		Common::StackLock lock(_prefetchMutex);
+		_prefetchQuit = true;
+	}
+
+	// The jobs not started yet fail right away
+	if (_prefetching) {
+		g_system->getJobSystem().wait(_prefetchGroup);
+		_prefetching = false;
+	}
+
+	for (PrefetchJobMap::iterator i = _prefetchJobs.begin(); i != _prefetchJobs.end(); ++i) {
+		delete[] i->_value->packed;
+		delete[] i->_value->data;
+		delete i->_value;
+	}
+	_prefetchJobs.clear();
+
+	if (_prefetchDone)
+		g_system->deleteSemaphore(_prefetchDone);
+	_prefetchDone = 0;
+}
+
+bool ResourceManager::queuePrefetch(Resource *res) {
+	// Resources from other sources need special handling when loading
+	if (res->_status != kResStatusNoMalloc || res->_source->getSourceType() != kSourceVolume)
+		return false;
+	if (_prefetchJobs.contains(res->_id))
+		return false;
+
+	Common::SeekableReadStream *fileStream = res->_source->getVolumeFile(this, res);
+	if (!fileStream)
+		return false;
+
+	fileStream->seek(res->_fileOffset, SEEK_SET);
+
+	// Reading the header updates the resource, which stays unloaded for now
+	const ResourceId id = res->_id;
+	const uint32 size = res->_size;
+	uint32 packedSize;
+	ResourceCompression compression;
+	const int error = res->readResourceInfo(_volVersion, fileStream, packedSize, compression);
+	const ResourceId headerId = res->_id;
+	const uint32 unpackedSize = res->_size;
+	res->_id = id;
+	res->_size = size;
+
+	// Audio resources get special post-processing after decompression, and
+	// resources with a mismatching header are left to the regular loader
+	if (error || headerId != id || id.getType() == kResourceTypeAudio || unpackedSize == 0) {
+		disposeVolumeFileStream(fileStream, res->_source);
+		return false;
+	}
+
+	PrefetchJob *job = new PrefetchJob;
+	job->resMan = this;
+	job->id = id;
+	job->compression = compression;
+	job->packed = new byte[packedSize];
+	job->packedSize = packedSize;
+	job->data = nullptr;
+	job->size = unpackedSize;
+	job->error = 0;
+	job->started = false;
+	job->cancelled = false;
+	job->done = false;
+
+	const bool read = fileStream->read(job->packed, packedSize) == packedSize;
+	disposeVolumeFileStream(fileStream, res->_source);
+	if (!read) {
+		delete[] job->packed;
+		delete job;
+		return false;
+	}
+
+	_prefetchJobs[id] = job;
+	g_system->getJobSystem().submit(_prefetchGroup, prefetchJobProc, job);
+	return true;
+}
+
+void ResourceManager::adoptPrefetches(Resource *wanted) {
+	for (;;) {
+		Common::Array<PrefetchJob *> done;
+		bool wantedPending = false;
+		bool wantedCancelled = false;
+		{
+			Common::StackLock lock(_prefetchMutex);
+			for (PrefetchJobMap::iterator i = _prefetchJobs.begin(); i != _prefetchJobs.end(); ++i) {
+				PrefetchJob *job = i->_value;
+				if (job->done) {
+					done.push_back(job);
+				} else if (i->_key == wanted->_id) {
+					// Rather than waiting for the jobs queued in front of
+					// it, the requested resource is loaded right away if it
+					// was not started
+					if (job->started)
+						wantedPending = true;
+					else
+						job->cancelled = wantedCancelled = true;
+				}
+			}
+		}
+
+		if (wantedCancelled)
+			_prefetchJobs.erase(wanted->_id);
+
+		for (uint i = 0; i < done.size(); ++i) {
+			PrefetchJob *job = done[i];
+			_prefetchJobs.erase(job->id);
+
+			Resource *res = testResource(job->id);
+			if (!job->error && res && res->_status == kResStatusNoMalloc) {
+				res->_data = job->data;
+				res->_size = job->size;
+				res->_status = kResStatusAllocated;
+				if (_patcher)
+					_patcher->applyPatch(*res);
+				addToLRU(res);
+			} else {
+				if (job->error)
+					debugC(kDebugLevelPrefetch, "Prefetching %s failed with error %d, loading it again", job->id.toString().c_str(), job->error);
+				delete[] job->data;
+			}
+
+			delete[] job->packed;
+			delete job;
+		}
+
+		if (!wantedPending)
+			break;
+
+		// The requested resource is still being decompressed
+		g_system->waitSemaphore(_prefetchDone);
+	}
+}
+
+void ResourceManager::prefetchJobProc(void *param) {
+	PrefetchJob *job = (PrefetchJob *)param;
+	ResourceManager *resMan = job->resMan;
+
+	{
+		Common::StackLock lock(resMan->_prefetchMutex);
+		if (job->cancelled) {
+			delete[] job->packed;
+			delete job;
+			return;
+		}
+
+		if (resMan->_prefetchQuit) {
+			job->error = SCI_ERROR_IO_ERROR;
+			job->done = true;
+			return;
+		}
+
+		job->started = true;
+	}
+
+	Decompressor *dec = createDecompressor(job->compression);
+	byte *data = new byte[job->size];
+	Common::MemoryReadStream stream(job->packed, job->packedSize);
+	int error = SCI_ERROR_UNKNOWN_COMPRESSION;
+	if (dec) {
+		dec->setQuiet(true);
+		error = dec->unpack(&stream, data, job->packedSize, job->size);
+		if (!error && dec->hadProblem())
+			error = SCI_ERROR_DECOMPRESSION_ERROR;
+	}
+	delete dec;
+
+	if (error) {
+		delete[] data;
+		data = nullptr;
+	}
+
+	{
+		Common::StackLock lock(resMan->_prefetchMutex);
+		job->data = data;
+		job->error = error;
+		job->done = true;
+	}
+
+	g_system->postSemaphore(resMan->_prefetchDone);
+}
+
+} // End of namespace Sci
@@ -134,6 +134,7 @@ SciEngine::SciEngine(OSystem *syst, const ADGameDescription *desc, SciGameId gam
 	DebugMan.addDebugChannel(kDebugLevelWorkarounds, "Workarounds", "Notifies when workarounds are triggered");
 	DebugMan.addDebugChannel(kDebugLevelVideo, "Video", "Video (SEQ, VMD, RBT) debugging");
 	DebugMan.addDebugChannel(kDebugLevelGame, "Game", "Debug calls from game scripts");
+	DebugMan.addDebugChannel(kDebugLevelPrefetch, "Prefetch", "Resource prefetching debugging");
 	DebugMan.addDebugChannel(kDebugLevelGC, "GC", "Garbage Collector debugging");
 	DebugMan.addDebugChannel(kDebugLevelResMan, "ResMan", "Resource manager debugging");
 	DebugMan.addDebugChannel(kDebugLevelOnStartup, "OnStartup", "Enter debugger at start of game");
@@ -252,6 +253,10 @@ SciEngine::~SciEngine() {
 	delete[] _opcode_formats;
 
 	delete _scriptPatcher;
+	if (_resMan) {
+		_resMan->dumpAccessLog();
+		_resMan->saveAccessLog(_targetName + "-resources.log");
+	}
 	delete _resMan;	// should be deleted last
 	g_sci = 0;
 }
@@ -263,6 +268,7 @@ Common::Error SciEngine::run() {
 	assert(_resMan);
 	_resMan->addAppropriateSources();
 	_resMan->init();
+	_resMan->loadAccessLog(_targetName + "-resources.log");
 
 	// TODO: Add error handling. Check return values of addAppropriateSources
 	// and init. We first have to *add* sensible return values, though ;).
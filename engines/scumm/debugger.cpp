@@ -93,6 +93,7 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 
 	registerCmd("show",      WRAP_METHOD(ScummDebugger, Cmd_Show));
 	registerCmd("hide",      WRAP_METHOD(ScummDebugger, Cmd_Hide));
+	registerCmd("opcodes",   WRAP_METHOD(ScummDebugger, Cmd_Opcodes));
 
 	registerCmd("imuse",     WRAP_METHOD(ScummDebugger, Cmd_IMuse));
 
@@ -253,6 +254,65 @@ bool ScummDebugger::Cmd_Hide(int argc, const char **argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_Opcodes(int argc, const char **argv) {
+	if (argc == 1) {
+		debugPrintf("Superinstructions: %s\n", _vm->_superinstructions ? "on" : "off");
+		debugPrintf("Opcode pair counting: %s\n", _vm->_opcodePairCounts ? "on" : "off");
+		debugPrintf("Usage: opcodes fast on|off\n");
+		debugPrintf("       opcodes count on|off\n");
+		debugPrintf("       opcodes top [<count>]\n");
+		debugPrintf("       opcodes save\n");
+		return true;
+	}
+
+	if (!strcmp(argv[1], "fast") && argc == 3) {
+		_vm->_superinstructions = !strcmp(argv[2], "on");
+		_vm->setupFastOpcodes();
+		debugPrintf("Superinstructions %s\n", _vm->_superinstructions ? "on" : "off");
+	} else if (!strcmp(argv[1], "count") && argc == 3) {
+		_vm->setOpcodePairCounting(!strcmp(argv[2], "on"));
+		debugPrintf("Opcode pair counting %s\n", _vm->_opcodePairCounts ? "on" : "off");
+	} else if (!strcmp(argv[1], "top")) {
+		if (!_vm->_opcodePairCounts) {
+			debugPrintf("Opcode pair counting is off\n");
+			return true;
+		}
+
+		// Selection of the most frequent pairs, the table is sparse
+		int count = (argc > 2) ? atoi(argv[2]) : 20;
+		uint32 limit = 0xFFFFFFFF;
+		int limitPair = -1;
+		for (int i = 0; i < count; i++) {
+			int best = -1;
+			for (int pair = 0; pair < 256 * 256; pair++) {
+				const uint32 n = _vm->_opcodePairCounts[pair];
+				if (!n || n > limit || (n == limit && pair <= limitPair))
+					continue;
+				if (best < 0 || n > _vm->_opcodePairCounts[best])
+					best = pair;
+			}
+			if (best < 0)
+				break;
+
+			const char *first = _vm->getOpcodeDesc(best >> 8);
+			const char *second = _vm->getOpcodeDesc(best & 0xFF);
+			debugPrintf("%02x %02x %10u  %s %s\n", best >> 8, best & 0xFF, _vm->_opcodePairCounts[best],
+				first && *first ? first : "-", second && *second ? second : "-");
+			limit = _vm->_opcodePairCounts[best];
+			limitPair = best;
+		}
+	} else if (!strcmp(argv[1], "save")) {
+		const Common::String fileName = _vm->getTargetName() + "-opcodes.log";
+		if (_vm->saveOpcodePairCounts(fileName))
+			debugPrintf("Opcode pair counts saved to '%s'\n", fileName.c_str());
+		else
+			debugPrintf("Could not save the opcode pair counts\n");
+	} else {
+		debugPrintf("Unknown opcodes parameter '%s'\n", argv[1]);
+	}
+	return true;
+}
+
 bool ScummDebugger::Cmd_Script(int argc, const char** argv) {
 	int scriptnum;
 
@@ -64,6 +64,7 @@ private:
 
 	bool Cmd_Show(int argc, const char **argv);
 	bool Cmd_Hide(int argc, const char **argv);
+	bool Cmd_Opcodes(int argc, const char **argv);
 
 	bool Cmd_IMuse(int argc, const char **argv);
 
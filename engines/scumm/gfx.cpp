@@ -478,24 +478,83 @@ void ScummEngine::markRectAsDirty(VirtScreenNumber virt, int left, int right, in
 			setGfxUsageBit(lp, dirtybit);
 	}
 
-	// The following code used to be in the separate method setVirtscreenDirty
-	lp = left / 8;
-	rp = right / 8;
+	// The following code used to be in the separate method setVirtscreenDirty.
+	// The right edge is inclusive, as callers are not consistent about it.
+	// The text compositing in drawStripToScreen() works on four pixels at a
+	// time, and the NES and FM-TOWNS rendering on whole strips.
+	int align = 4;
+	if (_game.platform == Common::kPlatformNES || _game.platform == Common::kPlatformFMTowns)
+		align = 8;
+	else if (_game.version >= 7)
+		align = 1;
+
+	lp = MAX(left - left % align, 0);
+	rp = MIN(right + align - right % align, _gdi->_numStrips * 8);
+	if (lp >= rp || top >= bottom)
+		return;
+
+	vs->markDirty(Common::Rect(lp, top, rp, bottom));
+}
 
-	if ((lp >= _gdi->_numStrips) || (rp < 0))
+void VirtScreen::markDirty(const Common::Rect &rect) {
+	if (rect.isEmpty())
 		return;
-	if (lp < 0)
-		lp = 0;
-	if (rp >= _gdi->_numStrips)
-		rp = _gdi->_numStrips - 1;
-
-	while (lp <= rp) {
-		if (top < vs->tdirty[lp])
-			vs->tdirty[lp] = top;
-		if (bottom > vs->bdirty[lp])
-			vs->bdirty[lp] = bottom;
-		lp++;
+
+	const int lp = MAX(rect.left / 8, 0);
+	const int rp = MIN((rect.right - 1) / 8, 80);
+	for (int i = lp; i <= rp; i++) {
+		if (rect.top < tdirty[i])
+			tdirty[i] = rect.top;
+		if (rect.bottom > bdirty[i])
+			bdirty[i] = rect.bottom;
 	}
+
+	addDirtyRect(rect);
+}
+
+void VirtScreen::addDirtyRect(Common::Rect rect) {
+	// Merge the rectangle with the ones it overlaps, and with neighbors of
+	// the same height or width, so every pixel is copied once and runs of
+	// strips are copied in one go. The merged rectangle may in turn overlap
+	// further ones.
+	for (int i = 0; i < numDirtyRects; ) {
+		const Common::Rect &r = dirtyRects[i];
+		if (r.contains(rect))
+			return;
+
+		const bool rowNeighbor = r.top == rect.top && r.bottom == rect.bottom && r.left <= rect.right && rect.left <= r.right;
+		const bool columnNeighbor = r.left == rect.left && r.right == rect.right && r.top <= rect.bottom && rect.top <= r.bottom;
+		if (r.intersects(rect) || rowNeighbor || columnNeighbor) {
+			rect.extend(r);
+			dirtyRects[i] = dirtyRects[--numDirtyRects];
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+
+	if (numDirtyRects == kMaxDirtyRects) {
+		// Out of rectangles: merge with the one growing the least, and start
+		// over with the result
+		int best = 0;
+		int bestGrowth = 0x7FFFFFFF;
+		for (int i = 0; i < numDirtyRects; i++) {
+			Common::Rect merged(rect);
+			merged.extend(dirtyRects[i]);
+			const int growth = merged.width() * merged.height() - dirtyRects[i].width() * dirtyRects[i].height();
+			if (growth < bestGrowth) {
+				best = i;
+				bestGrowth = growth;
+			}
+		}
+
+		rect.extend(dirtyRects[best]);
+		dirtyRects[best] = dirtyRects[--numDirtyRects];
+		addDirtyRect(rect);
+		return;
+	}
+
+	dirtyRects[numDirtyRects++] = rect;
 }
 
 /**
@@ -574,27 +633,12 @@ void ScummEngine::updateDirtyScreen(VirtScreenNumber slot) {
 	if (vs->h == 0)
 		return;
 
-	int i;
-	int w = 8;
-	int start = 0;
-
-	for (i = 0; i < _gdi->_numStrips; i++) {
-		if (vs->bdirty[i]) {
-			const int top = vs->tdirty[i];
-			const int bottom = vs->bdirty[i];
-			vs->tdirty[i] = vs->h;
-			vs->bdirty[i] = 0;
-			if (i != (_gdi->_numStrips - 1) && vs->bdirty[i + 1] == bottom && vs->tdirty[i + 1] == top) {
-				// Simple optimizations: if two or more neighboring strips
-				// form one bigger rectangle, coalesce them.
-				w += 8;
-				continue;
-			}
-			drawStripToScreen(vs, start * 8, w, top, bottom);
-			w = 8;
-		}
-		start = i + 1;
+	for (int i = 0; i < vs->numDirtyRects; i++) {
+		const Common::Rect &r = vs->dirtyRects[i];
+		drawStripToScreen(vs, r.left, MIN<int>(r.right, _gdi->_numStrips * 8) - r.left, r.top, r.bottom);
 	}
+
+	vs->setDirtyRange(vs->h, 0);
 }
 
 /**
@@ -648,8 +692,10 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 		assert(_compositeBuf);
 		const void *text = _textSurface.getBasePtr(x * m, y * m);
 
-		// The values x, width, etc. are all multiples of 8 at this point,
-		// so loop unrolloing might be a good idea...
+		// The dirty rectangles are aligned to 4 pixels for these games, and
+		// to whole 8 pixel strips for NES and FM-TOWNS (see markRectAsDirty),
+		// so x and width are multiples of 4 at this point. Only the games
+		// from v7 on, which skip this path, use unaligned rectangles.
 		assert(IS_ALIGNED(text, 4));
 		assert(0 == (width & 3));
 
@@ -1450,8 +1496,7 @@ void ScummEngine_v5::drawFlashlight() {
 	for (i = _flashlight.x / 8; i < (_flashlight.x + _flashlight.w) / 8; i++) {
 		assert(0 <= i && i < _gdi->_numStrips);
 		setGfxUsageBit(_screenStartStrip + i, USAGE_BIT_DIRTY);
-		vs->tdirty[i] = 0;
-		vs->bdirty[i] = vs->h;
+		vs->markDirty(Common::Rect(i * 8, 0, i * 8 + 8, vs->h));
 	}
 
 	byte *bgbak;
@@ -1819,11 +1864,7 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	if (limit > _numStrips - sx)
 		limit = _numStrips - sx;
 	for (int k = 0; k < limit; ++k, ++stripnr, ++sx, ++x) {
-		if (y < vs->tdirty[sx])
-			vs->tdirty[sx] = y;
-
-		if (y + height > vs->bdirty[sx])
-			vs->bdirty[sx] = y + height;
+		vs->markDirty(Common::Rect(sx * 8, y, sx * 8 + 8, y + height));
 
 		// In the case of a double buffered virtual screen, we draw to
 		// the backbuffer, otherwise to the primary surface memory.
@@ -2264,11 +2305,7 @@ void Gdi::resetBackground(int top, int bottom, int strip) {
 
 	assert(0 <= strip && strip < _numStrips);
 
-	if (top < vs->tdirty[strip])
-		vs->tdirty[strip] = top;
-
-	if (bottom > vs->bdirty[strip])
-		vs->bdirty[strip] = bottom;
+	vs->markDirty(Common::Rect(strip * 8, top, strip * 8 + 8, bottom));
 
 	bgbak_ptr = (byte *)vs->backBuf + top * vs->pitch + (strip + vs->xstart/8) * 8 * vs->format.bytesPerPixel;
 	backbuff_ptr = (byte *)vs->getBasePtr((strip + vs->xstart/8) * 8, top);
@@ -3896,10 +3933,8 @@ void ScummEngine::transitionEffect(int a) {
 
 			if (t == b) {
 				while (l <= r) {
-					if (l >= 0 && l < _gdi->_numStrips && t < bottom) {
-						_virtscr[kMainVirtScreen].tdirty[l] = _screenTop + t * 8;
-						_virtscr[kMainVirtScreen].bdirty[l] = _screenTop + (b + 1) * 8;
-					}
+					if (l >= 0 && l < _gdi->_numStrips && t < bottom)
+						_virtscr[kMainVirtScreen].markDirty(Common::Rect(l * 8, _screenTop + t * 8, l * 8 + 8, _screenTop + (b + 1) * 8));
 					l++;
 				}
 			} else {
@@ -3909,8 +3944,7 @@ void ScummEngine::transitionEffect(int a) {
 					b = bottom;
 				if (t < 0)
 					t = 0;
-				_virtscr[kMainVirtScreen].tdirty[l] = _screenTop + t * 8;
-				_virtscr[kMainVirtScreen].bdirty[l] = _screenTop + (b + 1) * 8;
+				_virtscr[kMainVirtScreen].markDirty(Common::Rect(l * 8, _screenTop + t * 8, l * 8 + 8, _screenTop + (b + 1) * 8));
 			}
 			updateDirtyScreen(kMainVirtScreen);
 		}
@@ -25,6 +25,7 @@
 
 #include "common/system.h"
 #include "common/list.h"
+#include "common/rect.h"
 
 #include "graphics/surface.h"
 
@@ -156,6 +157,22 @@ struct VirtScreen : Graphics::Surface {
 	 */
 	uint16 bdirty[80 + 1];
 
+	enum {
+		/** Maximum number of separate dirty rectangles */
+		kMaxDirtyRects = 32
+	};
+
+	/**
+	 * The dirty areas which updateDirtyScreen() copies to the real screen,
+	 * in the same coordinates as tdirty and bdirty: horizontally relative
+	 * to the real screen, vertically to the virtual screen. Unlike the
+	 * strips, the rectangles keep the exact extent of every change, so
+	 * separate changes within a strip are not copied as one span. The
+	 * rectangles never overlap.
+	 */
+	Common::Rect dirtyRects[kMaxDirtyRects];
+	int numDirtyRects;
+
 	/**
 	 * Convenience method to set the whole tdirty and bdirty arrays to one
 	 * specific value each. This is mostly used to mark every as dirty in
@@ -169,8 +186,19 @@ struct VirtScreen : Graphics::Surface {
 			tdirty[i] = top;
 			bdirty[i] = bottom;
 		}
+
+		numDirtyRects = 0;
+		if (top < bottom)
+			dirtyRects[numDirtyRects++] = Common::Rect(0, top, w, bottom);
 	}
 
+	/**
+	 * Mark the given area as dirty, in the coordinates of tdirty and bdirty.
+	 * The area is added to the dirty rectangles, and to the dirty ranges of
+	 * the strips it touches.
+	 */
+	void markDirty(const Common::Rect &rect);
+
 	byte *getPixels(int x, int y) const {
 		return (byte *)pixels + y * pitch + (xstart + x) * format.bytesPerPixel;
 	}
@@ -178,6 +206,9 @@ struct VirtScreen : Graphics::Surface {
 	byte *getBackPixels(int x, int y) const {
 		return (byte *)backBuf + y * pitch + (xstart + x) * format.bytesPerPixel;
 	}
+
+private:
+	void addDirtyRect(Common::Rect rect);
 };
 
 /** Palette cycles */
@@ -21,6 +21,8 @@
  */
 
 #include "common/config-manager.h"
+#include "common/debug-channels.h"
+#include "common/savefile.h"
 #include "common/util.h"
 #include "common/system.h"
 
@@ -458,6 +460,31 @@ void ScummEngine::refreshScriptPointer() {
 
 /** Execute a script - Read opcode, and execute it from the table */
 void ScummEngine::executeScript() {
+	if (isTracingOpcodes()) {
+		executeScriptTraced();
+		return;
+	}
+
+	const bool setDidexec = _game.version > 2; // V0-V2 games didn't use the didexec flag
+	while (_currentScript != 0xFF) {
+		_opcode = fetchScriptByte();
+		if (setDidexec)
+			vm.slot[_currentScript].didexec = true;
+
+		const OpcodeProc proc = _fastOpcodes[_opcode];
+		if (!proc)
+			error("Invalid opcode '%x' at %lx", _opcode, (long)(_scriptPointer - _scriptOrgPointer));
+		(this->*proc)();
+	}
+}
+
+bool ScummEngine::isTracingOpcodes() const {
+	// Debug level 11 turns on all debug channels, see debugC()
+	return _showStack || _hexdumpScripts || _opcodePairCounts ||
+		gDebugLevel == 11 || DebugMan.isDebugChannelEnabled(DEBUG_OPCODES);
+}
+
+void ScummEngine::executeScriptTraced() {
 	int c;
 	while (_currentScript != 0xFF) {
 
@@ -482,6 +509,10 @@ void ScummEngine::executeScript() {
 			}
 			debugN("\n");
 		}
+		if (_opcodePairCounts) {
+			++_opcodePairCounts[(_prevOpcode << 8) | _opcode];
+			_prevOpcode = _opcode;
+		}
 
 		executeOpcode(_opcode);
 
@@ -489,13 +520,54 @@ void ScummEngine::executeScript() {
 }
 
 void ScummEngine::executeOpcode(byte i) {
-	if (_opcodes[i].proc && _opcodes[i].proc->isValid())
-		(*_opcodes[i].proc)();
+	if (_opcodes[i].proc)
+		(this->*_opcodes[i].proc)();
 	else {
 		error("Invalid opcode '%x' at %lx", i, (long)(_scriptPointer - _scriptOrgPointer));
 	}
 }
 
+void ScummEngine::setupFastOpcodes() {
+	for (int i = 0; i < ARRAYSIZE(_fastOpcodes); i++)
+		_fastOpcodes[i] = _opcodes[i].proc;
+}
+
+void ScummEngine::setOpcodePairCounting(bool enable) {
+	if (enable && !_opcodePairCounts) {
+		_opcodePairCounts = new uint32[256 * 256];
+		memset(_opcodePairCounts, 0, 256 * 256 * sizeof(uint32));
+		_prevOpcode = 0;
+	} else if (!enable) {
+		delete[] _opcodePairCounts;
+		_opcodePairCounts = nullptr;
+	}
+}
+
+bool ScummEngine::saveOpcodePairCounts(const Common::String &fileName) {
+	if (!_opcodePairCounts)
+		return false;
+
+	Common::OutSaveFile *file = _saveFileMan->openForSaving(fileName, false);
+	if (!file)
+		return false;
+
+	// One line per executed pair: the opcodes in hex, the count and the
+	// names of the handlers
+	for (int pair = 0; pair < 256 * 256; pair++) {
+		if (!_opcodePairCounts[pair])
+			continue;
+		const char *first = getOpcodeDesc(pair >> 8);
+		const char *second = getOpcodeDesc(pair & 0xFF);
+		file->writeString(Common::String::format("%02x %02x %u %s %s\n", pair >> 8, pair & 0xFF, _opcodePairCounts[pair],
+			first && *first ? first : "-", second && *second ? second : "-"));
+	}
+
+	file->finalize();
+	const bool success = !file->err();
+	delete file;
+	return success;
+}
+
 const char *ScummEngine::getOpcodeDesc(byte i) {
 #ifndef REDUCE_MEMORY_USAGE
 	return _opcodes[i].desc;
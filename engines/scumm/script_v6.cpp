@@ -483,6 +483,123 @@ int ScummEngine_v6::getStackList(int *args, uint maxnum) {
 	return num;
 }
 
+void ScummEngine_v6::setupFastOpcodes() {
+	ScummEngine::setupFastOpcodes();
+
+	memset(_superOpcodeKinds, kSuperNone, sizeof(_superOpcodeKinds));
+	if (!_superinstructions)
+		return;
+
+	// The opcodes are recognized by their handlers rather than their
+	// numbers, which differ between versions
+	static const struct {
+		OpcodeProc proc;
+		SuperOpcodeKind kind;
+	} superOpcodes[] = {
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_pushByte),    kSuperPushByte },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_pushWord),    kSuperPushWord },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_pushByteVar), kSuperPushByteVar },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_pushWordVar), kSuperPushWordVar },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_eq),          kSuperEq },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_neq),         kSuperNeq },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_gt),          kSuperGt },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_lt),          kSuperLt },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_le),          kSuperLe },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_ge),          kSuperGe },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_if),          kSuperIf },
+		{ static_cast<OpcodeProc>(&ScummEngine_v6::o6_ifNot),       kSuperIfNot }
+	};
+
+	for (int i = 0; i < ARRAYSIZE(_opcodes); i++) {
+		if (!_opcodes[i].proc)
+			continue;
+
+		for (int j = 0; j < ARRAYSIZE(superOpcodes); j++) {
+			if (_opcodes[i].proc == superOpcodes[j].proc)
+				_superOpcodeKinds[i] = superOpcodes[j].kind;
+		}
+
+		const byte kind = _superOpcodeKinds[i];
+		if (kind >= kSuperPushByte && kind <= kSuperPushWordVar)
+			_fastOpcodes[i] = static_cast<OpcodeProc>(&ScummEngine_v6::o6_pushRun);
+		else if (kind >= kSuperEq && kind <= kSuperGe)
+			_fastOpcodes[i] = static_cast<OpcodeProc>(&ScummEngine_v6::o6_compareAndBranch);
+	}
+}
+
+void ScummEngine_v6::o6_pushRun() {
+	// Pushes come in runs, like the arguments of most opcodes. As they can
+	// neither stop the script nor move it, the pushes following the first
+	// one are executed right away. The script pointer is valid for peeking,
+	// as every push fetched its operand through it.
+	byte kind = _superOpcodeKinds[_opcode];
+	for (;;) {
+		switch (kind) {
+		case kSuperPushByte:
+			push(fetchScriptByte());
+			break;
+		case kSuperPushWord:
+			push(fetchScriptWordSigned());
+			break;
+		case kSuperPushByteVar:
+			push(readVar(fetchScriptByte()));
+			break;
+		case kSuperPushWordVar:
+			push(readVar(fetchScriptWord()));
+			break;
+		default:
+			return;
+		}
+
+		kind = _superOpcodeKinds[*_scriptPointer];
+		if (kind < kSuperPushByte || kind > kSuperPushWordVar)
+			return;
+		_opcode = *_scriptPointer++;
+	}
+}
+
+void ScummEngine_v6::o6_compareAndBranch() {
+	// A comparison followed by a conditional jump is executed without
+	// pushing and popping the result in between
+	const byte kind = _superOpcodeKinds[_opcode];
+	const byte nextKind = _superOpcodeKinds[*_scriptPointer];
+	if ((nextKind != kSuperIf && nextKind != kSuperIfNot) || (kind == kSuperEq && _game.id == GID_BASEBALL2001)) {
+		// o6_eq has a workaround for Baseball 2001
+		(this->*_opcodes[_opcode].proc)();
+		return;
+	}
+
+	const int a = pop();
+	const int b = pop();
+	bool result;
+	switch (kind) {
+	case kSuperEq:
+		result = (b == a);
+		break;
+	case kSuperNeq:
+		result = (b != a);
+		break;
+	case kSuperGt:
+		result = (b > a);
+		break;
+	case kSuperLt:
+		result = (b < a);
+		break;
+	case kSuperLe:
+		result = (b <= a);
+		break;
+	default:
+		result = (b >= a);
+		break;
+	}
+
+	_opcode = *_scriptPointer++;
+	if (result == (nextKind == kSuperIf))
+		o6_jump();
+	else
+		fetchScriptWord();
+}
+
 void ScummEngine_v6::o6_pushByte() {
 	push(fetchScriptByte());
 }
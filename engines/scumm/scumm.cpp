@@ -548,6 +548,9 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 
 	_hexdumpScripts = false;
 	_showStack = false;
+	_superinstructions = true;
+	_opcodePairCounts = nullptr;
+	_prevOpcode = 0;
 
 	if (_game.platform == Common::kPlatformFMTowns && _game.version == 3) {	// FM-TOWNS V3 games use 320x240
 		_screenWidth = 320;
@@ -613,6 +616,8 @@ ScummEngine::~ScummEngine() {
 
 	delete[] _sortedActors;
 
+	delete[] _opcodePairCounts;
+
 	delete[] _2byteFontPtr;
 	delete _charset;
 	delete _messageDialog;
@@ -796,6 +801,8 @@ ScummEngine_v6::ScummEngine_v6(OSystem *syst, const DetectorResult &dr)
 	_forcedWaitForMessage = false;
 	_skipVideo = false;
 
+	memset(_superOpcodeKinds, kSuperNone, sizeof(_superOpcodeKinds));
+
 	VAR_VIDEONAME = 0xFF;
 	VAR_RANDOM_NR = 0xFF;
 	VAR_STRING2DRAW = 0xFF;
@@ -1383,6 +1390,7 @@ void ScummEngine::setupScumm() {
 	setupScummVars();
 
 	setupOpcodes();
+	setupFastOpcodes();
 
 	if (_game.version == 8)
 		_numActors = 80;
@@ -659,10 +659,45 @@ protected:
 
 	OpcodeEntry _opcodes[256];
 
+	/**
+	 * The opcode handlers used while no opcodes are traced or counted. These
+	 * are the handlers from _opcodes, except where a superinstruction takes
+	 * over, which also executes the hot opcodes following its own without
+	 * going back through executeScript().
+	 */
+	OpcodeProc _fastOpcodes[256];
+
+	/** Whether setupFastOpcodes() installs superinstructions */
+	bool _superinstructions;
+
+	/**
+	 * Execution counts of opcode pairs, indexed by the previous opcode times
+	 * 256 plus the current one, or null when not counting.
+	 */
+	uint32 *_opcodePairCounts;
+	byte _prevOpcode;
+
 	virtual void setupOpcodes() = 0;
+
+	/**
+	 * Fills _fastOpcodes from _opcodes. Engines with superinstructions
+	 * override this to install them.
+	 */
+	virtual void setupFastOpcodes();
+
 	void executeOpcode(byte i);
 	const char *getOpcodeDesc(byte i);
 
+	/**
+	 * Whether the opcodes have to be executed one at a time by
+	 * executeScriptTraced(), for debug output or to count them.
+	 */
+	bool isTracingOpcodes() const;
+	void executeScriptTraced();
+
+	void setOpcodePairCounting(bool enable);
+	bool saveOpcodePairCounts(const Common::String &fileName);
+
 	void initializeLocals(int slot, int *vars);
 	int	getScriptSlot();
 
@@ -92,6 +92,25 @@ protected:
 	bool _forcedWaitForMessage;
 	bool _skipVideo;
 
+	/** The opcodes executed by superinstructions, see setupFastOpcodes() */
+	enum SuperOpcodeKind {
+		kSuperNone = 0,
+		kSuperPushByte,
+		kSuperPushWord,
+		kSuperPushByteVar,
+		kSuperPushWordVar,
+		kSuperEq,
+		kSuperNeq,
+		kSuperGt,
+		kSuperLt,
+		kSuperLe,
+		kSuperGe,
+		kSuperIf,
+		kSuperIfNot
+	};
+
+	byte _superOpcodeKinds[256];
+
 public:
 	ScummEngine_v6(OSystem *syst, const DetectorResult &dr);
 
@@ -99,6 +118,7 @@ public:
 
 protected:
 	void setupOpcodes() override;
+	void setupFastOpcodes() override;
 
 	void scummLoop_handleActors() override;
 	void processKeyboard(Common::KeyState lastKeyHit) override;
@@ -162,6 +182,10 @@ protected:
 
 	int getDistanceBetween(bool is_obj_1, int b, int c, bool is_obj_2, int e, int f);
 
+	/* Superinstructions */
+	void o6_pushRun();
+	void o6_compareAndBranch();
+
 	/* Version 6 script opcodes */
 	void o6_setBlastObjectWindow();
 	void o6_pushByte();
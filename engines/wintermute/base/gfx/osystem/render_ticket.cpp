@@ -30,6 +30,7 @@
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/gfx/osystem/render_ticket.h"
 #include "engines/wintermute/base/gfx/osystem/base_surface_osystem.h"
+#include "graphics/surface_pool.h"
 #include "graphics/transform_tools.h"
 #include "common/textconsole.h"
 
@@ -43,8 +44,10 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	_wantsDraw(true),
 	_transform(transform) {
 	if (surf) {
-		_surface = new Graphics::Surface();
-		_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
+		// Tickets are created for every draw, so their surfaces come from the
+		// scratch pool rather than being allocated each time
+		Graphics::SurfacePool &pool = Graphics::getScratchSurfacePool();
+		_surface = pool.acquire((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
 		assert(_surface->format.bytesPerPixel == 4);
 		// Get a clipped copy of the surface
 		for (int i = 0; i < _surface->h; i++) {
@@ -60,27 +63,26 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 		// TransformTools.)
 		if (_transform._angle != Graphics::kDefaultAngle) {
 			Graphics::TransparentSurface src(*_surface, false);
-			Graphics::Surface *temp;
+			const Common::Rect rotated = Graphics::TransformTools::newRect(Common::Rect(0, 0, src.w, src.h), transform, nullptr);
+			Graphics::Surface *temp = pool.acquire(rotated.width(), rotated.height(), src.format);
 			if (owner->_gameRef->getBilinearFiltering()) {
-				temp = src.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
+				src.rotoscaleIntoT<Graphics::FILTER_BILINEAR>(*temp, transform);
 			} else {
-				temp = src.rotoscaleT<Graphics::FILTER_NEAREST>(transform);
+				src.rotoscaleIntoT<Graphics::FILTER_NEAREST>(*temp, transform);
 			}
-			_surface->free();
-			delete _surface;
+			pool.release(_surface);
 			_surface = temp;
 		} else if ((dstRect->width() != srcRect->width() ||
 					dstRect->height() != srcRect->height()) &&
 					_transform._numTimesX * _transform._numTimesY == 1) {
 			Graphics::TransparentSurface src(*_surface, false);
-			Graphics::Surface *temp;
+			Graphics::Surface *temp = pool.acquire(dstRect->width(), dstRect->height(), src.format);
 			if (owner->_gameRef->getBilinearFiltering()) {
-				temp = src.scaleT<Graphics::FILTER_BILINEAR>(dstRect->width(), dstRect->height());
+				src.scaleIntoT<Graphics::FILTER_BILINEAR>(*temp);
 			} else {
-				temp = src.scaleT<Graphics::FILTER_NEAREST>(dstRect->width(), dstRect->height());
+				src.scaleIntoT<Graphics::FILTER_NEAREST>(*temp);
 			}
-			_surface->free();
-			delete _surface;
+			pool.release(_surface);
 			_surface = temp;
 		}
 	} else {
@@ -89,10 +91,7 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 }
 
 RenderTicket::~RenderTicket() {
-	if (_surface) {
-		_surface->free();
-		delete _surface;
-	}
+	Graphics::getScratchSurfacePool().release(_surface);
 }
 
 bool RenderTicket::operator==(const RenderTicket &t) const {
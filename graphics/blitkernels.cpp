@@ -0,0 +1,659 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "graphics/blitkernels.h"
+#include "common/cpudetect.h"
+#include "common/endian.h"
+#include "common/util.h"
+
+#ifdef SCUMMVM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Graphics {
+
+// The pixels are in the format of TransparentSurface::getSupportedPixelFormat()
+#ifdef SCUMM_LITTLE_ENDIAN
+enum {
+	kAIndex = 0,
+	kBIndex = 1,
+	kGIndex = 2,
+	kRIndex = 3
+};
+#else
+enum {
+	kAIndex = 3,
+	kBIndex = 2,
+	kGIndex = 1,
+	kRIndex = 0
+};
+#endif
+
+// The channels of the color modulation
+enum {
+	kBModShift = 0,
+	kGModShift = 8,
+	kRModShift = 16,
+	kAModShift = 24
+};
+
+/**
+ * Draws a row with the per-pixel operation Op, which is specialized for the
+ * blend mode, as the direction of the row is.
+ */
+template<class Op, bool kFlip>
+static void blendRow(byte *out, const byte *in, uint width, uint32 color) {
+	const Op op(color);
+	for (uint i = 0; i < width; ++i) {
+		op(out, in);
+		out += 4;
+		in = kFlip ? in - 4 : in + 4;
+	}
+}
+
+struct OpaqueOp {
+	explicit OpaqueOp(uint32) {}
+
+	void operator()(byte *out, const byte *in) const {
+		WRITE_UINT32(out, READ_UINT32(in));
+		out[kAIndex] = 0xFF;
+	}
+};
+
+struct BinaryOp {
+	explicit BinaryOp(uint32) {}
+
+	void operator()(byte *out, const byte *in) const {
+		// Any alpha value not exactly 0 is opaque here
+		if (in[kAIndex] != 0) {
+			WRITE_UINT32(out, READ_UINT32(in));
+			out[kAIndex] = 0xFF;
+		}
+	}
+};
+
+/** The base of the operations which modulate the source with a color */
+struct TintedOp {
+	explicit TintedOp(uint32 color) :
+		ca((color >> kAModShift) & 0xFF),
+		cr((color >> kRModShift) & 0xFF),
+		cg((color >> kGModShift) & 0xFF),
+		cb((color >> kBModShift) & 0xFF) {
+	}
+
+	byte ca, cr, cg, cb;
+};
+
+struct AlphaOp {
+	explicit AlphaOp(uint32) {}
+
+	void operator()(byte *out, const byte *in) const {
+		if (in[kAIndex] != 0) {
+			out[kAIndex] = 255;
+			out[kRIndex] = ((in[kRIndex] * in[kAIndex]) + out[kRIndex] * (255 - in[kAIndex])) >> 8;
+			out[kGIndex] = ((in[kGIndex] * in[kAIndex]) + out[kGIndex] * (255 - in[kAIndex])) >> 8;
+			out[kBIndex] = ((in[kBIndex] * in[kAIndex]) + out[kBIndex] * (255 - in[kAIndex])) >> 8;
+		}
+	}
+};
+
+struct AlphaTintedOp : TintedOp {
+	explicit AlphaTintedOp(uint32 color) : TintedOp(color) {}
+
+	void operator()(byte *out, const byte *in) const {
+		const uint32 ina = in[kAIndex] * ca >> 8;
+
+		if (ina != 0) {
+			out[kAIndex] = 255;
+			out[kBIndex] = (out[kBIndex] * (255 - ina) >> 8) + (in[kBIndex] * ina * cb >> 16);
+			out[kGIndex] = (out[kGIndex] * (255 - ina) >> 8) + (in[kGIndex] * ina * cg >> 16);
+			out[kRIndex] = (out[kRIndex] * (255 - ina) >> 8) + (in[kRIndex] * ina * cr >> 16);
+		}
+	}
+};
+
+struct AdditiveOp {
+	explicit AdditiveOp(uint32) {}
+
+	void operator()(byte *out, const byte *in) const {
+		if (in[kAIndex] != 0) {
+			out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
+			out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) + out[kGIndex], 255);
+			out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) + out[kBIndex], 255);
+		}
+	}
+};
+
+struct AdditiveTintedOp : TintedOp {
+	explicit AdditiveTintedOp(uint32 color) : TintedOp(color) {}
+
+	static byte add(byte out, byte in, uint32 ina, byte c) {
+		if (c != 255)
+			return MIN<uint>(out + ((in * c * ina) >> 16), 255u);
+		return MIN<uint>(out + (in * ina >> 8), 255u);
+	}
+
+	void operator()(byte *out, const byte *in) const {
+		const uint32 ina = in[kAIndex] * ca >> 8;
+		out[kBIndex] = add(out[kBIndex], in[kBIndex], ina, cb);
+		out[kGIndex] = add(out[kGIndex], in[kGIndex], ina, cg);
+		out[kRIndex] = add(out[kRIndex], in[kRIndex], ina, cr);
+	}
+};
+
+struct SubtractiveOp {
+	explicit SubtractiveOp(uint32) {}
+
+	void operator()(byte *out, const byte *in) const {
+		if (in[kAIndex] != 0) {
+			out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
+			out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * out[kGIndex]) * in[kAIndex] >> 16), 0);
+			out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * out[kBIndex]) * in[kAIndex] >> 16), 0);
+		}
+	}
+};
+
+struct SubtractiveTintedOp : TintedOp {
+	explicit SubtractiveTintedOp(uint32 color) : TintedOp(color) {}
+
+	static byte subtract(byte out, byte in, byte a, byte c) {
+		if (c != 255)
+			return MAX(out - ((in * c * out * a) >> 24), 0);
+		return MAX(out - (in * out * a >> 16), 0);
+	}
+
+	void operator()(byte *out, const byte *in) const {
+		out[kAIndex] = 255;
+		out[kBIndex] = subtract(out[kBIndex], in[kBIndex], in[kAIndex], cb);
+		out[kGIndex] = subtract(out[kGIndex], in[kGIndex], in[kAIndex], cg);
+		out[kRIndex] = subtract(out[kRIndex], in[kRIndex], in[kAIndex], cr);
+	}
+};
+
+struct MultiplyOp {
+	explicit MultiplyOp(uint32) {}
+
+	void operator()(byte *out, const byte *in) const {
+		if (in[kAIndex] != 0) {
+			out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
+			out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) * out[kGIndex] >> 8, 255);
+			out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) * out[kBIndex] >> 8, 255);
+		}
+	}
+};
+
+struct MultiplyTintedOp : TintedOp {
+	explicit MultiplyTintedOp(uint32 color) : TintedOp(color) {}
+
+	static byte multiply(byte out, byte in, uint32 ina, byte c) {
+		if (c != 255)
+			return MIN<uint>(out * ((in * c * ina) >> 16) >> 8, 255u);
+		return MIN<uint>(out * (in * ina >> 8) >> 8, 255u);
+	}
+
+	void operator()(byte *out, const byte *in) const {
+		const uint32 ina = in[kAIndex] * ca >> 8;
+		out[kBIndex] = multiply(out[kBIndex], in[kBIndex], ina, cb);
+		out[kGIndex] = multiply(out[kGIndex], in[kGIndex], ina, cg);
+		out[kRIndex] = multiply(out[kRIndex], in[kRIndex], ina, cr);
+	}
+};
+
+template<typename T>
+static void keyedCopyRow(byte *out, const byte *in, uint width, uint32 transColor) {
+	T *dst = (T *)out;
+	const T *src = (const T *)in;
+	const T key = (T)transColor;
+
+	for (uint i = 0; i < width; ++i) {
+		if (src[i] != key)
+			dst[i] = src[i];
+	}
+}
+
+#define SCALAR_BLEND_ROWS(op) { blendRow<op, false>, blendRow<op, true> }
+
+static const BlitKernel blitKernelScalar = {
+	"c",
+	{
+		SCALAR_BLEND_ROWS(OpaqueOp),
+		SCALAR_BLEND_ROWS(BinaryOp),
+		SCALAR_BLEND_ROWS(AlphaOp),
+		SCALAR_BLEND_ROWS(AlphaTintedOp),
+		SCALAR_BLEND_ROWS(AdditiveOp),
+		SCALAR_BLEND_ROWS(AdditiveTintedOp),
+		SCALAR_BLEND_ROWS(SubtractiveOp),
+		SCALAR_BLEND_ROWS(SubtractiveTintedOp),
+		SCALAR_BLEND_ROWS(MultiplyOp),
+		SCALAR_BLEND_ROWS(MultiplyTintedOp)
+	},
+	{ keyedCopyRow<uint8>, keyedCopyRow<uint16>, keyedCopyRow<uint32> }
+};
+
+#ifdef SCUMMVM_SSE2
+
+#pragma mark -
+#pragma mark --- SSE2 ---
+#pragma mark -
+
+// SSE2 implies a little endian host, so the 16-bit lanes of an unpacked
+// pixel hold its alpha, blue, green and red channels, in that order. The
+// kernels only cover the common modes, the others use the scalar rows.
+
+/**
+ * Draws a row with the operation SIMDOp, four pixels at a time, and the rest
+ * with the equivalent scalar operation Op.
+ */
+template<class SIMDOp, class Op, bool kFlip>
+static void blendRowSSE2(byte *out, const byte *in, uint width, uint32 color) {
+	const SIMDOp op(color);
+
+	uint i = 0;
+	for (; i + 4 <= width; i += 4) {
+		__m128i src;
+		if (kFlip)
+			src = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(in - i * 4 - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+		else
+			src = _mm_loadu_si128((const __m128i *)(in + i * 4));
+
+		__m128i *dst = (__m128i *)(out + i * 4);
+		_mm_storeu_si128(dst, op(src, _mm_loadu_si128(dst)));
+	}
+
+	blendRow<Op, kFlip>(out + i * 4, kFlip ? in - i * 4 : in + i * 4, width - i, color);
+}
+
+/** Takes dst where mask is set, and src elsewhere */
+static inline __m128i selectSSE2(__m128i mask, __m128i dst, __m128i src) {
+	return _mm_or_si128(_mm_and_si128(mask, dst), _mm_andnot_si128(mask, src));
+}
+
+/** Copies the alpha of each pixel to all its 16-bit lanes */
+static inline __m128i broadcastAlphaSSE2(__m128i pixels) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+struct OpaqueOpSSE2 {
+	explicit OpaqueOpSSE2(uint32) : alphaMask(_mm_set1_epi32(0xFF)) {}
+
+	__m128i operator()(__m128i src, __m128i) const {
+		return _mm_or_si128(src, alphaMask);
+	}
+
+	__m128i alphaMask;
+};
+
+struct BinaryOpSSE2 {
+	explicit BinaryOpSSE2(uint32) : alphaMask(_mm_set1_epi32(0xFF)) {}
+
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), _mm_setzero_si128());
+		return selectSSE2(transparent, dst, _mm_or_si128(src, alphaMask));
+	}
+
+	__m128i alphaMask;
+};
+
+struct AlphaOpSSE2 {
+	explicit AlphaOpSSE2(uint32) : alphaMask(_mm_set1_epi32(0xFF)), full(_mm_set1_epi16(255)) {}
+
+	// (in * a + out * (255 - a)) >> 8 fits into 16 bits
+	__m128i blend(__m128i src, __m128i dst) const {
+		const __m128i alpha = broadcastAlphaSSE2(src);
+		const __m128i blended = _mm_add_epi16(_mm_mullo_epi16(src, alpha), _mm_mullo_epi16(dst, _mm_sub_epi16(full, alpha)));
+		return _mm_srli_epi16(blended, 8);
+	}
+
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), zero);
+		if (_mm_movemask_epi8(transparent) == 0xFFFF)
+			return dst;
+
+		const __m128i lo = blend(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dst, zero));
+		const __m128i hi = blend(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dst, zero));
+		return selectSSE2(transparent, dst, _mm_or_si128(_mm_packus_epi16(lo, hi), alphaMask));
+	}
+
+	__m128i alphaMask, full;
+};
+
+struct AlphaTintedOpSSE2 {
+	explicit AlphaTintedOpSSE2(uint32 color) :
+		alphaMask(_mm_set1_epi32(0xFF)),
+		full(_mm_set1_epi16(255)),
+		ca(_mm_set1_epi16((color >> kAModShift) & 0xFF)) {
+		const int16 cr = (color >> kRModShift) & 0xFF;
+		const int16 cg = (color >> kGModShift) & 0xFF;
+		const int16 cb = (color >> kBModShift) & 0xFF;
+		tint = _mm_set_epi16(cr, cg, cb, 0, cr, cg, cb, 0);
+	}
+
+	// in * c fits into 16 bits, so the high half of its product with ina
+	// is (in * ina * c) >> 16
+	__m128i blend(__m128i src, __m128i dst, __m128i ina) const {
+		const __m128i kept = _mm_srli_epi16(_mm_mullo_epi16(dst, _mm_sub_epi16(full, ina)), 8);
+		const __m128i added = _mm_mulhi_epu16(_mm_mullo_epi16(src, tint), ina);
+		return _mm_add_epi16(kept, added);
+	}
+
+	__m128i operator()(__m128i src, __m128i dst) const {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i srcLo = _mm_unpacklo_epi8(src, zero);
+		const __m128i srcHi = _mm_unpackhi_epi8(src, zero);
+		const __m128i inaLo = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlphaSSE2(srcLo), ca), 8);
+		const __m128i inaHi = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlphaSSE2(srcHi), ca), 8);
+		const __m128i transparent = _mm_packs_epi16(_mm_cmpeq_epi16(inaLo, zero), _mm_cmpeq_epi16(inaHi, zero));
+		if (_mm_movemask_epi8(transparent) == 0xFFFF)
+			return dst;
+
+		const __m128i lo = blend(srcLo, _mm_unpacklo_epi8(dst, zero), inaLo);
+		const __m128i hi = blend(srcHi, _mm_unpackhi_epi8(dst, zero), inaHi);
+		return selectSSE2(transparent, dst, _mm_or_si128(_mm_packus_epi16(lo, hi), alphaMask));
+	}
+
+	__m128i alphaMask, full, ca, tint;
+};
+
+template<typename T>
+static inline __m128i equalsSSE2(__m128i a, __m128i b);
+
+template<>
+inline __m128i equalsSSE2<uint8>(__m128i a, __m128i b) {
+	return _mm_cmpeq_epi8(a, b);
+}
+
+template<>
+inline __m128i equalsSSE2<uint16>(__m128i a, __m128i b) {
+	return _mm_cmpeq_epi16(a, b);
+}
+
+template<>
+inline __m128i equalsSSE2<uint32>(__m128i a, __m128i b) {
+	return _mm_cmpeq_epi32(a, b);
+}
+
+template<typename T>
+static void keyedCopyRowSSE2(byte *out, const byte *in, uint width, uint32 transColor) {
+	const T key = (T)transColor;
+	__m128i keys;
+	if (sizeof(T) == 1)
+		keys = _mm_set1_epi8((char)key);
+	else if (sizeof(T) == 2)
+		keys = _mm_set1_epi16((int16)key);
+	else
+		keys = _mm_set1_epi32((int32)key);
+
+	const uint blockPixels = 16 / sizeof(T);
+	uint i = 0;
+	for (; i + blockPixels <= width; i += blockPixels) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(in + i * sizeof(T)));
+		const __m128i transparent = equalsSSE2<T>(src, keys);
+		const int mask = _mm_movemask_epi8(transparent);
+		if (mask == 0xFFFF)
+			continue;
+
+		__m128i *dst = (__m128i *)(out + i * sizeof(T));
+		_mm_storeu_si128(dst, mask ? selectSSE2(transparent, _mm_loadu_si128(dst), src) : src);
+	}
+
+	keyedCopyRow<T>(out + i * sizeof(T), in + i * sizeof(T), width - i, transColor);
+}
+
+#define SSE2_BLEND_ROWS(op) { blendRowSSE2<op##SSE2, op, false>, blendRowSSE2<op##SSE2, op, true> }
+
+static const BlitKernel blitKernelSSE2 = {
+	"sse2",
+	{
+		SSE2_BLEND_ROWS(OpaqueOp),
+		SSE2_BLEND_ROWS(BinaryOp),
+		SSE2_BLEND_ROWS(AlphaOp),
+		SSE2_BLEND_ROWS(AlphaTintedOp),
+		SCALAR_BLEND_ROWS(AdditiveOp),
+		SCALAR_BLEND_ROWS(AdditiveTintedOp),
+		SCALAR_BLEND_ROWS(SubtractiveOp),
+		SCALAR_BLEND_ROWS(SubtractiveTintedOp),
+		SCALAR_BLEND_ROWS(MultiplyOp),
+		SCALAR_BLEND_ROWS(MultiplyTintedOp)
+	},
+	{ keyedCopyRowSSE2<uint8>, keyedCopyRowSSE2<uint16>, keyedCopyRowSSE2<uint32> }
+};
+
+#endif // SCUMMVM_SSE2
+
+#ifdef SCUMMVM_NEON
+
+#pragma mark -
+#pragma mark --- NEON ---
+#pragma mark -
+
+// The operations work on the pixels as 32-bit lanes, in which the alpha
+// channel is the lowest byte, and on the bytes of the lanes, which are in
+// the order of kAIndex and friends.
+
+template<class SIMDOp, class Op, bool kFlip>
+static void blendRowNEON(byte *out, const byte *in, uint width, uint32 color) {
+	const SIMDOp op(color);
+
+	uint i = 0;
+	for (; i + 4 <= width; i += 4) {
+		uint32x4_t src;
+		if (kFlip) {
+			const uint32x4_t reversed = vrev64q_u32(vld1q_u32((const uint32 *)(in - i * 4 - 12)));
+			src = vcombine_u32(vget_high_u32(reversed), vget_low_u32(reversed));
+		} else {
+			src = vld1q_u32((const uint32 *)(in + i * 4));
+		}
+
+		uint32 *dst = (uint32 *)(out + i * 4);
+		vst1q_u32(dst, op(src, vld1q_u32(dst)));
+	}
+
+	blendRow<Op, kFlip>(out + i * 4, kFlip ? in - i * 4 : in + i * 4, width - i, color);
+}
+
+/** Copies the lowest byte of each lane to all its bytes */
+static inline uint8x16_t broadcastLowNEON(uint32x4_t values) {
+	return vreinterpretq_u8_u32(vmulq_n_u32(values, 0x01010101));
+}
+
+struct OpaqueOpNEON {
+	explicit OpaqueOpNEON(uint32) : alphaMask(vdupq_n_u32(0xFF)) {}
+
+	uint32x4_t operator()(uint32x4_t src, uint32x4_t) const {
+		return vorrq_u32(src, alphaMask);
+	}
+
+	uint32x4_t alphaMask;
+};
+
+struct BinaryOpNEON {
+	explicit BinaryOpNEON(uint32) : alphaMask(vdupq_n_u32(0xFF)) {}
+
+	uint32x4_t operator()(uint32x4_t src, uint32x4_t dst) const {
+		const uint32x4_t transparent = vceqq_u32(vandq_u32(src, alphaMask), vdupq_n_u32(0));
+		return vbslq_u32(transparent, dst, vorrq_u32(src, alphaMask));
+	}
+
+	uint32x4_t alphaMask;
+};
+
+struct AlphaOpNEON {
+	explicit AlphaOpNEON(uint32) : alphaMask(vdupq_n_u32(0xFF)) {}
+
+	uint32x4_t operator()(uint32x4_t src, uint32x4_t dst) const {
+		const uint32x4_t alpha = vandq_u32(src, alphaMask);
+		const uint8x16_t a = broadcastLowNEON(alpha);
+		const uint8x16_t inv = vmvnq_u8(a);
+		const uint8x16_t s = vreinterpretq_u8_u32(src);
+		const uint8x16_t d = vreinterpretq_u8_u32(dst);
+
+		const uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(s), vget_low_u8(a)), vget_low_u8(d), vget_low_u8(inv));
+		const uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(s), vget_high_u8(a)), vget_high_u8(d), vget_high_u8(inv));
+		const uint32x4_t blended = vreinterpretq_u32_u8(vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+
+		return vbslq_u32(vceqq_u32(alpha, vdupq_n_u32(0)), dst, vorrq_u32(blended, alphaMask));
+	}
+
+	uint32x4_t alphaMask;
+};
+
+struct AlphaTintedOpNEON {
+	explicit AlphaTintedOpNEON(uint32 color) :
+		alphaMask(vdupq_n_u32(0xFF)),
+		ca((color >> kAModShift) & 0xFF) {
+		const uint32 cr = (color >> kRModShift) & 0xFF;
+		const uint32 cg = (color >> kGModShift) & 0xFF;
+		const uint32 cb = (color >> kBModShift) & 0xFF;
+		tint = vreinterpretq_u8_u32(vdupq_n_u32((cr << 24) | (cg << 16) | (cb << 8)));
+	}
+
+	// (in * ina * c) >> 16 for eight channels
+	static uint8x8_t modulate(uint8x8_t s, uint8x8_t ina, uint8x8_t tint) {
+		const uint16x8_t product = vmull_u8(s, tint);
+		const uint16x8_t ina16 = vmovl_u8(ina);
+		const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(product), vget_low_u16(ina16)), 16);
+		const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(product), vget_high_u16(ina16)), 16);
+		return vmovn_u16(vcombine_u16(lo, hi));
+	}
+
+	uint32x4_t operator()(uint32x4_t src, uint32x4_t dst) const {
+		const uint32x4_t ina32 = vshrq_n_u32(vmulq_n_u32(vandq_u32(src, alphaMask), ca), 8);
+		const uint8x16_t ina = broadcastLowNEON(ina32);
+		const uint8x16_t inv = vmvnq_u8(ina);
+		const uint8x16_t s = vreinterpretq_u8_u32(src);
+		const uint8x16_t d = vreinterpretq_u8_u32(dst);
+
+		const uint8x8_t lo = vadd_u8(vshrn_n_u16(vmull_u8(vget_low_u8(d), vget_low_u8(inv)), 8),
+		                             modulate(vget_low_u8(s), vget_low_u8(ina), vget_low_u8(tint)));
+		const uint8x8_t hi = vadd_u8(vshrn_n_u16(vmull_u8(vget_high_u8(d), vget_high_u8(inv)), 8),
+		                             modulate(vget_high_u8(s), vget_high_u8(ina), vget_high_u8(tint)));
+		const uint32x4_t blended = vreinterpretq_u32_u8(vcombine_u8(lo, hi));
+
+		return vbslq_u32(vceqq_u32(ina32, vdupq_n_u32(0)), dst, vorrq_u32(blended, alphaMask));
+	}
+
+	uint32x4_t alphaMask;
+	uint32 ca;
+	uint8x16_t tint;
+};
+
+static void keyedCopyRow8NEON(byte *out, const byte *in, uint width, uint32 transColor) {
+	const uint8x16_t keys = vdupq_n_u8((uint8)transColor);
+	uint i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const uint8x16_t src = vld1q_u8(in + i);
+		vst1q_u8(out + i, vbslq_u8(vceqq_u8(src, keys), vld1q_u8(out + i), src));
+	}
+
+	keyedCopyRow<uint8>(out + i, in + i, width - i, transColor);
+}
+
+static void keyedCopyRow16NEON(byte *out, const byte *in, uint width, uint32 transColor) {
+	const uint16x8_t keys = vdupq_n_u16((uint16)transColor);
+	uint i = 0;
+	for (; i + 8 <= width; i += 8) {
+		const uint16x8_t src = vld1q_u16((const uint16 *)in + i);
+		uint16 *dst = (uint16 *)out + i;
+		vst1q_u16(dst, vbslq_u16(vceqq_u16(src, keys), vld1q_u16(dst), src));
+	}
+
+	keyedCopyRow<uint16>(out + i * 2, in + i * 2, width - i, transColor);
+}
+
+static void keyedCopyRow32NEON(byte *out, const byte *in, uint width, uint32 transColor) {
+	const uint32x4_t keys = vdupq_n_u32(transColor);
+	uint i = 0;
+	for (; i + 4 <= width; i += 4) {
+		const uint32x4_t src = vld1q_u32((const uint32 *)in + i);
+		uint32 *dst = (uint32 *)out + i;
+		vst1q_u32(dst, vbslq_u32(vceqq_u32(src, keys), vld1q_u32(dst), src));
+	}
+
+	keyedCopyRow<uint32>(out + i * 4, in + i * 4, width - i, transColor);
+}
+
+#define NEON_BLEND_ROWS(op) { blendRowNEON<op##NEON, op, false>, blendRowNEON<op##NEON, op, true> }
+
+static const BlitKernel blitKernelNEON = {
+	"neon",
+	{
+		NEON_BLEND_ROWS(OpaqueOp),
+		NEON_BLEND_ROWS(BinaryOp),
+		NEON_BLEND_ROWS(AlphaOp),
+		NEON_BLEND_ROWS(AlphaTintedOp),
+		SCALAR_BLEND_ROWS(AdditiveOp),
+		SCALAR_BLEND_ROWS(AdditiveTintedOp),
+		SCALAR_BLEND_ROWS(SubtractiveOp),
+		SCALAR_BLEND_ROWS(SubtractiveTintedOp),
+		SCALAR_BLEND_ROWS(MultiplyOp),
+		SCALAR_BLEND_ROWS(MultiplyTintedOp)
+	},
+	{ keyedCopyRow8NEON, keyedCopyRow16NEON, keyedCopyRow32NEON }
+};
+
+#endif // SCUMMVM_NEON
+
+#pragma mark -
+
+const BlitKernel *getBlitKernel(BlitKernelType type) {
+	switch (type) {
+	case kBlitKernelScalar:
+		return &blitKernelScalar;
+
+#ifdef SCUMMVM_SSE2
+	case kBlitKernelSSE2:
+		return Common::hasCPUFeature(Common::kCPUFeatureSSE2) ? &blitKernelSSE2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_NEON
+	case kBlitKernelNEON:
+		return Common::hasCPUFeature(Common::kCPUFeatureNEON) ? &blitKernelNEON : nullptr;
+#endif
+
+	default:
+		return nullptr;
+	}
+}
+
+const BlitKernel &getDefaultBlitKernel() {
+	static const BlitKernel *defaultKernel = nullptr;
+
+	if (!defaultKernel) {
+		const BlitKernel *kernel = &blitKernelScalar;
+		for (int i = kBlitKernelScalar + 1; i < kBlitKernelCount; ++i) {
+			const BlitKernel *candidate = getBlitKernel((BlitKernelType)i);
+			if (candidate)
+				kernel = candidate;
+		}
+		defaultKernel = kernel;
+	}
+
+	return *defaultKernel;
+}
+
+} // End of namespace Graphics
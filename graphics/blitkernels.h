@@ -0,0 +1,99 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef GRAPHICS_BLITKERNELS_H
+#define GRAPHICS_BLITKERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * Draws a row of TransparentSurface pixels onto a row of a surface in the
+ * same format.
+ *
+ * @param out	row of the target
+ * @param in	first source pixel to draw; for horizontally flipped rows
+ *				this is the rightmost one, and the kernel goes left from it
+ * @param width	number of pixels
+ * @param color	color modulation in 0xAARRGGBB format, for the tinted modes
+ */
+typedef void (*BlendRowProc)(byte *out, const byte *in, uint width, uint32 color);
+
+/**
+ * Copies a row of pixels of 1, 2 or 4 bytes, leaving the target pixels
+ * under source pixels of the transparent color untouched.
+ */
+typedef void (*KeyedCopyRowProc)(byte *out, const byte *in, uint width, uint32 transColor);
+
+/**
+ * The ways to draw a row of TransparentSurface pixels. The tinted modes
+ * modulate the source with a color other than 0xFFFFFFFF.
+ */
+enum BlendRowMode {
+	kBlendRowOpaque = 0,		///< Copies the source as fully opaque
+	kBlendRowBinary,			///< Copies the source pixels with any alpha
+	kBlendRowAlpha,
+	kBlendRowAlphaTinted,
+	kBlendRowAdditive,
+	kBlendRowAdditiveTinted,
+	kBlendRowSubtractive,
+	kBlendRowSubtractiveTinted,
+	kBlendRowMultiply,
+	kBlendRowMultiplyTinted,
+
+	kBlendRowModeCount
+};
+
+/**
+ * A set of row drawing routines for one instruction set. All kernels
+ * produce exactly the same output as the scalar one.
+ */
+struct BlitKernel {
+	const char *name;
+	BlendRowProc blend[kBlendRowModeCount][2];	///< By mode, and whether flipped horizontally
+	KeyedCopyRowProc keyedCopy[3];				///< For 1, 2 and 4 bytes per pixel
+};
+
+enum BlitKernelType {
+	kBlitKernelScalar = 0,
+	kBlitKernelSSE2,
+	kBlitKernelNEON,
+
+	kBlitKernelCount
+};
+
+/**
+ * Returns the kernel of the given type, or nullptr if it is not available
+ * in this build or not supported by the host CPU.
+ */
+const BlitKernel *getBlitKernel(BlitKernelType type);
+
+/**
+ * Returns the fastest kernel available on the host.
+ */
+const BlitKernel &getDefaultBlitKernel();
+
+} // End of namespace Graphics
+
+#endif
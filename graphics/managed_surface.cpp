@@ -21,6 +21,7 @@
  */
 
 #include "graphics/managed_surface.h"
+#include "graphics/blitkernels.h"
 #include "common/algorithm.h"
 #include "common/textconsole.h"
 
@@ -349,6 +350,21 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, Surface &dest, c
 	byte rDest, gDest, bDest;
 	double alpha;
 
+	// Only the columns within the destination surface are drawn
+	const int destLeft = MAX<int>(destRect.left, 0);
+	const int destRight = MIN<int>(destRect.right, dest.w);
+	if (destLeft >= destRight)
+		return;
+
+	// Matching formats, so we can do a straight copy
+	const bool straightCopy = srcFormat == destFormat && srcAlpha == 0xff;
+
+	// Straight copies without scaling, flipping or color override copy
+	// whole rows with the blit kernels
+	KeyedCopyRowProc copyRow = nullptr;
+	if (straightCopy && !overrideColor && !flipped && scaleX == SCALE_THRESHOLD && sizeof(TSRC) == sizeof(TDEST))
+		copyRow = getDefaultBlitKernel().keyedCopy[sizeof(TSRC) / 2];
+
 	// Loop through drawing output lines
 	for (int destY = destRect.top, scaleYCtr = 0; destY < destRect.bottom; ++destY, scaleYCtr += scaleY) {
 		if (destY < 0 || destY >= dest.h)
@@ -356,17 +372,19 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, Surface &dest, c
 		const TSRC *srcLine = (const TSRC *)src.getBasePtr(srcRect.left, scaleYCtr / SCALE_THRESHOLD + srcRect.top);
 		TDEST *destLine = (TDEST *)dest.getBasePtr(destRect.left, destY);
 
-		// Loop through drawing the pixels of the row
-		for (int destX = destRect.left, xCtr = 0, scaleXCtr = 0; destX < destRect.right; ++destX, ++xCtr, scaleXCtr += scaleX) {
-			if (destX < 0 || destX >= dest.w)
-				continue;
+		if (copyRow) {
+			const int xCtr = destLeft - destRect.left;
+			copyRow((byte *)(destLine + xCtr), (const byte *)(srcLine + xCtr), destRight - destLeft, transColor);
+			continue;
+		}
 
+		// Loop through drawing the pixels of the row
+		for (int xCtr = destLeft - destRect.left, scaleXCtr = xCtr * scaleX; xCtr < destRight - destRect.left; ++xCtr, scaleXCtr += scaleX) {
 			TSRC srcVal = srcLine[flipped ? src.w - scaleXCtr / SCALE_THRESHOLD - 1 : scaleXCtr / SCALE_THRESHOLD];
 			if (srcVal == transColor)
 				continue;
 
-			if (srcFormat == destFormat && srcAlpha == 0xff) {
-				// Matching formats, so we can do a straight copy
+			if (straightCopy) {
 				destLine[xCtr] = overrideColor ? overrideColor : srcVal;
 			} else {
 				// Otherwise we have to manually decode and re-encode each pixel
@@ -1,6 +1,7 @@
 MODULE := graphics
 
 MODULE_OBJS := \
+	blitkernels.o \
 	conversion.o \
 	cursorman.o \
 	font.o \
@@ -32,6 +33,7 @@ MODULE_OBJS := \
 	screen.o \
 	sjis.o \
 	surface.o \
+	surface_pool.o \
 	transform_struct.o \
 	transform_tools.o \
 	transparent_surface.o \
@@ -39,7 +41,8 @@ MODULE_OBJS := \
 	VectorRenderer.o \
 	VectorRendererSpec.o \
 	wincursor.o \
-	yuv_to_rgb.o
+	yuv_to_rgb.o \
+	yuvkernels.o
 
 ifdef USE_SCALERS
 MODULE_OBJS += \
@@ -48,7 +51,8 @@ MODULE_OBJS += \
 	scaler/downscaler.o \
 	scaler/scale2x.o \
 	scaler/scale3x.o \
-	scaler/scalebit.o
+	scaler/scalebit.o \
+	scaler/scalerkernels.o
 
 ifdef USE_ARM_SCALER_ASM
 MODULE_OBJS += \
@@ -20,8 +20,12 @@
  *
  */
 
+#include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 #include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/scale3x.h"
+#include "graphics/scaler/scalerkernels.h"
+#include "common/jobsystem.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -102,6 +106,13 @@ void InitLUT(Graphics::PixelFormat format) {
 		RGBtoYUV[color] = (Y << 16) | (u << 8) | v;
 	}
 
+	gHQKernelFormat.rBits = format.rBits();
+	gHQKernelFormat.gBits = format.gBits();
+	gHQKernelFormat.bBits = format.bBits();
+	gHQKernelFormat.rShift = format.rShift;
+	gHQKernelFormat.gShift = format.gShift;
+	gHQKernelFormat.bShift = format.bShift;
+
 #ifdef USE_NASM
 	hqx_lowbits  = (1 << format.rShift) | (1 << format.gShift) | (1 << format.bShift),
 	hqx_low2bits = (3 << format.rShift) | (3 << format.gShift) | (3 << format.bShift),
@@ -144,6 +155,15 @@ void InitScalers(uint32 BitFormat) {
 	InitLUT(format);
 #endif
 
+#ifdef USE_SCALERS
+	// The kernels expand channels of 4 to 8 bits only, which covers all
+	// 16 bit formats in use
+	if (format.rBits() >= 4 && format.gBits() >= 4 && format.bBits() >= 4)
+		gScalerKernel = getDefaultScalerKernel();
+	else
+		gScalerKernel = nullptr;
+#endif
+
 	// Build dotmatrix lookup table for the DotMatrix scaler.
 	g_dotmatrix[0] = g_dotmatrix[10] = format.RGBToColor( 0, 63,  0);
 	g_dotmatrix[1] = g_dotmatrix[11] = format.RGBToColor( 0,  0, 63);
@@ -178,6 +198,76 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 	}
 }
 
+namespace {
+
+struct ScaleBandsJob {
+	ScalerProc *scaler;
+	int scaleFactor;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width;
+	int height;
+	uint numPairs;
+};
+
+void scaleBandsProc(void *param, uint begin, uint end) {
+	const ScaleBandsJob &job = *(const ScaleBandsJob *)param;
+
+	// The band holding the last pair of rows also gets an odd last row
+	const int top = begin * 2;
+	const int bottom = end == job.numPairs ? job.height : (int)end * 2;
+	job.scaler(job.srcPtr + top * job.srcPitch, job.srcPitch,
+	           job.dstPtr + top * job.scaleFactor * job.dstPitch, job.dstPitch, job.width, bottom - top);
+}
+
+/**
+ * Whether a scaler keeps all its state on the stack, so several bands can
+ * be scaled at the same time. The assembly versions of HQ2x and HQ3x keep
+ * their loop state in global variables.
+ */
+bool isScalerReentrant(ScalerProc *scaler) {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	if (scaler == HQ2x || scaler == HQ3x)
+		return false;
+#endif
+	return true;
+}
+
+} // End of anonymous namespace
+
+void ScaleInBands(ScalerProc *scaler, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
+							int width, int height, Common::JobSystem *jobSystem) {
+	enum {
+		kMinPixelsPerBand = 8192,	///< Smaller bands are not worth waking a thread
+		kMinRowsPerBand = 8
+	};
+
+	if (!jobSystem)
+		jobSystem = &g_system->getJobSystem();
+	if (!jobSystem->getThreadCount() || !isScalerReentrant(scaler) || width * height < 2 * kMinPixelsPerBand || height < 2 * kMinRowsPerBand) {
+		scaler(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	// The bands start on even rows, so the DotMatrix pattern stays in place,
+	// and have at least two rows, as needed by the Scale2x implementation
+	ScaleBandsJob job;
+	job.scaler = scaler;
+	job.scaleFactor = scaleFactor;
+	job.srcPtr = srcPtr;
+	job.srcPitch = srcPitch;
+	job.dstPtr = dstPtr;
+	job.dstPitch = dstPitch;
+	job.width = width;
+	job.height = height;
+	job.numPairs = height / 2;
+
+	const uint pairsPerBand = MAX<uint>(kMinRowsPerBand, kMinPixelsPerBand / width) / 2;
+	jobSystem->parallelFor(0, job.numPairs, pairsPerBand, scaleBandsProc, &job);
+}
+
 #ifdef USE_SCALERS
 
 
@@ -268,7 +358,28 @@ void AdvMame2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPi
  */
 void AdvMame3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 							 int width, int height) {
-	scale(3, dstPtr, dstPitch, srcPtr - srcPitch, srcPitch, 2, width, height);
+	if (!gScalerKernel) {
+		scale(3, dstPtr, dstPitch, srcPtr - srcPitch, srcPitch, 2, width, height);
+		return;
+	}
+
+	// The kernel scales whole blocks of pixels, the C implementation the
+	// rest of each row
+	const uint32 nextlineSrc = srcPitch / sizeof(uint16);
+	const uint16 *p = (const uint16 *)srcPtr;
+
+	const uint32 nextlineDst = dstPitch / sizeof(uint16);
+	uint16 *q = (uint16 *)dstPtr;
+
+	while (height--) {
+		const uint done = gScalerKernel->scale3x(q, q + nextlineDst, q + 2 * nextlineDst, p - nextlineSrc, p, p + nextlineSrc, width);
+		if (done < (uint)width)
+			scale3x_16_def(q + 3 * done, q + nextlineDst + 3 * done, q + 2 * nextlineDst + 3 * done,
+			               p - nextlineSrc + done, p + done, p + nextlineSrc + done, width - done);
+
+		p += nextlineSrc;
+		q += 3 * nextlineDst;
+	}
 }
 
 template<typename ColorMask>
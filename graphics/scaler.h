@@ -26,6 +26,10 @@
 #include "common/scummsys.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class JobSystem;
+}
+
 extern void InitScalers(uint32 BitFormat);
 extern void DestroyScalers();
 
@@ -61,6 +65,20 @@ DECLARE_SCALER(HQ3x);
 
 #endif // #ifdef USE_SCALERS
 
+/**
+ * Runs a scaler on a large area split into bands of rows, which are scaled
+ * in parallel on the job system of OSystem. Small areas are scaled right
+ * away. The scaler may read the source rows around a band, but must only
+ * write to the destination rows of the band. Scalers which are not
+ * re-entrant, like the assembly versions of HQ2x and HQ3x, always scale
+ * the whole area at once.
+ *
+ * @param scaleFactor	factor by which the scaler enlarges the height
+ * @param jobSystem		job system to use instead of the one of OSystem
+ */
+extern void ScaleInBands(ScalerProc *scaler, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+							uint8 *dstPtr, uint32 dstPitch, int width, int height, Common::JobSystem *jobSystem = nullptr);
+
 // creates a 160x100 thumbnail for 320x200 games
 // and 160x120 thumbnail for 320x240 and 640x480 games
 // only 565 mode
@@ -0,0 +1,542 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/scalerkernels.h"
+#include "common/cpudetect.h"
+#include "common/util.h"
+
+#if defined(SCUMMVM_AVX2)
+#include <immintrin.h>
+#elif defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+#endif
+
+// The kernels compute the YUV values of the RGBtoYUV table on the fly, as
+// gathering them from the table is what limits the C implementation:
+//   Y = (r + g + b) >> 2
+//   U = 128 + ((r - b) >> 2)
+//   V = 128 + ((2 * g - r - b) >> 3)
+// with every channel expanded to 8 bits the way PixelFormat::colorToRGB()
+// does. diffYUV() then checks the differences against these thresholds.
+enum {
+	kThresholdY = 0x30,
+	kThresholdU = 0x07,
+	kThresholdV = 0x06
+};
+
+enum {
+	kHQChunkSize = 64
+};
+
+/**
+ * The YUV values of three rows of pixels, from the pixel left of a chunk of
+ * a row to the one right of it. Converting the pixels once spares doing it
+ * again for each of their neighbours.
+ */
+struct HQChunk {
+	int16 y[3][kHQChunkSize + 2];
+	int16 u[3][kHQChunkSize + 2];
+	int16 v[3][kHQChunkSize + 2];
+};
+
+#ifdef SCUMMVM_SSE2
+
+#pragma mark -
+#pragma mark --- SSE2 ---
+#pragma mark -
+
+/** The format in registers */
+struct HQFormatSSE2 {
+	explicit HQFormatSSE2(const HQKernelFormat &format) {
+		const uint bits[3] = { format.rBits, format.gBits, format.bBits };
+		const uint shifts[3] = { format.rShift, format.gShift, format.bShift };
+		for (int i = 0; i < 3; ++i) {
+			shift[i] = _mm_cvtsi32_si128(shifts[i]);
+			mask[i] = _mm_set1_epi16((1 << bits[i]) - 1);
+			loss[i] = _mm_cvtsi32_si128(8 - bits[i]);
+			refill[i] = _mm_cvtsi32_si128(2 * bits[i] - 8);
+		}
+	}
+
+	__m128i shift[3];
+	__m128i mask[3];
+	__m128i loss[3];	///< Shift of the channel bits to the top of the byte
+	__m128i refill[3];	///< Shift of the channel bits to the bottom of the byte
+};
+
+struct YUVSSE2 {
+	__m128i y, u, v;
+};
+
+static inline __m128i expandSSE2(__m128i color, const HQFormatSSE2 &format, int i) {
+	const __m128i value = _mm_and_si128(_mm_srl_epi16(color, format.shift[i]), format.mask[i]);
+	return _mm_or_si128(_mm_sll_epi16(value, format.loss[i]), _mm_srl_epi16(value, format.refill[i]));
+}
+
+/** Returns the YUV values without the offset of 128 for U and V, which cancels out */
+static inline YUVSSE2 yuvSSE2(const uint16 *src, const HQFormatSSE2 &format) {
+	const __m128i color = _mm_loadu_si128((const __m128i *)src);
+	const __m128i r = expandSSE2(color, format, 0);
+	const __m128i g = expandSSE2(color, format, 1);
+	const __m128i b = expandSSE2(color, format, 2);
+
+	YUVSSE2 yuv;
+	yuv.y = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(r, g), b), 2);
+	yuv.u = _mm_srai_epi16(_mm_sub_epi16(r, b), 2);
+	yuv.v = _mm_srai_epi16(_mm_sub_epi16(_mm_add_epi16(g, g), _mm_add_epi16(r, b)), 3);
+	return yuv;
+}
+
+static inline __m128i absDiffSSE2(__m128i a, __m128i b) {
+	const __m128i diff = _mm_sub_epi16(a, b);
+	return _mm_max_epi16(diff, _mm_sub_epi16(_mm_setzero_si128(), diff));
+}
+
+/** Returns bit in every lane in which the colors differ */
+static inline __m128i diffYUVSSE2(const YUVSSE2 &a, const YUVSSE2 &b, int bit) {
+	const __m128i y = _mm_cmpgt_epi16(absDiffSSE2(a.y, b.y), _mm_set1_epi16(kThresholdY));
+	const __m128i u = _mm_cmpgt_epi16(absDiffSSE2(a.u, b.u), _mm_set1_epi16(kThresholdU));
+	const __m128i v = _mm_cmpgt_epi16(absDiffSSE2(a.v, b.v), _mm_set1_epi16(kThresholdV));
+	return _mm_and_si128(_mm_or_si128(_mm_or_si128(y, u), v), _mm_set1_epi16(bit));
+}
+
+static inline void storeYUVSSE2(HQChunk &chunk, int row, uint i, const uint16 *src, const HQFormatSSE2 &format) {
+	const YUVSSE2 yuv = yuvSSE2(src, format);
+	_mm_storeu_si128((__m128i *)&chunk.y[row][i], yuv.y);
+	_mm_storeu_si128((__m128i *)&chunk.u[row][i], yuv.u);
+	_mm_storeu_si128((__m128i *)&chunk.v[row][i], yuv.v);
+}
+
+static inline YUVSSE2 loadYUVSSE2(const HQChunk &chunk, int row, uint i) {
+	YUVSSE2 yuv;
+	yuv.y = _mm_loadu_si128((const __m128i *)&chunk.y[row][i]);
+	yuv.u = _mm_loadu_si128((const __m128i *)&chunk.u[row][i]);
+	yuv.v = _mm_loadu_si128((const __m128i *)&chunk.v[row][i]);
+	return yuv;
+}
+
+static uint hqPatternsSSE2(byte *patterns, const uint16 *src, uint32 nextlineSrc, uint width, const HQKernelFormat &kernelFormat) {
+	const HQFormatSSE2 format(kernelFormat);
+	HQChunk chunk;
+
+	uint x = 0;
+	while (x + 8 <= width) {
+		const uint count = MIN<uint>(kHQChunkSize, (width - x) & ~7);
+
+		// The last block overlaps the previous one rather than reading past
+		// the pixel right of the chunk
+		for (int row = 0; row < 3; ++row) {
+			const uint16 *in = src + (row - 1) * (int)nextlineSrc + x - 1;
+			for (uint i = 0; i + 8 <= count + 2; i += 8)
+				storeYUVSSE2(chunk, row, i, in + i, format);
+			storeYUVSSE2(chunk, row, count - 6, in + count - 6, format);
+		}
+
+		for (uint i = 0; i < count; i += 8) {
+			const YUVSSE2 center = loadYUVSSE2(chunk, 1, i + 1);
+			__m128i pattern = diffYUVSSE2(center, loadYUVSSE2(chunk, 0, i), 0x01);
+			pattern = _mm_or_si128(pattern, diffYUVSSE2(center, loadYUVSSE2(chunk, 0, i + 1), 0x02));
+			pattern = _mm_or_si128(pattern, diffYUVSSE2(center, loadYUVSSE2(chunk, 0, i + 2), 0x04));
+			pattern = _mm_or_si128(pattern, diffYUVSSE2(center, loadYUVSSE2(chunk, 1, i), 0x08));
+			pattern = _mm_or_si128(pattern, diffYUVSSE2(center, loadYUVSSE2(chunk, 1, i + 2), 0x10));
+			pattern = _mm_or_si128(pattern, diffYUVSSE2(center, loadYUVSSE2(chunk, 2, i), 0x20));
+			pattern = _mm_or_si128(pattern, diffYUVSSE2(center, loadYUVSSE2(chunk, 2, i + 1), 0x40));
+			pattern = _mm_or_si128(pattern, diffYUVSSE2(center, loadYUVSSE2(chunk, 2, i + 2), 0x80));
+			_mm_storel_epi64((__m128i *)(patterns + x + i), _mm_packus_epi16(pattern, pattern));
+		}
+
+		x += count;
+	}
+
+	return x;
+}
+
+static inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline __m128i load8SSE2(const uint16 *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+/**
+ * Writes three rows of pixels, interleaved pixel by pixel. SSE2 has no
+ * shuffle across 16-bit lanes which would do this in registers.
+ */
+static inline void store3SSE2(uint16 *dst, __m128i a, __m128i b, __m128i c) {
+	uint16 values[3][8];
+	_mm_storeu_si128((__m128i *)values[0], a);
+	_mm_storeu_si128((__m128i *)values[1], b);
+	_mm_storeu_si128((__m128i *)values[2], c);
+
+	for (int i = 0; i < 8; ++i) {
+		dst[3 * i + 0] = values[0][i];
+		dst[3 * i + 1] = values[1][i];
+		dst[3 * i + 2] = values[2][i];
+	}
+}
+
+static uint scale3xSSE2(uint16 *dst0, uint16 *dst1, uint16 *dst2, const uint16 *src0, const uint16 *src1, const uint16 *src2, uint count) {
+	//	A B C
+	//	D E F
+	//	G H I
+	uint x = 0;
+	for (; x + 8 <= count; x += 8) {
+		const __m128i a = load8SSE2(src0 + x - 1), b = load8SSE2(src0 + x), c = load8SSE2(src0 + x + 1);
+		const __m128i d = load8SSE2(src1 + x - 1), e = load8SSE2(src1 + x), f = load8SSE2(src1 + x + 1);
+		const __m128i g = load8SSE2(src2 + x - 1), h = load8SSE2(src2 + x), i = load8SSE2(src2 + x + 1);
+
+		// Pixels with B == H or D == F are copied unchanged
+		const __m128i active = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi16(b, h), _mm_cmpeq_epi16(d, f)), _mm_set1_epi16(-1));
+		const __m128i db = _mm_and_si128(active, _mm_cmpeq_epi16(d, b));
+		const __m128i fb = _mm_and_si128(active, _mm_cmpeq_epi16(f, b));
+		const __m128i dh = _mm_and_si128(active, _mm_cmpeq_epi16(d, h));
+		const __m128i fh = _mm_and_si128(active, _mm_cmpeq_epi16(f, h));
+		const __m128i ea = _mm_cmpeq_epi16(e, a), ec = _mm_cmpeq_epi16(e, c);
+		const __m128i eg = _mm_cmpeq_epi16(e, g), ei = _mm_cmpeq_epi16(e, i);
+
+		store3SSE2(dst0 + 3 * x,
+			selectSSE2(db, d, e),
+			selectSSE2(_mm_or_si128(_mm_andnot_si128(ec, db), _mm_andnot_si128(ea, fb)), b, e),
+			selectSSE2(fb, f, e));
+		store3SSE2(dst1 + 3 * x,
+			selectSSE2(_mm_or_si128(_mm_andnot_si128(eg, db), _mm_andnot_si128(ea, dh)), d, e),
+			e,
+			selectSSE2(_mm_or_si128(_mm_andnot_si128(ei, fb), _mm_andnot_si128(ec, fh)), f, e));
+		store3SSE2(dst2 + 3 * x,
+			selectSSE2(dh, d, e),
+			selectSSE2(_mm_or_si128(_mm_andnot_si128(ei, dh), _mm_andnot_si128(eg, fh)), h, e),
+			selectSSE2(fh, f, e));
+	}
+
+	return x;
+}
+
+static const ScalerKernel scalerKernelSSE2 = { "sse2", hqPatternsSSE2, scale3xSSE2 };
+
+#endif // SCUMMVM_SSE2
+
+#ifdef SCUMMVM_AVX2
+
+#pragma mark -
+#pragma mark --- AVX2 ---
+#pragma mark -
+
+/** The format in registers, see HQFormatSSE2. The shift counts stay 128-bit. */
+struct HQFormatAVX2 {
+	__m128i shift[3];
+	__m256i mask[3];
+	__m128i loss[3];
+	__m128i refill[3];
+};
+
+SCUMMVM_TARGET_AVX2
+static inline HQFormatAVX2 loadHQFormatAVX2(const HQKernelFormat &format) {
+	const uint bits[3] = { format.rBits, format.gBits, format.bBits };
+	const uint shifts[3] = { format.rShift, format.gShift, format.bShift };
+
+	HQFormatAVX2 result;
+	for (int i = 0; i < 3; ++i) {
+		result.shift[i] = _mm_cvtsi32_si128(shifts[i]);
+		result.mask[i] = _mm256_set1_epi16((1 << bits[i]) - 1);
+		result.loss[i] = _mm_cvtsi32_si128(8 - bits[i]);
+		result.refill[i] = _mm_cvtsi32_si128(2 * bits[i] - 8);
+	}
+	return result;
+}
+
+struct YUVAVX2 {
+	__m256i y, u, v;
+};
+
+SCUMMVM_TARGET_AVX2
+static inline __m256i expandAVX2(__m256i color, const HQFormatAVX2 &format, int i) {
+	const __m256i value = _mm256_and_si256(_mm256_srl_epi16(color, format.shift[i]), format.mask[i]);
+	return _mm256_or_si256(_mm256_sll_epi16(value, format.loss[i]), _mm256_srl_epi16(value, format.refill[i]));
+}
+
+SCUMMVM_TARGET_AVX2
+static inline YUVAVX2 yuvAVX2(const uint16 *src, const HQFormatAVX2 &format) {
+	const __m256i color = _mm256_loadu_si256((const __m256i *)src);
+	const __m256i r = expandAVX2(color, format, 0);
+	const __m256i g = expandAVX2(color, format, 1);
+	const __m256i b = expandAVX2(color, format, 2);
+
+	YUVAVX2 yuv;
+	yuv.y = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(r, g), b), 2);
+	yuv.u = _mm256_srai_epi16(_mm256_sub_epi16(r, b), 2);
+	yuv.v = _mm256_srai_epi16(_mm256_sub_epi16(_mm256_add_epi16(g, g), _mm256_add_epi16(r, b)), 3);
+	return yuv;
+}
+
+SCUMMVM_TARGET_AVX2
+static inline __m256i diffYUVAVX2(const YUVAVX2 &a, const YUVAVX2 &b, int bit) {
+	const __m256i y = _mm256_cmpgt_epi16(_mm256_abs_epi16(_mm256_sub_epi16(a.y, b.y)), _mm256_set1_epi16(kThresholdY));
+	const __m256i u = _mm256_cmpgt_epi16(_mm256_abs_epi16(_mm256_sub_epi16(a.u, b.u)), _mm256_set1_epi16(kThresholdU));
+	const __m256i v = _mm256_cmpgt_epi16(_mm256_abs_epi16(_mm256_sub_epi16(a.v, b.v)), _mm256_set1_epi16(kThresholdV));
+	return _mm256_and_si256(_mm256_or_si256(_mm256_or_si256(y, u), v), _mm256_set1_epi16(bit));
+}
+
+SCUMMVM_TARGET_AVX2
+static inline void storeYUVAVX2(HQChunk &chunk, int row, uint i, const uint16 *src, const HQFormatAVX2 &format) {
+	const YUVAVX2 yuv = yuvAVX2(src, format);
+	_mm256_storeu_si256((__m256i *)&chunk.y[row][i], yuv.y);
+	_mm256_storeu_si256((__m256i *)&chunk.u[row][i], yuv.u);
+	_mm256_storeu_si256((__m256i *)&chunk.v[row][i], yuv.v);
+}
+
+SCUMMVM_TARGET_AVX2
+static inline YUVAVX2 loadYUVAVX2(const HQChunk &chunk, int row, uint i) {
+	YUVAVX2 yuv;
+	yuv.y = _mm256_loadu_si256((const __m256i *)&chunk.y[row][i]);
+	yuv.u = _mm256_loadu_si256((const __m256i *)&chunk.u[row][i]);
+	yuv.v = _mm256_loadu_si256((const __m256i *)&chunk.v[row][i]);
+	return yuv;
+}
+
+SCUMMVM_TARGET_AVX2
+static uint hqPatternsAVX2(byte *patterns, const uint16 *src, uint32 nextlineSrc, uint width, const HQKernelFormat &kernelFormat) {
+	const HQFormatAVX2 format = loadHQFormatAVX2(kernelFormat);
+	HQChunk chunk;
+
+	uint x = 0;
+	while (x + 16 <= width) {
+		const uint count = MIN<uint>(kHQChunkSize, (width - x) & ~15);
+
+		for (int row = 0; row < 3; ++row) {
+			const uint16 *in = src + (row - 1) * (int)nextlineSrc + x - 1;
+			for (uint i = 0; i + 16 <= count + 2; i += 16)
+				storeYUVAVX2(chunk, row, i, in + i, format);
+			storeYUVAVX2(chunk, row, count - 14, in + count - 14, format);
+		}
+
+		for (uint i = 0; i < count; i += 16) {
+			const YUVAVX2 center = loadYUVAVX2(chunk, 1, i + 1);
+			__m256i pattern = diffYUVAVX2(center, loadYUVAVX2(chunk, 0, i), 0x01);
+			pattern = _mm256_or_si256(pattern, diffYUVAVX2(center, loadYUVAVX2(chunk, 0, i + 1), 0x02));
+			pattern = _mm256_or_si256(pattern, diffYUVAVX2(center, loadYUVAVX2(chunk, 0, i + 2), 0x04));
+			pattern = _mm256_or_si256(pattern, diffYUVAVX2(center, loadYUVAVX2(chunk, 1, i), 0x08));
+			pattern = _mm256_or_si256(pattern, diffYUVAVX2(center, loadYUVAVX2(chunk, 1, i + 2), 0x10));
+			pattern = _mm256_or_si256(pattern, diffYUVAVX2(center, loadYUVAVX2(chunk, 2, i), 0x20));
+			pattern = _mm256_or_si256(pattern, diffYUVAVX2(center, loadYUVAVX2(chunk, 2, i + 1), 0x40));
+			pattern = _mm256_or_si256(pattern, diffYUVAVX2(center, loadYUVAVX2(chunk, 2, i + 2), 0x80));
+
+			// The packing works within 128-bit lanes
+			const __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(pattern), _mm256_extracti128_si256(pattern, 1));
+			_mm_storeu_si128((__m128i *)(patterns + x + i), packed);
+		}
+
+		x += count;
+	}
+
+	return x;
+}
+
+// Scale3x is bound by storing the interleaved pixels, for which AVX2 does
+// not help much
+static const ScalerKernel scalerKernelAVX2 = { "avx2", hqPatternsAVX2, scale3xSSE2 };
+
+#endif // SCUMMVM_AVX2
+
+#ifdef SCUMMVM_NEON
+
+#pragma mark -
+#pragma mark --- NEON ---
+#pragma mark -
+
+/** The format in registers, see HQFormatSSE2. Shifts to the right are negative. */
+struct HQFormatNEON {
+	explicit HQFormatNEON(const HQKernelFormat &format) {
+		const uint bits[3] = { format.rBits, format.gBits, format.bBits };
+		const uint shifts[3] = { format.rShift, format.gShift, format.bShift };
+		for (int i = 0; i < 3; ++i) {
+			shift[i] = vdupq_n_s16(-(int)shifts[i]);
+			mask[i] = vdupq_n_u16((1 << bits[i]) - 1);
+			loss[i] = vdupq_n_s16(8 - bits[i]);
+			refill[i] = vdupq_n_s16(8 - 2 * (int)bits[i]);
+		}
+	}
+
+	int16x8_t shift[3];
+	uint16x8_t mask[3];
+	int16x8_t loss[3];
+	int16x8_t refill[3];
+};
+
+struct YUVNEON {
+	int16x8_t y, u, v;
+};
+
+static inline uint16x8_t expandNEON(uint16x8_t color, const HQFormatNEON &format, int i) {
+	const uint16x8_t value = vandq_u16(vshlq_u16(color, format.shift[i]), format.mask[i]);
+	return vorrq_u16(vshlq_u16(value, format.loss[i]), vshlq_u16(value, format.refill[i]));
+}
+
+static inline YUVNEON yuvNEON(const uint16 *src, const HQFormatNEON &format) {
+	const uint16x8_t color = vld1q_u16(src);
+	const int16x8_t r = vreinterpretq_s16_u16(expandNEON(color, format, 0));
+	const int16x8_t g = vreinterpretq_s16_u16(expandNEON(color, format, 1));
+	const int16x8_t b = vreinterpretq_s16_u16(expandNEON(color, format, 2));
+
+	YUVNEON yuv;
+	yuv.y = vshrq_n_s16(vaddq_s16(vaddq_s16(r, g), b), 2);
+	yuv.u = vshrq_n_s16(vsubq_s16(r, b), 2);
+	yuv.v = vshrq_n_s16(vsubq_s16(vaddq_s16(g, g), vaddq_s16(r, b)), 3);
+	return yuv;
+}
+
+static inline uint16x8_t diffYUVNEON(const YUVNEON &a, const YUVNEON &b, int bit) {
+	const uint16x8_t y = vcgtq_s16(vabdq_s16(a.y, b.y), vdupq_n_s16(kThresholdY));
+	const uint16x8_t u = vcgtq_s16(vabdq_s16(a.u, b.u), vdupq_n_s16(kThresholdU));
+	const uint16x8_t v = vcgtq_s16(vabdq_s16(a.v, b.v), vdupq_n_s16(kThresholdV));
+	return vandq_u16(vorrq_u16(vorrq_u16(y, u), v), vdupq_n_u16(bit));
+}
+
+static inline void storeYUVNEON(HQChunk &chunk, int row, uint i, const uint16 *src, const HQFormatNEON &format) {
+	const YUVNEON yuv = yuvNEON(src, format);
+	vst1q_s16(&chunk.y[row][i], yuv.y);
+	vst1q_s16(&chunk.u[row][i], yuv.u);
+	vst1q_s16(&chunk.v[row][i], yuv.v);
+}
+
+static inline YUVNEON loadYUVNEON(const HQChunk &chunk, int row, uint i) {
+	YUVNEON yuv;
+	yuv.y = vld1q_s16(&chunk.y[row][i]);
+	yuv.u = vld1q_s16(&chunk.u[row][i]);
+	yuv.v = vld1q_s16(&chunk.v[row][i]);
+	return yuv;
+}
+
+static uint hqPatternsNEON(byte *patterns, const uint16 *src, uint32 nextlineSrc, uint width, const HQKernelFormat &kernelFormat) {
+	const HQFormatNEON format(kernelFormat);
+	HQChunk chunk;
+
+	uint x = 0;
+	while (x + 8 <= width) {
+		const uint count = MIN<uint>(kHQChunkSize, (width - x) & ~7);
+
+		for (int row = 0; row < 3; ++row) {
+			const uint16 *in = src + (row - 1) * (int)nextlineSrc + x - 1;
+			for (uint i = 0; i + 8 <= count + 2; i += 8)
+				storeYUVNEON(chunk, row, i, in + i, format);
+			storeYUVNEON(chunk, row, count - 6, in + count - 6, format);
+		}
+
+		for (uint i = 0; i < count; i += 8) {
+			const YUVNEON center = loadYUVNEON(chunk, 1, i + 1);
+			uint16x8_t pattern = diffYUVNEON(center, loadYUVNEON(chunk, 0, i), 0x01);
+			pattern = vorrq_u16(pattern, diffYUVNEON(center, loadYUVNEON(chunk, 0, i + 1), 0x02));
+			pattern = vorrq_u16(pattern, diffYUVNEON(center, loadYUVNEON(chunk, 0, i + 2), 0x04));
+			pattern = vorrq_u16(pattern, diffYUVNEON(center, loadYUVNEON(chunk, 1, i), 0x08));
+			pattern = vorrq_u16(pattern, diffYUVNEON(center, loadYUVNEON(chunk, 1, i + 2), 0x10));
+			pattern = vorrq_u16(pattern, diffYUVNEON(center, loadYUVNEON(chunk, 2, i), 0x20));
+			pattern = vorrq_u16(pattern, diffYUVNEON(center, loadYUVNEON(chunk, 2, i + 1), 0x40));
+			pattern = vorrq_u16(pattern, diffYUVNEON(center, loadYUVNEON(chunk, 2, i + 2), 0x80));
+			vst1_u8(patterns + x + i, vmovn_u16(pattern));
+		}
+
+		x += count;
+	}
+
+	return x;
+}
+
+static uint scale3xNEON(uint16 *dst0, uint16 *dst1, uint16 *dst2, const uint16 *src0, const uint16 *src1, const uint16 *src2, uint count) {
+	uint x = 0;
+	for (; x + 8 <= count; x += 8) {
+		const uint16x8_t a = vld1q_u16(src0 + x - 1), b = vld1q_u16(src0 + x), c = vld1q_u16(src0 + x + 1);
+		const uint16x8_t d = vld1q_u16(src1 + x - 1), e = vld1q_u16(src1 + x), f = vld1q_u16(src1 + x + 1);
+		const uint16x8_t g = vld1q_u16(src2 + x - 1), h = vld1q_u16(src2 + x), i = vld1q_u16(src2 + x + 1);
+
+		const uint16x8_t active = vmvnq_u16(vorrq_u16(vceqq_u16(b, h), vceqq_u16(d, f)));
+		const uint16x8_t db = vandq_u16(active, vceqq_u16(d, b));
+		const uint16x8_t fb = vandq_u16(active, vceqq_u16(f, b));
+		const uint16x8_t dh = vandq_u16(active, vceqq_u16(d, h));
+		const uint16x8_t fh = vandq_u16(active, vceqq_u16(f, h));
+		const uint16x8_t ea = vceqq_u16(e, a), ec = vceqq_u16(e, c);
+		const uint16x8_t eg = vceqq_u16(e, g), ei = vceqq_u16(e, i);
+
+		uint16x8x3_t row;
+		row.val[0] = vbslq_u16(db, d, e);
+		row.val[1] = vbslq_u16(vorrq_u16(vbicq_u16(db, ec), vbicq_u16(fb, ea)), b, e);
+		row.val[2] = vbslq_u16(fb, f, e);
+		vst3q_u16(dst0 + 3 * x, row);
+
+		row.val[0] = vbslq_u16(vorrq_u16(vbicq_u16(db, eg), vbicq_u16(dh, ea)), d, e);
+		row.val[1] = e;
+		row.val[2] = vbslq_u16(vorrq_u16(vbicq_u16(fb, ei), vbicq_u16(fh, ec)), f, e);
+		vst3q_u16(dst1 + 3 * x, row);
+
+		row.val[0] = vbslq_u16(dh, d, e);
+		row.val[1] = vbslq_u16(vorrq_u16(vbicq_u16(dh, ei), vbicq_u16(fh, eg)), h, e);
+		row.val[2] = vbslq_u16(fh, f, e);
+		vst3q_u16(dst2 + 3 * x, row);
+	}
+
+	return x;
+}
+
+static const ScalerKernel scalerKernelNEON = { "neon", hqPatternsNEON, scale3xNEON };
+
+#endif // SCUMMVM_NEON
+
+#pragma mark -
+
+const ScalerKernel *gScalerKernel = nullptr;
+HQKernelFormat gHQKernelFormat = { 5, 6, 5, 11, 5, 0 };
+
+const ScalerKernel *getScalerKernel(ScalerKernelType type) {
+	switch (type) {
+#ifdef SCUMMVM_SSE2
+	case kScalerKernelSSE2:
+		return Common::hasCPUFeature(Common::kCPUFeatureSSE2) ? &scalerKernelSSE2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_AVX2
+	case kScalerKernelAVX2:
+		return Common::hasCPUFeature(Common::kCPUFeatureAVX2) ? &scalerKernelAVX2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_NEON
+	case kScalerKernelNEON:
+		return Common::hasCPUFeature(Common::kCPUFeatureNEON) ? &scalerKernelNEON : nullptr;
+#endif
+
+	default:
+		return nullptr;
+	}
+}
+
+const ScalerKernel *getDefaultScalerKernel() {
+	const ScalerKernel *kernel = nullptr;
+	for (int i = 0; i < kScalerKernelCount; ++i) {
+		const ScalerKernel *candidate = getScalerKernel((ScalerKernelType)i);
+		if (candidate)
+			kernel = candidate;
+	}
+
+	return kernel;
+}
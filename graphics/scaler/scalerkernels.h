@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_SCALERKERNELS_H
+#define GRAPHICS_SCALER_SCALERKERNELS_H
+
+#include "common/scummsys.h"
+
+/**
+ * The pixel format of the HQ scalers, prepared for the kernels. Every
+ * channel has 4 to 8 bits.
+ */
+struct HQKernelFormat {
+	uint rBits, gBits, bBits;
+	uint rShift, gShift, bShift;
+};
+
+/**
+ * Computes the neighbour patterns of the HQ scalers for a row of pixels,
+ * from the beginning on, for as long as the kernel can process them in
+ * whole blocks. Bit n of a pattern is set when the n-th neighbour, in the
+ * order w1, w2, w3, w4, w6, w7, w8, w9, differs from the pixel according to
+ * diffYUV() and the RGBtoYUV table.
+ *
+ * @param patterns		one pattern per pixel
+ * @param src			first pixel of the row
+ * @param nextlineSrc	distance between two source rows, in pixels
+ * @param width			width of the row
+ * @return the number of patterns computed; the caller computes the rest
+ */
+typedef uint (*HQPatternRowProc)(byte *patterns, const uint16 *src, uint32 nextlineSrc, uint width, const HQKernelFormat &format);
+
+/**
+ * Scales a row of 16 bit pixels by three with the Scale3x effect, like
+ * scale3x_16_def(), for as long as the kernel can process the pixels in
+ * whole blocks.
+ *
+ * @return the number of pixels scaled; the caller scales the rest
+ */
+typedef uint (*Scale3xRowProc)(uint16 *dst0, uint16 *dst1, uint16 *dst2, const uint16 *src0, const uint16 *src1, const uint16 *src2, uint count);
+
+/**
+ * A set of routines speeding up the scalers on one instruction set. All
+ * kernels produce exactly the same output as the C implementation.
+ */
+struct ScalerKernel {
+	const char *name;
+	HQPatternRowProc hqPatterns;
+	Scale3xRowProc scale3x;
+};
+
+enum ScalerKernelType {
+	kScalerKernelSSE2 = 0,
+	kScalerKernelAVX2,
+	kScalerKernelNEON,
+
+	kScalerKernelCount
+};
+
+/**
+ * Returns the kernel of the given type, or nullptr if it is not available
+ * in this build or not supported by the host CPU.
+ */
+const ScalerKernel *getScalerKernel(ScalerKernelType type);
+
+/**
+ * Returns the fastest kernel available on the host, or nullptr if there is
+ * none.
+ */
+const ScalerKernel *getDefaultScalerKernel();
+
+/**
+ * The kernel used by the scalers, or nullptr for the C implementation.
+ * InitScalers() sets it to the default kernel.
+ */
+extern const ScalerKernel *gScalerKernel;
+
+/** The pixel format of the RGBtoYUV table, set up by InitScalers(). */
+extern HQKernelFormat gHQKernelFormat;
+
+#endif
@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "graphics/surface_pool.h"
+#include "graphics/surface.h"
+
+namespace Graphics {
+
+/** A surface which remembers the size of its buffer */
+struct SurfacePool::PooledSurface : public Surface {
+	uint32 capacity;
+};
+
+SurfacePool::SurfacePool(uint maxSurfaces, uint32 maxBytes) :
+	_unusedBytes(0), _maxSurfaces(maxSurfaces), _maxBytes(maxBytes) {
+	_unused.reserve(maxSurfaces);
+}
+
+SurfacePool::~SurfacePool() {
+	clear();
+}
+
+Surface *SurfacePool::acquire(uint16 w, uint16 h, const PixelFormat &format) {
+	const uint32 size = w * h * format.bytesPerPixel;
+
+	// Take the smallest buffer which is large enough
+	PooledSurface *surface = nullptr;
+	int best = -1;
+	for (uint i = 0; i < _unused.size(); ++i) {
+		if (_unused[i]->capacity >= size && (best < 0 || _unused[i]->capacity < _unused[best]->capacity))
+			best = i;
+	}
+	if (best >= 0) {
+		surface = _unused[best];
+		_unusedBytes -= surface->capacity;
+		_unused.remove_at(best);
+	}
+
+	if (!surface) {
+		surface = new PooledSurface();
+		surface->capacity = size;
+		surface->setPixels(size ? malloc(size) : nullptr);
+	}
+
+	surface->w = w;
+	surface->h = h;
+	surface->pitch = w * format.bytesPerPixel;
+	surface->format = format;
+	return surface;
+}
+
+void SurfacePool::release(Surface *surface) {
+	if (!surface)
+		return;
+
+	PooledSurface *pooled = static_cast<PooledSurface *>(surface);
+
+	if (_unused.size() < _maxSurfaces && _unusedBytes + pooled->capacity <= _maxBytes) {
+		_unused.push_back(pooled);
+		_unusedBytes += pooled->capacity;
+	} else {
+		pooled->free();
+		delete pooled;
+	}
+}
+
+void SurfacePool::clear() {
+	for (uint i = 0; i < _unused.size(); ++i) {
+		_unused[i]->free();
+		delete _unused[i];
+	}
+	_unused.clear();
+	_unusedBytes = 0;
+}
+
+uint SurfacePool::getUnusedCount() const {
+	return _unused.size();
+}
+
+SurfacePool &getScratchSurfacePool() {
+	// Enough for the sprites of a frame, which are mostly small
+	static SurfacePool pool(32, 8 * 1024 * 1024);
+	return pool;
+}
+
+} // End of namespace Graphics
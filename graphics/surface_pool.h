@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef GRAPHICS_SURFACE_POOL_H
+#define GRAPHICS_SURFACE_POOL_H
+
+#include "common/array.h"
+#include "common/noncopyable.h"
+
+namespace Graphics {
+
+struct PixelFormat;
+struct Surface;
+
+/**
+ * Keeps the pixel buffers of temporary surfaces for reuse. Drawing code
+ * which needs a scratch surface for every draw, like a scaled copy of a
+ * sprite, saves allocating and freeing one each time.
+ *
+ * The pool is not thread-safe, it is meant for the drawing code on the
+ * main thread.
+ */
+class SurfacePool : Common::NonCopyable {
+public:
+	/**
+	 * @param maxSurfaces	maximum number of unused surfaces kept
+	 * @param maxBytes		maximum size of the buffers of the unused surfaces
+	 */
+	SurfacePool(uint maxSurfaces, uint32 maxBytes);
+	~SurfacePool();
+
+	/**
+	 * Returns a surface of the given size and format, with pitch w *
+	 * bytesPerPixel. Its pixels are undefined. The surface must be given
+	 * back with release() rather than freed.
+	 */
+	Surface *acquire(uint16 w, uint16 h, const PixelFormat &format);
+
+	/**
+	 * Gives a surface returned by acquire() back to the pool, which keeps
+	 * it for reuse if the limits allow.
+	 */
+	void release(Surface *surface);
+
+	/**
+	 * Frees all unused surfaces.
+	 */
+	void clear();
+
+	/**
+	 * Returns the number of unused surfaces kept.
+	 */
+	uint getUnusedCount() const;
+
+private:
+	struct PooledSurface;
+
+	Common::Array<PooledSurface *> _unused;
+	uint32 _unusedBytes;
+	const uint _maxSurfaces;
+	const uint32 _maxBytes;
+};
+
+/**
+ * Returns the pool for the temporary surfaces of the drawing code.
+ */
+SurfacePool &getScratchSurfacePool();
+
+} // End of namespace Graphics
+
+#endif
@@ -33,37 +33,16 @@
 #include "common/rect.h"
 #include "common/math.h"
 #include "common/textconsole.h"
+#include "graphics/blitkernels.h"
 #include "graphics/primitives.h"
+#include "graphics/surface_pool.h"
 #include "graphics/transparent_surface.h"
 #include "graphics/transform_tools.h"
 
 namespace Graphics {
 
-static const int kBModShift = 0;//img->format.bShift;
-static const int kGModShift = 8;//img->format.gShift;
-static const int kRModShift = 16;//img->format.rShift;
 static const int kAModShift = 24;//img->format.aShift;
 
-#ifdef SCUMM_LITTLE_ENDIAN
-static const int kAIndex = 0;
-static const int kBIndex = 1;
-static const int kGIndex = 2;
-static const int kRIndex = 3;
-
-#else
-static const int kAIndex = 3;
-static const int kBIndex = 2;
-static const int kGIndex = 1;
-static const int kRIndex = 0;
-#endif
-
-void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
-void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
-void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
 TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Surface(), _alphaMode(ALPHA_FULL) {
@@ -82,320 +61,48 @@ TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Sur
 }
 
 /**
- * Optimized version of doBlit to be used w/opaque blitting (no alpha).
+ * Returns how to draw the rows of a blit, so that the kernels do not need
+ * to check the blending parameters for each pixel.
  */
-void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
-
-	byte *in;
-	byte *out;
-
-	for (uint32 i = 0; i < height; i++) {
-		out = outo;
-		in = ino;
-		memcpy(out, in, width * 4);
-		for (uint32 j = 0; j < width; j++) {
-			out[kAIndex] = 0xFF;
-			out += 4;
-		}
-		outo += pitch;
-		ino += inoStep;
+static BlendRowMode getBlendRowMode(TSpriteBlendMode blendMode, AlphaType alphaMode, uint color) {
+	const bool tinted = color != 0xFFFFFFFF;
+
+	if (!tinted && blendMode == BLEND_NORMAL && alphaMode == ALPHA_OPAQUE)
+		return kBlendRowOpaque;
+	if (!tinted && blendMode == BLEND_NORMAL && alphaMode == ALPHA_BINARY)
+		return kBlendRowBinary;
+
+	switch (blendMode) {
+	case BLEND_ADDITIVE:
+		return tinted ? kBlendRowAdditiveTinted : kBlendRowAdditive;
+	case BLEND_SUBTRACTIVE:
+		return tinted ? kBlendRowSubtractiveTinted : kBlendRowSubtractive;
+	case BLEND_MULTIPLY:
+		return tinted ? kBlendRowMultiplyTinted : kBlendRowMultiply;
+	default:
+		assert(blendMode == BLEND_NORMAL);
+		return tinted ? kBlendRowAlphaTinted : kBlendRowAlpha;
 	}
 }
 
 /**
- * Optimized version of doBlit to be used w/binary blitting (blit or no-blit, no blending).
+ * Draws the clipped image onto the target.
+ * @param ino the first source pixel to draw, the last one of its row if flipped horizontally
+ * @param outo the first target pixel
+ * @param pitch pitch of the target
+ * @param inoStep offset between the source rows, negative if flipped vertically
  */
-void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
-
-	byte *in;
-	byte *out;
+static void drawRows(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inoStep,
+                     bool flipH, TSpriteBlendMode blendMode, AlphaType alphaMode, uint color) {
+	const BlendRowProc drawRow = getDefaultBlitKernel().blend[getBlendRowMode(blendMode, alphaMode, color)][flipH];
 
 	for (uint32 i = 0; i < height; i++) {
-		out = outo;
-		in = ino;
-		for (uint32 j = 0; j < width; j++) {
-			uint32 pix = *(uint32 *)in;
-			int a = in[kAIndex];
-
-			if (a != 0) {   // Full opacity (Any value not exactly 0 is Opaque here)
-				*(uint32 *)out = pix;
-				out[kAIndex] = 0xFF;
-			}
-			out += 4;
-			in += inStep;
-		}
+		drawRow(outo, ino, width, color);
 		outo += pitch;
 		ino += inoStep;
 	}
 }
 
-/**
- * Optimized version of doBlit to be used with alpha blended blitting
- * @param ino a pointer to the input surface
- * @param outo a pointer to the output surface
- * @param width width of the input surface
- * @param height height of the input surface
- * @param pitch pitch of the output surface - that is, width in bytes of every row, usually bpp * width of the TARGET surface (the area we are blitting to might be smaller, do the math)
- * @inStep size in bytes to skip to address each pixel, usually bpp of the source surface
- * @inoStep width in bytes of every row on the *input* surface / kind of like pitch
- * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
- */
-void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kAIndex] = 255;
-					out[kRIndex] = ((in[kRIndex] * in[kAIndex]) + out[kRIndex] * (255 - in[kAIndex])) >> 8;
-					out[kGIndex] = ((in[kGIndex] * in[kAIndex]) + out[kGIndex] * (255 - in[kAIndex])) >> 8;
-					out[kBIndex] = ((in[kBIndex] * in[kAIndex]) + out[kBIndex] * (255 - in[kAIndex])) >> 8;
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-
-				if (ina != 0) {
-					out[kAIndex] = 255;
-					out[kBIndex] = (out[kBIndex] * (255 - ina) >> 8);
-					out[kGIndex] = (out[kGIndex] * (255 - ina) >> 8);
-					out[kRIndex] = (out[kRIndex] * (255 - ina) >> 8);
-
-					out[kBIndex] = out[kBIndex] + (in[kBIndex] * ina * cb >> 16);
-					out[kGIndex] = out[kGIndex] + (in[kGIndex] * ina * cg >> 16);
-					out[kRIndex] = out[kRIndex] + (in[kRIndex] * ina * cr >> 16);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
-}
-
-/**
- * Optimized version of doBlit to be used with additive blended blitting
- */
-void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
-					out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) + out[kGIndex], 255);
-					out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) + out[kBIndex], 255);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-
-				if (cb != 255) {
-					out[kBIndex] = MIN<uint>(out[kBIndex] + ((in[kBIndex] * cb * ina) >> 16), 255u);
-				} else {
-					out[kBIndex] = MIN<uint>(out[kBIndex] + (in[kBIndex] * ina >> 8), 255u);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MIN<uint>(out[kGIndex] + ((in[kGIndex] * cg * ina) >> 16), 255u);
-				} else {
-					out[kGIndex] = MIN<uint>(out[kGIndex] + (in[kGIndex] * ina >> 8), 255u);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MIN<uint>(out[kRIndex] + ((in[kRIndex] * cr * ina) >> 16), 255u);
-				} else {
-					out[kRIndex] = MIN<uint>(out[kRIndex] + (in[kRIndex] * ina >> 8), 255u);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
-}
-
-/**
- * Optimized version of doBlit to be used with subtractive blended blitting
- */
-void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * out[kGIndex]) * in[kAIndex] >> 16), 0);
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * out[kBIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				out[kAIndex] = 255;
-				if (cb != 255) {
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * cb  * (out[kBIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kBIndex] = MAX(out[kBIndex] - (in[kBIndex] * (out[kBIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * cg  * (out[kGIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kGIndex] = MAX(out[kGIndex] - (in[kGIndex] * (out[kGIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * cr * (out[kRIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kRIndex] = MAX(out[kRIndex] - (in[kRIndex] * (out[kRIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
-}
-
-/**
- * Optimized version of doBlit to be used with multiply blended blitting
- */
-void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
-					out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) * out[kGIndex] >> 8, 255);
-					out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) * out[kBIndex] >> 8, 255);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-
-				if (cb != 255) {
-					out[kBIndex] = MIN<uint>(out[kBIndex] * ((in[kBIndex] * cb * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kBIndex] = MIN<uint>(out[kBIndex] * (in[kBIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MIN<uint>(out[kGIndex] * ((in[kGIndex] * cg * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kGIndex] = MIN<uint>(out[kGIndex] * (in[kGIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MIN<uint>(out[kRIndex] * ((in[kRIndex] * cr * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kRIndex] = MIN<uint>(out[kRIndex] * (in[kRIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
-
-}
-
 Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, TSpriteBlendMode blendMode) {
 
 	Common::Rect retSize;
@@ -460,8 +167,10 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 	Graphics::Surface *imgScaled = nullptr;
 	byte *savedPixels = nullptr;
 	if ((width != srcImage.w) || (height != srcImage.h)) {
-		// Scale the image
-		img = imgScaled = srcImage.scale(width, height);
+		// Scale the image into a scratch surface, which is reused by the
+		// next scaled blit
+		img = imgScaled = getScratchSurfacePool().acquire(width, height, srcImage.format);
+		srcImage.scaleIntoT<FILTER_NEAREST>(*imgScaled);
 		savedPixels = (byte *)img->getPixels();
 	} else {
 		img = &srcImage;
@@ -498,10 +207,8 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 	if ((img->w > 0) && (img->h > 0)) {
 		int xp = 0, yp = 0;
 
-		int inStep = 4;
 		int inoStep = img->pitch;
 		if (flipping & FLIP_H) {
-			inStep = -inStep;
 			xp = img->w - 1;
 		}
 
@@ -513,22 +220,7 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
+		drawRows(ino, outo, img->w, img->h, target.pitch, inoStep, flipping & FLIP_H, blendMode, _alphaMode, color);
 
 	}
 
@@ -537,8 +229,7 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 
 	if (imgScaled) {
 		imgScaled->setPixels(savedPixels);
-		imgScaled->free();
-		delete imgScaled;
+		getScratchSurfacePool().release(imgScaled);
 	}
 
 	return retSize;
@@ -607,8 +298,10 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 	Graphics::Surface *imgScaled = nullptr;
 	byte *savedPixels = nullptr;
 	if ((width != srcImage.w) || (height != srcImage.h)) {
-		// Scale the image
-		img = imgScaled = srcImage.scale(width, height);
+		// Scale the image into a scratch surface, which is reused by the
+		// next scaled blit
+		img = imgScaled = getScratchSurfacePool().acquire(width, height, srcImage.format);
+		srcImage.scaleIntoT<FILTER_NEAREST>(*imgScaled);
 		savedPixels = (byte *)img->getPixels();
 	} else {
 		img = &srcImage;
@@ -645,10 +338,8 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 	if ((img->w > 0) && (img->h > 0)) {
 		int xp = 0, yp = 0;
 
-		int inStep = 4;
 		int inoStep = img->pitch;
 		if (flipping & FLIP_H) {
-			inStep = -inStep;
 			xp = img->w - 1;
 		}
 
@@ -660,22 +351,7 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
+		drawRows(ino, outo, img->w, img->h, target.pitch, inoStep, flipping & FLIP_H, blendMode, _alphaMode, color);
 
 	}
 
@@ -684,8 +360,7 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 
 	if (imgScaled) {
 		imgScaled->setPixels(savedPixels);
-		imgScaled->free();
-		delete imgScaled;
+		getScratchSurfacePool().release(imgScaled);
 	}
 
 	return retSize;
@@ -798,12 +473,26 @@ TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transf
 
 	assert(transform._angle != 0); // This would not be ideal; rotoscale() should never be called in conditional branches where angle = 0 anyway.
 
+	Common::Rect rect = TransformTools::newRect(Common::Rect(0, 0, (int16)w, (int16)h), transform, nullptr);
+
+	TransparentSurface *target = new TransparentSurface();
+	assert(format.bytesPerPixel == 4);
+
+	target->create((uint16)rect.width(), (uint16)rect.height(), this->format);
+	rotoscaleIntoT<filteringMode>(*target, transform);
+	return target;
+}
+
+template <TFilteringMode filteringMode>
+void TransparentSurface::rotoscaleIntoT(Surface &target, const TransformStruct &transform) const {
+
+	assert(transform._angle != 0);
+
 	Common::Point newHotspot;
 	Common::Rect srcRect(0, 0, (int16)w, (int16)h);
 	Common::Rect rect = TransformTools::newRect(Common::Rect(srcRect), transform, &newHotspot);
 	Common::Rect dstRect(0, 0, (int16)(rect.right - rect.left), (int16)(rect.bottom - rect.top));
 
-	TransparentSurface *target = new TransparentSurface();
 	assert(format.bytesPerPixel == 4);
 
 	int srcW = w;
@@ -811,10 +500,13 @@ TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transf
 	int dstW = dstRect.width();
 	int dstH = dstRect.height();
 
-	target->create((uint16)dstW, (uint16)dstH, this->format);
+	assert(target.w == dstW && target.h == dstH && target.pitch == dstW * 4);
+
+	// Pixels outside the rotated image are left transparent
+	memset(target.getPixels(), 0, target.pitch * target.h);
 
 	if (transform._zoom.x == 0 || transform._zoom.y == 0) {
-		return target;
+		return;
 	}
 
 	uint32 invAngle = 360 - (transform._angle % 360);
@@ -840,7 +532,7 @@ TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transf
 	int sw = srcW - 1;
 	int sh = srcH - 1;
 
-	tColorRGBA *pc = (tColorRGBA*)target->getBasePtr(0, 0);
+	tColorRGBA *pc = (tColorRGBA*)target.getBasePtr(0, 0);
 
 	for (int y = 0; y < dstH; y++) {
 		int t = cy - y;
@@ -905,20 +597,26 @@ TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transf
 			pc++;
 		}
 	}
-	return target;
 }
 
 template <TFilteringMode filteringMode>
 TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight) const {
 
 	TransparentSurface *target = new TransparentSurface();
+	target->create(newWidth, newHeight, format);
+	scaleIntoT<filteringMode>(*target);
+	return target;
+}
+
+template <TFilteringMode filteringMode>
+void TransparentSurface::scaleIntoT(Surface &target) const {
 
 	int srcW = w;
 	int srcH = h;
-	int dstW = newWidth;
-	int dstH = newHeight;
+	int dstW = target.w;
+	int dstH = target.h;
 
-	target->create((uint16)dstW, (uint16)dstH, format);
+	assert(target.format == format);
 
 	if (filteringMode == FILTER_BILINEAR) {
 		assert(format.bytesPerPixel == 4);
@@ -971,7 +669,7 @@ TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight
 		}
 
 		const tColorRGBA *sp = (const tColorRGBA *) getBasePtr(0, 0);
-		tColorRGBA *dp = (tColorRGBA *) target->getBasePtr(0, 0);
+		tColorRGBA *dp = (tColorRGBA *) target.getBasePtr(0, 0);
 		int spixelgap = srcW;
 
 		if (flipx) {
@@ -1089,8 +787,6 @@ TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight
 
 		delete[] scaleCacheX;
 	}
-
-	return target;
 }
 
 TransparentSurface *TransparentSurface::convertTo(const PixelFormat &dstFormat, const byte *palette) const {
@@ -1172,11 +868,11 @@ TransparentSurface *TransparentSurface::convertTo(const PixelFormat &dstFormat,
 }
 
 template <typename Size>
-void TransparentSurface::scaleNN(int *scaleCacheX, TransparentSurface *target) const {
-	for (int y = 0; y < target->h; y++) {
-		Size *destP = (Size *)target->getBasePtr(0, y);
-		const Size *srcP = (const Size *)getBasePtr(0, (y * h) / target->h);
-		for (int x = 0; x < target->w; x++) {
+void TransparentSurface::scaleNN(int *scaleCacheX, Surface &target) const {
+	for (int y = 0; y < target.h; y++) {
+		Size *destP = (Size *)target.getBasePtr(0, y);
+		const Size *srcP = (const Size *)getBasePtr(0, (y * h) / target.h);
+		for (int x = 0; x < target.w; x++) {
 			*destP++ = srcP[scaleCacheX[x]];
 		}
 	}
@@ -1186,10 +882,14 @@ template TransparentSurface *TransparentSurface::rotoscaleT<FILTER_NEAREST>(cons
 template TransparentSurface *TransparentSurface::rotoscaleT<FILTER_BILINEAR>(const TransformStruct &transform) const;
 template TransparentSurface *TransparentSurface::scaleT<FILTER_NEAREST>(uint16 newWidth, uint16 newHeight) const;
 template TransparentSurface *TransparentSurface::scaleT<FILTER_BILINEAR>(uint16 newWidth, uint16 newHeight) const;
-
-template void TransparentSurface::scaleNN<uint8>(int *scaleCacheX, TransparentSurface *target) const;
-template void TransparentSurface::scaleNN<uint16>(int *scaleCacheX, TransparentSurface *target) const;
-template void TransparentSurface::scaleNN<uint32>(int *scaleCacheX, TransparentSurface *target) const;
+template void TransparentSurface::rotoscaleIntoT<FILTER_NEAREST>(Surface &target, const TransformStruct &transform) const;
+template void TransparentSurface::rotoscaleIntoT<FILTER_BILINEAR>(Surface &target, const TransformStruct &transform) const;
+template void TransparentSurface::scaleIntoT<FILTER_NEAREST>(Surface &target) const;
+template void TransparentSurface::scaleIntoT<FILTER_BILINEAR>(Surface &target) const;
+
+template void TransparentSurface::scaleNN<uint8>(int *scaleCacheX, Surface &target) const;
+template void TransparentSurface::scaleNN<uint16>(int *scaleCacheX, Surface &target) const;
+template void TransparentSurface::scaleNN<uint32>(int *scaleCacheX, Surface &target) const;
 
 TransparentSurface *TransparentSurface::rotoscale(const TransformStruct &transform) const {
 	return rotoscaleT<FILTER_BILINEAR>(transform);
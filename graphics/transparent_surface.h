@@ -152,6 +152,16 @@ struct TransparentSurface : public Graphics::Surface {
 
 	TransparentSurface *scale(uint16 newWidth, uint16 newHeight) const;
 
+	/**
+	 * Same as scaleT(), but scales into the given surface, which determines
+	 * the resulting size. This allows reusing the target, e.g. one from a
+	 * SurfacePool.
+	 *
+	 * @param target a surface of the same format, with pitch w * bytesPerPixel
+	 */
+	template <TFilteringMode filteringMode>
+	void scaleIntoT(Graphics::Surface &target) const;
+
 	/**
 	 * @brief Rotoscale function; this returns a transformed version of this surface after rotation and
 	 * scaling. Please do not use this if angle == 0, use plain old scaling function.
@@ -164,6 +174,16 @@ struct TransparentSurface : public Graphics::Surface {
 
 	TransparentSurface *rotoscale(const TransformStruct &transform) const;
 
+	/**
+	 * Same as rotoscaleT(), but draws into the given surface. Its size has
+	 * to be the one TransformTools::newRect() gives for the transform.
+	 *
+	 * @param target a surface of the same format, with pitch w * bytesPerPixel
+	 * @param transform a TransformStruct wrapping the required info. @see TransformStruct
+	 */
+	template <TFilteringMode filteringMode>
+	void rotoscaleIntoT(Graphics::Surface &target, const TransformStruct &transform) const;
+
 	TransparentSurface *convertTo(const PixelFormat &dstFormat, const byte *palette = 0) const;
 
 	float getRatio() {
@@ -179,7 +199,7 @@ private:
 	AlphaType _alphaMode;
 
 	template <typename Size>
-	void scaleNN(int *scaleCacheX, TransparentSurface *target) const;
+	void scaleNN(int *scaleCacheX, Graphics::Surface &target) const;
 };
 
 /**
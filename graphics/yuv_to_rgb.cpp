@@ -159,6 +159,7 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
+	_kernel = getDefaultYUVKernel();
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -184,6 +185,7 @@ YUVToRGBManager::~YUVToRGBManager() {
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
+	Common::StackLock lock(_lookupMutex);
 	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
 		return _lookup;
 
@@ -197,16 +199,27 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
 template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const YUVKernel *kernel, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const YUVKernelFormat kernelFormat(lookup->getFormat(), lookup->getScale() == YUVToRGBManager::kScaleITU);
 
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
+		// The kernel converts the row in blocks, the rest is done here
+		int w = 0;
+		if (kernel) {
+			w = kernel->convert444(dstPtr, ySrc, uSrc, vSrc, yWidth, kernelFormat);
+			dstPtr += w * sizeof(PixelInt);
+			ySrc += w;
+			uSrc += w;
+			vSrc += w;
+		}
+
+		for (; w < yWidth; w++) {
 			const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -237,13 +250,13 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _kernel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _kernel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const YUVKernel *kernel, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
@@ -253,9 +266,21 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const YUVKernelFormat kernelFormat(lookup->getFormat(), lookup->getScale() == YUVToRGBManager::kScaleITU);
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		// The kernel converts the rows in blocks, the rest is done here
+		int w = 0;
+		if (kernel) {
+			const int done = kernel->convert420(dstPtr, dstPitch, ySrc, yPitch, uSrc, vSrc, yWidth, kernelFormat);
+			dstPtr += done * sizeof(PixelInt);
+			ySrc += done;
+			uSrc += done >> 1;
+			vSrc += done >> 1;
+			w = done >> 1;
+		}
+
+		for (; w < halfWidth; w++) {
 			const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -293,9 +318,9 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _kernel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _kernel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 #define READ_QUAD(ptr, prefix) \
@@ -366,6 +391,39 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
 
+/**
+ * Interpolates a row of a 410 chroma plane to full width, with the same
+ * results as the bilinear scaling in convertYUV410ToRGB().
+ */
+static void interpolateYUV410Row(byte *dst, const byte *src, int quarterWidth, int uvPitch, int yDiff) {
+	for (int x = 0; x < quarterWidth; x++) {
+		const int left = src[x] * (4 - yDiff) + src[x + uvPitch] * yDiff;
+		const int right = src[x + 1] * (4 - yDiff) + src[x + uvPitch + 1] * yDiff;
+
+		for (int xDiff = 0; xDiff < 4; xDiff++)
+			*dst++ = (left * (4 - xDiff) + right * xDiff) >> 4;
+	}
+}
+
+template<typename PixelInt>
+void convertYUV410ToRGBByRows(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const YUVKernel *kernel, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	// Scale up the chroma of each row and convert it like 444
+	byte *uRow = new byte[yWidth * 2];
+	byte *vRow = uRow + yWidth;
+
+	for (int y = 0; y < yHeight; y++) {
+		const int index = (y >> 2) * uvPitch;
+		interpolateYUV410Row(uRow, uSrc + index, yWidth >> 2, uvPitch, y & 3);
+		interpolateYUV410Row(vRow, vSrc + index, yWidth >> 2, uvPitch, y & 3);
+
+		convertYUV444ToRGB<PixelInt>(dstPtr, dstPitch, lookup, colorTab, kernel, ySrc, uRow, vRow, yWidth, 1, yPitch, yWidth);
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+
+	delete[] uRow;
+}
+
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -376,6 +434,14 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	if (_kernel) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV410ToRGBByRows<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _kernel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV410ToRGBByRows<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _kernel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
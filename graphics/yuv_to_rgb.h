@@ -36,13 +36,20 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/mutex.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
+#include "graphics/yuvkernels.h"
 
 namespace Graphics {
 
 class YUVToRGBLookup;
 
+/**
+ * Converts YUV images to RGB. Conversions to the same pixel format and with
+ * the same luminance scale may run on several threads at once, e.g. for
+ * different bands of a frame.
+ */
 class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
 public:
 	/** The scale of the luminance values */
@@ -102,6 +109,14 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Select the SIMD routines used for the conversion. By default, the
+	 * fastest ones supported by the host are used. A null kernel selects the
+	 * lookup tables, which produce the same output.
+	 */
+	void setKernel(const YUVKernel *kernel) { _kernel = kernel; }
+	const YUVKernel *getKernel() const { return _kernel; }
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -109,7 +124,9 @@ private:
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
+	Common::Mutex _lookupMutex;
 	YUVToRGBLookup *_lookup;
+	const YUVKernel *_kernel;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 };
 
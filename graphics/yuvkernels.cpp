@@ -0,0 +1,585 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuvkernels.h"
+#include "graphics/pixelformat.h"
+#include "common/cpudetect.h"
+
+#if defined(SCUMMVM_AVX2)
+#include <immintrin.h>
+#elif defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Graphics {
+
+// The lookup tables of the YUVToRGBManager hold the chroma terms as
+// floating point products truncated towards zero. The kernels compute them
+// as (c << 2) * k >> 16, with constants which give the same result for
+// every chroma value. As the product of a negative value is rounded down
+// instead, and is never exact, one is added to it. The luminance scaling of
+// the ITU range, (y - 16) * 255 / 219, is done the same way.
+enum {
+	kChromaRV = 22938,	// 0.419 / 0.299
+	kChromaGV = 11684,	// 0.299 / 0.419
+	kChromaGU = 5641,	// 0.114 / 0.331
+	kChromaBU = 29055,	// 0.587 / 0.331
+	kITUScale = 19078	// 255 / 219
+};
+
+YUVKernelFormat::YUVKernelFormat(const PixelFormat &format, bool itu) {
+	bytesPerPixel = format.bytesPerPixel;
+	rLoss = format.rLoss;
+	gLoss = format.gLoss;
+	bLoss = format.bLoss;
+	rShift = format.rShift;
+	gShift = format.gShift;
+	bShift = format.bShift;
+	alpha = (0xFF >> format.aLoss) << format.aShift;
+	ituScale = itu;
+}
+
+// Returns the row function specialized for the format, which spares the
+// checks for the luminance scale and the channel losses in the inner loops
+#define SELECT_YUV_ROW_PROC(proc, format) \
+	((format).bytesPerPixel == 2 ? \
+		((format).ituScale ? proc<2, true, true> : proc<2, false, true>) : \
+		((format).rLoss | (format).gLoss | (format).bLoss) ? \
+			((format).ituScale ? proc<4, true, true> : proc<4, false, true>) : \
+			((format).ituScale ? proc<4, true, false> : proc<4, false, false>))
+
+#ifdef SCUMMVM_SSE2
+
+#pragma mark -
+#pragma mark --- SSE2 ---
+#pragma mark -
+
+/**
+ * The format in registers. The row functions keep it in a local variable,
+ * as the stores through byte pointers would otherwise force the compiler to
+ * reload the format for every block.
+ */
+struct FormatSSE2 {
+	explicit FormatSSE2(const YUVKernelFormat &format) {
+		const uint losses[3] = { format.rLoss, format.gLoss, format.bLoss };
+		const uint shifts[3] = { format.rShift, format.gShift, format.bShift };
+		for (int i = 0; i < 3; ++i) {
+			lossMul[i] = _mm_set1_epi16(1 << (8 - losses[i]));
+			lowMul[i] = _mm_set1_epi16(shifts[i] < 16 ? 1 << shifts[i] : 0);
+			highMulLow[i] = _mm_set1_epi16(shifts[i] < 16 ? 0 : 1 << (shifts[i] - 16));
+			highMulHigh[i] = _mm_set1_epi16(shifts[i] < 16 ? 1 << shifts[i] : 0);
+		}
+		alphaLow = _mm_set1_epi16((int16)format.alpha);
+		alphaHigh = _mm_set1_epi16((int16)(format.alpha >> 16));
+	}
+
+	/**
+	 * The multipliers which shift the channels into place. Shifts by a
+	 * variable count are slow, and the pixels are built from two 16-bit
+	 * halves, as there are no 32-bit multiplications in SSE2.
+	 */
+	__m128i lossMul[3];
+	__m128i lowMul[3];
+	__m128i highMulLow[3], highMulHigh[3];
+	__m128i alphaLow, alphaHigh;
+};
+
+/** The chroma terms of the red, green and blue channel */
+struct ChromaSSE2 {
+	__m128i r, g, b;
+};
+
+static inline ChromaSSE2 chromaSSE2(__m128i u, __m128i v) {
+	u = _mm_sub_epi16(u, _mm_set1_epi16(128));
+	v = _mm_sub_epi16(v, _mm_set1_epi16(128));
+	const __m128i uSign = _mm_srai_epi16(u, 15);
+	const __m128i vSign = _mm_srai_epi16(v, 15);
+	u = _mm_slli_epi16(u, 2);
+	v = _mm_slli_epi16(v, 2);
+
+	ChromaSSE2 chroma;
+	chroma.r = _mm_sub_epi16(_mm_mulhi_epi16(v, _mm_set1_epi16(kChromaRV)), vSign);
+	chroma.g = _mm_sub_epi16(_mm_add_epi16(_mm_mulhi_epi16(v, _mm_set1_epi16(kChromaGV)), _mm_mulhi_epi16(u, _mm_set1_epi16(kChromaGU))), _mm_add_epi16(uSign, vSign));
+	chroma.b = _mm_sub_epi16(_mm_mulhi_epi16(u, _mm_set1_epi16(kChromaBU)), uSign);
+	return chroma;
+}
+
+/** Returns the terms for the first or second half of the samples, each of them used twice */
+static inline ChromaSSE2 duplicateChromaSSE2(const ChromaSSE2 &chroma, bool high) {
+	ChromaSSE2 result;
+	result.r = high ? _mm_unpackhi_epi16(chroma.r, chroma.r) : _mm_unpacklo_epi16(chroma.r, chroma.r);
+	result.g = high ? _mm_unpackhi_epi16(chroma.g, chroma.g) : _mm_unpacklo_epi16(chroma.g, chroma.g);
+	result.b = high ? _mm_unpackhi_epi16(chroma.b, chroma.b) : _mm_unpacklo_epi16(chroma.b, chroma.b);
+	return result;
+}
+
+static inline __m128i clampSSE2(__m128i x, bool ituScale) {
+	if (ituScale) {
+		x = _mm_min_epi16(_mm_max_epi16(x, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+		return _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(x, _mm_set1_epi16(16)), 2), _mm_set1_epi16(kITUScale));
+	}
+
+	return _mm_min_epi16(_mm_max_epi16(x, _mm_setzero_si128()), _mm_set1_epi16(255));
+}
+
+/** Adds a channel to the low and high halves of the pixels */
+template<uint kBytesPerPixel, bool kLoss>
+static inline void packChannelSSE2(__m128i &low, __m128i &high, __m128i channel, const FormatSSE2 &format, int i) {
+	if (kLoss)
+		channel = _mm_mulhi_epu16(_mm_slli_epi16(channel, 8), format.lossMul[i]);
+
+	low = _mm_or_si128(low, _mm_mullo_epi16(channel, format.lowMul[i]));
+	if (kBytesPerPixel == 4) {
+		high = _mm_or_si128(high, _mm_mullo_epi16(channel, format.highMulLow[i]));
+		high = _mm_or_si128(high, _mm_mulhi_epu16(channel, format.highMulHigh[i]));
+	}
+}
+
+/** Converts 8 pixels, with the luminance given as 16-bit values */
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+static inline void convert8SSE2(byte *dst, __m128i y, const ChromaSSE2 &chroma, const FormatSSE2 &format) {
+	__m128i low = format.alphaLow;
+	__m128i high = format.alphaHigh;
+	packChannelSSE2<kBytesPerPixel, kLoss>(low, high, clampSSE2(_mm_add_epi16(y, chroma.r), kITUScale), format, 0);
+	packChannelSSE2<kBytesPerPixel, kLoss>(low, high, clampSSE2(_mm_sub_epi16(y, chroma.g), kITUScale), format, 1);
+	packChannelSSE2<kBytesPerPixel, kLoss>(low, high, clampSSE2(_mm_add_epi16(y, chroma.b), kITUScale), format, 2);
+
+	if (kBytesPerPixel == 2) {
+		_mm_storeu_si128((__m128i *)dst, low);
+	} else {
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(low, high));
+		_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(low, high));
+	}
+}
+
+static inline __m128i load8SSE2(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+static uint convert444SSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &kernelFormat) {
+	const FormatSSE2 format(kernelFormat);
+
+	uint x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const ChromaSSE2 chroma = chromaSSE2(load8SSE2(uSrc + x), load8SSE2(vSrc + x));
+		convert8SSE2<kBytesPerPixel, kITUScale, kLoss>(dst + x * kBytesPerPixel, load8SSE2(ySrc + x), chroma, format);
+	}
+
+	return x;
+}
+
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+static uint convert420SSE2(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &kernelFormat) {
+	const FormatSSE2 format(kernelFormat);
+
+	uint x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const ChromaSSE2 chroma = chromaSSE2(load8SSE2(uSrc + x / 2), load8SSE2(vSrc + x / 2));
+		const ChromaSSE2 low = duplicateChromaSSE2(chroma, false);
+		const ChromaSSE2 high = duplicateChromaSSE2(chroma, true);
+
+		for (int row = 0; row < 2; ++row) {
+			byte *out = dst + row * dstPitch + x * kBytesPerPixel;
+			const byte *in = ySrc + row * yPitch + x;
+			convert8SSE2<kBytesPerPixel, kITUScale, kLoss>(out, load8SSE2(in), low, format);
+			convert8SSE2<kBytesPerPixel, kITUScale, kLoss>(out + 8 * kBytesPerPixel, load8SSE2(in + 8), high, format);
+		}
+	}
+
+	return x;
+}
+
+static uint convert444SSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &format) {
+	return SELECT_YUV_ROW_PROC(convert444SSE2, format)(dst, ySrc, uSrc, vSrc, width, format);
+}
+
+static uint convert420SSE2(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &format) {
+	return SELECT_YUV_ROW_PROC(convert420SSE2, format)(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, format);
+}
+
+static const YUVKernel yuvKernelSSE2 = { "sse2", convert444SSE2, convert420SSE2 };
+
+#endif // SCUMMVM_SSE2
+
+#ifdef SCUMMVM_AVX2
+
+#pragma mark -
+#pragma mark --- AVX2 ---
+#pragma mark -
+
+/** The format in registers, see FormatSSE2 */
+struct FormatAVX2 {
+	__m256i lossMul[3];
+	__m256i lowMul[3];
+	__m256i highMulLow[3], highMulHigh[3];
+	__m256i alphaLow, alphaHigh;
+};
+
+SCUMMVM_TARGET_AVX2
+static inline FormatAVX2 loadFormatAVX2(const YUVKernelFormat &format) {
+	const uint losses[3] = { format.rLoss, format.gLoss, format.bLoss };
+	const uint shifts[3] = { format.rShift, format.gShift, format.bShift };
+
+	FormatAVX2 result;
+	for (int i = 0; i < 3; ++i) {
+		result.lossMul[i] = _mm256_set1_epi16(1 << (8 - losses[i]));
+		result.lowMul[i] = _mm256_set1_epi16(shifts[i] < 16 ? 1 << shifts[i] : 0);
+		result.highMulLow[i] = _mm256_set1_epi16(shifts[i] < 16 ? 0 : 1 << (shifts[i] - 16));
+		result.highMulHigh[i] = _mm256_set1_epi16(shifts[i] < 16 ? 1 << shifts[i] : 0);
+	}
+	result.alphaLow = _mm256_set1_epi16((int16)format.alpha);
+	result.alphaHigh = _mm256_set1_epi16((int16)(format.alpha >> 16));
+	return result;
+}
+
+struct ChromaAVX2 {
+	__m256i r, g, b;
+};
+
+SCUMMVM_TARGET_AVX2
+static inline ChromaAVX2 chromaAVX2(__m256i u, __m256i v) {
+	u = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+	v = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+	const __m256i uSign = _mm256_srai_epi16(u, 15);
+	const __m256i vSign = _mm256_srai_epi16(v, 15);
+	u = _mm256_slli_epi16(u, 2);
+	v = _mm256_slli_epi16(v, 2);
+
+	ChromaAVX2 chroma;
+	chroma.r = _mm256_sub_epi16(_mm256_mulhi_epi16(v, _mm256_set1_epi16(kChromaRV)), vSign);
+	chroma.g = _mm256_sub_epi16(_mm256_add_epi16(_mm256_mulhi_epi16(v, _mm256_set1_epi16(kChromaGV)), _mm256_mulhi_epi16(u, _mm256_set1_epi16(kChromaGU))), _mm256_add_epi16(uSign, vSign));
+	chroma.b = _mm256_sub_epi16(_mm256_mulhi_epi16(u, _mm256_set1_epi16(kChromaBU)), uSign);
+	return chroma;
+}
+
+SCUMMVM_TARGET_AVX2
+static inline __m256i duplicateAVX2(__m256i x, bool high) {
+	// The unpacking works within the 128-bit lanes
+	const __m256i low = _mm256_unpacklo_epi16(x, x);
+	const __m256i hi = _mm256_unpackhi_epi16(x, x);
+	return high ? _mm256_permute2x128_si256(low, hi, 0x31) : _mm256_permute2x128_si256(low, hi, 0x20);
+}
+
+SCUMMVM_TARGET_AVX2
+static inline ChromaAVX2 duplicateChromaAVX2(const ChromaAVX2 &chroma, bool high) {
+	ChromaAVX2 result;
+	result.r = duplicateAVX2(chroma.r, high);
+	result.g = duplicateAVX2(chroma.g, high);
+	result.b = duplicateAVX2(chroma.b, high);
+	return result;
+}
+
+SCUMMVM_TARGET_AVX2
+static inline __m256i clampAVX2(__m256i x, bool ituScale) {
+	if (ituScale) {
+		x = _mm256_min_epi16(_mm256_max_epi16(x, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+		return _mm256_mulhi_epi16(_mm256_slli_epi16(_mm256_sub_epi16(x, _mm256_set1_epi16(16)), 2), _mm256_set1_epi16(kITUScale));
+	}
+
+	return _mm256_min_epi16(_mm256_max_epi16(x, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+}
+
+template<uint kBytesPerPixel, bool kLoss>
+SCUMMVM_TARGET_AVX2
+static inline void packChannelAVX2(__m256i &low, __m256i &high, __m256i channel, const FormatAVX2 &format, int i) {
+	if (kLoss)
+		channel = _mm256_mulhi_epu16(_mm256_slli_epi16(channel, 8), format.lossMul[i]);
+
+	low = _mm256_or_si256(low, _mm256_mullo_epi16(channel, format.lowMul[i]));
+	if (kBytesPerPixel == 4) {
+		high = _mm256_or_si256(high, _mm256_mullo_epi16(channel, format.highMulLow[i]));
+		high = _mm256_or_si256(high, _mm256_mulhi_epu16(channel, format.highMulHigh[i]));
+	}
+}
+
+/** Converts 16 pixels, with the luminance given as 16-bit values */
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+SCUMMVM_TARGET_AVX2
+static inline void convert16AVX2(byte *dst, __m256i y, const ChromaAVX2 &chroma, const FormatAVX2 &format) {
+	__m256i low = format.alphaLow;
+	__m256i high = format.alphaHigh;
+	packChannelAVX2<kBytesPerPixel, kLoss>(low, high, clampAVX2(_mm256_add_epi16(y, chroma.r), kITUScale), format, 0);
+	packChannelAVX2<kBytesPerPixel, kLoss>(low, high, clampAVX2(_mm256_sub_epi16(y, chroma.g), kITUScale), format, 1);
+	packChannelAVX2<kBytesPerPixel, kLoss>(low, high, clampAVX2(_mm256_add_epi16(y, chroma.b), kITUScale), format, 2);
+
+	if (kBytesPerPixel == 2) {
+		_mm256_storeu_si256((__m256i *)dst, low);
+	} else {
+		// The unpacking works within the 128-bit lanes
+		const __m256i first = _mm256_unpacklo_epi16(low, high);
+		const __m256i second = _mm256_unpackhi_epi16(low, high);
+		_mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256((__m256i *)(dst + 32), _mm256_permute2x128_si256(first, second, 0x31));
+	}
+}
+
+SCUMMVM_TARGET_AVX2
+static inline __m256i load16AVX2(const byte *src) {
+	return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)src));
+}
+
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+SCUMMVM_TARGET_AVX2
+static uint convert444AVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &kernelFormat) {
+	const FormatAVX2 format = loadFormatAVX2(kernelFormat);
+
+	uint x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const ChromaAVX2 chroma = chromaAVX2(load16AVX2(uSrc + x), load16AVX2(vSrc + x));
+		convert16AVX2<kBytesPerPixel, kITUScale, kLoss>(dst + x * kBytesPerPixel, load16AVX2(ySrc + x), chroma, format);
+	}
+
+	return x;
+}
+
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+SCUMMVM_TARGET_AVX2
+static uint convert420AVX2(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &kernelFormat) {
+	const FormatAVX2 format = loadFormatAVX2(kernelFormat);
+
+	uint x = 0;
+	for (; x + 32 <= width; x += 32) {
+		const ChromaAVX2 chroma = chromaAVX2(load16AVX2(uSrc + x / 2), load16AVX2(vSrc + x / 2));
+		const ChromaAVX2 low = duplicateChromaAVX2(chroma, false);
+		const ChromaAVX2 high = duplicateChromaAVX2(chroma, true);
+
+		for (int row = 0; row < 2; ++row) {
+			byte *out = dst + row * dstPitch + x * kBytesPerPixel;
+			const byte *in = ySrc + row * yPitch + x;
+			convert16AVX2<kBytesPerPixel, kITUScale, kLoss>(out, load16AVX2(in), low, format);
+			convert16AVX2<kBytesPerPixel, kITUScale, kLoss>(out + 16 * kBytesPerPixel, load16AVX2(in + 16), high, format);
+		}
+	}
+
+	return x;
+}
+
+static uint convert444AVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &format) {
+	return SELECT_YUV_ROW_PROC(convert444AVX2, format)(dst, ySrc, uSrc, vSrc, width, format);
+}
+
+static uint convert420AVX2(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &format) {
+	return SELECT_YUV_ROW_PROC(convert420AVX2, format)(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, format);
+}
+
+static const YUVKernel yuvKernelAVX2 = { "avx2", convert444AVX2, convert420AVX2 };
+
+#endif // SCUMMVM_AVX2
+
+#ifdef SCUMMVM_NEON
+
+#pragma mark -
+#pragma mark --- NEON ---
+#pragma mark -
+
+/** The format in registers, see FormatSSE2. Shifts to the right are negative. */
+struct FormatNEON {
+	explicit FormatNEON(const YUVKernelFormat &format) {
+		rLoss16 = vdupq_n_s16(-(int)format.rLoss);
+		gLoss16 = vdupq_n_s16(-(int)format.gLoss);
+		bLoss16 = vdupq_n_s16(-(int)format.bLoss);
+		rShift16 = vdupq_n_s16(format.rShift);
+		gShift16 = vdupq_n_s16(format.gShift);
+		bShift16 = vdupq_n_s16(format.bShift);
+		rLoss32 = vdupq_n_s32(-(int)format.rLoss);
+		gLoss32 = vdupq_n_s32(-(int)format.gLoss);
+		bLoss32 = vdupq_n_s32(-(int)format.bLoss);
+		rShift32 = vdupq_n_s32(format.rShift);
+		gShift32 = vdupq_n_s32(format.gShift);
+		bShift32 = vdupq_n_s32(format.bShift);
+		alpha16 = vdupq_n_u16(format.alpha);
+		alpha32 = vdupq_n_u32(format.alpha);
+	}
+
+	int16x8_t rLoss16, gLoss16, bLoss16;
+	int16x8_t rShift16, gShift16, bShift16;
+	int32x4_t rLoss32, gLoss32, bLoss32;
+	int32x4_t rShift32, gShift32, bShift32;
+	uint16x8_t alpha16;
+	uint32x4_t alpha32;
+};
+
+struct ChromaNEON {
+	int16x8_t r, g, b;
+};
+
+static inline ChromaNEON chromaNEON(int16x8_t u, int16x8_t v) {
+	u = vsubq_s16(u, vdupq_n_s16(128));
+	v = vsubq_s16(v, vdupq_n_s16(128));
+	const int16x8_t uSign = vshrq_n_s16(u, 15);
+	const int16x8_t vSign = vshrq_n_s16(v, 15);
+	// vqdmulh doubles the product, so the values are only shifted by one
+	u = vshlq_n_s16(u, 1);
+	v = vshlq_n_s16(v, 1);
+
+	ChromaNEON chroma;
+	chroma.r = vsubq_s16(vqdmulhq_s16(v, vdupq_n_s16(kChromaRV)), vSign);
+	chroma.g = vsubq_s16(vaddq_s16(vqdmulhq_s16(v, vdupq_n_s16(kChromaGV)), vqdmulhq_s16(u, vdupq_n_s16(kChromaGU))), vaddq_s16(uSign, vSign));
+	chroma.b = vsubq_s16(vqdmulhq_s16(u, vdupq_n_s16(kChromaBU)), uSign);
+	return chroma;
+}
+
+static inline ChromaNEON duplicateChromaNEON(const ChromaNEON &chroma, int half) {
+	ChromaNEON result;
+	result.r = vzipq_s16(chroma.r, chroma.r).val[half];
+	result.g = vzipq_s16(chroma.g, chroma.g).val[half];
+	result.b = vzipq_s16(chroma.b, chroma.b).val[half];
+	return result;
+}
+
+static inline uint16x8_t clampNEON(int16x8_t x, bool ituScale) {
+	if (ituScale) {
+		x = vminq_s16(vmaxq_s16(x, vdupq_n_s16(16)), vdupq_n_s16(235));
+		x = vqdmulhq_s16(vshlq_n_s16(vsubq_s16(x, vdupq_n_s16(16)), 1), vdupq_n_s16(kITUScale));
+	} else {
+		x = vminq_s16(vmaxq_s16(x, vdupq_n_s16(0)), vdupq_n_s16(255));
+	}
+
+	return vreinterpretq_u16_s16(x);
+}
+
+static inline uint16x8_t packChannel16NEON(uint16x8_t x, int16x8_t loss, int16x8_t shift, bool applyLoss) {
+	return vshlq_u16(applyLoss ? vshlq_u16(x, loss) : x, shift);
+}
+
+static inline uint32x4_t packChannel32NEON(uint16x4_t x, int32x4_t loss, int32x4_t shift, bool applyLoss) {
+	const uint32x4_t wide = vmovl_u16(x);
+	return vshlq_u32(applyLoss ? vshlq_u32(wide, loss) : wide, shift);
+}
+
+/** Converts 8 pixels, with the luminance given as 16-bit values */
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+static inline void convert8NEON(byte *dst, int16x8_t y, const ChromaNEON &chroma, const FormatNEON &format) {
+	const uint16x8_t r = clampNEON(vaddq_s16(y, chroma.r), kITUScale);
+	const uint16x8_t g = clampNEON(vsubq_s16(y, chroma.g), kITUScale);
+	const uint16x8_t b = clampNEON(vaddq_s16(y, chroma.b), kITUScale);
+
+	if (kBytesPerPixel == 2) {
+		uint16x8_t pixels = format.alpha16;
+		pixels = vorrq_u16(pixels, packChannel16NEON(r, format.rLoss16, format.rShift16, kLoss));
+		pixels = vorrq_u16(pixels, packChannel16NEON(g, format.gLoss16, format.gShift16, kLoss));
+		pixels = vorrq_u16(pixels, packChannel16NEON(b, format.bLoss16, format.bShift16, kLoss));
+		vst1q_u16((uint16_t *)dst, pixels);
+	} else {
+		uint32x4_t pixels = vorrq_u32(format.alpha32, packChannel32NEON(vget_low_u16(r), format.rLoss32, format.rShift32, kLoss));
+		pixels = vorrq_u32(pixels, packChannel32NEON(vget_low_u16(g), format.gLoss32, format.gShift32, kLoss));
+		pixels = vorrq_u32(pixels, packChannel32NEON(vget_low_u16(b), format.bLoss32, format.bShift32, kLoss));
+		vst1q_u32((uint32_t *)dst, pixels);
+
+		pixels = vorrq_u32(format.alpha32, packChannel32NEON(vget_high_u16(r), format.rLoss32, format.rShift32, kLoss));
+		pixels = vorrq_u32(pixels, packChannel32NEON(vget_high_u16(g), format.gLoss32, format.gShift32, kLoss));
+		pixels = vorrq_u32(pixels, packChannel32NEON(vget_high_u16(b), format.bLoss32, format.bShift32, kLoss));
+		vst1q_u32((uint32_t *)(dst + 16), pixels);
+	}
+}
+
+static inline int16x8_t load8NEON(const byte *src) {
+	return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+}
+
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+static uint convert444NEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &kernelFormat) {
+	const FormatNEON format(kernelFormat);
+
+	uint x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const ChromaNEON chroma = chromaNEON(load8NEON(uSrc + x), load8NEON(vSrc + x));
+		convert8NEON<kBytesPerPixel, kITUScale, kLoss>(dst + x * kBytesPerPixel, load8NEON(ySrc + x), chroma, format);
+	}
+
+	return x;
+}
+
+template<uint kBytesPerPixel, bool kITUScale, bool kLoss>
+static uint convert420NEON(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &kernelFormat) {
+	const FormatNEON format(kernelFormat);
+
+	uint x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const ChromaNEON chroma = chromaNEON(load8NEON(uSrc + x / 2), load8NEON(vSrc + x / 2));
+		const ChromaNEON low = duplicateChromaNEON(chroma, 0);
+		const ChromaNEON high = duplicateChromaNEON(chroma, 1);
+
+		for (int row = 0; row < 2; ++row) {
+			byte *out = dst + row * dstPitch + x * kBytesPerPixel;
+			const byte *in = ySrc + row * yPitch + x;
+			convert8NEON<kBytesPerPixel, kITUScale, kLoss>(out, load8NEON(in), low, format);
+			convert8NEON<kBytesPerPixel, kITUScale, kLoss>(out + 8 * kBytesPerPixel, load8NEON(in + 8), high, format);
+		}
+	}
+
+	return x;
+}
+
+static uint convert444NEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &format) {
+	return SELECT_YUV_ROW_PROC(convert444NEON, format)(dst, ySrc, uSrc, vSrc, width, format);
+}
+
+static uint convert420NEON(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &format) {
+	return SELECT_YUV_ROW_PROC(convert420NEON, format)(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, format);
+}
+
+static const YUVKernel yuvKernelNEON = { "neon", convert444NEON, convert420NEON };
+
+#endif // SCUMMVM_NEON
+
+#pragma mark -
+
+const YUVKernel *getYUVKernel(YUVKernelType type) {
+	switch (type) {
+#ifdef SCUMMVM_SSE2
+	case kYUVKernelSSE2:
+		return Common::hasCPUFeature(Common::kCPUFeatureSSE2) ? &yuvKernelSSE2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_AVX2
+	case kYUVKernelAVX2:
+		return Common::hasCPUFeature(Common::kCPUFeatureAVX2) ? &yuvKernelAVX2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_NEON
+	case kYUVKernelNEON:
+		return Common::hasCPUFeature(Common::kCPUFeatureNEON) ? &yuvKernelNEON : nullptr;
+#endif
+
+	default:
+		return nullptr;
+	}
+}
+
+const YUVKernel *getDefaultYUVKernel() {
+	const YUVKernel *kernel = nullptr;
+	for (int i = 0; i < kYUVKernelCount; ++i) {
+		const YUVKernel *candidate = getYUVKernel((YUVKernelType)i);
+		if (candidate)
+			kernel = candidate;
+	}
+
+	return kernel;
+}
+
+} // End of namespace Graphics
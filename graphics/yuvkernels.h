@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_YUVKERNELS_H
+#define GRAPHICS_YUVKERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+struct PixelFormat;
+
+/**
+ * The destination format of a conversion, prepared for the kernels.
+ */
+struct YUVKernelFormat {
+	YUVKernelFormat(const PixelFormat &format, bool ituScale);
+
+	uint bytesPerPixel;		///< 2 or 4
+	uint rLoss, gLoss, bLoss;
+	uint rShift, gShift, bShift;
+	uint32 alpha;			///< Bits set in every pixel
+	bool ituScale;			///< Luminance values range from [16, 235]
+};
+
+/**
+ * Converts the pixels of a YUV444 row from the beginning on, for as long as
+ * the kernel can process them in whole blocks.
+ *
+ * @param dst		destination row
+ * @param ySrc		luminance of the row
+ * @param uSrc		chroma of the row, one sample per pixel
+ * @param vSrc		see uSrc
+ * @param width		width of the row
+ * @return the number of pixels converted; the caller converts the rest
+ */
+typedef uint (*YUV444RowProc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &format);
+
+/**
+ * Same as YUV444RowProc, but for the two rows of a YUV420 image which share
+ * one row of chroma samples, each of them covering two pixels. The number
+ * of converted pixels is even.
+ */
+typedef uint (*YUV420RowProc)(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, uint width, const YUVKernelFormat &format);
+
+/**
+ * A set of YUV to RGB conversion routines for one instruction set. All
+ * kernels produce exactly the same output as the lookup tables of the
+ * YUVToRGBManager.
+ */
+struct YUVKernel {
+	const char *name;
+	YUV444RowProc convert444;
+	YUV420RowProc convert420;
+};
+
+enum YUVKernelType {
+	kYUVKernelSSE2 = 0,
+	kYUVKernelAVX2,
+	kYUVKernelNEON,
+
+	kYUVKernelCount
+};
+
+/**
+ * Returns the kernel of the given type, or nullptr if it is not available
+ * in this build or not supported by the host CPU.
+ */
+const YUVKernel *getYUVKernel(YUVKernelType type);
+
+/**
+ * Returns the fastest kernel available on the host, or nullptr if the
+ * lookup tables are the fastest option.
+ */
+const YUVKernel *getDefaultYUVKernel();
+
+} // End of namespace Graphics
+
+#endif
@@ -20,6 +20,8 @@
  *
  */
 
+#include "engines/detectioncache.h"
+#include "engines/detectionscanner.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
@@ -57,6 +59,8 @@ enum {
 
 MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	: Dialog("MassAdd"),
+	_scanner(nullptr),
+	_scanFinished(false),
 	_dirsScanned(0),
 	_oldGamesCount(0),
 	_dirTotal(0),
@@ -66,8 +70,9 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 
 	StringArray l;
 
-	// The dir we start our scan at
-	_scanStack.push(startDir);
+	// The dir we start our scan at. The directories are listed, and the
+	// files the detectors need are checksummed, on background threads.
+	_scanner = new DetectionScanner(startDir, true);
 
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
@@ -116,6 +121,10 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	}
 }
 
+MassAddDialog::~MassAddDialog() {
+	delete _scanner;
+}
+
 struct GameTargetLess {
 	bool operator()(const DetectedGame &x, const DetectedGame &y) const {
 		return x.preferredTarget.compareToIgnoreCase(y.preferredTarget) < 0;
@@ -169,19 +178,24 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 }
 
 void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
+	if (_scanFinished)
 		return;	// We have finished scanning
 
 	uint32 t = g_system->getMillis();
 
-	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
-
+	// Perform a depth-first scan of the filesystem.
+	while ((g_system->getMillis() - t) < kMaxScanTime) {
+		Common::FSNode dir;
 		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
+		DetectionScanner::Result scanResult = _scanner->next(dir, files, false);
+		if (scanResult == DetectionScanner::kPending)
+			break;
+		if (scanResult == DetectionScanner::kFinished) {
+			_scanFinished = true;
+			break;
 		}
+		if (scanResult == DetectionScanner::kUnreadable)
+			continue;
 
 		// Run the detector on the dir
 		DetectionResults detectionResults = EngineMan.detectGames(files);
@@ -238,13 +252,10 @@ void MassAddDialog::handleTickle() {
 		}
 
 
-		// Recurse into all subdirs
+		// The scanner recurses into all subdirs
 		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
-
+			if (file->isDirectory())
 				_dirTotal++;
-			}
 		}
 
 		_dirsScanned++;
@@ -259,7 +270,11 @@ void MassAddDialog::handleTickle() {
 	// Update the dialog
 	Common::String buf;
 
-	if (_scanStack.empty()) {
+	if (_scanFinished) {
+		delete _scanner;
+		_scanner = nullptr;
+		DetCache.flush();
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
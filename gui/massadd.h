@@ -27,9 +27,10 @@
 #include "gui/widgets/list.h"
 #include "common/fs.h"
 #include "common/hashmap.h"
-#include "common/stack.h"
 #include "common/str.h"
 
+class DetectionScanner;
+
 namespace GUI {
 
 class StaticTextWidget;
@@ -38,6 +39,7 @@ class MassAddDialog : public Dialog {
 	typedef Common::Array<Common::String> StringArray;
 public:
 	MassAddDialog(const Common::FSNode &startDir);
+	~MassAddDialog() override;
 
 	//void open();
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
@@ -50,7 +52,8 @@ public:
 	}
 
 private:
-	Common::Stack<Common::FSNode>  _scanStack;
+	DetectionScanner *_scanner;
+	bool _scanFinished;
 	DetectedGames _games;
 
 	/**
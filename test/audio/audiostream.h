@@ -1,8 +1,11 @@
 #include <cxxtest/TestSuite.h>
 
 #include "audio/audiostream.h"
+#include "common/jobsystem.h"
+#include "common/system.h"
 
 #include "helper.h"
+#include "test/system/test_system.h"
 
 class AudioStreamTestSuite : public CxxTest::TestSuite
 {
@@ -205,4 +208,94 @@ public:
 	void test_sub_looping_audio_stream_stereo_22050_end_fixed_iter() {
 		testSubLoopingAudioStreamFixedIter(22050, true, 2, 2);
 	}
+
+private:
+	void testPrefetchingAudioStream(const int sampleRate, const bool isStereo) {
+		Test::installTestSystem();
+
+		const int length = sampleRate * 2 * (isStereo ? 2 : 1);
+
+		// Whatever the number of cores, decode ahead on worker threads
+		Common::JobSystem jobs(2);
+
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 2, &sine, false, isStereo);
+		Audio::SeekablePrefetchingAudioStream *prefetch = Audio::makePrefetchingAudioStream(s, 100, DisposeAfterUse::YES, &jobs);
+		TS_ASSERT(prefetch->getBufferSize() > 0);
+
+		TS_ASSERT_EQUALS(prefetch->isStereo(), isStereo);
+		TS_ASSERT_EQUALS(prefetch->getRate(), sampleRate);
+		TS_ASSERT_EQUALS(prefetch->getLength().totalNumberOfFrames(), sampleRate * 2);
+		TS_ASSERT(prefetch->getBufferedSamples() <= prefetch->getBufferSize());
+
+		// Read the whole stream in blocks of varying size
+		int16 *buffer = new int16[length];
+		int pos = 0;
+		for (int step = 1; pos < length; step++) {
+			const int samples = MIN(length - pos, (step * 397) % 3000 * (isStereo ? 2 : 1));
+			TS_ASSERT_EQUALS(prefetch->readBuffer(buffer + pos, samples), samples);
+			TS_ASSERT_EQUALS(prefetch->endOfData(), pos + samples == length);
+			pos += samples;
+		}
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, length * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(prefetch->readBuffer(buffer, length), 0);
+		TS_ASSERT_EQUALS(prefetch->endOfStream(), true);
+
+		// Seeking drops the data decoded ahead
+		const int half = length / 2;
+		TS_ASSERT(prefetch->seek(Audio::Timestamp(1000, 1000)));
+		TS_ASSERT_EQUALS(prefetch->endOfData(), false);
+		TS_ASSERT_EQUALS(prefetch->readBuffer(buffer, half), half);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + half, half * sizeof(int16)), 0);
+
+		// Loop it twice
+		prefetch->rewind();
+		Audio::AudioStream *loop = Audio::makeLoopingAudioStream(prefetch, 2);
+		TS_ASSERT_EQUALS(loop->readBuffer(buffer, length), length);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, length * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(loop->readBuffer(buffer, length), length);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, length * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(loop->endOfData(), true);
+
+		delete loop;
+		delete[] buffer;
+		delete[] sine;
+	}
+
+public:
+	void test_prefetching_audio_stream_mono_11025() {
+		testPrefetchingAudioStream(11025, false);
+	}
+
+	void test_prefetching_audio_stream_stereo_22050() {
+		testPrefetchingAudioStream(22050, true);
+	}
+
+	void test_prefetching_audio_stream_plain() {
+		Test::installTestSystem();
+
+		const int length = 44100;
+		int16 *sine = 0;
+		Common::JobSystem jobs(2);
+		Audio::AudioStream *s = createSineStream<int16>(44100, 1, &sine, false, false);
+		Audio::PrefetchingAudioStream *prefetch = Audio::makePrefetchingAudioStream(s, 50, DisposeAfterUse::YES, &jobs);
+
+		// Give the job a chance to decode ahead
+		for (int i = 0; i < 100 && prefetch->getBufferedSamples() < prefetch->getBufferSize() / 2; i++)
+			g_system->delayMillis(1);
+		TS_ASSERT(prefetch->getBufferedSamples() <= prefetch->getBufferSize());
+
+		int16 *buffer = new int16[length];
+		for (int pos = 0; pos < length; pos += 1000) {
+			const int samples = MIN(length - pos, 1000);
+			TS_ASSERT_EQUALS(prefetch->readBuffer(buffer + pos, samples), samples);
+		}
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, length * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(prefetch->endOfData(), true);
+		TS_ASSERT_EQUALS(prefetch->getBufferedSamples(), 0U);
+
+		delete prefetch;
+		delete[] buffer;
+		delete[] sine;
+	}
 };
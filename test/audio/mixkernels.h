@@ -0,0 +1,124 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixkernels.h"
+#include "audio/mixer.h"
+
+class MixKernelsTestSuite : public CxxTest::TestSuite {
+	enum {
+		kBufferFrames = 4096
+	};
+
+	uint32 _seed;
+
+	int16 nextSample() {
+		_seed = _seed * 1103515245 + 12345;
+		// Make sure the extremes are well represented
+		switch ((_seed >> 8) & 15) {
+		case 0:
+			return -32768;
+		case 1:
+			return 32767;
+		default:
+			return (int16)(_seed >> 16);
+		}
+	}
+
+	void fill(int16 *buf, int count) {
+		for (int i = 0; i < count; ++i)
+			buf[i] = nextSample();
+	}
+
+public:
+	void test_kernels_match_scalar() {
+		static const Audio::st_volume_t volumes[] = { 0, 1, 127, 255, Audio::Mixer::kMaxMixerVolume };
+		const Audio::MixKernel *scalar = Audio::getMixKernel(Audio::kMixKernelScalar);
+		TS_ASSERT(scalar);
+
+		int16 input[2 * 64];
+		int16 output[2 * 64];
+		int16 expected[2 * 64];
+		_seed = 1;
+
+		for (int type = Audio::kMixKernelScalar + 1; type < Audio::kMixKernelCount; ++type) {
+			const Audio::MixKernel *kernel = Audio::getMixKernel((Audio::MixKernelType)type);
+			if (!kernel)
+				continue;
+
+			for (int v = 0; v < ARRAYSIZE(volumes) * ARRAYSIZE(volumes); ++v) {
+				const Audio::st_volume_t volL = volumes[v % ARRAYSIZE(volumes)];
+				const Audio::st_volume_t volR = volumes[v / ARRAYSIZE(volumes)];
+
+				for (int frames = 0; frames <= 64; frames += 7) {
+					fill(input, ARRAYSIZE(input));
+					fill(output, ARRAYSIZE(output));
+					memcpy(expected, output, sizeof(output));
+					scalar->mixStereo(expected, input, frames, volL, volR);
+					kernel->mixStereo(output, input, frames, volL, volR);
+					TS_ASSERT_SAME_DATA(output, expected, sizeof(output));
+
+					fill(output, ARRAYSIZE(output));
+					memcpy(expected, output, sizeof(output));
+					scalar->mixMono(expected, input, frames, volL, volR);
+					kernel->mixMono(output, input, frames, volL, volR);
+					TS_ASSERT_SAME_DATA(output, expected, sizeof(output));
+				}
+			}
+		}
+	}
+
+	void test_fir_matches_scalar() {
+		const Audio::MixKernel *scalar = Audio::getMixKernel(Audio::kMixKernelScalar);
+		int16 coeffs[128];
+		int16 samples[128];
+		_seed = 3;
+
+		for (int type = Audio::kMixKernelScalar + 1; type < Audio::kMixKernelCount; ++type) {
+			const Audio::MixKernel *kernel = Audio::getMixKernel((Audio::MixKernelType)type);
+			if (!kernel)
+				continue;
+
+			for (uint taps = 8; taps <= 128; taps += 8) {
+				fill(samples, taps);
+				// Q14 coefficients as used by the resampler
+				for (uint i = 0; i < taps; ++i)
+					coeffs[i] = nextSample() >> 4;
+				TS_ASSERT_EQUALS(kernel->fir(coeffs, samples, taps), scalar->fir(coeffs, samples, taps));
+			}
+		}
+	}
+
+	void test_default_kernel() {
+		const Audio::MixKernel &kernel = Audio::getDefaultMixKernel();
+		TS_ASSERT(kernel.mixStereo);
+		TS_ASSERT(kernel.mixMono);
+		TS_ASSERT(kernel.fir);
+	}
+
+	void test_benchmark() {
+		const int iterations = 200;
+		int16 *input = new int16[2 * kBufferFrames];
+		int16 *output = new int16[2 * kBufferFrames];
+		_seed = 2;
+		fill(input, 2 * kBufferFrames);
+
+		for (int type = Audio::kMixKernelScalar; type < Audio::kMixKernelCount; ++type) {
+			const Audio::MixKernel *kernel = Audio::getMixKernel((Audio::MixKernelType)type);
+			if (!kernel)
+				continue;
+
+			memset(output, 0, 2 * kBufferFrames * sizeof(int16));
+			double start = Benchmark::seconds();
+			for (int i = 0; i < iterations; ++i)
+				kernel->mixStereo(output, input, kBufferFrames, 200, 100);
+			Benchmark::report("mixStereo", kernel->name, 2.0 * kBufferFrames * iterations, "samples", Benchmark::seconds() - start);
+
+			start = Benchmark::seconds();
+			for (int i = 0; i < iterations; ++i)
+				kernel->mixMono(output, input, kBufferFrames, 200, 100);
+			Benchmark::report("mixMono", kernel->name, 2.0 * kBufferFrames * iterations, "samples", Benchmark::seconds() - start);
+		}
+
+		delete[] input;
+		delete[] output;
+	}
+};
@@ -0,0 +1,208 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/fmopl.h"
+#include "common/atomic.h"
+#include "common/system.h"
+
+#include "test/system/test_system.h"
+
+/**
+ * Plays a simple arpeggio on the first three channels, changing registers
+ * on every timer callback like a music driver does.
+ */
+class TestOPLPlayer {
+	OPL::OPL *_opl;
+	OPL::Config::OplType _type;
+	uint _tick;
+
+public:
+	TestOPLPlayer(OPL::OPL *opl, OPL::Config::OplType type) : _opl(opl), _type(type), _tick(0) {}
+
+	void onTimer() {
+		if (_tick == 0) {
+			if (_type == OPL::Config::kOpl3)
+				_opl->writeReg(0x105, 0x01);
+			_opl->writeReg(0x01, 0x20);
+			for (int i = 0; i < 3; ++i) {
+				_opl->writeReg(0x20 + i, 0x01);
+				_opl->writeReg(0x23 + i, 0x01);
+				_opl->writeReg(0x40 + i, 0x10);
+				_opl->writeReg(0x43 + i, 0x00);
+				_opl->writeReg(0x60 + i, 0xF2);
+				_opl->writeReg(0x63 + i, 0xF4);
+				_opl->writeReg(0x80 + i, 0x45);
+				_opl->writeReg(0x83 + i, 0x56);
+				_opl->writeReg(0xC0 + i, 0x3E);
+			}
+		}
+
+		// Status reads have to see the chip at the current position
+		_opl->read(0x388);
+
+		const int channel = _tick % 3;
+		const int fnum = 0x200 + (_tick * 37) % 0x100;
+		if (_tick % 5 == 0) {
+			_opl->writeReg(0xB0 + channel, 0x00);
+			_opl->writeReg(0xA0 + channel, fnum & 0xFF);
+			_opl->writeReg(0xB0 + channel, 0x20 | ((_tick % 4) << 2) | (fnum >> 8));
+		}
+
+		++_tick;
+	}
+};
+
+/** The emulators, which render their samples in readBuffer() */
+static const char *const testOPLEmulators[] = { "mame", "db", "nuked", 0 };
+
+class OPLTestSuite : public CxxTest::TestSuite {
+	/**
+	 * Render numSamples samples from the given emulator, calling readBuffer
+	 * with at most chunk samples at a time.
+	 */
+	void render(OPL::Config::DriverId driver, OPL::Config::OplType type, int16 *buffer, int numSamples, int chunk) {
+		OPL::OPL *opl = OPL::Config::create(driver, type);
+		TS_ASSERT(opl != 0);
+		if (!opl)
+			return;
+		TS_ASSERT(opl->init());
+
+		TestOPLPlayer player(opl, type);
+		opl->start(new Common::Functor0Mem<void, TestOPLPlayer>(&player, &TestOPLPlayer::onTimer));
+
+		OPL::EmulatedOPL *emulator = static_cast<OPL::EmulatedOPL *>(opl);
+		for (int pos = 0; pos < numSamples; pos += chunk)
+			emulator->readBuffer(buffer + pos, MIN(chunk, numSamples - pos));
+
+		opl->stop();
+		delete opl;
+	}
+
+	void checkBatching(OPL::Config::DriverId driver, OPL::Config::OplType type) {
+		// Two stereo seconds, which works for mono emulators as well
+		const int numSamples = 2 * 2 * 44100;
+		int16 *reference = new int16[numSamples];
+		int16 *batched = new int16[numSamples];
+
+		// Rendering two samples at a time generates the samples in between
+		// two timer callbacks right after each other, like rendering
+		// without any batching does.
+		render(driver, type, reference, numSamples, 2);
+		render(driver, type, batched, numSamples, numSamples);
+
+		bool silent = true;
+		for (int i = 0; i < numSamples; ++i)
+			silent = silent && !reference[i];
+		TS_ASSERT(!silent);
+		TS_ASSERT_SAME_DATA(reference, batched, numSamples * sizeof(int16));
+
+		// Chunk sizes not matching the callback rate
+		render(driver, type, batched, numSamples, 2 * 1000 + 2);
+		TS_ASSERT_SAME_DATA(reference, batched, numSamples * sizeof(int16));
+
+		delete[] reference;
+		delete[] batched;
+	}
+
+	struct WriterThread {
+		OPL::OPL *opl;
+		volatile int32 quit;
+		volatile int32 writes;
+	};
+
+	static void writerProc(void *param) {
+		WriterThread *writer = (WriterThread *)param;
+		while (!Common::atomicLoad(&writer->quit)) {
+			writer->opl->writeReg(0x40 + writer->writes % 3, writer->writes & 0x3F);
+			writer->opl->write(0x388, 0xBD);
+			writer->writes++;
+		}
+	}
+
+public:
+	void test_batched_rendering() {
+		Test::installTestSystem();
+
+		for (const char *const *name = testOPLEmulators; *name; ++name) {
+			const OPL::Config::DriverId driver = OPL::Config::parse(*name);
+			const OPL::Config::EmulatorDescription *desc = OPL::Config::findDriver(driver);
+			if (!desc)
+				continue;
+
+			checkBatching(driver, OPL::Config::kOpl2);
+			if (desc->flags & OPL::Config::kFlagOpl3)
+				checkBatching(driver, OPL::Config::kOpl3);
+		}
+	}
+
+	void test_engine_writes_while_rendering() {
+		Test::installTestSystem();
+
+		// Writes made on the engine thread while the audio thread runs the
+		// callbacks have to be safe, the output does not matter
+		OPL::OPL *opl = OPL::Config::create(OPL::Config::parse("db"), OPL::Config::kOpl2);
+		if (!opl || !opl->init()) {
+			delete opl;
+			return;
+		}
+
+		TestOPLPlayer player(opl, OPL::Config::kOpl2);
+		opl->start(new Common::Functor0Mem<void, TestOPLPlayer>(&player, &TestOPLPlayer::onTimer), 1000);
+
+		WriterThread writer = { opl, 0, 0 };
+		OSystem::ThreadRef thread = g_system->createThread(writerProc, &writer, "opl writer");
+		TS_ASSERT(thread);
+		if (!thread) {
+			opl->stop();
+			delete opl;
+			return;
+		}
+
+		const int chunk = 2 * 1024;
+		int16 *buffer = new int16[chunk];
+		OPL::EmulatedOPL *emulator = static_cast<OPL::EmulatedOPL *>(opl);
+		for (int i = 0; i < 200 || Common::atomicLoad(&writer.writes) < 1000; ++i)
+			emulator->readBuffer(buffer, chunk);
+
+		Common::atomicStore(&writer.quit, 1);
+		g_system->joinThread(thread);
+
+		opl->stop();
+		delete opl;
+		delete[] buffer;
+	}
+
+	void test_benchmark() {
+		Test::installTestSystem();
+
+		const int seconds = 10;
+		const int chunk = 2 * 1024;
+		int16 *buffer = new int16[chunk];
+
+		for (const char *const *name = testOPLEmulators; *name; ++name) {
+			const OPL::Config::DriverId driver = OPL::Config::parse(*name);
+			if (!OPL::Config::findDriver(driver))
+				continue;
+
+			OPL::OPL *opl = OPL::Config::create(driver, OPL::Config::kOpl2);
+			if (!opl || !opl->init()) {
+				delete opl;
+				continue;
+			}
+
+			TestOPLPlayer player(opl, OPL::Config::kOpl2);
+			opl->start(new Common::Functor0Mem<void, TestOPLPlayer>(&player, &TestOPLPlayer::onTimer));
+
+			OPL::EmulatedOPL *emulator = static_cast<OPL::EmulatedOPL *>(opl);
+			const int iterations = seconds * 44100 / chunk;
+			const double start = Benchmark::seconds();
+			for (int i = 0; i < iterations; ++i)
+				emulator->readBuffer(buffer, chunk);
+			Benchmark::report("opl2 render with 250Hz callbacks", *name, (double)iterations * chunk, "samples", Benchmark::seconds() - start);
+
+			opl->stop();
+			delete opl;
+		}
+
+		delete[] buffer;
+	}
+};
@@ -0,0 +1,147 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "test/system/test_system.h"
+
+/**
+ * Endless stream producing a square wave, or a constant value when the
+ * period is 0.
+ */
+class TestToneStream : public Audio::AudioStream {
+	const int _rate;
+	const bool _stereo;
+	const int16 _amplitude;
+	const int _period;
+	int _pos;
+
+public:
+	TestToneStream(int rate, bool stereo, int16 amplitude, int period)
+		: _rate(rate), _stereo(stereo), _amplitude(amplitude), _period(period), _pos(0) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		for (int i = 0; i < numSamples; ++i) {
+			const int frame = _pos / (_stereo ? 2 : 1);
+			buffer[i] = (_period && (frame % _period) >= _period / 2) ? -_amplitude : _amplitude;
+			_pos++;
+		}
+		return numSamples;
+	}
+
+	bool isStereo() const { return _stereo; }
+	int getRate() const { return _rate; }
+	bool endOfData() const { return false; }
+};
+
+class RateConverterTestSuite : public CxxTest::TestSuite {
+	void checkConstantLevel(int inRate, int outRate, bool stereo, Audio::ResamplerType resampler) {
+		TestToneStream stream(inRate, stereo, 10000, 0);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, false, resampler);
+
+		int16 buffer[2 * 1024];
+		memset(buffer, 0, sizeof(buffer));
+		TS_ASSERT_EQUALS(converter->flow(stream, buffer, 1024, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1024);
+
+		// Skip the initial filter response, after which DC must pass unchanged
+		for (int i = 2 * 128; i < 2 * 1024; ++i)
+			TS_ASSERT_EQUALS(buffer[i], 10000);
+
+		delete converter;
+	}
+
+	void runBenchmark(const char *name, Audio::ResamplerType resampler) {
+		const int frames = 4096;
+		const int iterations = 50;
+		TestToneStream stream(22050, true, 8000, 50);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 44100, true, false, resampler);
+		int16 *buffer = new int16[2 * frames];
+
+		const double start = Benchmark::seconds();
+		for (int i = 0; i < iterations; ++i) {
+			memset(buffer, 0, 2 * frames * sizeof(int16));
+			converter->flow(stream, buffer, frames, 200, 200);
+		}
+		Benchmark::report("resample 22050->44100 stereo", name, (double)frames * iterations, "frames", Benchmark::seconds() - start);
+
+		delete[] buffer;
+		delete converter;
+	}
+
+public:
+	void setUp() {
+		// The sinc filter banks are guarded by a mutex
+		Test::installTestSystem();
+	}
+
+	void test_linear_constant_level() {
+		checkConstantLevel(22050, 44100, false, Audio::kResamplerLinear);
+		checkConstantLevel(11025, 48000, true, Audio::kResamplerLinear);
+	}
+
+	void test_sinc_constant_level() {
+		checkConstantLevel(22050, 44100, false, Audio::kResamplerSinc);
+		checkConstantLevel(11025, 48000, true, Audio::kResamplerSinc);
+		checkConstantLevel(22254, 44100, true, Audio::kResamplerSinc);
+		checkConstantLevel(48000, 22050, false, Audio::kResamplerSinc);
+	}
+
+	void test_sinc_upsampling_keeps_input_samples() {
+		// With an integer ratio, every other output frame lies exactly on an
+		// input sample. A slow square wave passes through almost unchanged.
+		TestToneStream stream(22050, false, 8000, 400);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 44100, false, false, Audio::kResamplerSinc);
+
+		int16 buffer[2 * 1024];
+		memset(buffer, 0, sizeof(buffer));
+		TS_ASSERT_EQUALS(converter->flow(stream, buffer, 1024, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1024);
+
+		// Middle of the first half period (input frames 50 to 150)
+		for (int i = 100; i < 300; i += 2)
+			TS_ASSERT_DELTA(buffer[2 * i], 8000, 80);
+		// Middle of the second half period (input frames 250 to 350)
+		for (int i = 500; i < 700; i += 2)
+			TS_ASSERT_DELTA(buffer[2 * i + 1], -8000, 80);
+
+		delete converter;
+	}
+
+	void test_sinc_shares_filter_banks() {
+		// Creating and destroying converters for various ratios in any order
+		// must not crash or leak. The banks stay cached until freed.
+		Audio::RateConverter *c1 = Audio::makeRateConverter(11025, 22050, false, false, Audio::kResamplerSinc);
+		Audio::RateConverter *c2 = Audio::makeRateConverter(22050, 44100, true, false, Audio::kResamplerSinc);
+		Audio::RateConverter *c3 = Audio::makeRateConverter(8000, 44100, true, true, Audio::kResamplerSinc);
+		delete c1;
+		Audio::RateConverter *c4 = Audio::makeRateConverter(11025, 22050, false, false, Audio::kResamplerSinc);
+		delete c2;
+		delete c3;
+		delete c4;
+		Audio::freeSincFilterBanks();
+
+		checkConstantLevel(22050, 44100, false, Audio::kResamplerSinc);
+		Audio::freeSincFilterBanks();
+	}
+
+	void test_sinc_nearest_phase() {
+		// 22050 Hz to 48000 Hz uses all 320 phases, 22254 Hz to 44100 Hz
+		// would need 7350 and rounds to the nearest one
+		checkConstantLevel(22050, 48000, true, Audio::kResamplerSinc);
+		checkConstantLevel(22254, 44100, false, Audio::kResamplerSinc);
+
+		// With 11025 Hz to 48000 Hz, output frame 640 lies on input frame 147
+		TestToneStream stream(11025, false, 8000, 400);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 48000, false, false, Audio::kResamplerSinc);
+		int16 buffer[2 * 1024];
+		memset(buffer, 0, sizeof(buffer));
+		TS_ASSERT_EQUALS(converter->flow(stream, buffer, 1024, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1024);
+		TS_ASSERT_DELTA(buffer[2 * 640], 8000, 80);
+		delete converter;
+	}
+
+	void test_benchmark() {
+		runBenchmark("linear", Audio::kResamplerLinear);
+		runBenchmark("sinc", Audio::kResamplerSinc);
+	}
+};
@@ -0,0 +1,65 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+// Helpers for the benchmarks which are part of the test suites. This header
+// is included into the test runner before any ScummVM header, so that it can
+// use the C library timing functions which are forbidden elsewhere.
+
+#include <stdio.h>
+#include <time.h>
+
+namespace Benchmark {
+
+/**
+ * Returns the wall-clock time in seconds, counted from an arbitrary point.
+ * Unlike the processor time, it also gives the right throughput for
+ * benchmarks which run on several threads.
+ */
+inline double seconds() {
+#ifdef CLOCK_MONOTONIC
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1000000000.0;
+#else
+	// Without a monotonic clock, e.g. on Windows, whose clock() does
+	// return the elapsed time
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * Prints the throughput of a benchmark run, e.g.
+ * "mixStereo/sse2: 123.4 Msamples/s".
+ */
+inline void report(const char *name, const char *variant, double units, const char *unit, double elapsed) {
+	if (elapsed <= 0.0)
+		elapsed = 0.000001;
+	printf("\n    %s/%s: %.1f M%s/s", name, variant, units / elapsed / 1000000.0, unit);
+	fflush(stdout);
+}
+
+} // End of namespace Benchmark
+
+#endif
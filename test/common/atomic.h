@@ -0,0 +1,35 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+
+class AtomicTestSuite : public CxxTest::TestSuite {
+public:
+	void test_load_store() {
+		volatile int32 value = 0;
+		Common::atomicStore(&value, -42);
+		TS_ASSERT_EQUALS(Common::atomicLoad(&value), -42);
+
+		volatile uint32 uvalue = 0;
+		Common::atomicStore(&uvalue, 0xFFFFFFFF);
+		TS_ASSERT_EQUALS(Common::atomicLoad(&uvalue), 0xFFFFFFFFU);
+	}
+
+	void test_add() {
+		volatile int32 value = 5;
+		TS_ASSERT_EQUALS(Common::atomicAdd(&value, 3), 8);
+		TS_ASSERT_EQUALS(Common::atomicAdd(&value, -10), -2);
+		TS_ASSERT_EQUALS(Common::atomicLoad(&value), -2);
+
+		// Unsigned counters wrap around
+		volatile uint32 uvalue = 0xFFFFFFFF;
+		TS_ASSERT_EQUALS(Common::atomicAdd(&uvalue, 1), 0U);
+	}
+
+	void test_compare_and_swap() {
+		volatile int32 value = 7;
+		TS_ASSERT(!Common::atomicCompareAndSwap(&value, 6, 1));
+		TS_ASSERT_EQUALS(Common::atomicLoad(&value), 7);
+		TS_ASSERT(Common::atomicCompareAndSwap(&value, 7, 1));
+		TS_ASSERT_EQUALS(Common::atomicLoad(&value), 1);
+	}
+};
@@ -0,0 +1,140 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/jobsystem.h"
+
+#include "test/system/test_system.h"
+
+class JobSystemTestSuite : public CxxTest::TestSuite {
+	enum {
+		kNumJobs = 1000
+	};
+
+	static void setValue(void *param) {
+		uint *value = (uint *)param;
+		*value += 1;
+	}
+
+	static void fillRange(void *param, uint begin, uint end) {
+		uint *values = (uint *)param;
+		for (uint i = begin; i < end; ++i)
+			values[i] += i;
+	}
+
+	// Every job submits two more, until the counter runs out
+	struct Tree {
+		Common::JobSystem *jobs;
+		Common::JobSystem::JobGroup *group;
+		uint *values;
+		uint index;
+	};
+
+	static void growTree(void *param) {
+		Tree *tree = (Tree *)param;
+		tree->values[tree->index] += 1;
+
+		for (uint child = tree->index * 2 + 1; child <= tree->index * 2 + 2; ++child) {
+			if (child < kNumJobs) {
+				Tree *next = &tree[child - tree->index];
+				tree->jobs->submit(*tree->group, growTree, next);
+			}
+		}
+	}
+
+	static void spin(void *param, uint begin, uint end) {
+		uint32 *results = (uint32 *)param;
+		for (uint i = begin; i < end; ++i) {
+			uint32 x = i;
+			for (int j = 0; j < 1000; ++j)
+				x = x * 1103515245 + 12345;
+			results[i] = x;
+		}
+	}
+
+	static void doNothing(void *param) {
+	}
+
+	void checkJobSystem(Common::JobSystem &jobs) {
+		uint values[kNumJobs];
+
+		// Submitted jobs
+		memset(values, 0, sizeof(values));
+		Common::JobSystem::JobGroup group;
+		for (uint i = 0; i < kNumJobs; ++i)
+			jobs.submit(group, setValue, &values[i]);
+		jobs.wait(group);
+		for (uint i = 0; i < kNumJobs; ++i)
+			TS_ASSERT_EQUALS(values[i], 1u);
+
+		// The group can be reused, and jobs may submit jobs
+		Tree tree[kNumJobs];
+		for (uint i = 0; i < kNumJobs; ++i) {
+			tree[i].jobs = &jobs;
+			tree[i].group = &group;
+			tree[i].values = values;
+			tree[i].index = i;
+		}
+		jobs.submit(group, growTree, &tree[0]);
+		jobs.wait(group);
+		for (uint i = 0; i < kNumJobs; ++i)
+			TS_ASSERT_EQUALS(values[i], 2u);
+
+		// Every element is handled once, for any range and grain size
+		static const uint grainSizes[] = { 0, 1, 7, 64, kNumJobs };
+		for (uint g = 0; g < ARRAYSIZE(grainSizes); ++g) {
+			memset(values, 0, sizeof(values));
+			jobs.parallelFor(3, kNumJobs - 5, grainSizes[g], fillRange, values);
+			for (uint i = 0; i < kNumJobs; ++i)
+				TS_ASSERT_EQUALS(values[i], (i >= 3 && i < kNumJobs - 5) ? i : 0);
+		}
+
+		jobs.parallelFor(5, 5, 1, fillRange, values);
+	}
+
+public:
+	void setUp() {
+		Test::installTestSystem();
+	}
+
+	void test_threads() {
+		Common::JobSystem jobs(3);
+		TS_ASSERT_EQUALS(jobs.getThreadCount(), 3u);
+		checkJobSystem(jobs);
+	}
+
+	void test_synchronous() {
+		Common::JobSystem jobs(0);
+		TS_ASSERT_EQUALS(jobs.getThreadCount(), 0u);
+		checkJobSystem(jobs);
+	}
+
+	void test_shared() {
+		Common::JobSystem &jobs = g_system->getJobSystem();
+		TS_ASSERT_EQUALS(jobs.getThreadCount() + 1, MIN<uint>(g_system->getCPUCount(), Common::JobSystem::kMaxThreads + 1));
+		checkJobSystem(jobs);
+	}
+
+	void test_benchmark() {
+		const int numJobs = 100000;
+		const uint numElements = 20000;
+		uint32 *results = new uint32[numElements];
+
+		static const uint threadCounts[] = { 0, 3 };
+		for (uint t = 0; t < ARRAYSIZE(threadCounts); ++t) {
+			Common::JobSystem jobs(threadCounts[t]);
+			const Common::String variant = Common::String::format("%u workers", jobs.getThreadCount());
+
+			Common::JobSystem::JobGroup group;
+			double start = Benchmark::seconds();
+			for (int i = 0; i < numJobs; ++i)
+				jobs.submit(group, doNothing, nullptr);
+			jobs.wait(group);
+			Benchmark::report("empty jobs", variant.c_str(), numJobs, "jobs", Benchmark::seconds() - start);
+
+			start = Benchmark::seconds();
+			jobs.parallelFor(0, numElements, 16, spin, results);
+			Benchmark::report("parallelFor", variant.c_str(), numElements, "elements", Benchmark::seconds() - start);
+		}
+
+		delete[] results;
+	}
+};
@@ -3,6 +3,17 @@
 #include "common/memstream.h"
 
 class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
+	struct CountingDeleter {
+		int *_count;
+
+		CountingDeleter(int *count) : _count(count) {}
+
+		void operator()(const byte *memory) {
+			++*_count;
+			delete[] memory;
+		}
+	};
+
 	public:
 	void test_seek_set() {
 		byte contents[] = { 'a', 'b', '\n', '\n', 'c', '\n' };
@@ -104,4 +115,61 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_shared_views() {
+		byte *contents = new byte[7];
+		for (int i = 0; i < 7; ++i)
+			contents[i] = i + 1;
+
+		int deleted = 0;
+		Common::SharedPtr<const byte> memory(contents, CountingDeleter(&deleted));
+		Common::SeekableReadStream *ms = new Common::SharedMemoryReadStream(memory, contents + 1, 6);
+		memory.reset();
+
+		// readStream returns a view on the same memory
+		ms->skip(1);
+		Common::SeekableReadStream *part = ms->readStream(3);
+		TS_ASSERT_EQUALS(ms->pos(), 4);
+		TS_ASSERT(!ms->eos());
+		TS_ASSERT_EQUALS(part->size(), 3);
+
+		// Reading past the end of the stream returns the rest
+		Common::SeekableReadStream *rest = ms->readStream(10);
+		TS_ASSERT(ms->eos());
+		TS_ASSERT_EQUALS(rest->size(), 2);
+
+		Common::SeekableReadStream *view = ms->createView(4, 2);
+		TS_ASSERT(!ms->createView(4, 3));
+		TS_ASSERT(!ms->createView(7, 0));
+
+		// Views keep the memory alive
+		delete ms;
+		TS_ASSERT_EQUALS(deleted, 0);
+		TS_ASSERT_EQUALS(part->readByte(), 3);
+		TS_ASSERT_EQUALS(part->readUint16BE(), 0x0405);
+		TS_ASSERT_EQUALS(rest->readUint16BE(), 0x0607);
+		TS_ASSERT_EQUALS(view->readUint16BE(), 0x0607);
+
+		// Views of views share the memory as well
+		Common::SeekableReadStream *inner = part->createView(1, 1);
+		delete part;
+		delete rest;
+		delete view;
+		TS_ASSERT_EQUALS(deleted, 0);
+		TS_ASSERT_EQUALS(inner->readByte(), 4);
+		delete inner;
+		TS_ASSERT_EQUALS(deleted, 1);
+	}
+
+	void test_plain_stream_has_no_views() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		TS_ASSERT(!ms.createView(0, 4));
+
+		// readStream still copies
+		Common::SeekableReadStream *part = ms.readStream(4);
+		contents[1] = 0;
+		TS_ASSERT_EQUALS(part->readUint32BE(), 0x01020304U);
+		delete part;
+	}
 };
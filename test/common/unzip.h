@@ -0,0 +1,267 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+#include "test/system/test_system.h"
+
+#ifdef USE_ZLIB
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+	struct Member {
+		const char *name;
+		bool deflate;
+		uint32 size;
+		byte *data;
+	};
+
+	enum {
+		kNumMembers = 3
+	};
+
+	struct ArrayDeleter {
+		void operator()(const byte *memory) { delete[] memory; }
+	};
+
+	Member _members[kNumMembers];
+	byte *_zipData;
+	uint32 _zipSize;
+
+	static byte *makeData(uint32 size, uint32 seed) {
+		// Compressible, but not trivially so
+		byte *data = new byte[size];
+		uint32 state = seed;
+		for (uint32 i = 0; i < size; ++i) {
+			state = state * 1103515245 + 12345;
+			data[i] = (state >> 28) + (i >> 12);
+		}
+		return data;
+	}
+
+	static void writeMember(Common::MemoryWriteStreamDynamic &zip, Common::MemoryWriteStreamDynamic &dir, const Member &member) {
+		// The gzip format holds the raw deflate data and its CRC
+		Common::MemoryWriteStreamDynamic *gzipData = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(gzipData);
+		gzip->write(member.data, member.size);
+		gzip->finalize();
+		byte *gzipBytes = gzipData->getData();
+		const uint32 gzipSize = gzipData->size();
+		delete gzip;
+
+		const uint32 crc = READ_LE_UINT32(gzipBytes + gzipSize - 8);
+		const byte *data = member.deflate ? gzipBytes + 10 : member.data;
+		const uint32 compressedSize = member.deflate ? gzipSize - 18 : member.size;
+		const uint16 nameLength = strlen(member.name);
+		const uint32 offset = zip.pos();
+
+		zip.writeUint32LE(0x04034b50);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(member.deflate ? 8 : 0);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(compressedSize);
+		zip.writeUint32LE(member.size);
+		zip.writeUint16LE(nameLength);
+		zip.writeUint16LE(0);
+		zip.write(member.name, nameLength);
+		zip.write(data, compressedSize);
+
+		dir.writeUint32LE(0x02014b50);
+		dir.writeUint16LE(20);
+		dir.writeUint16LE(20);
+		dir.writeUint16LE(0);
+		dir.writeUint16LE(member.deflate ? 8 : 0);
+		dir.writeUint32LE(0);
+		dir.writeUint32LE(crc);
+		dir.writeUint32LE(compressedSize);
+		dir.writeUint32LE(member.size);
+		dir.writeUint16LE(nameLength);
+		dir.writeUint32LE(0);
+		dir.writeUint32LE(0);
+		dir.writeUint32LE(0);
+		dir.writeUint32LE(offset);
+		dir.write(member.name, nameLength);
+
+		free(gzipBytes);
+	}
+
+	Common::Archive *openZip() {
+		return Common::makeZipArchive(new Common::MemoryReadStream(_zipData, _zipSize));
+	}
+
+	bool checkRange(Common::SeekableReadStream *stream, const Member &member, uint32 pos, uint32 size) {
+		byte buffer[1000];
+		if (!stream->seek(pos) || stream->read(buffer, size) != size)
+			return false;
+		return memcmp(buffer, member.data + pos, size) == 0 && (uint32)stream->pos() == pos + size;
+	}
+
+public:
+	void setUp() {
+		// The archive guards its stream with a mutex
+		Test::installTestSystem();
+
+		const Member members[kNumMembers] = {
+			{ "stored.bin", false, 100000, nullptr },
+			{ "small.txt", true, 5000, nullptr },
+			{ "large.bin", true, 3 * 1024 * 1024 + 17, nullptr }
+		};
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		Common::MemoryWriteStreamDynamic dir(DisposeAfterUse::YES);
+		for (int i = 0; i < kNumMembers; ++i) {
+			_members[i] = members[i];
+			_members[i].data = makeData(_members[i].size, i);
+			writeMember(zip, dir, _members[i]);
+		}
+
+		const uint32 dirOffset = zip.pos();
+		zip.write(dir.getData(), dir.size());
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint32LE(0);
+		zip.writeUint16LE(kNumMembers);
+		zip.writeUint16LE(kNumMembers);
+		zip.writeUint32LE(dir.size());
+		zip.writeUint32LE(dirOffset);
+		zip.writeUint16LE(0);
+
+		_zipData = zip.getData();
+		_zipSize = zip.size();
+	}
+
+	void tearDown() {
+		for (int i = 0; i < kNumMembers; ++i)
+			delete[] _members[i].data;
+		free(_zipData);
+	}
+
+	void test_read_members() {
+		Common::Archive *archive = openZip();
+		TS_ASSERT(archive);
+
+		for (int i = 0; i < kNumMembers; ++i) {
+			Common::SeekableReadStream *stream = archive->createReadStreamForMember(_members[i].name);
+			TS_ASSERT(stream);
+			TS_ASSERT_EQUALS((uint32)stream->size(), _members[i].size);
+
+			byte *data = new byte[_members[i].size + 1];
+			TS_ASSERT_EQUALS(stream->read(data, _members[i].size + 1), _members[i].size);
+			TS_ASSERT(stream->eos());
+			TS_ASSERT(!stream->err());
+			TS_ASSERT(memcmp(data, _members[i].data, _members[i].size) == 0);
+
+			delete[] data;
+			delete stream;
+		}
+
+		delete archive;
+	}
+
+	void test_mapped_stored_member() {
+		// A ZIP file on shared memory, like a memory mapped one
+		byte *zipData = new byte[_zipSize];
+		memcpy(zipData, _zipData, _zipSize);
+		Common::SharedPtr<const byte> memory(zipData, ArrayDeleter());
+		Common::Archive *archive = Common::makeZipArchive(new Common::SharedMemoryReadStream(memory, zipData, _zipSize));
+		TS_ASSERT(archive);
+
+		for (int i = 0; i < kNumMembers; ++i) {
+			Common::SeekableReadStream *stream = archive->createReadStreamForMember(_members[i].name);
+			TS_ASSERT(stream);
+
+			// Only stored members are views into the ZIP file
+			Common::SeekableReadStream *view = stream->createView(0, 100);
+			TS_ASSERT_EQUALS(view != nullptr, !_members[i].deflate);
+			delete view;
+
+			TS_ASSERT(checkRange(stream, _members[i], 0, 1000));
+			TS_ASSERT(checkRange(stream, _members[i], _members[i].size - 10, 10));
+			delete stream;
+		}
+
+		delete archive;
+	}
+
+	void test_stored_member_crc() {
+		// Damage the data of the stored member, which comes first
+		_zipData[30 + strlen(_members[0].name) + 500] ^= 1;
+
+		Common::Archive *archive = openZip();
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember(_members[0].name);
+		TS_ASSERT(stream);
+
+		byte *data = new byte[_members[0].size];
+		TS_ASSERT(checkRange(stream, _members[0], 1000, 1000));
+		TS_ASSERT(!stream->err());
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT_EQUALS(stream->read(data, _members[0].size), _members[0].size);
+		TS_ASSERT(stream->err());
+		delete[] data;
+		delete stream;
+		delete archive;
+
+		// Mapped members are checked when they are opened
+		byte *zipData = new byte[_zipSize];
+		memcpy(zipData, _zipData, _zipSize);
+		Common::SharedPtr<const byte> memory(zipData, ArrayDeleter());
+		archive = Common::makeZipArchive(new Common::SharedMemoryReadStream(memory, zipData, _zipSize));
+		TS_ASSERT(archive);
+		TS_ASSERT(archive->hasFile(_members[0].name));
+		TS_ASSERT(!archive->createReadStreamForMember(_members[0].name));
+		delete archive;
+	}
+
+	void test_seek() {
+		Common::Archive *archive = openZip();
+
+		for (int i = 0; i < kNumMembers; ++i) {
+			const Member &member = _members[i];
+			Common::SeekableReadStream *stream = archive->createReadStreamForMember(member.name);
+
+			// Forwards, then backwards across the checkpoints of large members
+			const uint32 step = member.size / 7;
+			for (uint32 pos = 0; pos + 1000 <= member.size; pos += step)
+				TS_ASSERT(checkRange(stream, member, pos, 1000));
+			for (uint32 pos = member.size - 1000; pos >= step; pos -= step)
+				TS_ASSERT(checkRange(stream, member, pos, 1000));
+			TS_ASSERT(checkRange(stream, member, 0, 1000));
+			TS_ASSERT(checkRange(stream, member, member.size - 10, 10));
+
+			TS_ASSERT(stream->seek(-5, SEEK_END));
+			TS_ASSERT_EQUALS((uint32)stream->pos(), member.size - 5);
+			TS_ASSERT(!stream->err());
+
+			delete stream;
+		}
+
+		delete archive;
+	}
+
+	void test_interleaved_members() {
+		Common::Archive *archive = openZip();
+
+		Common::SeekableReadStream *streams[kNumMembers];
+		for (int i = 0; i < kNumMembers; ++i)
+			streams[i] = archive->createReadStreamForMember(_members[i].name);
+
+		// Members read independently of each other, even after the archive
+		// is gone
+		for (uint32 pos = 0; pos < 4000; pos += 500) {
+			for (int i = 0; i < kNumMembers; ++i)
+				TS_ASSERT(checkRange(streams[i], _members[i], pos, 500));
+
+			if (pos == 2000) {
+				delete archive;
+				archive = nullptr;
+			}
+		}
+
+		for (int i = 0; i < kNumMembers; ++i)
+			delete streams[i];
+	}
+};
+
+#endif
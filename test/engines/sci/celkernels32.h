@@ -0,0 +1,142 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/sci/graphics/celkernels32.h"
+
+class CelKernels32TestSuite : public CxxTest::TestSuite {
+	enum {
+		kSkipColor = 255,
+		kRemapStart = 236,
+		kCelWidth = 320,
+		kCelHeight = 200
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	// Fills a row like the ones of a sprite cel: runs of transparent pixels
+	// around runs of opaque ones, with some remap colors in between
+	void fillCelRow(byte *row, uint width) {
+		uint i = 0;
+		while (i < width) {
+			uint run = MIN<uint>(1 + nextRandom() % 24, width - i);
+			const uint kind = nextRandom() % 8;
+			for (; run > 0; --run, ++i) {
+				if (kind < 3)
+					row[i] = kSkipColor;
+				else if (kind == 3)
+					row[i] = kRemapStart + nextRandom() % (kSkipColor - kRemapStart);
+				else
+					row[i] = nextRandom() % 256;
+			}
+		}
+	}
+
+	void fillRandom(byte *row, uint width) {
+		for (uint i = 0; i < width; ++i)
+			row[i] = nextRandom();
+	}
+
+public:
+	void test_kernels_match_scalar() {
+		const Sci::CelRowKernel *scalar = Sci::getCelRowKernel(Sci::kCelRowKernelScalar);
+		TS_ASSERT(scalar);
+
+		byte source[80];
+		byte output[80];
+		byte expected[80];
+		_seed = 1;
+
+		for (int type = Sci::kCelRowKernelScalar + 1; type < Sci::kCelRowKernelCount; ++type) {
+			const Sci::CelRowKernel *kernel = Sci::getCelRowKernel((Sci::CelRowKernelType)type);
+			if (!kernel)
+				continue;
+
+			for (uint width = 0; width <= ARRAYSIZE(source); ++width) {
+				fillCelRow(source, width);
+				fillRandom(output, ARRAYSIZE(output));
+				memcpy(expected, output, sizeof(output));
+				scalar->drawSkip(expected, source, width, kSkipColor);
+				kernel->drawSkip(output, source, width, kSkipColor);
+				TS_ASSERT_SAME_DATA(output, expected, sizeof(output));
+
+				static const uint8 limits[] = { 0, 1, kRemapStart, 255 };
+				for (uint l = 0; l < ARRAYSIZE(limits); ++l) {
+					fillRandom(output, ARRAYSIZE(output));
+					memcpy(expected, output, sizeof(output));
+					const bool expectedRemap = scalar->drawBelow(expected, source, width, kSkipColor, limits[l]);
+					const bool remap = kernel->drawBelow(output, source, width, kSkipColor, limits[l]);
+					TS_ASSERT_EQUALS(remap, expectedRemap);
+					TS_ASSERT_SAME_DATA(output, expected, sizeof(output));
+				}
+
+				fillRandom(output, ARRAYSIZE(output));
+				memcpy(expected, output, sizeof(output));
+				scalar->reverse(expected, source, width);
+				kernel->reverse(output, source, width);
+				TS_ASSERT_SAME_DATA(output, expected, sizeof(output));
+			}
+		}
+	}
+
+	void test_scalar_kernel() {
+		const Sci::CelRowKernel *scalar = Sci::getCelRowKernel(Sci::kCelRowKernelScalar);
+		const byte source[] = { 1, kSkipColor, 3, kRemapStart, 5 };
+		byte output[] = { 9, 9, 9, 9, 9 };
+
+		TS_ASSERT(scalar->drawBelow(output, source, ARRAYSIZE(source), kSkipColor, kRemapStart));
+		const byte expectedBelow[] = { 1, 9, 3, 9, 5 };
+		TS_ASSERT_SAME_DATA(output, expectedBelow, sizeof(output));
+
+		scalar->reverse(output, source, ARRAYSIZE(source));
+		const byte expectedReverse[] = { 5, kRemapStart, 3, kSkipColor, 1 };
+		TS_ASSERT_SAME_DATA(output, expectedReverse, sizeof(output));
+	}
+
+	void test_benchmark() {
+		const int iterations = 50;
+		byte *cel = new byte[kCelWidth * kCelHeight];
+		byte *screen = new byte[kCelWidth * kCelHeight];
+		byte row[kCelWidth];
+		_seed = 2;
+		for (int y = 0; y < kCelHeight; ++y)
+			fillCelRow(cel + y * kCelWidth, kCelWidth);
+		memset(screen, 0, kCelWidth * kCelHeight);
+
+		const double pixels = (double)kCelWidth * kCelHeight * iterations;
+		for (int type = Sci::kCelRowKernelScalar; type < Sci::kCelRowKernelCount; ++type) {
+			const Sci::CelRowKernel *kernel = Sci::getCelRowKernel((Sci::CelRowKernelType)type);
+			if (!kernel)
+				continue;
+
+			double start = Benchmark::seconds();
+			for (int i = 0; i < iterations; ++i) {
+				for (int y = 0; y < kCelHeight; ++y)
+					kernel->drawSkip(screen + y * kCelWidth, cel + y * kCelWidth, kCelWidth, kSkipColor);
+			}
+			Benchmark::report("celDrawSkip", kernel->name, pixels, "pixels", Benchmark::seconds() - start);
+
+			start = Benchmark::seconds();
+			for (int i = 0; i < iterations; ++i) {
+				for (int y = 0; y < kCelHeight; ++y)
+					kernel->drawBelow(screen + y * kCelWidth, cel + y * kCelWidth, kCelWidth, kSkipColor, kRemapStart);
+			}
+			Benchmark::report("celDrawBelow", kernel->name, pixels, "pixels", Benchmark::seconds() - start);
+
+			start = Benchmark::seconds();
+			for (int i = 0; i < iterations; ++i) {
+				for (int y = 0; y < kCelHeight; ++y) {
+					kernel->reverse(row, cel + y * kCelWidth, kCelWidth);
+					kernel->drawSkip(screen + y * kCelWidth, row, kCelWidth, kSkipColor);
+				}
+			}
+			Benchmark::report("celDrawFlipped", kernel->name, pixels, "pixels", Benchmark::seconds() - start);
+		}
+
+		delete[] cel;
+		delete[] screen;
+	}
+};
@@ -0,0 +1,294 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/blitkernels.h"
+#include "graphics/managed_surface.h"
+#include "graphics/surface_pool.h"
+#include "graphics/transparent_surface.h"
+
+#include "test/system/test_system.h"
+
+class BlitKernelsTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	uint32 nextValue() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	/** Random pixels, a third of them fully transparent and a third opaque */
+	void fillSprite(uint32 *pixels, uint count) {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		for (uint i = 0; i < count; ++i) {
+			const uint32 value = nextValue();
+			byte a = value >> 16;
+			if (value % 3 == 0)
+				a = 0;
+			else if (value % 3 == 1)
+				a = 0xFF;
+			pixels[i] = format.ARGBToColor(a, value, value >> 4, value >> 8);
+		}
+	}
+
+	static const char *getModeName(int mode) {
+		static const char *const names[] = {
+			"opaque", "binary", "alpha", "alphaTinted", "additive", "additiveTinted",
+			"subtractive", "subtractiveTinted", "multiply", "multiplyTinted"
+		};
+		return names[mode];
+	}
+
+	static bool isTinted(int mode) {
+		return mode == Graphics::kBlendRowAlphaTinted || mode == Graphics::kBlendRowAdditiveTinted ||
+		       mode == Graphics::kBlendRowSubtractiveTinted || mode == Graphics::kBlendRowMultiplyTinted;
+	}
+
+public:
+	void setUp() {
+		// Blitting logs through the debug channels
+		Test::installTestSystem();
+		_seed = 1;
+	}
+
+	void test_kernels_match_scalar() {
+		const Graphics::BlitKernel &scalar = *Graphics::getBlitKernel(Graphics::kBlitKernelScalar);
+		const uint maxWidth = 37;
+		uint32 src[maxWidth], dst[maxWidth], expected[maxWidth], actual[maxWidth];
+
+		for (int type = Graphics::kBlitKernelScalar + 1; type < Graphics::kBlitKernelCount; ++type) {
+			const Graphics::BlitKernel *kernel = Graphics::getBlitKernel((Graphics::BlitKernelType)type);
+			if (!kernel)
+				continue;
+
+			for (int mode = 0; mode < Graphics::kBlendRowModeCount; ++mode) {
+				for (int flip = 0; flip < 2; ++flip) {
+					for (uint width = 1; width <= maxWidth; width += 4) {
+						fillSprite(src, width);
+						fillSprite(dst, width);
+						const uint32 color = isTinted(mode) ? (nextValue() | 0x01000000) : 0xFFFFFFFF;
+						const byte *in = (const byte *)(flip ? src + width - 1 : src);
+
+						memcpy(expected, dst, width * 4);
+						scalar.blend[mode][flip]((byte *)expected, in, width, color);
+						memcpy(actual, dst, width * 4);
+						kernel->blend[mode][flip]((byte *)actual, in, width, color);
+
+						TS_ASSERT_SAME_DATA(actual, expected, width * 4);
+					}
+				}
+			}
+
+			for (int bytes = 0; bytes < 3; ++bytes) {
+				for (uint width = 1; width <= maxWidth; width += 3) {
+					byte *in = (byte *)src;
+					for (uint i = 0; i < width * 4; ++i)
+						in[i] = nextValue() % 3;
+					fillSprite(dst, width);
+
+					memcpy(expected, dst, width * 4);
+					scalar.keyedCopy[bytes]((byte *)expected, in, width, 0);
+					memcpy(actual, dst, width * 4);
+					kernel->keyedCopy[bytes]((byte *)actual, in, width, 0);
+
+					TS_ASSERT_SAME_DATA(actual, expected, width * 4);
+				}
+			}
+		}
+	}
+
+	void test_alpha_blend() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite, target;
+		sprite.create(2, 1, format);
+		target.create(2, 1, format);
+
+		uint32 *in = (uint32 *)sprite.getPixels();
+		uint32 *out = (uint32 *)target.getPixels();
+		in[0] = format.ARGBToColor(0x80, 0xFF, 0x00, 0x40);
+		in[1] = format.ARGBToColor(0x00, 0xFF, 0xFF, 0xFF);
+		out[0] = out[1] = format.ARGBToColor(0xFF, 0x00, 0xFF, 0x40);
+
+		sprite.blit(target);
+
+		// (in * a + out * (255 - a)) >> 8 where the source is not transparent
+		TS_ASSERT_EQUALS(out[0], format.ARGBToColor(0xFF, 0x7F, 0x7E, 0x3F));
+		TS_ASSERT_EQUALS(out[1], format.ARGBToColor(0xFF, 0x00, 0xFF, 0x40));
+
+		sprite.free();
+		target.free();
+	}
+
+	void test_flipped_blit() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite;
+		Graphics::Surface target;
+		sprite.create(9, 3, format);
+		target.create(9, 3, format);
+
+		// The modes which copy opaque pixels unchanged
+		for (int alphaMode = Graphics::ALPHA_OPAQUE; alphaMode <= Graphics::ALPHA_BINARY; ++alphaMode) {
+			fillSprite((uint32 *)sprite.getPixels(), 9 * 3);
+			for (int y = 0; y < 3; ++y) {
+				for (int x = 0; x < 9; ++x)
+					*(uint32 *)sprite.getBasePtr(x, y) |= format.ARGBToColor(0xFF, 0, 0, 0);
+			}
+
+			sprite.setAlphaMode((Graphics::AlphaType)alphaMode);
+			sprite.blit(target, 0, 0, Graphics::FLIP_HV);
+
+			for (int y = 0; y < 3; ++y) {
+				for (int x = 0; x < 9; ++x)
+					TS_ASSERT_EQUALS(*(const uint32 *)target.getBasePtr(x, y), *(const uint32 *)sprite.getBasePtr(8 - x, 2 - y));
+			}
+		}
+
+		sprite.free();
+		target.free();
+	}
+
+	void test_scaled_blit() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite;
+		Graphics::Surface target;
+		sprite.create(2, 2, format);
+		target.create(4, 4, format);
+
+		for (int i = 0; i < 4; ++i)
+			((uint32 *)sprite.getPixels())[i] = format.ARGBToColor(0xFF, i * 50, 0, 0);
+		sprite.setAlphaMode(Graphics::ALPHA_OPAQUE);
+
+		// Twice, to draw through a surface reused from the scratch pool
+		for (int pass = 0; pass < 2; ++pass) {
+			target.fillRect(Common::Rect(4, 4), 0);
+			sprite.blit(target, 0, 0, Graphics::FLIP_NONE, nullptr, TS_ARGB(255, 255, 255, 255), 4, 4);
+
+			for (int y = 0; y < 4; ++y) {
+				for (int x = 0; x < 4; ++x)
+					TS_ASSERT_EQUALS(*(const uint32 *)target.getBasePtr(x, y), *(const uint32 *)sprite.getBasePtr(x / 2, y / 2));
+			}
+		}
+
+		sprite.free();
+		target.free();
+	}
+
+	void test_managed_surface_trans_blit() {
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		Graphics::ManagedSurface sprite(40, 3, format);
+		Graphics::ManagedSurface target(40, 3, format);
+
+		uint16 *in = (uint16 *)sprite.getPixels();
+		uint16 *out = (uint16 *)target.getPixels();
+		for (int i = 0; i < 40 * 3; ++i) {
+			in[i] = nextValue() % 4;
+			out[i] = 100 + i;
+		}
+
+		// Partially outside of the target
+		target.transBlitFrom(sprite, Common::Point(-3, 1), 0);
+
+		for (int y = 0; y < 3; ++y) {
+			for (int x = 0; x < 40; ++x) {
+				uint16 expected = 100 + y * 40 + x;
+				if (y >= 1 && x + 3 < 40 && in[(y - 1) * 40 + x + 3] != 0)
+					expected = in[(y - 1) * 40 + x + 3];
+				TS_ASSERT_EQUALS(out[y * 40 + x], expected);
+			}
+		}
+	}
+
+	void test_surface_pool() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::SurfacePool pool(2, 64 * 64 * 4 + 8 * 8 * 4);
+
+		Graphics::Surface *large = pool.acquire(64, 64, format);
+		Graphics::Surface *small = pool.acquire(8, 8, format);
+		TS_ASSERT_EQUALS(small->pitch, 8 * 4);
+		const void *largePixels = large->getPixels();
+		pool.release(large);
+		pool.release(small);
+		TS_ASSERT_EQUALS(pool.getUnusedCount(), 2u);
+
+		// The smallest buffer which fits is reused
+		Graphics::Surface *surface = pool.acquire(32, 10, format);
+		TS_ASSERT_EQUALS(surface->getPixels(), largePixels);
+		TS_ASSERT_EQUALS(surface->w, 32);
+		TS_ASSERT_EQUALS(surface->pitch, 32 * 4);
+		TS_ASSERT_EQUALS(pool.getUnusedCount(), 1u);
+
+		// Beyond the byte limit, surfaces are freed rather than kept
+		Graphics::Surface *extra = pool.acquire(65, 64, format);
+		pool.release(extra);
+		TS_ASSERT_EQUALS(pool.getUnusedCount(), 1u);
+
+		pool.release(surface);
+		pool.clear();
+		TS_ASSERT_EQUALS(pool.getUnusedCount(), 0u);
+	}
+
+	void test_benchmark() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		const int width = 640;
+		const int height = 480;
+		const int frames = 10;
+		uint32 *src = new uint32[width * height];
+		uint32 *dst = new uint32[width * height];
+		fillSprite(src, width * height);
+		fillSprite(dst, width * height);
+
+		static const int modes[] = { Graphics::kBlendRowOpaque, Graphics::kBlendRowBinary, Graphics::kBlendRowAlpha, Graphics::kBlendRowAlphaTinted };
+		for (int m = 0; m < ARRAYSIZE(modes); ++m) {
+			for (int type = 0; type < Graphics::kBlitKernelCount; ++type) {
+				const Graphics::BlitKernel *kernel = Graphics::getBlitKernel((Graphics::BlitKernelType)type);
+				if (!kernel)
+					continue;
+
+				const double start = Benchmark::seconds();
+				for (int frame = 0; frame < frames; ++frame) {
+					for (int y = 0; y < height; ++y)
+						kernel->blend[modes[m]][frame & 1]((byte *)(dst + y * width), (const byte *)(src + y * width + ((frame & 1) ? width - 1 : 0)), width, 0x80FF8040);
+				}
+
+				const Common::String name = Common::String::format("blend/%s", getModeName(modes[m]));
+				Benchmark::report(name.c_str(), kernel->name, (double)width * height * frames, "pixels", Benchmark::seconds() - start);
+			}
+		}
+
+		for (int type = 0; type < Graphics::kBlitKernelCount; ++type) {
+			const Graphics::BlitKernel *kernel = Graphics::getBlitKernel((Graphics::BlitKernelType)type);
+			if (!kernel)
+				continue;
+
+			const double start = Benchmark::seconds();
+			for (int frame = 0; frame < frames; ++frame) {
+				for (int y = 0; y < height; ++y)
+					kernel->keyedCopy[1]((byte *)(dst + y * width), (const byte *)(src + y * width), width * 2, 0);
+			}
+
+			Benchmark::report("keyedCopy/16bpp", kernel->name, (double)width * 2 * height * frames, "pixels", Benchmark::seconds() - start);
+		}
+
+		// Scaled sprites, as drawn by the engines every frame
+		Graphics::TransparentSurface sprite;
+		sprite.init(64, 64, 64 * 4, src, format);
+		const int sprites = 2000;
+		for (int pool = 0; pool < 2; ++pool) {
+			const double start = Benchmark::seconds();
+			for (int i = 0; i < sprites; ++i) {
+				if (pool) {
+					Graphics::Surface *scaled = Graphics::getScratchSurfacePool().acquire(48, 80, format);
+					sprite.scaleIntoT<Graphics::FILTER_NEAREST>(*scaled);
+					Graphics::getScratchSurfacePool().release(scaled);
+				} else {
+					Graphics::TransparentSurface *scaled = sprite.scale(48, 80);
+					scaled->free();
+					delete scaled;
+				}
+			}
+
+			Benchmark::report("scale/64x64", pool ? "pool" : "alloc", (double)sprites, "sprites", Benchmark::seconds() - start);
+		}
+
+		delete[] src;
+		delete[] dst;
+	}
+};
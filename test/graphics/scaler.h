@@ -0,0 +1,218 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/jobsystem.h"
+#include "graphics/scaler.h"
+#include "graphics/scaler/scalerkernels.h"
+
+#include "test/system/test_system.h"
+
+#ifdef USE_SCALERS
+
+class ScalerTestSuite : public CxxTest::TestSuite {
+	enum {
+		kBorder = 4,	///< The scalers read a few pixels around the area
+		kMaxScale = 3
+	};
+
+	struct Image {
+		int width, height;
+		uint32 pitch;
+		uint16 *buffer;
+
+		Image(int w, int h) : width(w), height(h), pitch((w + 2 * kBorder) * sizeof(uint16)) {
+			buffer = new uint16[(w + 2 * kBorder) * (h + 2 * kBorder)];
+		}
+
+		~Image() {
+			delete[] buffer;
+		}
+
+		uint8 *getPixels() {
+			return (uint8 *)(buffer + kBorder * (width + 2 * kBorder) + kBorder);
+		}
+	};
+
+	struct Scaler {
+		const char *name;
+		ScalerProc *proc;
+		int factor;
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	/**
+	 * Fills an image with content like that of a game screen: a dithered
+	 * gradient as the background, flat areas, outlined shapes and some noise.
+	 * The colors come from a small palette, as with 8 bit games.
+	 */
+	void fillGameFrame(Image &image, bool is565) {
+		uint16 palette[64];
+		for (int i = 0; i < 64; ++i) {
+			const int r = (i * 5) & 31, g = (i * 3 + (i >> 3)) & 31, b = (31 - i / 2) & 31;
+			palette[i] = is565 ? (r << 11) | (g << 6) | b : (r << 10) | (g << 5) | b;
+		}
+
+		const int rowLength = image.width + 2 * kBorder;
+		for (int y = 0; y < image.height + 2 * kBorder; ++y) {
+			for (int x = 0; x < rowLength; ++x) {
+				int color = (y * 16 / (image.height + 2 * kBorder) + ((x ^ y) & 1)) & 15;
+				if (x > rowLength / 4 && x < rowLength / 2 && y > 10 && y < 60)
+					color = (x == rowLength / 4 + 1 || y == 11) ? 40 : 32;
+				if ((x - 200) * (x - 200) + (y - 100) * (y - 100) < 900)
+					color = 48 + (x + y) % 3;
+				if ((nextRandom() & 63) == 0)
+					color = nextRandom() & 63;
+				image.buffer[y * rowLength + x] = palette[color];
+			}
+		}
+	}
+
+	static void getScalers(Common::Array<Scaler> &scalers) {
+		static const Scaler all[] = {
+			{ "Normal1x", Normal1x, 1 },
+			{ "Normal2x", Normal2x, 2 },
+			{ "Normal3x", Normal3x, 3 },
+			{ "2xSaI", _2xSaI, 2 },
+			{ "Super2xSaI", Super2xSaI, 2 },
+			{ "SuperEagle", SuperEagle, 2 },
+			{ "AdvMame2x", AdvMame2x, 2 },
+			{ "AdvMame3x", AdvMame3x, 3 },
+			{ "TV2x", TV2x, 2 },
+			{ "DotMatrix", DotMatrix, 2 },
+#ifdef USE_HQ_SCALERS
+			{ "HQ2x", HQ2x, 2 },
+			{ "HQ3x", HQ3x, 3 },
+#endif
+		};
+
+		for (int i = 0; i < ARRAYSIZE(all); ++i)
+			scalers.push_back(all[i]);
+	}
+
+	static void checkSame(Image &expected, Image &actual, const char *name) {
+		const uint32 rowBytes = expected.width * sizeof(uint16);
+		for (int y = 0; y < expected.height; ++y) {
+			if (memcmp(expected.getPixels() + y * expected.pitch, actual.getPixels() + y * actual.pitch, rowBytes)) {
+				TS_FAIL(Common::String::format("%s differs in row %d", name, y).c_str());
+				return;
+			}
+		}
+	}
+
+public:
+	void setUp() {
+		Test::installTestSystem();
+		InitScalers(565);
+		_seed = 1;
+	}
+
+	void tearDown() {
+		DestroyScalers();
+	}
+
+	void test_kernels_match_c() {
+		static const Scaler scalers[] = {
+			{ "AdvMame3x", AdvMame3x, 3 },
+#ifdef USE_HQ_SCALERS
+			{ "HQ2x", HQ2x, 2 },
+			{ "HQ3x", HQ3x, 3 },
+#endif
+		};
+
+		// Widths with and without a remainder after the SIMD blocks
+		static const int widths[] = { 7, 37, 320 };
+
+		for (int format = 0; format < 2; ++format) {
+			InitScalers(format ? 555 : 565);
+
+			for (int type = 0; type < kScalerKernelCount; ++type) {
+				const ScalerKernel *kernel = getScalerKernel((ScalerKernelType)type);
+				if (!kernel)
+					continue;
+
+				for (int w = 0; w < ARRAYSIZE(widths); ++w) {
+					Image src(widths[w], 20);
+					fillGameFrame(src, format == 0);
+
+					for (int s = 0; s < ARRAYSIZE(scalers); ++s) {
+						const Scaler &scaler = scalers[s];
+						Image expected(src.width * scaler.factor, src.height * scaler.factor);
+						Image actual(src.width * scaler.factor, src.height * scaler.factor);
+
+						gScalerKernel = nullptr;
+						scaler.proc(src.getPixels(), src.pitch, expected.getPixels(), expected.pitch, src.width, src.height);
+						gScalerKernel = kernel;
+						scaler.proc(src.getPixels(), src.pitch, actual.getPixels(), actual.pitch, src.width, src.height);
+
+						checkSame(expected, actual, Common::String::format("%s/%s/%d", scaler.name, kernel->name, src.width).c_str());
+					}
+				}
+			}
+		}
+	}
+
+	void test_bands_match_whole() {
+		Common::Array<Scaler> scalers;
+		getScalers(scalers);
+
+		Common::JobSystem jobSystem(3);
+
+		// An odd height leaves a single row for the last band
+		Image src(320, 201);
+		fillGameFrame(src, true);
+
+		for (uint s = 0; s < scalers.size(); ++s) {
+			const Scaler &scaler = scalers[s];
+			Image expected(src.width * scaler.factor, src.height * scaler.factor);
+			Image actual(src.width * scaler.factor, src.height * scaler.factor);
+
+			scaler.proc(src.getPixels(), src.pitch, expected.getPixels(), expected.pitch, src.width, src.height);
+			ScaleInBands(scaler.proc, scaler.factor, src.getPixels(), src.pitch, actual.getPixels(), actual.pitch, src.width, src.height, &jobSystem);
+
+			checkSame(expected, actual, scaler.name);
+		}
+	}
+
+	void test_benchmark() {
+		Common::Array<Scaler> scalers;
+		getScalers(scalers);
+
+		const int frames = 20;
+		Image src(320, 200);
+		fillGameFrame(src, true);
+
+		Common::JobSystem jobSystem(3);
+
+		for (uint s = 0; s < scalers.size(); ++s) {
+			const Scaler &scaler = scalers[s];
+			Image dst(src.width * scaler.factor, src.height * scaler.factor);
+
+			for (int type = -1; type < kScalerKernelCount; ++type) {
+				const ScalerKernel *kernel = type < 0 ? nullptr : getScalerKernel((ScalerKernelType)type);
+				if (type >= 0 && !kernel)
+					continue;
+
+				gScalerKernel = kernel;
+				const double start = Benchmark::seconds();
+				for (int frame = 0; frame < frames; ++frame)
+					scaler.proc(src.getPixels(), src.pitch, dst.getPixels(), dst.pitch, src.width, src.height);
+				Benchmark::report(scaler.name, kernel ? kernel->name : "c", (double)src.width * src.height * frames, "pixels", Benchmark::seconds() - start);
+			}
+
+			// The processor time of all threads is counted, so this shows the
+			// overhead of the bands rather than the speedup
+			gScalerKernel = getDefaultScalerKernel();
+			const double start = Benchmark::seconds();
+			for (int frame = 0; frame < frames; ++frame)
+				ScaleInBands(scaler.proc, scaler.factor, src.getPixels(), src.pitch, dst.getPixels(), dst.pitch, src.width, src.height, &jobSystem);
+			Benchmark::report(scaler.name, "bands", (double)src.width * src.height * frames, "pixels", Benchmark::seconds() - start);
+		}
+	}
+};
+
+#endif
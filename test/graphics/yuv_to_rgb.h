@@ -0,0 +1,179 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuvkernels.h"
+
+#include "test/system/test_system.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	enum Subsampling {
+		k444,
+		k420,
+		k410
+	};
+
+	uint32 _seed;
+
+	void fill(byte *buf, int count) {
+		for (int i = 0; i < count; ++i) {
+			_seed = _seed * 1103515245 + 12345;
+			buf[i] = _seed >> 24;
+		}
+	}
+
+	static void convert(Subsampling subsampling, Graphics::Surface &dst, Graphics::YUVToRGBManager::LuminanceScale scale, const byte *y, const byte *u, const byte *v, int width, int height) {
+		switch (subsampling) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, y, u, v, width, height, width, width);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, y, u, v, width, height, width, width / 2);
+			break;
+		case k410:
+			// The chroma planes have an extra row and column
+			YUVToRGBMan.convert410(&dst, scale, y, u, v, width, height, width, width / 4 + 1);
+			break;
+		}
+	}
+
+	/** Compares a kernel against the tables, for one image and format */
+	void checkImage(const Graphics::YUVKernel *kernel, Subsampling subsampling, const Graphics::PixelFormat &format,
+	                const byte *y, const byte *u, const byte *v, int width, int height) {
+		Graphics::Surface expected, actual;
+		expected.create(width, height, format);
+		actual.create(width, height, format);
+
+		for (int s = 0; s < 2; ++s) {
+			const Graphics::YUVToRGBManager::LuminanceScale scale = s ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+			YUVToRGBMan.setKernel(nullptr);
+			convert(subsampling, expected, scale, y, u, v, width, height);
+			YUVToRGBMan.setKernel(kernel);
+			convert(subsampling, actual, scale, y, u, v, width, height);
+
+			for (int row = 0; row < height; ++row)
+				TS_ASSERT_SAME_DATA(actual.getBasePtr(0, row), expected.getBasePtr(0, row), width * format.bytesPerPixel);
+		}
+
+		expected.free();
+		actual.free();
+	}
+
+	static Graphics::PixelFormat getFormat(int i) {
+		switch (i) {
+		case 0:
+			return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		case 1:
+			return Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15);
+		case 2:
+			return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		default:
+			return Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0);
+		}
+	}
+
+public:
+	void setUp() {
+		// The manager guards its lookup tables with a mutex
+		Test::installTestSystem();
+	}
+
+	void tearDown() {
+		YUVToRGBMan.setKernel(Graphics::getDefaultYUVKernel());
+	}
+
+	void test_all_colors() {
+		// Every chroma pair, with a luminance changing across the image
+		const int size = 256;
+		byte *y = new byte[size * size];
+		byte *u = new byte[size * size];
+		byte *v = new byte[size * size];
+		for (int i = 0; i < size * size; ++i) {
+			y[i] = (i * 7 + (i >> 8) * 13) & 0xFF;
+			u[i] = i & 0xFF;
+			v[i] = i >> 8;
+		}
+
+		for (int type = 0; type < Graphics::kYUVKernelCount; ++type) {
+			const Graphics::YUVKernel *kernel = Graphics::getYUVKernel((Graphics::YUVKernelType)type);
+			if (!kernel)
+				continue;
+
+			for (int f = 0; f < 4; ++f)
+				checkImage(kernel, k444, getFormat(f), y, u, v, size, size);
+		}
+
+		delete[] y;
+		delete[] u;
+		delete[] v;
+	}
+
+	void test_kernels_match_tables() {
+		byte y[68 * 8];
+		byte u[68 * 8];
+		byte v[68 * 8];
+		_seed = 1;
+
+		for (int type = 0; type < Graphics::kYUVKernelCount; ++type) {
+			const Graphics::YUVKernel *kernel = Graphics::getYUVKernel((Graphics::YUVKernelType)type);
+			if (!kernel)
+				continue;
+
+			// Widths with and without a remainder after the SIMD blocks
+			for (int width = 4; width <= 68; width += 4) {
+				fill(y, sizeof(y));
+				fill(u, sizeof(u));
+				fill(v, sizeof(v));
+
+				for (int f = 0; f < 4; ++f) {
+					checkImage(kernel, k444, getFormat(f), y, u, v, width, 8);
+					checkImage(kernel, k420, getFormat(f), y, u, v, width, 8);
+					checkImage(kernel, k410, getFormat(f), y, u, v, width, 8);
+				}
+			}
+		}
+	}
+
+	void test_benchmark() {
+		static const int sizes[][2] = { { 640, 480 }, { 1280, 720 } };
+		const int frames = 20;
+
+		for (int i = 0; i < ARRAYSIZE(sizes); ++i) {
+			const int width = sizes[i][0];
+			const int height = sizes[i][1];
+			byte *y = new byte[width * height];
+			byte *u = new byte[width * height];
+			byte *v = new byte[width * height];
+			_seed = 2;
+			fill(y, width * height);
+			fill(u, width * height);
+			fill(v, width * height);
+
+			for (int f = 0; f < 4; f += 2) {
+				const Graphics::PixelFormat format = getFormat(f);
+				Graphics::Surface dst;
+				dst.create(width, height, format);
+
+				for (int type = -1; type < Graphics::kYUVKernelCount; ++type) {
+					const Graphics::YUVKernel *kernel = type < 0 ? nullptr : Graphics::getYUVKernel((Graphics::YUVKernelType)type);
+					if (type >= 0 && !kernel)
+						continue;
+
+					YUVToRGBMan.setKernel(kernel);
+					const double start = Benchmark::seconds();
+					for (int frame = 0; frame < frames; ++frame)
+						convert(k420, dst, Graphics::YUVToRGBManager::kScaleITU, y, u, v, width, height);
+
+					const Common::String name = Common::String::format("convert420/%dx%d/%dbpp", width, height, format.bytesPerPixel * 8);
+					Benchmark::report(name.c_str(), kernel ? kernel->name : "tables", (double)width * height * frames, "pixels", Benchmark::seconds() - start);
+				}
+
+				dst.free();
+			}
+
+			delete[] y;
+			delete[] u;
+			delete[] v;
+		}
+	}
+};
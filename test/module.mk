@@ -5,8 +5,21 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h
+TEST_SYSTEM  := test/system/test_system.o
+
+ifdef POSIX
+	# The test system uses the threads and mutexes of the POSIX backends
+	TEST_SYSTEM += backends/mutex/pthread/pthread-mutex.o backends/thread/pthread/pthread-thread.o
+endif
+
+TEST_LIBS    := $(TEST_SYSTEM) audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+ifdef USE_BINK
+	TESTS += $(srcdir)/test/video/*.h
+	# The kernels depend on the common code, so the video code goes first
+	TEST_LIBS := video/libvideo.a $(TEST_LIBS)
+endif
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -18,8 +31,16 @@ ifeq ($(ENABLE_ULTIMA), STATIC_PLUGIN)
 	TEST_LIBS += engines/ultima/libultima.a
 endif
 
+ifeq ($(ENABLE_SCI), STATIC_PLUGIN)
+ifdef ENABLE_SCI32
+	TESTS += $(srcdir)/test/engines/sci/*.h
+	# The kernels depend on the common code, so the engine goes first
+	TEST_LIBS := engines/sci/libsci.a $(TEST_LIBS)
+endif
+endif
+
 #
-TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
+TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h --include=$(srcdir)/test/benchmark.h
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
 TEST_LDFLAGS := $(LDFLAGS) $(LIBS)
 TEST_CXXFLAGS := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
@@ -39,6 +60,9 @@ endif
 #TEST_LDFLAGS += -L/usr/X11R6/lib -lX11
 
 
+# The test system is not part of a module, so track its dependencies here
+-include $(wildcard test/system/$(DEPDIR)/*.d)
+
 test: test/runner
 	./test/runner
 test/runner: test/runner.cpp $(TEST_LIBS)
@@ -49,6 +73,6 @@ test/runner.cpp: $(TESTS)
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/system/test_system.o
 
 .PHONY: test clean-test
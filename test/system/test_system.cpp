@@ -0,0 +1,145 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The test system uses the host's timing functions directly
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "test/system/test_system.h"
+
+#include "audio/mixer_intern.h"
+#include "common/system.h"
+#include "graphics/pixelformat.h"
+
+#if defined(POSIX)
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/thread/pthread/pthread-thread.h"
+
+#include <sys/time.h>
+#include <unistd.h>
+#else
+#include <time.h>
+#endif
+
+namespace Test {
+
+namespace {
+
+class TestSystem : public OSystem {
+public:
+	TestSystem() : _mixer(0) {
+#if defined(POSIX)
+		gettimeofday(&_start, NULL);
+#endif
+	}
+
+	// Graphics
+	virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return 0; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return 0; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeXOffset, int shakeYOffset) {}
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return 0; }
+	virtual int16 getOverlayWidth() { return 0; }
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format) {}
+
+	// Events and time
+	virtual void getTimeAndDate(TimeDate &t) const {}
+	virtual Audio::Mixer *getMixer() {
+		// Nothing ever pulls samples from this mixer, but audio code like
+		// the OPL emulators queries it for the output rate and registers
+		// its streams with it.
+		if (!_mixer) {
+			_mixer = new Audio::MixerImpl(44100);
+			_mixer->setReady(true);
+		}
+		return _mixer;
+	}
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg) {}
+	virtual void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+	virtual void logMessage(LogMessageType::Type type, const char *message) {}
+
+#if defined(POSIX)
+	virtual uint32 getMillis(bool skipRecord = false) {
+		struct timeval now;
+		gettimeofday(&now, NULL);
+		return (now.tv_sec - _start.tv_sec) * 1000 + (now.tv_usec - _start.tv_usec) / 1000;
+	}
+
+	virtual void delayMillis(uint msecs) { usleep(msecs * 1000); }
+
+	// Mutexes and threads, from the backend code
+	virtual MutexRef createMutex() { return _mutexManager.createMutex(); }
+	virtual void lockMutex(MutexRef mutex) { _mutexManager.lockMutex(mutex); }
+	virtual void unlockMutex(MutexRef mutex) { _mutexManager.unlockMutex(mutex); }
+	virtual void deleteMutex(MutexRef mutex) { _mutexManager.deleteMutex(mutex); }
+
+	virtual ThreadRef createThread(ThreadProc proc, void *param, const char *name) { return _threadManager.createThread(proc, param, name); }
+	virtual void joinThread(ThreadRef thread) { _threadManager.joinThread(thread); }
+	virtual SemaphoreRef createSemaphore(uint value) { return _threadManager.createSemaphore(value); }
+	virtual void waitSemaphore(SemaphoreRef sem) { _threadManager.waitSemaphore(sem); }
+	virtual void postSemaphore(SemaphoreRef sem) { _threadManager.postSemaphore(sem); }
+	virtual void deleteSemaphore(SemaphoreRef sem) { _threadManager.deleteSemaphore(sem); }
+	virtual uint getCPUCount() { return _threadManager.getCPUCount(); }
+
+private:
+	struct timeval _start;
+	PthreadMutexManager _mutexManager;
+	PthreadThreadManager _threadManager;
+#else
+	virtual uint32 getMillis(bool skipRecord = false) { return clock() * 1000 / CLOCKS_PER_SEC; }
+	virtual void delayMillis(uint msecs) {}
+
+	// Without threads, there is nothing to lock against
+	virtual MutexRef createMutex() { return (MutexRef)this; }
+	virtual void lockMutex(MutexRef mutex) {}
+	virtual void unlockMutex(MutexRef mutex) {}
+	virtual void deleteMutex(MutexRef mutex) {}
+#endif
+
+private:
+	Audio::MixerImpl *_mixer;
+};
+
+} // End of anonymous namespace
+
+void installTestSystem() {
+	if (!g_system)
+		g_system = new TestSystem();
+}
+
+} // End of namespace Test
@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/binkkernels.h"
+
+#ifdef USE_BINK
+
+class BinkKernelsTestSuite : public CxxTest::TestSuite {
+	enum {
+		kPitch = 40,
+		kBufferSize = kPitch * 20
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	// Mostly small coefficients, with many blocks holding only a few of them
+	// like in actual videos
+	void fillBlock(int32 *block) {
+		const uint32 density = nextRandom() % 4;
+		for (int i = 0; i < 64; ++i) {
+			if (density == 0 && i != 0)
+				block[i] = 0;
+			else if (density == 1 && nextRandom() % 8 != 0)
+				block[i] = 0;
+			else
+				block[i] = (int32)(nextRandom() % 4096) - 2048;
+		}
+	}
+
+	void fillRandom(byte *buffer, uint size) {
+		for (uint i = 0; i < size; ++i)
+			buffer[i] = nextRandom();
+	}
+
+	void checkIDCT(Video::BinkIDCTProc scalar, Video::BinkIDCTProc kernel) {
+		int32 coeffs[64], block[64];
+		byte output[kBufferSize], expected[kBufferSize];
+
+		for (int i = 0; i < 500; ++i) {
+			fillBlock(coeffs);
+			fillRandom(output, sizeof(output));
+			memcpy(expected, output, sizeof(output));
+
+			// The pixels around the block must stay untouched
+			memcpy(block, coeffs, sizeof(block));
+			scalar(expected + kPitch + 4, kPitch, block);
+			memcpy(block, coeffs, sizeof(block));
+			kernel(output + kPitch + 4, kPitch, block);
+			TS_ASSERT_SAME_DATA(output, expected, sizeof(output));
+		}
+	}
+
+public:
+	void test_kernels_match_scalar() {
+		const Video::BinkKernel *scalar = Video::getBinkKernel(Video::kBinkKernelScalar);
+		TS_ASSERT(scalar);
+		_seed = 1;
+
+		for (int type = Video::kBinkKernelScalar + 1; type < Video::kBinkKernelCount; ++type) {
+			const Video::BinkKernel *kernel = Video::getBinkKernel((Video::BinkKernelType)type);
+			if (!kernel)
+				continue;
+
+			checkIDCT(scalar->idctPut, kernel->idctPut);
+			checkIDCT(scalar->idctAdd, kernel->idctAdd);
+			checkIDCT(scalar->idctPutScaled, kernel->idctPutScaled);
+
+			int16 residue[64];
+			byte output[kBufferSize], expected[kBufferSize];
+			for (int i = 0; i < 100; ++i) {
+				for (int j = 0; j < 64; ++j)
+					residue[j] = (int16)(nextRandom() % 1024) - 512;
+				fillRandom(output, sizeof(output));
+				memcpy(expected, output, sizeof(output));
+
+				scalar->addResidue(expected + kPitch + 4, kPitch, residue);
+				kernel->addResidue(output + kPitch + 4, kPitch, residue);
+				TS_ASSERT_SAME_DATA(output, expected, sizeof(output));
+			}
+		}
+	}
+
+	void test_scalar_kernel() {
+		// A block with only a DC coefficient is flat
+		int32 block[64];
+		memset(block, 0, sizeof(block));
+		block[0] = 100 << 8;
+
+		byte output[64];
+		Video::getBinkKernel(Video::kBinkKernelScalar)->idctPut(output, 8, block);
+		for (int i = 0; i < 64; ++i)
+			TS_ASSERT_EQUALS(output[i], 100);
+	}
+
+	void test_benchmark() {
+		const int numBlocks = 1024;
+		const int iterations = 20;
+		int32 *coeffs = new int32[numBlocks * 64];
+		int32 block[64];
+		byte plane[kBufferSize];
+		_seed = 2;
+		for (int i = 0; i < numBlocks; ++i)
+			fillBlock(coeffs + i * 64);
+		memset(plane, 0, sizeof(plane));
+
+		const double blocks = (double)numBlocks * iterations;
+		for (int type = Video::kBinkKernelScalar; type < Video::kBinkKernelCount; ++type) {
+			const Video::BinkKernel *kernel = Video::getBinkKernel((Video::BinkKernelType)type);
+			if (!kernel)
+				continue;
+
+			double start = Benchmark::seconds();
+			for (int i = 0; i < iterations; ++i) {
+				for (int j = 0; j < numBlocks; ++j) {
+					memcpy(block, coeffs + j * 64, sizeof(block));
+					kernel->idctPut(plane, kPitch, block);
+				}
+			}
+			Benchmark::report("binkIDCTPut", kernel->name, blocks, "blocks", Benchmark::seconds() - start);
+
+			start = Benchmark::seconds();
+			for (int i = 0; i < iterations; ++i) {
+				for (int j = 0; j < numBlocks; ++j) {
+					memcpy(block, coeffs + j * 64, sizeof(block));
+					kernel->idctAdd(plane, kPitch, block);
+				}
+			}
+			Benchmark::report("binkIDCTAdd", kernel->name, blocks, "blocks", Benchmark::seconds() - start);
+		}
+
+		delete[] coeffs;
+	}
+};
+
+#endif
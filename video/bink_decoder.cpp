@@ -28,6 +28,7 @@
 #include "audio/decoders/raw.h"
 
 #include "common/util.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/math.h"
 #include "common/stream.h"
@@ -243,7 +244,8 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 }
 
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
-		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
+		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id),
+		_kernel(getDefaultBinkKernel()), _jobSystem(0), _jobSystemChecked(false), _dctJob(0), _decodeTime(0) {
 	_curFrame = -1;
 
 	for (int i = 0; i < 16; i++)
@@ -317,6 +319,12 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 }
 
 BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
+	if (_curFrame >= 0)
+		debug(2, "BinkVideoTrack: Decoded %d frames in %u ms with %d threads", _curFrame + 1, _decodeTime, _jobSystem ? (int)_jobSystem->getThreadCount() + 1 : 1);
+
+	for (uint i = 0; i < _freeJobs.size(); i++)
+		delete _freeJobs[i];
+
 	for (int i = 0; i < 4; i++) {
 		delete[] _curPlanes[i]; _curPlanes[i] = 0;
 		delete[] _oldPlanes[i]; _oldPlanes[i] = 0;
@@ -335,11 +343,16 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	assert(frame.bits);
 
+	const uint32 startTime = g_system->getMillis();
+	if (useDecodeJobs())
+		_dctJob = allocJob();
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
 
 		decodePlane(frame, 3, false);
+		flushDCTBlocks();
 	}
 
 	if (_id == kBIKiID)
@@ -349,6 +362,7 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
 
 		decodePlane(frame, planeIdx, i != 0);
+		flushDCTBlocks();
 
 		if (frame.bits->pos() >= frame.bits->size())
 			break;
@@ -359,14 +373,142 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
 	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-	YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-			_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+	if (_dctJob) {
+		// All planes have to be complete before converting any band
+		{
+			Common::StackLock lock(_decodeMutex);
+			_freeJobs.push_back(_dctJob);
+		}
+		_dctJob = 0;
+		_jobSystem->wait(_decodeJobs);
+
+		// Pairs of rows, so that every band starts at a row of chroma samples
+		_jobSystem->parallelFor(0, _surfaceHeight / 2, 8, convertBandsProc, this);
+	} else {
+		convertFrame(0, _surfaceHeight);
+	}
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
 		SWAP(_curPlanes[i], _oldPlanes[i]);
 
 	_curFrame++;
+	_decodeTime += g_system->getMillis() - startTime;
+}
+
+void BinkDecoder::BinkVideoTrack::convertFrame(int top, int bottom) {
+	// The band starts at an even row, i.e. at a row of chroma samples
+	Graphics::Surface band;
+	band.init(_surfaceWidth, bottom - top, _surface.pitch, _surface.getBasePtr(0, top), _surface.format);
+
+	const int yPitch  = _yBlockWidth  * 8;
+	const int uvPitch = _uvBlockWidth * 8;
+	YUVToRGBMan.convert420(&band, Graphics::YUVToRGBManager::kScaleITU,
+			_curPlanes[0] + top * yPitch, _curPlanes[1] + top / 2 * uvPitch, _curPlanes[2] + top / 2 * uvPitch,
+			_surfaceWidth, bottom - top, yPitch, uvPitch);
+}
+
+void BinkDecoder::BinkVideoTrack::transformBlock(DCTOp op, byte *dest, uint32 pitch, int32 *block) {
+	if (!_dctJob) {
+		switch (op) {
+		case kDCTPut:
+			_kernel.idctPut(dest, pitch, block);
+			break;
+		case kDCTAdd:
+			_kernel.idctAdd(dest, pitch, block);
+			break;
+		case kDCTPutScaled:
+			_kernel.idctPutScaled(dest, pitch, block);
+			break;
+		}
+		return;
+	}
+
+	DCTBlock &dct = _dctJob->blocks[_dctJob->blockCount++];
+	memcpy(dct.coeffs, block, sizeof(dct.coeffs));
+	dct.dest  = dest;
+	dct.pitch = pitch;
+	dct.op    = op;
+
+	if (_dctJob->blockCount == kDCTBatchSize)
+		flushDCTBlocks();
+}
+
+bool BinkDecoder::BinkVideoTrack::useDecodeJobs() {
+	if (!_jobSystemChecked) {
+		_jobSystemChecked = true;
+
+		if (_surfaceWidth * _surfaceHeight >= kMinThreadedArea) {
+			_jobSystem = &g_system->getJobSystem();
+			if (_jobSystem->getThreadCount()) {
+				// The converter is shared by the jobs, so it has to exist already
+				Graphics::YUVToRGBManager::instance();
+			} else {
+				_jobSystem = 0;
+			}
+		}
+	}
+
+	return _jobSystem != 0;
+}
+
+BinkDecoder::BinkVideoTrack::DecodeJob *BinkDecoder::BinkVideoTrack::allocJob() {
+	DecodeJob *job = 0;
+	{
+		Common::StackLock lock(_decodeMutex);
+		if (!_freeJobs.empty()) {
+			job = _freeJobs.back();
+			_freeJobs.pop_back();
+		}
+	}
+
+	if (!job) {
+		job = new DecodeJob;
+		job->track = this;
+	}
+
+	job->blockCount = 0;
+	return job;
+}
+
+void BinkDecoder::BinkVideoTrack::flushDCTBlocks() {
+	if (!_dctJob || !_dctJob->blockCount)
+		return;
+
+	// The jobs start on the blocks of a plane while the next one is read
+	_jobSystem->submit(_decodeJobs, dctJobProc, _dctJob);
+	_dctJob = allocJob();
+}
+
+void BinkDecoder::BinkVideoTrack::dctJobProc(void *param) {
+	DecodeJob &job = *(DecodeJob *)param;
+	BinkVideoTrack &track = *job.track;
+
+	for (uint i = 0; i < job.blockCount; i++) {
+		DCTBlock &dct = job.blocks[i];
+		switch (dct.op) {
+		case kDCTPut:
+			track._kernel.idctPut(dct.dest, dct.pitch, dct.coeffs);
+			break;
+		case kDCTAdd:
+			track._kernel.idctAdd(dct.dest, dct.pitch, dct.coeffs);
+			break;
+		case kDCTPutScaled:
+			track._kernel.idctPutScaled(dct.dest, dct.pitch, dct.coeffs);
+			break;
+		}
+	}
+
+	Common::StackLock lock(track._decodeMutex);
+	track._freeJobs.push_back(&job);
+}
+
+void BinkDecoder::BinkVideoTrack::convertBandsProc(void *param, uint begin, uint end) {
+	BinkVideoTrack &track = *(BinkVideoTrack *)param;
+
+	// The last band includes the odd row at the bottom, if any
+	const int bottom = ((int)end == track._surfaceHeight / 2) ? track._surfaceHeight : end * 2;
+	track.convertFrame(begin * 2, bottom);
 }
 
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
@@ -686,17 +828,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCT(block);
-
-	int32 *src   = block;
-	byte  *dest1 = ctx.dest;
-	byte  *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
-
-	}
+	transformBlock(kDCTPutScaled, ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
@@ -816,11 +948,7 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 
 	readResidue(*ctx.video, block, v);
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	_kernel.addResidue(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
@@ -831,7 +959,7 @@ void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCTPut(ctx, block);
+	transformBlock(kDCTPut, ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
@@ -852,7 +980,7 @@ void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, false);
 
-	IDCTAdd(ctx, block);
+	transformBlock(kDCTAdd, ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
@@ -1280,88 +1408,6 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-    const int a0 = (src)[s0] + (src)[s4]; \
-    const int a1 = (src)[s0] - (src)[s4]; \
-    const int a2 = (src)[s2] + (src)[s6]; \
-    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-    const int a4 = (src)[s5] + (src)[s3]; \
-    const int a5 = (src)[s5] - (src)[s3]; \
-    const int a6 = (src)[s1] + (src)[s7]; \
-    const int a7 = (src)[s1] - (src)[s7]; \
-    const int b0 = a4 + a6; \
-    const int b1 = (A3*(a5 + a7)) >> 11; \
-    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-    (dest)[d0] = munge(a0+a2   +b0); \
-    (dest)[d1] = munge(a1+a3-a2+b2); \
-    (dest)[d2] = munge(a1-a3+a2+b3); \
-    (dest)[d3] = munge(a0-a2   -b4); \
-    (dest)[d4] = munge(a0-a2   +b4); \
-    (dest)[d5] = munge(a1-a3+a2-b3); \
-    (dest)[d6] = munge(a1+a3-a2-b2); \
-    (dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int32 *dest, const int32 *src) {
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
-	int i;
-	int32 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
-	int i;
-	int32 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
@@ -33,8 +33,11 @@
 
 #include "common/array.h"
 #include "common/bitstream.h"
+#include "common/jobsystem.h"
+#include "common/mutex.h"
 #include "common/rational.h"
 
+#include "video/binkkernels.h"
 #include "video/video_decoder.h"
 
 #include "graphics/surface.h"
@@ -212,6 +215,33 @@ private:
 			kBlockRaw           ///< Uncoded 8x8 block.
 		};
 
+		enum {
+			kMinThreadedArea  = 320 * 240,  ///< Minimum frame size decoded by several threads.
+			kDCTBatchSize     = 64          ///< Number of DCT blocks transformed in one go.
+		};
+
+		/** How a transformed DCT block is written into its plane. */
+		enum DCTOp {
+			kDCTPut,      ///< The block replaces the pixels.
+			kDCTAdd,      ///< The block is added to the pixels.
+			kDCTPutScaled ///< The block is scaled up to 16x16 and replaces the pixels.
+		};
+
+		/** A DCT block whose transform is left to a job. */
+		struct DCTBlock {
+			int32 coeffs[64];
+			byte *dest;
+			uint32 pitch;
+			DCTOp op;
+		};
+
+		/** A batch of DCT blocks, transformed by one job. */
+		struct DecodeJob {
+			BinkVideoTrack *track;
+			DCTBlock blocks[kDCTBatchSize];
+			uint blockCount;
+		};
+
 		/** Data structure for decoding and tranlating Huffman'd data. */
 		struct Huffman {
 			int  index;       ///< Index of the Huffman codebook to use.
@@ -263,6 +293,27 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		const BinkKernel &_kernel; ///< The IDCT routines.
+
+		/**
+		 * The bitstream is only read by the main thread. The inverse DCTs are
+		 * transformed by jobs on the worker threads meanwhile, followed by the
+		 * conversion of the frame to RGB. Blocks never overlap and only read
+		 * the last frame, so this yields the same result as decoding serially.
+		 * Null if the video is too small, or there are no worker threads.
+		 */
+		Common::JobSystem *_jobSystem;
+		Common::JobSystem::JobGroup _decodeJobs;
+		bool _jobSystemChecked;
+
+		DecodeJob *_dctJob; ///< The batch collecting DCT blocks, only used by the main thread.
+
+		/** Guards the member below */
+		Common::Mutex _decodeMutex;
+		Common::Array<DecodeJob *> _freeJobs;
+
+		uint32 _decodeTime; ///< Time spent decoding frames, in milliseconds.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -318,10 +369,17 @@ private:
 		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
-		// Bink video IDCT
-		void IDCT(int32 *block);
-		void IDCTPut(DecodeContext &ctx, int32 *block);
-		void IDCTAdd(DecodeContext &ctx, int32 *block);
+		/** Transform a DCT block, or queue it for a job. */
+		void transformBlock(DCTOp op, byte *dest, uint32 pitch, int32 *block);
+
+		// Decoding jobs
+		bool useDecodeJobs();
+		DecodeJob *allocJob();
+		/** Submit the DCT blocks collected so far. */
+		void flushDCTBlocks();
+		static void dctJobProc(void *param);
+		static void convertBandsProc(void *param, uint begin, uint end);
+		void convertFrame(int top, int bottom);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -0,0 +1,570 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "video/binkkernels.h"
+#include "common/cpudetect.h"
+
+#if defined(SCUMMVM_AVX2)
+#include <immintrin.h>
+#elif defined(SCUMMVM_SSE2)
+#include <emmintrin.h>
+#endif
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Video {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#pragma mark -
+#pragma mark --- Scalar ---
+#pragma mark -
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int32 *dest, const int32 *src) {
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+static void IDCT(int32 *block) {
+	int i;
+	int32 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+static void idctPutScalar(byte *dest, uint pitch, int32 *block) {
+	int i;
+	int32 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+static void idctAddScalar(byte *dest, uint pitch, int32 *block) {
+	int i, j;
+
+	IDCT(block);
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (j = 0; j < 8; j++)
+			 dest[j] += block[j];
+}
+
+static void idctPutScaledScalar(byte *dest, uint pitch, int32 *block) {
+	IDCT(block);
+
+	const int32 *src = block;
+	byte *dest1 = dest;
+	byte *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, src += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
+
+	}
+}
+
+static void addResidueScalar(byte *dest, uint pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+static const BinkKernel binkKernelScalar = { "scalar", idctPutScalar, idctAddScalar, idctPutScaledScalar, addResidueScalar };
+
+// The SIMD kernels transform eight columns at once, with one vector per row.
+// The rows are then transformed the same way after transposing the block.
+// Skipping empty columns like the scalar code does is not worth it, as the
+// full transform yields the same result for them. Blocks with only a DC
+// coefficient, which are common, are flat and skip the transform.
+#define IDCT_TRANSFORM_VECTOR(type,dest,src,add,sub,mulShift) {\
+	const type a0 = add((src)[0], (src)[4]); \
+	const type a1 = sub((src)[0], (src)[4]); \
+	const type a2 = add((src)[2], (src)[6]); \
+	const type a3 = mulShift(sub((src)[2], (src)[6]), A1); \
+	const type a4 = add((src)[5], (src)[3]); \
+	const type a5 = sub((src)[5], (src)[3]); \
+	const type a6 = add((src)[1], (src)[7]); \
+	const type a7 = sub((src)[1], (src)[7]); \
+	const type b0 = add(a4, a6); \
+	const type b1 = mulShift(add(a5, a7), A3); \
+	const type b2 = add(sub(mulShift(a5, A4), b0), b1); \
+	const type b3 = sub(mulShift(sub(a6, a4), A1), b2); \
+	const type b4 = sub(add(mulShift(a7, A2), b3), b1); \
+	(dest)[0] = add(add(a0, a2), b0); \
+	(dest)[1] = add(sub(add(a1, a3), a2), b2); \
+	(dest)[2] = add(add(sub(a1, a3), a2), b3); \
+	(dest)[3] = sub(sub(a0, a2), b4); \
+	(dest)[4] = add(sub(a0, a2), b4); \
+	(dest)[5] = sub(add(sub(a1, a3), a2), b3); \
+	(dest)[6] = sub(sub(add(a1, a3), a2), b2); \
+	(dest)[7] = sub(add(a0, a2), b0); \
+}
+
+#ifdef SCUMMVM_SSE2
+
+#pragma mark -
+#pragma mark --- SSE2 ---
+#pragma mark -
+
+static inline __m128i mulShiftSSE2(__m128i x, int32 factor) {
+	// SSE2 has no 32-bit multiplication keeping the low halves. As the
+	// factors fit into 16 bits, x * factor is split into lo * factor and
+	// hi * factor << 16, with x = lo + (hi << 16) and lo a signed 16-bit
+	// value. The overflow of hi only changes bits above 32.
+	const __m128i f = _mm_set1_epi32(factor & 0xFFFF);
+	const __m128i hi = _mm_srai_epi32(_mm_add_epi32(x, _mm_set1_epi32(0x8000)), 16);
+	const __m128i product = _mm_add_epi32(_mm_madd_epi16(x, f), _mm_slli_epi32(_mm_madd_epi16(hi, f), 16));
+	return _mm_srai_epi32(product, 11);
+}
+
+static inline void transposeSSE2(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t1);
+	r1 = _mm_unpackhi_epi64(t0, t1);
+	r2 = _mm_unpacklo_epi64(t2, t3);
+	r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+static inline void transformSSE2(__m128i *v) {
+	IDCT_TRANSFORM_VECTOR(__m128i, v, v, _mm_add_epi32, _mm_sub_epi32, mulShiftSSE2);
+}
+
+/**
+ * Transforms the block into rows[2 * i] and rows[2 * i + 1], which hold the
+ * left and right half of row i.
+ */
+static inline void idctSSE2(const int32 *block, __m128i *rows) {
+	__m128i left[8], right[8];
+	for (int i = 0; i < 8; i++) {
+		left[i] = _mm_loadu_si128((const __m128i *)&block[8 * i]);
+		right[i] = _mm_loadu_si128((const __m128i *)&block[8 * i + 4]);
+	}
+
+	__m128i ac = _mm_and_si128(left[0], _mm_set_epi32(-1, -1, -1, 0));
+	for (int i = 0; i < 8; i++)
+		ac = _mm_or_si128(ac, i ? _mm_or_si128(left[i], right[i]) : right[i]);
+	if (_mm_movemask_epi8(_mm_cmpeq_epi32(ac, _mm_setzero_si128())) == 0xFFFF) {
+		const __m128i dc = _mm_set1_epi32((block[0] + 0x7F) >> 8);
+		for (int i = 0; i < 16; i++)
+			rows[i] = dc;
+		return;
+	}
+
+	transformSSE2(left);
+	transformSSE2(right);
+
+	// Four rows at a time, turned into columns
+	const __m128i bias = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i += 4) {
+		__m128i v[8] = { left[i], left[i + 1], left[i + 2], left[i + 3], right[i], right[i + 1], right[i + 2], right[i + 3] };
+		transposeSSE2(v[0], v[1], v[2], v[3]);
+		transposeSSE2(v[4], v[5], v[6], v[7]);
+
+		transformSSE2(v);
+		for (int j = 0; j < 8; j++)
+			v[j] = _mm_srai_epi32(_mm_add_epi32(v[j], bias), 8);
+
+		transposeSSE2(v[0], v[1], v[2], v[3]);
+		transposeSSE2(v[4], v[5], v[6], v[7]);
+		for (int j = 0; j < 4; j++) {
+			rows[2 * (i + j)] = v[j];
+			rows[2 * (i + j) + 1] = v[4 + j];
+		}
+	}
+}
+
+/** Truncates a row to bytes, in the lower half of the result. */
+static inline __m128i packRowSSE2(__m128i left, __m128i right) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i words = _mm_packs_epi32(_mm_and_si128(left, mask), _mm_and_si128(right, mask));
+	return _mm_packus_epi16(words, words);
+}
+
+static void idctPutSSE2(byte *dest, uint pitch, int32 *block) {
+	__m128i rows[16];
+	idctSSE2(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, packRowSSE2(rows[2 * i], rows[2 * i + 1]));
+}
+
+static void idctAddSSE2(byte *dest, uint pitch, int32 *block) {
+	__m128i rows[16];
+	idctSSE2(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i sum = _mm_add_epi8(_mm_loadl_epi64((const __m128i *)dest), packRowSSE2(rows[2 * i], rows[2 * i + 1]));
+		_mm_storel_epi64((__m128i *)dest, sum);
+	}
+}
+
+static void idctPutScaledSSE2(byte *dest, uint pitch, int32 *block) {
+	__m128i rows[16];
+	idctSSE2(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += 2 * pitch) {
+		const __m128i row = packRowSSE2(rows[2 * i], rows[2 * i + 1]);
+		const __m128i doubled = _mm_unpacklo_epi8(row, row);
+		_mm_storeu_si128((__m128i *)dest, doubled);
+		_mm_storeu_si128((__m128i *)(dest + pitch), doubled);
+	}
+}
+
+static void addResidueSSE2(byte *dest, uint pitch, const int16 *block) {
+	const __m128i mask = _mm_set1_epi16(0xFF);
+
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8) {
+		const __m128i words = _mm_and_si128(_mm_loadu_si128((const __m128i *)block), mask);
+		const __m128i sum = _mm_add_epi8(_mm_loadl_epi64((const __m128i *)dest), _mm_packus_epi16(words, words));
+		_mm_storel_epi64((__m128i *)dest, sum);
+	}
+}
+
+static const BinkKernel binkKernelSSE2 = { "sse2", idctPutSSE2, idctAddSSE2, idctPutScaledSSE2, addResidueSSE2 };
+
+#endif // SCUMMVM_SSE2
+
+#ifdef SCUMMVM_AVX2
+
+#pragma mark -
+#pragma mark --- AVX2 ---
+#pragma mark -
+
+SCUMMVM_TARGET_AVX2
+static inline __m256i mulShiftAVX2(__m256i x, int32 factor) {
+	return _mm256_srai_epi32(_mm256_mullo_epi32(x, _mm256_set1_epi32(factor)), 11);
+}
+
+SCUMMVM_TARGET_AVX2
+static inline void transposeAVX2(__m256i *r) {
+	const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+	const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+	const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+	const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+	const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+	const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+	const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+	const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+	const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+	const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+	const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+	const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+	const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+	const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+	const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+	const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+	r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+	r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+	r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+	r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+	r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+	r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+	r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+	r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+SCUMMVM_TARGET_AVX2
+static inline void transformAVX2(__m256i *v) {
+	IDCT_TRANSFORM_VECTOR(__m256i, v, v, _mm256_add_epi32, _mm256_sub_epi32, mulShiftAVX2);
+}
+
+/** Transforms the block into rows[i], which holds row i. */
+SCUMMVM_TARGET_AVX2
+static inline void idctAVX2(const int32 *block, __m256i *rows) {
+	for (int i = 0; i < 8; i++)
+		rows[i] = _mm256_loadu_si256((const __m256i *)&block[8 * i]);
+
+	__m256i ac = _mm256_and_si256(rows[0], _mm256_set_epi32(-1, -1, -1, -1, -1, -1, -1, 0));
+	for (int i = 1; i < 8; i++)
+		ac = _mm256_or_si256(ac, rows[i]);
+	if (_mm256_testz_si256(ac, ac)) {
+		const __m256i dc = _mm256_set1_epi32((block[0] + 0x7F) >> 8);
+		for (int i = 0; i < 8; i++)
+			rows[i] = dc;
+		return;
+	}
+
+	transformAVX2(rows);
+	transposeAVX2(rows);
+	transformAVX2(rows);
+
+	const __m256i bias = _mm256_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++)
+		rows[i] = _mm256_srai_epi32(_mm256_add_epi32(rows[i], bias), 8);
+	transposeAVX2(rows);
+}
+
+/** Truncates a row to bytes, in the lower half of the result. */
+SCUMMVM_TARGET_AVX2
+static inline __m128i packRowAVX2(__m256i row) {
+	const __m256i masked = _mm256_and_si256(row, _mm256_set1_epi32(0xFF));
+	const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(masked), _mm256_extracti128_si256(masked, 1));
+	return _mm_packus_epi16(words, words);
+}
+
+SCUMMVM_TARGET_AVX2
+static void idctPutAVX2(byte *dest, uint pitch, int32 *block) {
+	__m256i rows[8];
+	idctAVX2(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, packRowAVX2(rows[i]));
+}
+
+SCUMMVM_TARGET_AVX2
+static void idctAddAVX2(byte *dest, uint pitch, int32 *block) {
+	__m256i rows[8];
+	idctAVX2(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i sum = _mm_add_epi8(_mm_loadl_epi64((const __m128i *)dest), packRowAVX2(rows[i]));
+		_mm_storel_epi64((__m128i *)dest, sum);
+	}
+}
+
+SCUMMVM_TARGET_AVX2
+static void idctPutScaledAVX2(byte *dest, uint pitch, int32 *block) {
+	__m256i rows[8];
+	idctAVX2(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += 2 * pitch) {
+		const __m128i row = packRowAVX2(rows[i]);
+		const __m128i doubled = _mm_unpacklo_epi8(row, row);
+		_mm_storeu_si128((__m128i *)dest, doubled);
+		_mm_storeu_si128((__m128i *)(dest + pitch), doubled);
+	}
+}
+
+// Residues are too small a job for wider vectors
+static const BinkKernel binkKernelAVX2 = { "avx2", idctPutAVX2, idctAddAVX2, idctPutScaledAVX2, addResidueSSE2 };
+
+#endif // SCUMMVM_AVX2
+
+#ifdef SCUMMVM_NEON
+
+#pragma mark -
+#pragma mark --- NEON ---
+#pragma mark -
+
+static inline int32x4_t mulShiftNEON(int32x4_t x, int32 factor) {
+	return vshrq_n_s32(vmulq_n_s32(x, factor), 11);
+}
+
+static inline void transposeNEON(int32x4_t &r0, int32x4_t &r1, int32x4_t &r2, int32x4_t &r3) {
+	const int32x4x2_t t0 = vtrnq_s32(r0, r1);
+	const int32x4x2_t t1 = vtrnq_s32(r2, r3);
+	r0 = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+	r1 = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+	r2 = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+	r3 = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+}
+
+static inline void transformNEON(int32x4_t *v) {
+	IDCT_TRANSFORM_VECTOR(int32x4_t, v, v, vaddq_s32, vsubq_s32, mulShiftNEON);
+}
+
+/** Same as idctSSE2. */
+static inline void idctNEON(const int32 *block, int32x4_t *rows) {
+	int32x4_t left[8], right[8];
+	for (int i = 0; i < 8; i++) {
+		left[i] = vld1q_s32(&block[8 * i]);
+		right[i] = vld1q_s32(&block[8 * i + 4]);
+	}
+
+	int32x4_t ac = vsetq_lane_s32(0, left[0], 0);
+	for (int i = 0; i < 8; i++)
+		ac = vorrq_s32(ac, i ? vorrq_s32(left[i], right[i]) : right[i]);
+	const int32x2_t acHalf = vorr_s32(vget_low_s32(ac), vget_high_s32(ac));
+	if ((vget_lane_s32(acHalf, 0) | vget_lane_s32(acHalf, 1)) == 0) {
+		const int32x4_t dc = vdupq_n_s32((block[0] + 0x7F) >> 8);
+		for (int i = 0; i < 16; i++)
+			rows[i] = dc;
+		return;
+	}
+
+	transformNEON(left);
+	transformNEON(right);
+
+	const int32x4_t bias = vdupq_n_s32(0x7F);
+	for (int i = 0; i < 8; i += 4) {
+		int32x4_t v[8] = { left[i], left[i + 1], left[i + 2], left[i + 3], right[i], right[i + 1], right[i + 2], right[i + 3] };
+		transposeNEON(v[0], v[1], v[2], v[3]);
+		transposeNEON(v[4], v[5], v[6], v[7]);
+
+		transformNEON(v);
+		for (int j = 0; j < 8; j++)
+			v[j] = vshrq_n_s32(vaddq_s32(v[j], bias), 8);
+
+		transposeNEON(v[0], v[1], v[2], v[3]);
+		transposeNEON(v[4], v[5], v[6], v[7]);
+		for (int j = 0; j < 4; j++) {
+			rows[2 * (i + j)] = v[j];
+			rows[2 * (i + j) + 1] = v[4 + j];
+		}
+	}
+}
+
+static inline uint8x8_t packRowNEON(int32x4_t left, int32x4_t right) {
+	return vmovn_u16(vreinterpretq_u16_s16(vcombine_s16(vmovn_s32(left), vmovn_s32(right))));
+}
+
+static void idctPutNEON(byte *dest, uint pitch, int32 *block) {
+	int32x4_t rows[16];
+	idctNEON(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, packRowNEON(rows[2 * i], rows[2 * i + 1]));
+}
+
+static void idctAddNEON(byte *dest, uint pitch, int32 *block) {
+	int32x4_t rows[16];
+	idctNEON(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), packRowNEON(rows[2 * i], rows[2 * i + 1])));
+}
+
+static void idctPutScaledNEON(byte *dest, uint pitch, int32 *block) {
+	int32x4_t rows[16];
+	idctNEON(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += 2 * pitch) {
+		const uint8x8_t row = packRowNEON(rows[2 * i], rows[2 * i + 1]);
+		const uint8x8x2_t zipped = vzip_u8(row, row);
+		const uint8x16_t doubled = vcombine_u8(zipped.val[0], zipped.val[1]);
+		vst1q_u8(dest, doubled);
+		vst1q_u8(dest + pitch, doubled);
+	}
+}
+
+static void addResidueNEON(byte *dest, uint pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8) {
+		const uint8x8_t residue = vmovn_u16(vreinterpretq_u16_s16(vld1q_s16(block)));
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), residue));
+	}
+}
+
+static const BinkKernel binkKernelNEON = { "neon", idctPutNEON, idctAddNEON, idctPutScaledNEON, addResidueNEON };
+
+#endif // SCUMMVM_NEON
+
+#pragma mark -
+
+const BinkKernel *getBinkKernel(BinkKernelType type) {
+	switch (type) {
+	case kBinkKernelScalar:
+		return &binkKernelScalar;
+
+#ifdef SCUMMVM_SSE2
+	case kBinkKernelSSE2:
+		return Common::hasCPUFeature(Common::kCPUFeatureSSE2) ? &binkKernelSSE2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_AVX2
+	case kBinkKernelAVX2:
+		return Common::hasCPUFeature(Common::kCPUFeatureAVX2) ? &binkKernelAVX2 : nullptr;
+#endif
+
+#ifdef SCUMMVM_NEON
+	case kBinkKernelNEON:
+		return Common::hasCPUFeature(Common::kCPUFeatureNEON) ? &binkKernelNEON : nullptr;
+#endif
+
+	default:
+		return nullptr;
+	}
+}
+
+const BinkKernel &getDefaultBinkKernel() {
+	static const BinkKernel *defaultKernel = nullptr;
+
+	if (!defaultKernel) {
+		const BinkKernel *kernel = &binkKernelScalar;
+		for (int i = kBinkKernelScalar + 1; i < kBinkKernelCount; ++i) {
+			const BinkKernel *candidate = getBinkKernel((BinkKernelType)i);
+			if (candidate)
+				kernel = candidate;
+		}
+		defaultKernel = kernel;
+	}
+
+	return *defaultKernel;
+}
+
+} // End of namespace Video
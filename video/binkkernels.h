@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef VIDEO_BINKKERNELS_H
+#define VIDEO_BINKKERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * Applies the inverse DCT of Bink video to an 8x8 block and writes the
+ * result into a plane. The results are truncated to 8 bits, without
+ * clamping, like in the original decoder.
+ *
+ * @param dest		top left pixel of the block in the plane
+ * @param pitch		pitch of the plane
+ * @param block		the coefficients, which may be modified
+ */
+typedef void (*BinkIDCTProc)(byte *dest, uint pitch, int32 *block);
+
+/**
+ * Adds the residue of a motion compensated 8x8 block to a plane, again
+ * truncating the results to 8 bits.
+ */
+typedef void (*BinkResidueProc)(byte *dest, uint pitch, const int16 *block);
+
+/**
+ * A set of Bink video block routines for one instruction set. All kernels
+ * produce exactly the same output as the scalar one.
+ */
+struct BinkKernel {
+	const char *name;
+	BinkIDCTProc idctPut;			///< Stores the transformed block
+	BinkIDCTProc idctAdd;			///< Adds the transformed block
+	BinkIDCTProc idctPutScaled;		///< Stores the transformed block scaled up to 16x16
+	BinkResidueProc addResidue;
+};
+
+enum BinkKernelType {
+	kBinkKernelScalar = 0,
+	kBinkKernelSSE2,
+	kBinkKernelAVX2,
+	kBinkKernelNEON,
+
+	kBinkKernelCount
+};
+
+/**
+ * Returns the kernel of the given type, or nullptr if it is not available
+ * in this build or not supported by the host CPU.
+ */
+const BinkKernel *getBinkKernel(BinkKernelType type);
+
+/**
+ * Returns the fastest kernel available on the host.
+ */
+const BinkKernel &getDefaultBinkKernel();
+
+} // End of namespace Video
+
+#endif